@@ -245,13 +245,15 @@ void btDbvtBroadphase::rayTest(const btVector3& rayFrom, const btVector3& rayTo,
 	// for this function to be threadsafe, each thread must have a separate copy
 	// of this stack.  This could be thread-local static to avoid dynamic allocations,
 	// instead of just a local.
-	int threadIndex = btGetCurrentThreadIndex();
+	// The thread index is only read when using the per-thread stacks, the game engine casts
+	// rays from task scheduler threads without a bullet thread index.
 	btAlignedObjectArray<const btDbvtNode*> localStack;
 	//todo(erwincoumans, "why do we get tsan issue here?")
 	if (0)//threadIndex < m_rayTestStacks.size())
 	//if (threadIndex < m_rayTestStacks.size())
 	{
 		// use per-thread preallocated stack if possible to avoid dynamic allocations
+		int threadIndex = btGetCurrentThreadIndex();
 		stack = &m_rayTestStacks[threadIndex];
 	}
 	else
@@ -115,6 +115,16 @@ public:
 				 const float* startPos, const float* endPos,
 				 dtStatPolyRef* path, const int maxPathSize);
 
+	// Same as findPath above, using the given search nodes instead of the navmesh ones.
+	// The navmesh is only read, this version can run in several threads at once.
+	// Params:
+	//	nodePool - (in) Node pool of the search, at least 2048 nodes.
+	//	openList - (in) Open list of the search, at least 2048 nodes.
+	int findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
+				 const float* startPos, const float* endPos,
+				 dtStatPolyRef* path, const int maxPathSize,
+				 class dtNodePool* nodePool, class dtNodeQueue* openList);
+
 	// Finds a straight path from start to end locations within the corridor
 	// described by the path polygons.
 	// Start and end locations will be clamped on the corridor.
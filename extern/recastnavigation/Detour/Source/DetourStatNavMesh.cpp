@@ -103,6 +103,14 @@ int dtStatNavMesh::getPolyIndexByRef(dtStatPolyRef ref) const
 int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 							const float* startPos, const float* endPos,
 							dtStatPolyRef* path, const int maxPathSize)
+{
+	return findPath(startRef, endRef, startPos, endPos, path, maxPathSize, m_nodePool, m_openList);
+}
+
+int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
+							const float* startPos, const float* endPos,
+							dtStatPolyRef* path, const int maxPathSize,
+							dtNodePool* nodePool, dtNodeQueue* openList)
 {
 	if (!m_header) return 0;
 	
@@ -118,24 +126,24 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 		return 1;
 	}
 
-	m_nodePool->clear();
-	m_openList->clear();
+	nodePool->clear();
+	openList->clear();
 
 	static const float H_SCALE = 1.1f;	// Heuristic scale.
 	
-	dtNode* startNode = m_nodePool->getNode(startRef);
+	dtNode* startNode = nodePool->getNode(startRef);
 	startNode->pidx = 0;
 	startNode->cost = 0;
 	startNode->total = vdist(startPos, endPos) * H_SCALE;
 	startNode->id = startRef;
 	startNode->flags = DT_NODE_OPEN;
-	m_openList->push(startNode);
+	openList->push(startNode);
 
 	dtNode* lastBestNode = startNode;
 	float lastBestNodeCost = startNode->total;
-	while (!m_openList->empty())
+	while (!openList->empty())
 	{
-		dtNode* bestNode = m_openList->pop();
+		dtNode* bestNode = openList->pop();
 	
 		if (bestNode->id == endRef)
 		{
@@ -150,12 +158,12 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 			if (neighbour)
 			{
 				// Skip parent node.
-				if (bestNode->pidx && m_nodePool->getNodeAtIdx(bestNode->pidx)->id == neighbour)
+				if (bestNode->pidx && nodePool->getNodeAtIdx(bestNode->pidx)->id == neighbour)
 					continue;
 
 				dtNode* parent = bestNode;
 				dtNode newNode;
-				newNode.pidx = m_nodePool->getNodeIdx(parent);
+				newNode.pidx = nodePool->getNodeIdx(parent);
 				newNode.id = neighbour;
 
 				// Calculate cost.
@@ -163,7 +171,7 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 				if (!parent->pidx)
 					vcopy(p0, startPos);
 				else
-					getEdgeMidPoint(m_nodePool->getNodeAtIdx(parent->pidx)->id, parent->id, p0);
+					getEdgeMidPoint(nodePool->getNodeAtIdx(parent->pidx)->id, parent->id, p0);
 				getEdgeMidPoint(parent->id, newNode.id, p1);
 				newNode.cost = parent->cost + vdist(p0,p1);
 				// Special case for last node.
@@ -174,7 +182,7 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 				const float h = vdist(p1,endPos)*H_SCALE;
 				newNode.total = newNode.cost + h;
 				
-				dtNode* actualNode = m_nodePool->getNode(newNode.id);
+				dtNode* actualNode = nodePool->getNode(newNode.id);
 				if (!actualNode)
 					continue;
 						
@@ -194,12 +202,12 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 
 					if (actualNode->flags & DT_NODE_OPEN)
 					{
-						m_openList->modify(actualNode);
+						openList->modify(actualNode);
 					}
 					else
 					{
 						actualNode->flags |= DT_NODE_OPEN;
-						m_openList->push(actualNode);
+						openList->push(actualNode);
 					}
 				}
 			}
@@ -212,8 +220,8 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 	dtNode* node = lastBestNode;
 	do
 	{
-		dtNode* next = m_nodePool->getNodeAtIdx(node->pidx);
-		node->pidx = m_nodePool->getNodeIdx(prev);
+		dtNode* next = nodePool->getNodeAtIdx(node->pidx);
+		node->pidx = nodePool->getNodeIdx(prev);
 		prev = node;
 		node = next;
 	}
@@ -225,7 +233,7 @@ int dtStatNavMesh::findPath(dtStatPolyRef startRef, dtStatPolyRef endRef,
 	do
 	{
 		path[n++] = node->id;
-		node = m_nodePool->getNodeAtIdx(node->pidx);
+		node = nodePool->getNodeAtIdx(node->pidx);
 	}
 	while (node && n < maxPathSize);
 
@@ -90,7 +90,7 @@ dtTiledNavMesh::~dtTiledNavMesh()
 {
 	for (int i = 0; i < DT_MAX_TILES; ++i)
 	{
-		if (m_tiles[i].data && m_tiles[i].dataSize < 0)
+		if (m_tiles[i].data && m_tiles[i].ownsData)
 		{
 			delete [] m_tiles[i].data;
 			m_tiles[i].data = 0;
@@ -669,6 +669,14 @@ int dtTiledNavMesh::queryPolygons(const float* center, const float* extents,
 int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 							 const float* startPos, const float* endPos,
 							 dtTilePolyRef* path, const int maxPathSize)
+{
+	return findPath(startRef, endRef, startPos, endPos, path, maxPathSize, m_nodePool, m_openList);
+}
+
+int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
+							 const float* startPos, const float* endPos,
+							 dtTilePolyRef* path, const int maxPathSize,
+							 dtNodePool* nodePool, dtNodeQueue* openList)
 {
 	if (!startRef || !endRef)
 		return 0;
@@ -685,27 +693,27 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 		return 1;
 	}
 	
-	if (!m_nodePool || !m_openList)
+	if (!nodePool || !openList)
 		return 0;
 		
-	m_nodePool->clear();
-	m_openList->clear();
+	nodePool->clear();
+	openList->clear();
 	
 	static const float H_SCALE = 1.1f;	// Heuristic scale.
 	
-	dtNode* startNode = m_nodePool->getNode(startRef);
+	dtNode* startNode = nodePool->getNode(startRef);
 	startNode->pidx = 0;
 	startNode->cost = 0;
 	startNode->total = vdist(startPos, endPos) * H_SCALE;
 	startNode->id = startRef;
 	startNode->flags = DT_NODE_OPEN;
-	m_openList->push(startNode);
+	openList->push(startNode);
 	
 	dtNode* lastBestNode = startNode;
 	float lastBestNodeCost = startNode->total;
-	while (!m_openList->empty())
+	while (!openList->empty())
 	{
-		dtNode* bestNode = m_openList->pop();
+		dtNode* bestNode = openList->pop();
 		
 		if (bestNode->id == endRef)
 		{
@@ -726,12 +734,12 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 			if (neighbour)
 			{
 				// Skip parent node.
-				if (bestNode->pidx && m_nodePool->getNodeAtIdx(bestNode->pidx)->id == neighbour)
+				if (bestNode->pidx && nodePool->getNodeAtIdx(bestNode->pidx)->id == neighbour)
 					continue;
 
 				dtNode* parent = bestNode;
 				dtNode newNode;
-				newNode.pidx = m_nodePool->getNodeIdx(parent);
+				newNode.pidx = nodePool->getNodeIdx(parent);
 				newNode.id = neighbour;
 
 				// Calculate cost.
@@ -739,7 +747,7 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 				if (!parent->pidx)
 					vcopy(p0, startPos);
 				else
-					getEdgeMidPoint(m_nodePool->getNodeAtIdx(parent->pidx)->id, parent->id, p0);
+					getEdgeMidPoint(nodePool->getNodeAtIdx(parent->pidx)->id, parent->id, p0);
 				getEdgeMidPoint(parent->id, newNode.id, p1);
 				newNode.cost = parent->cost + vdist(p0,p1);
 				// Special case for last node.
@@ -750,14 +758,14 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 				const float h = vdist(p1,endPos)*H_SCALE;
 				newNode.total = newNode.cost + h;
 				
-				dtNode* actualNode = m_nodePool->getNode(newNode.id);
+				dtNode* actualNode = nodePool->getNode(newNode.id);
 				if (!actualNode)
 					continue;
 				
 				if (!((actualNode->flags & DT_NODE_OPEN) && newNode.total > actualNode->total) &&
 					!((actualNode->flags & DT_NODE_CLOSED) && newNode.total > actualNode->total))
 				{
-					actualNode->flags &= DT_NODE_CLOSED;
+					actualNode->flags &= ~DT_NODE_CLOSED;
 					actualNode->pidx = newNode.pidx;
 					actualNode->cost = newNode.cost;
 					actualNode->total = newNode.total;
@@ -770,12 +778,12 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 					
 					if (actualNode->flags & DT_NODE_OPEN)
 					{
-						m_openList->modify(actualNode);
+						openList->modify(actualNode);
 					}
 					else
 					{
 						actualNode->flags |= DT_NODE_OPEN;
-						m_openList->push(actualNode);
+						openList->push(actualNode);
 					}
 				}
 			}
@@ -788,8 +796,8 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 	dtNode* node = lastBestNode;
 	do
 	{
-		dtNode* next = m_nodePool->getNodeAtIdx(node->pidx);
-		node->pidx = m_nodePool->getNodeIdx(prev);
+		dtNode* next = nodePool->getNodeAtIdx(node->pidx);
+		node->pidx = nodePool->getNodeIdx(prev);
 		prev = node;
 		node = next;
 	}
@@ -801,7 +809,7 @@ int dtTiledNavMesh::findPath(dtTilePolyRef startRef, dtTilePolyRef endRef,
 	do
 	{
 		path[n++] = node->id;
-		node = m_nodePool->getNodeAtIdx(node->pidx);
+		node = nodePool->getNodeAtIdx(node->pidx);
 	}
 	while (node && n < maxPathSize);
 	
@@ -3768,6 +3768,10 @@ void DRW_game_render_loop(bContext *C,
       }
 
       Object *orig_ob = DEG_get_original_object(ob);
+      /* Skip objects culled by the game engine, instances are never culled. */
+      if ((orig_ob->gameflag & OB_CULLED) && !data_.dupli_object_current) {
+        continue;
+      }
 
       if (orig_ob->gameflag & OB_OVERLAY_COLLECTION) {
         DST.dupli_parent = data_.dupli_parent;
@@ -3795,6 +3799,9 @@ void DRW_game_render_loop(bContext *C,
       if (orig_ob->gameflag & OB_OVERLAY_COLLECTION) {
         continue;
       }
+      if ((orig_ob->gameflag & OB_CULLED) && !data_.dupli_object_current) {
+        continue;
+      }
       DST.dupli_parent = data_.dupli_parent;
       DST.dupli_source = data_.dupli_object_current;
       drw_duplidata_load(ob);
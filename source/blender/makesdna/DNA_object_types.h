@@ -846,6 +846,9 @@ enum {
   OB_OVERLAY_COLLECTION = 1 << 24,
 
   OB_LOD_UPDATE_PHYSICS = 1 << 25,
+
+  /* Runtime, set by the game engine culling for the camera being rendered. */
+  OB_CULLED = 1 << 26,
 };
 
 /* ob->gameflag2 */
@@ -190,6 +190,7 @@
     .detailsampledist = 6.0f, \
     .detailsamplemaxerror = 1.0f, \
     .partitioning = RC_PARTITION_WATERSHED, \
+    .tilesize = 0.0f, \
   }
 
 #define _DNA_DEFAULT_GameData \
@@ -882,7 +882,10 @@ typedef struct RecastData {
   float detailsamplemaxerror;
   char partitioning;
   char _pad1;
-  short _pad2[5];
+  short _pad2;
+  /* Size of the game engine navigation mesh tiles, 0 for a single navigation mesh. */
+  float tilesize;
+  float _pad3;
 } RecastData;
 
 /* RecastData.partitioning */
@@ -1001,6 +1004,8 @@ enum {
 #define GAME_PYTHON_CONSOLE (1 << 22)
 #define GAME_USE_INTERACTIVE_DYNAPAINT (1 << 23)
 #define GAME_USE_INTERACTIVE_RIGIDBODY (1 << 24)
+#define GAME_USE_THREADED_PHYSICS (1 << 25)
+#define GAME_USE_OCCLUSION_CULLING (1 << 26)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
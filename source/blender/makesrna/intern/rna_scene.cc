@@ -5932,6 +5932,16 @@ static void rna_def_scene_game_recast_data(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Max Sample Error", "Detail mesh simplification max sample error");
   RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "tile_size", PROP_FLOAT, PROP_DISTANCE);
+  RNA_def_property_float_sdna(prop, NULL, "tilesize");
+  RNA_def_property_range(prop, 0.0, FLT_MAX);
+  RNA_def_property_ui_range(prop, 0.0, 500.0, 10, 2);
+  RNA_def_property_ui_text(prop,
+                           "Tile Size",
+                           "Size of the navigation mesh tiles in the game engine, tiles can be "
+                           "rebuilt separately at runtime (0 to use a single navigation mesh)");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
 }
 
 static void rna_def_bake_data(BlenderRNA *brna)
@@ -6344,6 +6354,20 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Physics Solver", "Physics constraint solver");
   RNA_def_property_update(prop, NC_SCENE, NULL);
 
+  prop = RNA_def_property(srna, "use_threaded_physics", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_THREADED_PHYSICS);
+  RNA_def_property_ui_text(prop,
+                           "Threaded Physics",
+                           "Dispatch the collision pairs and solve the constraints on multiple "
+                           "threads, scenes with soft bodies fall back to serial collision");
+
+  prop = RNA_def_property(srna, "use_occlusion_culling", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_OCCLUSION_CULLING);
+  RNA_def_property_ui_text(prop,
+                           "Occlusion Culling",
+                           "Hide the objects outside of the camera view or behind occluders, "
+                           "hidden objects don't cast shadows");
+
   prop = RNA_def_property(srna, "occlusion_culling_resolution", PROP_INT, PROP_PIXEL);
   RNA_def_property_int_sdna(prop, NULL, "occlusionRes");
   RNA_def_property_range(prop, 128.0, 1024.0);
@@ -699,6 +699,9 @@ bool BL_Converter::FreeBlendFile(Main *maggie)
           }
         }
       }
+
+      // Replica objects pooled for tagged templates reference freed data.
+      scene->FreeReplicaObjectPool(true);
     }
   }
 
@@ -1162,7 +1162,8 @@ static void bl_ConvertBlenderObject_Single(BL_SceneConverter *converter,
                           nullptr,
                           nullptr,
                           KX_Scene::KX_ScenegraphUpdateFunc,
-                          KX_Scene::KX_ScenegraphRescheduleFunc);
+                          KX_Scene::KX_ScenegraphRescheduleFunc,
+                          nullptr);
     SG_Node *parentinversenode = new SG_Node(nullptr, kxscene, callback);
 
     // Define a normal parent relationship for this node.
@@ -1310,10 +1311,9 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
 
     /* set activity culling parameters */
     kxscene->SetActivityCulling((blenderscene->gm.mode & WO_ACTIVITY_CULLING) != 0);
-    kxscene->SetDbvtCulling(false);
-
-    // no occlusion culling by default
-    kxscene->SetDbvtOcclusionRes(0);
+    const bool useCulling = (blenderscene->gm.flag & GAME_USE_OCCLUSION_CULLING) != 0;
+    kxscene->SetDbvtCulling(useCulling);
+    kxscene->SetDbvtOcclusionRes(useCulling ? blenderscene->gm.occlusionRes : 0);
 
     if (blenderscene->gm.lodflag & SCE_LOD_USE_HYST) {
       kxscene->SetLodHysteresis(true);
@@ -0,0 +1,126 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file EXP_Bytecode.h
+ *  \ingroup expressions
+ */
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "EXP_IntValue.h"
+
+class EXP_Expression;
+
+/**
+ * Flat register based program compiled from an expression tree.
+ * Every node of the tree writes its result in its own register, the constants are stored in
+ * registers never written and the instructions are ordered so that the operands are computed
+ * before their use.
+ * The identifiers are not resolved by the program, they are listed as inputs whose registers
+ * are written by the owner of the program before each execution.
+ * The execution doesn't allocate any memory: the operations which would need to (string
+ * concatenation) or which produce an error stop the execution, the caller then falls back to
+ * EXP_Expression::Calculate to get the same result and error message.
+ */
+class EXP_Bytecode {
+ public:
+  struct Register {
+    /// Only VALUE_EMPTY_TYPE, VALUE_BOOL_TYPE, VALUE_INT_TYPE, VALUE_FLOAT_TYPE and
+    /// VALUE_STRING_TYPE are used.
+    VALUE_DATA_TYPE m_type;
+    union {
+      bool m_bool;
+      cInt m_int;
+      float m_float;
+      const std::string *m_string;
+    };
+  };
+
+  enum Opcode {
+    /// Copy the register lhs to dest.
+    OP_MOVE,
+    /// Apply the operator to lhs and write in dest.
+    OP_UNARY,
+    /// Apply the operator to lhs and rhs and write in dest.
+    OP_BINARY,
+    /// Jump to the instruction target if lhs is false, stop if lhs is not a boolean.
+    OP_BRANCH,
+    /// Jump to the instruction target.
+    OP_JUMP
+  };
+
+ private:
+  struct Instruction {
+    Opcode m_opcode;
+    VALUE_OPERATOR m_operator;
+    unsigned int m_dest;
+    unsigned int m_lhs;
+    union {
+      unsigned int m_rhs;
+      unsigned int m_target;
+    };
+  };
+
+  struct Input {
+    std::string m_name;
+    unsigned int m_register;
+  };
+
+  std::vector<Instruction> m_instructions;
+  std::vector<Register> m_registers;
+  std::vector<Input> m_inputs;
+  /// Storage of the constant strings, a deque keeps the addresses stable.
+  std::deque<std::string> m_strings;
+  unsigned int m_result;
+
+  bool ExecuteUnary(VALUE_OPERATOR op, const Register &lhs, Register &dest) const;
+  bool ExecuteBinary(VALUE_OPERATOR op,
+                     const Register &lhs,
+                     const Register &rhs,
+                     Register &dest) const;
+
+ public:
+  EXP_Bytecode();
+  ~EXP_Bytecode() = default;
+
+  /// Compile an expression tree, return false if one of its nodes is not supported.
+  bool Compile(EXP_Expression *expr);
+
+  /**
+   * Execute the program, return false if an operation is not supported with the current
+   * values of the inputs or produces an error.
+   */
+  bool Execute();
+
+  const Register &GetResult() const;
+
+  unsigned int GetNumInputs() const;
+  const std::string &GetInputName(unsigned int index) const;
+  Register &GetInput(unsigned int index);
+
+  /// Add a register, used by the expression nodes to compile.
+  unsigned int AddRegister();
+  /// Add a register holding a constant value, return -1 if the value type is not supported.
+  int AddConstant(EXP_Value *value);
+  /// Return the register of the input named name, added if not existing.
+  unsigned int AddInput(const std::string &name);
+  /// Add an instruction and return its index.
+  unsigned int AddInstruction(Opcode opcode,
+                              VALUE_OPERATOR op,
+                              unsigned int dest,
+                              unsigned int lhs,
+                              unsigned int rhs);
+  /// Set the jump target of a branch instruction to the next added instruction.
+  void SetJumpTarget(unsigned int index);
+
+  /**
+   * Convert a value to a register, return false if the value type is not supported.
+   * The string values are referenced, the register must not outlive the value.
+   */
+  static bool ConvertValue(EXP_Value *value, Register &reg);
+  /// Same as EXP_Value::GetNumber.
+  static double GetNumber(const Register &reg);
+};
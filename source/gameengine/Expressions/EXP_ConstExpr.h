@@ -30,6 +30,7 @@ class EXP_ConstExpr : public EXP_Expression {
   virtual unsigned char GetExpressionID();
   virtual double GetNumber();
   virtual EXP_Value *Calculate();
+  virtual int Compile(EXP_Bytecode &code);
 
  private:
   EXP_Value *m_value;
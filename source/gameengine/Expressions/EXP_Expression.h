@@ -20,6 +20,8 @@
 
 #include "EXP_Value.h"
 
+class EXP_Bytecode;
+
 class EXP_Expression : public CM_RefCount<EXP_Expression> {
  public:
   enum {
@@ -39,4 +41,9 @@ class EXP_Expression : public CM_RefCount<EXP_Expression> {
 
   virtual EXP_Value *Calculate() = 0;
   virtual unsigned char GetExpressionID() = 0;
+  /**
+   * Emit the instructions computing the expression.
+   * \return The register containing the result or -1 if the expression can't be compiled.
+   */
+  virtual int Compile(EXP_Bytecode &code);
 };
@@ -44,4 +44,5 @@ class EXP_IdentifierExpr : public EXP_Expression {
 
   virtual EXP_Value *Calculate();
   virtual unsigned char GetExpressionID();
+  virtual int Compile(EXP_Bytecode &code);
 };
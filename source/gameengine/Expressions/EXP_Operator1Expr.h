@@ -28,6 +28,7 @@ class EXP_Operator1Expr : public EXP_Expression {
 
   virtual unsigned char GetExpressionID();
   virtual EXP_Value *Calculate();
+  virtual int Compile(EXP_Bytecode &code);
 
  private:
   VALUE_OPERATOR m_op;
@@ -29,6 +29,7 @@ class EXP_Operator2Expr : public EXP_Expression {
 
   virtual unsigned char GetExpressionID();
   virtual EXP_Value *Calculate();
+  virtual int Compile(EXP_Bytecode &code);
 
  protected:
   EXP_Expression *m_rhs;
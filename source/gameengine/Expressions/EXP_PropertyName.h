@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file EXP_PropertyName.h
+ *  \ingroup expressions
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+/**
+ * Interned name of a game property.
+ * All the names with the same text share the same storage, two names are compared
+ * with a pointer comparison and their hash is computed only once at construction.
+ * Logic bricks construct their property names once and use them as handles to
+ * access the properties without any string comparison, see EXP_Value::GetProperty.
+ * The storage of a text is freed with the last name using it.
+ */
+class EXP_PropertyName {
+ public:
+  /// Interned text shared by all the names with the same text.
+  struct Entry {
+    std::string m_name;
+    /// Number of names using the entry.
+    std::atomic<unsigned int> m_users;
+  };
+
+ private:
+  Entry *m_entry;
+  size_t m_hash;
+
+  void Release();
+
+ public:
+  /// Construct the empty name.
+  EXP_PropertyName();
+  explicit EXP_PropertyName(const std::string &name);
+  EXP_PropertyName(const EXP_PropertyName &other);
+  EXP_PropertyName(EXP_PropertyName &&other);
+  ~EXP_PropertyName();
+
+  EXP_PropertyName &operator=(const EXP_PropertyName &other);
+  EXP_PropertyName &operator=(EXP_PropertyName &&other);
+
+  const std::string &GetName() const
+  {
+    return m_entry->m_name;
+  }
+
+  size_t GetHash() const
+  {
+    return m_hash;
+  }
+
+  bool operator==(const EXP_PropertyName &other) const
+  {
+    return m_entry == other.m_entry;
+  }
+
+  bool operator!=(const EXP_PropertyName &other) const
+  {
+    return m_entry != other.m_entry;
+  }
+
+  /// Return the hash of a property name text, equal to the hash of its interned name.
+  static size_t Hash(const std::string &name);
+};
@@ -34,6 +34,8 @@ class EXP_StringValue : public EXP_PropValue {
   virtual double GetNumber();
   virtual int GetValueType();
 
+  const std::string &GetString() const;
+
   virtual EXP_Value *Calc(VALUE_OPERATOR op, EXP_Value *val);
   virtual EXP_Value *CalcFinal(VALUE_DATA_TYPE dtype, VALUE_OPERATOR op, EXP_Value *val);
   virtual void SetValue(EXP_Value *newval);
@@ -22,11 +22,12 @@
 #  pragma warning(disable : 4786)
 #endif
 
-#include <map>     // Array functionality for the property list.
+#include <map>
 #include <string>  // std::string class.
 #include <vector>
 
 #include "CM_RefCount.h"
+#include "EXP_PropertyName.h"
 
 #ifndef GEN_NO_TRACE
 #  undef trace
@@ -72,6 +73,18 @@ enum VALUE_DATA_TYPE {
 #  include "object.h"
 #endif
 
+class EXP_Value;
+
+/// Interface of the objects notified of the modifications of a value, see EXP_Value::AddObserver.
+class EXP_ValueObserver {
+ public:
+  virtual ~EXP_ValueObserver() = default;
+
+  /// Called when the value is modified or when one of its properties is added, replaced or
+  /// removed.
+  virtual void ValueModified(EXP_Value *value) = 0;
+};
+
 /**
  * Baseclass EXP_Value
  *
@@ -125,6 +138,9 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   /// needed.
   virtual void SetProperty(const std::string &name, EXP_Value *ioProperty);
   virtual EXP_Value *GetProperty(const std::string &inName);
+  /// Fast path of SetProperty and GetProperty for a name interned before, e.g by a logic brick.
+  void SetProperty(const EXP_PropertyName &name, EXP_Value *ioProperty);
+  EXP_Value *GetProperty(const EXP_PropertyName &name);
   /// Get text description of property with name <inName>, returns an empty string if there is no
   /// property named <inName>.
   const std::string GetPropertyText(const std::string &inName);
@@ -163,12 +179,44 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
 
   virtual bool IsError() const;
 
+  /// Return the number of modifications of the value, see SetValue.
+  unsigned int GetRevision() const
+  {
+    return m_revision;
+  }
+
+  /// Return the number of additions, replacements and removals of properties.
+  unsigned int GetPropertiesRevision() const
+  {
+    return m_propertiesRevision;
+  }
+
+  void AddObserver(EXP_ValueObserver *observer);
+  void RemoveObserver(EXP_ValueObserver *observer);
+
  protected:
   virtual void DestructFromPython();
 
+  /// Increment the revision and notify the observers, called by the value types each time their
+  /// value is modified.
+  void NotifyModified();
+
  private:
-  /// Properties for user/game etc.
-  std::map<std::string, EXP_Value *> m_properties;
+  unsigned int m_revision;
+  unsigned int m_propertiesRevision;
+  std::vector<EXP_ValueObserver *> m_observers;
+
+  /// Increment the properties revision and notify the observers.
+  void NotifyPropertiesModified();
+
+  typedef std::pair<EXP_PropertyName, EXP_Value *> PropertyEntry;
+
+  /** Properties for user/game etc, sorted by name. Objects usually own few properties,
+   * a linear search over the names hash is faster than a search tree of strings. */
+  std::vector<PropertyEntry> m_properties;
+
+  /// Return the property entry with name <inName>, nullptr if not found.
+  PropertyEntry *FindPropertyEntry(const std::string &inName);
 };
 
 /** EXP_PropValue is a EXP_Value derived class, that implements the identification (String name)
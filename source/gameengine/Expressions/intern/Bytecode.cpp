@@ -0,0 +1,434 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/Expressions/Bytecode.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_Bytecode.h"
+
+#include <cmath>
+
+#include "EXP_BoolValue.h"
+#include "EXP_Expression.h"
+#include "EXP_FloatValue.h"
+#include "EXP_StringValue.h"
+
+EXP_Bytecode::EXP_Bytecode() : m_result(0)
+{
+}
+
+bool EXP_Bytecode::Compile(EXP_Expression *expr)
+{
+  m_instructions.clear();
+  m_registers.clear();
+  m_inputs.clear();
+  m_strings.clear();
+
+  const int result = expr->Compile(*this);
+  if (result == -1) {
+    return false;
+  }
+
+  m_result = result;
+  return true;
+}
+
+bool EXP_Bytecode::Execute()
+{
+  Register *regs = m_registers.data();
+  const Instruction *instructions = m_instructions.data();
+
+  for (unsigned int pc = 0, size = m_instructions.size(); pc < size;) {
+    const Instruction &inst = instructions[pc++];
+    switch (inst.m_opcode) {
+      case OP_MOVE: {
+        regs[inst.m_dest] = regs[inst.m_lhs];
+        break;
+      }
+      case OP_UNARY: {
+        if (!ExecuteUnary(inst.m_operator, regs[inst.m_lhs], regs[inst.m_dest])) {
+          return false;
+        }
+        break;
+      }
+      case OP_BINARY: {
+        if (!ExecuteBinary(
+                inst.m_operator, regs[inst.m_lhs], regs[inst.m_rhs], regs[inst.m_dest])) {
+          return false;
+        }
+        break;
+      }
+      case OP_BRANCH: {
+        const Register &guard = regs[inst.m_lhs];
+        // EXP_IfExpr only accepts booleans.
+        if (guard.m_type != VALUE_BOOL_TYPE) {
+          return false;
+        }
+        if (!guard.m_bool) {
+          pc = inst.m_target;
+        }
+        break;
+      }
+      case OP_JUMP: {
+        pc = inst.m_target;
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
+/* The two following functions reproduce the operations of EXP_Value::Calc and CalcFinal of the
+ * supported types, every other combination returns false to produce the error value with the
+ * expression tree. */
+
+bool EXP_Bytecode::ExecuteUnary(VALUE_OPERATOR op, const Register &lhs, Register &dest) const
+{
+  switch (lhs.m_type) {
+    case VALUE_EMPTY_TYPE: {
+      dest.m_type = VALUE_EMPTY_TYPE;
+      return true;
+    }
+    case VALUE_BOOL_TYPE: {
+      if (op != VALUE_NOT_OPERATOR) {
+        return false;
+      }
+      dest.m_type = VALUE_BOOL_TYPE;
+      dest.m_bool = !lhs.m_bool;
+      return true;
+    }
+    case VALUE_INT_TYPE: {
+      switch (op) {
+        case VALUE_NEG_OPERATOR: {
+          dest.m_type = VALUE_INT_TYPE;
+          dest.m_int = -lhs.m_int;
+          return true;
+        }
+        case VALUE_POS_OPERATOR: {
+          dest.m_type = VALUE_INT_TYPE;
+          dest.m_int = lhs.m_int;
+          return true;
+        }
+        case VALUE_NOT_OPERATOR: {
+          dest.m_type = VALUE_BOOL_TYPE;
+          dest.m_bool = (lhs.m_int == 0);
+          return true;
+        }
+        default: {
+          return false;
+        }
+      }
+    }
+    case VALUE_FLOAT_TYPE: {
+      switch (op) {
+        case VALUE_NEG_OPERATOR: {
+          dest.m_type = VALUE_FLOAT_TYPE;
+          dest.m_float = -lhs.m_float;
+          return true;
+        }
+        case VALUE_POS_OPERATOR: {
+          dest.m_type = VALUE_FLOAT_TYPE;
+          dest.m_float = lhs.m_float;
+          return true;
+        }
+        case VALUE_NOT_OPERATOR: {
+          dest.m_type = VALUE_BOOL_TYPE;
+          dest.m_bool = (lhs.m_float == 0.0f);
+          return true;
+        }
+        default: {
+          return false;
+        }
+      }
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+template<class Type>
+static bool compare_values(VALUE_OPERATOR op, Type lhs, Type rhs, bool &result)
+{
+  switch (op) {
+    case VALUE_EQL_OPERATOR: {
+      result = (lhs == rhs);
+      return true;
+    }
+    case VALUE_NEQ_OPERATOR: {
+      result = (lhs != rhs);
+      return true;
+    }
+    case VALUE_GRE_OPERATOR: {
+      result = (lhs > rhs);
+      return true;
+    }
+    case VALUE_LES_OPERATOR: {
+      result = (lhs < rhs);
+      return true;
+    }
+    case VALUE_GEQ_OPERATOR: {
+      result = (lhs >= rhs);
+      return true;
+    }
+    case VALUE_LEQ_OPERATOR: {
+      result = (lhs <= rhs);
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+bool EXP_Bytecode::ExecuteBinary(VALUE_OPERATOR op,
+                                 const Register &lhs,
+                                 const Register &rhs,
+                                 Register &dest) const
+{
+  const VALUE_DATA_TYPE ltype = lhs.m_type;
+  const VALUE_DATA_TYPE rtype = rhs.m_type;
+
+  if (ltype == VALUE_BOOL_TYPE && rtype == VALUE_BOOL_TYPE) {
+    dest.m_type = VALUE_BOOL_TYPE;
+    switch (op) {
+      case VALUE_AND_OPERATOR: {
+        dest.m_bool = lhs.m_bool && rhs.m_bool;
+        return true;
+      }
+      case VALUE_OR_OPERATOR: {
+        dest.m_bool = lhs.m_bool || rhs.m_bool;
+        return true;
+      }
+      case VALUE_EQL_OPERATOR: {
+        dest.m_bool = (lhs.m_bool == rhs.m_bool);
+        return true;
+      }
+      case VALUE_NEQ_OPERATOR: {
+        dest.m_bool = (lhs.m_bool != rhs.m_bool);
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  if (ltype == VALUE_STRING_TYPE && rtype == VALUE_STRING_TYPE) {
+    dest.m_type = VALUE_BOOL_TYPE;
+    return compare_values<const std::string &>(op, *lhs.m_string, *rhs.m_string, dest.m_bool);
+  }
+
+  if (ltype == VALUE_INT_TYPE && rtype == VALUE_INT_TYPE) {
+    const cInt l = lhs.m_int;
+    const cInt r = rhs.m_int;
+    dest.m_type = VALUE_INT_TYPE;
+    switch (op) {
+      case VALUE_MOD_OPERATOR: {
+        if (r == 0) {
+          return false;
+        }
+        dest.m_int = l % r;
+        return true;
+      }
+      case VALUE_ADD_OPERATOR: {
+        dest.m_int = l + r;
+        return true;
+      }
+      case VALUE_SUB_OPERATOR: {
+        dest.m_int = l - r;
+        return true;
+      }
+      case VALUE_MUL_OPERATOR: {
+        dest.m_int = l * r;
+        return true;
+      }
+      case VALUE_DIV_OPERATOR: {
+        if (r == 0) {
+          return false;
+        }
+        dest.m_int = l / r;
+        return true;
+      }
+      default: {
+        dest.m_type = VALUE_BOOL_TYPE;
+        return compare_values<cInt>(op, l, r, dest.m_bool);
+      }
+    }
+  }
+
+  const bool lnumber = (ltype == VALUE_INT_TYPE || ltype == VALUE_FLOAT_TYPE);
+  const bool rnumber = (rtype == VALUE_INT_TYPE || rtype == VALUE_FLOAT_TYPE);
+  if (!lnumber || !rnumber) {
+    return false;
+  }
+
+  // At least one float, the integer is converted to float as in EXP_IntValue::CalcFinal.
+  const float l = (ltype == VALUE_INT_TYPE) ? (float)lhs.m_int : lhs.m_float;
+  const float r = (rtype == VALUE_INT_TYPE) ? (float)rhs.m_int : rhs.m_float;
+  dest.m_type = VALUE_FLOAT_TYPE;
+  switch (op) {
+    case VALUE_MOD_OPERATOR: {
+      // The integer is promoted to double by fmod.
+      const double ld = (ltype == VALUE_INT_TYPE) ? (double)lhs.m_int : (double)l;
+      const double rd = (rtype == VALUE_INT_TYPE) ? (double)rhs.m_int : (double)r;
+      dest.m_float = (float)fmod(ld, rd);
+      return true;
+    }
+    case VALUE_ADD_OPERATOR: {
+      dest.m_float = l + r;
+      return true;
+    }
+    case VALUE_SUB_OPERATOR: {
+      dest.m_float = l - r;
+      return true;
+    }
+    case VALUE_MUL_OPERATOR: {
+      dest.m_float = l * r;
+      return true;
+    }
+    case VALUE_DIV_OPERATOR: {
+      if (r == 0.0f) {
+        return false;
+      }
+      dest.m_float = l / r;
+      return true;
+    }
+    default: {
+      dest.m_type = VALUE_BOOL_TYPE;
+      return compare_values<float>(op, l, r, dest.m_bool);
+    }
+  }
+}
+
+const EXP_Bytecode::Register &EXP_Bytecode::GetResult() const
+{
+  return m_registers[m_result];
+}
+
+unsigned int EXP_Bytecode::GetNumInputs() const
+{
+  return m_inputs.size();
+}
+
+const std::string &EXP_Bytecode::GetInputName(unsigned int index) const
+{
+  return m_inputs[index].m_name;
+}
+
+EXP_Bytecode::Register &EXP_Bytecode::GetInput(unsigned int index)
+{
+  return m_registers[m_inputs[index].m_register];
+}
+
+unsigned int EXP_Bytecode::AddRegister()
+{
+  Register reg;
+  reg.m_type = VALUE_EMPTY_TYPE;
+  reg.m_int = 0;
+  m_registers.push_back(reg);
+  return m_registers.size() - 1;
+}
+
+int EXP_Bytecode::AddConstant(EXP_Value *value)
+{
+  Register reg;
+  if (!ConvertValue(value, reg)) {
+    return -1;
+  }
+
+  // Copy the string to not depend on the lifetime of the value.
+  if (reg.m_type == VALUE_STRING_TYPE) {
+    m_strings.push_back(*reg.m_string);
+    reg.m_string = &m_strings.back();
+  }
+
+  m_registers.push_back(reg);
+  return m_registers.size() - 1;
+}
+
+unsigned int EXP_Bytecode::AddInput(const std::string &name)
+{
+  for (const Input &input : m_inputs) {
+    if (input.m_name == name) {
+      return input.m_register;
+    }
+  }
+
+  const unsigned int reg = AddRegister();
+  m_inputs.push_back({name, reg});
+  return reg;
+}
+
+unsigned int EXP_Bytecode::AddInstruction(
+    Opcode opcode, VALUE_OPERATOR op, unsigned int dest, unsigned int lhs, unsigned int rhs)
+{
+  Instruction inst;
+  inst.m_opcode = opcode;
+  inst.m_operator = op;
+  inst.m_dest = dest;
+  inst.m_lhs = lhs;
+  inst.m_rhs = rhs;
+  m_instructions.push_back(inst);
+  return m_instructions.size() - 1;
+}
+
+void EXP_Bytecode::SetJumpTarget(unsigned int index)
+{
+  m_instructions[index].m_target = m_instructions.size();
+}
+
+bool EXP_Bytecode::ConvertValue(EXP_Value *value, Register &reg)
+{
+  switch (value->GetValueType()) {
+    case VALUE_EMPTY_TYPE: {
+      reg.m_type = VALUE_EMPTY_TYPE;
+      return true;
+    }
+    case VALUE_BOOL_TYPE: {
+      reg.m_type = VALUE_BOOL_TYPE;
+      reg.m_bool = static_cast<EXP_BoolValue *>(value)->GetBool();
+      return true;
+    }
+    case VALUE_INT_TYPE: {
+      reg.m_type = VALUE_INT_TYPE;
+      reg.m_int = static_cast<EXP_IntValue *>(value)->GetInt();
+      return true;
+    }
+    case VALUE_FLOAT_TYPE: {
+      reg.m_type = VALUE_FLOAT_TYPE;
+      reg.m_float = static_cast<EXP_FloatValue *>(value)->GetFloat();
+      return true;
+    }
+    case VALUE_STRING_TYPE: {
+      reg.m_type = VALUE_STRING_TYPE;
+      reg.m_string = &static_cast<EXP_StringValue *>(value)->GetString();
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+double EXP_Bytecode::GetNumber(const Register &reg)
+{
+  switch (reg.m_type) {
+    case VALUE_BOOL_TYPE: {
+      return (double)reg.m_bool;
+    }
+    case VALUE_INT_TYPE: {
+      return (double)reg.m_int;
+    }
+    case VALUE_FLOAT_TYPE: {
+      return reg.m_float;
+    }
+    case VALUE_STRING_TYPE: {
+      return -1.0;
+    }
+    default: {
+      return 0.0;
+    }
+  }
+}
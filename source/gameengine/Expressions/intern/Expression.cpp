@@ -23,3 +23,8 @@ EXP_Expression::EXP_Expression()
 EXP_Expression::~EXP_Expression()
 {
 }
+
+int EXP_Expression::Compile(EXP_Bytecode &code)
+{
+  return -1;
+}
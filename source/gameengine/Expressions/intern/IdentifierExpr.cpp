@@ -31,6 +31,8 @@
 
 #include "EXP_IdentifierExpr.h"
 
+#include "EXP_Bytecode.h"
+
 EXP_IdentifierExpr::EXP_IdentifierExpr(const std::string &identifier, EXP_Value *id_context)
     : m_identifier(identifier)
 {
@@ -63,3 +65,13 @@ unsigned char EXP_IdentifierExpr::GetExpressionID()
 {
   return CIDENTIFIEREXPRESSIONID;
 }
+
+int EXP_IdentifierExpr::Compile(EXP_Bytecode &code)
+{
+  // The identifiers of sub-contexts are resolved by name at each evaluation.
+  if (!m_idContext || m_identifier.find('.') != std::string::npos) {
+    return -1;
+  }
+
+  return code.AddInput(m_identifier);
+}
@@ -18,6 +18,7 @@
 #include "EXP_IfExpr.h"
 
 #include "EXP_BoolValue.h"
+#include "EXP_Bytecode.h"
 #include "EXP_ErrorValue.h"
 
 EXP_IfExpr::EXP_IfExpr()
@@ -65,3 +66,33 @@ unsigned char EXP_IfExpr::GetExpressionID()
 {
   return CIFEXPRESSIONID;
 }
+
+int EXP_IfExpr::Compile(EXP_Bytecode &code)
+{
+  const int guard = m_guard->Compile(code);
+  if (guard == -1) {
+    return -1;
+  }
+
+  const unsigned int dest = code.AddRegister();
+  const unsigned int branch = code.AddInstruction(
+      EXP_Bytecode::OP_BRANCH, VALUE_NO_OPERATOR, 0, guard, 0);
+
+  const int e1 = m_e1->Compile(code);
+  if (e1 == -1) {
+    return -1;
+  }
+  code.AddInstruction(EXP_Bytecode::OP_MOVE, VALUE_NO_OPERATOR, dest, e1, 0);
+  const unsigned int jump = code.AddInstruction(
+      EXP_Bytecode::OP_JUMP, VALUE_NO_OPERATOR, 0, 0, 0);
+
+  code.SetJumpTarget(branch);
+  const int e2 = m_e2->Compile(code);
+  if (e2 == -1) {
+    return -1;
+  }
+  code.AddInstruction(EXP_Bytecode::OP_MOVE, VALUE_NO_OPERATOR, dest, e2, 0);
+  code.SetJumpTarget(jump);
+
+  return dest;
+}
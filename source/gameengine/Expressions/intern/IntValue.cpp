@@ -284,6 +284,7 @@ EXP_Value *EXP_IntValue::GetReplica()
 void EXP_IntValue::SetValue(EXP_Value *newval)
 {
   m_int = (cInt)newval->GetNumber();
+  NotifyModified();
 }
 
 #ifdef WITH_PYTHON
@@ -17,6 +17,7 @@
 
 #include "EXP_Operator1Expr.h"
 
+#include "EXP_Bytecode.h"
 #include "EXP_EmptyValue.h"
 
 EXP_Operator1Expr::EXP_Operator1Expr() : m_lhs(nullptr)
@@ -50,3 +51,15 @@ EXP_Value *EXP_Operator1Expr::Calculate()
 
   return ret;
 }
+
+int EXP_Operator1Expr::Compile(EXP_Bytecode &code)
+{
+  const int lhs = m_lhs->Compile(code);
+  if (lhs == -1) {
+    return -1;
+  }
+
+  const unsigned int dest = code.AddRegister();
+  code.AddInstruction(EXP_Bytecode::OP_UNARY, m_op, dest, lhs, 0);
+  return dest;
+}
@@ -17,6 +17,8 @@
 
 #include "EXP_Operator2Expr.h"
 
+#include "EXP_Bytecode.h"
+
 EXP_Operator2Expr::EXP_Operator2Expr(VALUE_OPERATOR op, EXP_Expression *lhs, EXP_Expression *rhs)
     : m_rhs(rhs), m_lhs(lhs), m_op(op)
 {
@@ -54,3 +56,19 @@ EXP_Value *EXP_Operator2Expr::Calculate()
 
   return calculate;
 }
+
+int EXP_Operator2Expr::Compile(EXP_Bytecode &code)
+{
+  const int lhs = m_lhs->Compile(code);
+  if (lhs == -1) {
+    return -1;
+  }
+  const int rhs = m_rhs->Compile(code);
+  if (rhs == -1) {
+    return -1;
+  }
+
+  const unsigned int dest = code.AddRegister();
+  code.AddInstruction(EXP_Bytecode::OP_BINARY, m_op, dest, lhs, rhs);
+  return dest;
+}
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/Expressions/intern/PropertyName.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertyName.h"
+
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+#include "CM_Thread.h"
+
+using PropertyNameTable = std::unordered_map<std::string_view, EXP_PropertyName::Entry *>;
+
+/// Table of all the interned names, the keys are the texts of the entries.
+static PropertyNameTable &property_name_table()
+{
+  static PropertyNameTable table;
+  return table;
+}
+
+/// Names can be interned during asynchronous libraries loading.
+static CM_ThreadMutex &property_name_mutex()
+{
+  static CM_ThreadMutex mutex;
+  return mutex;
+}
+
+EXP_PropertyName::EXP_PropertyName() : EXP_PropertyName(std::string())
+{
+}
+
+EXP_PropertyName::EXP_PropertyName(const std::string &name) : m_hash(Hash(name))
+{
+  CM_ThreadMutex &mutex = property_name_mutex();
+  mutex.Lock();
+  PropertyNameTable &table = property_name_table();
+  PropertyNameTable::iterator it = table.find(name);
+  if (it != table.end()) {
+    m_entry = it->second;
+    ++m_entry->m_users;
+  }
+  else {
+    m_entry = new Entry{name, {1}};
+    table.emplace(m_entry->m_name, m_entry);
+  }
+  mutex.Unlock();
+}
+
+EXP_PropertyName::EXP_PropertyName(const EXP_PropertyName &other)
+    : m_entry(other.m_entry), m_hash(other.m_hash)
+{
+  ++m_entry->m_users;
+}
+
+EXP_PropertyName::EXP_PropertyName(EXP_PropertyName &&other)
+    : m_entry(other.m_entry), m_hash(other.m_hash)
+{
+  other.m_entry = nullptr;
+}
+
+EXP_PropertyName::~EXP_PropertyName()
+{
+  Release();
+}
+
+EXP_PropertyName &EXP_PropertyName::operator=(const EXP_PropertyName &other)
+{
+  if (m_entry != other.m_entry) {
+    ++other.m_entry->m_users;
+    Release();
+    m_entry = other.m_entry;
+    m_hash = other.m_hash;
+  }
+  return *this;
+}
+
+EXP_PropertyName &EXP_PropertyName::operator=(EXP_PropertyName &&other)
+{
+  if (this != &other) {
+    Release();
+    m_entry = other.m_entry;
+    m_hash = other.m_hash;
+    other.m_entry = nullptr;
+  }
+  return *this;
+}
+
+void EXP_PropertyName::Release()
+{
+  // Moved from name.
+  if (!m_entry) {
+    return;
+  }
+
+  // Only the last user removes the entry, without locking while other names use it.
+  unsigned int users = m_entry->m_users.load();
+  while (users > 1) {
+    if (m_entry->m_users.compare_exchange_weak(users, users - 1)) {
+      return;
+    }
+  }
+
+  /* The entry can be found again by a new name in the meantime, the users are decremented
+   * with the table locked. */
+  CM_ThreadMutex &mutex = property_name_mutex();
+  mutex.Lock();
+  if (--m_entry->m_users == 0) {
+    property_name_table().erase(m_entry->m_name);
+    delete m_entry;
+  }
+  mutex.Unlock();
+}
+
+size_t EXP_PropertyName::Hash(const std::string &name)
+{
+  return std::hash<std::string>()(name);
+}
@@ -91,6 +91,12 @@ EXP_Value *EXP_StringValue::CalcFinal(VALUE_DATA_TYPE dtype, VALUE_OPERATOR op,
 void EXP_StringValue::SetValue(EXP_Value *newval)
 {
   m_strString = newval->GetText();
+  NotifyModified();
+}
+
+const std::string &EXP_StringValue::GetString() const
+{
+  return m_strString;
 }
 
 double EXP_StringValue::GetNumber()
@@ -20,6 +20,9 @@
 
 #include "EXP_Value.h"
 
+#include <algorithm>
+
+#include "CM_List.h"
 #include "EXP_BoolValue.h"
 #include "EXP_ErrorValue.h"
 #include "EXP_FloatValue.h"
@@ -71,7 +74,7 @@ PyMethodDef EXP_Value::Methods[] = {
 };
 #endif  // WITH_PYTHON
 
-EXP_Value::EXP_Value()
+EXP_Value::EXP_Value() : m_revision(0), m_propertiesRevision(0)
 {
 }
 
@@ -144,6 +147,17 @@ std::string EXP_Value::op2str(VALUE_OPERATOR op)
 //	Property Management
 //---------------------------------------------------------------------------------------------------------------------
 
+EXP_Value::PropertyEntry *EXP_Value::FindPropertyEntry(const std::string &inName)
+{
+  const size_t hash = EXP_PropertyName::Hash(inName);
+  for (PropertyEntry &entry : m_properties) {
+    if (entry.first.GetHash() == hash && entry.first.GetName() == inName) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
 /// Set property <ioProperty>, overwrites and releases a previous property with the same name if
 /// needed.
 void EXP_Value::SetProperty(const std::string &name, EXP_Value *ioProperty)
@@ -154,23 +168,65 @@ void EXP_Value::SetProperty(const std::string &name, EXP_Value *ioProperty)
     return;
   }
 
+  // Try to replace property (if so -> exit as soon as we replaced it), avoid to intern the name.
+  PropertyEntry *entry = FindPropertyEntry(name);
+  if (entry) {
+    entry->second->Release();
+    entry->second = ioProperty->AddRef();
+    NotifyPropertiesModified();
+    return;
+  }
+
+  SetProperty(EXP_PropertyName(name), ioProperty);
+}
+
+void EXP_Value::SetProperty(const EXP_PropertyName &name, EXP_Value *ioProperty)
+{
+  // Check if somebody is setting an empty property.
+  if (ioProperty == nullptr) {
+    trace("Warning:trying to set empty property!");
+    return;
+  }
+
   // Try to replace property (if so -> exit as soon as we replaced it).
-  EXP_Value *oldval = m_properties[name];
-  if (oldval) {
-    oldval->Release();
+  for (PropertyEntry &entry : m_properties) {
+    if (entry.first == name) {
+      entry.second->Release();
+      entry.second = ioProperty->AddRef();
+      NotifyPropertiesModified();
+      return;
+    }
   }
 
-  // Add property at end of array.
-  m_properties[name] = ioProperty->AddRef();
+  // Insert the property keeping the list sorted by name.
+  std::vector<PropertyEntry>::iterator it = std::lower_bound(
+      m_properties.begin(),
+      m_properties.end(),
+      name.GetName(),
+      [](const PropertyEntry &entry, const std::string &str) {
+        return entry.first.GetName() < str;
+      });
+  m_properties.emplace(it, name, ioProperty->AddRef());
+  NotifyPropertiesModified();
 }
 
 /// Get pointer to a property with name <inName>, returns nullptr if there is no property named
 /// <inName>.
 EXP_Value *EXP_Value::GetProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
-  if (it != m_properties.end()) {
-    return it->second;
+  PropertyEntry *entry = FindPropertyEntry(inName);
+  if (entry) {
+    return entry->second;
+  }
+  return nullptr;
+}
+
+EXP_Value *EXP_Value::GetProperty(const EXP_PropertyName &name)
+{
+  for (const PropertyEntry &entry : m_properties) {
+    if (entry.first == name) {
+      return entry.second;
+    }
   }
   return nullptr;
 }
@@ -203,10 +259,11 @@ float EXP_Value::GetPropertyNumber(const std::string &inName, float defnumber)
 /// if property was not found or could not be removed.
 bool EXP_Value::RemoveProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
-  if (it != m_properties.end()) {
-    (*it).second->Release();
-    m_properties.erase(it);
+  PropertyEntry *entry = FindPropertyEntry(inName);
+  if (entry) {
+    entry->second->Release();
+    m_properties.erase(m_properties.begin() + (entry - m_properties.data()));
+    NotifyPropertiesModified();
     return true;
   }
 
@@ -220,8 +277,8 @@ std::vector<std::string> EXP_Value::GetPropertyNames()
   std::vector<std::string> result(size);
 
   unsigned short i = 0;
-  for (const auto &pair : m_properties) {
-    result[i++] = pair.first;
+  for (const PropertyEntry &entry : m_properties) {
+    result[i++] = entry.first.GetName();
   }
   return result;
 }
@@ -230,25 +287,22 @@ std::vector<std::string> EXP_Value::GetPropertyNames()
 void EXP_Value::ClearProperties()
 {
   // Remove all properties.
-  for (const auto &pair : m_properties) {
-    pair.second->Release();
+  for (const PropertyEntry &entry : m_properties) {
+    entry.second->Release();
   }
 
   // Delete property array.
   m_properties.clear();
+  NotifyPropertiesModified();
 }
 
 /// Get property number <inIndex>.
 EXP_Value *EXP_Value::GetProperty(int inIndex)
 {
-  int count = 0;
-
-  for (const auto &pair : m_properties) {
-    if (count++ == inIndex) {
-      return pair.second;
-    }
+  if (inIndex < 0 || inIndex >= (int)m_properties.size()) {
+    return nullptr;
   }
-  return nullptr;
+  return m_properties[inIndex].second;
 }
 
 /// Get the amount of properties assiocated with this value.
@@ -257,6 +311,32 @@ int EXP_Value::GetPropertyCount()
   return m_properties.size();
 }
 
+void EXP_Value::AddObserver(EXP_ValueObserver *observer)
+{
+  CM_ListAddIfNotFound(m_observers, observer);
+}
+
+void EXP_Value::RemoveObserver(EXP_ValueObserver *observer)
+{
+  CM_ListRemoveIfFound(m_observers, observer);
+}
+
+void EXP_Value::NotifyModified()
+{
+  ++m_revision;
+  for (EXP_ValueObserver *observer : m_observers) {
+    observer->ValueModified(this);
+  }
+}
+
+void EXP_Value::NotifyPropertiesModified()
+{
+  ++m_propertiesRevision;
+  for (EXP_ValueObserver *observer : m_observers) {
+    observer->ValueModified(this);
+  }
+}
+
 void EXP_Value::DestructFromPython()
 {
 #ifdef WITH_PYTHON
@@ -270,10 +350,14 @@ void EXP_Value::ProcessReplica()
 {
   EXP_PyObjectPlus::ProcessReplica();
 
+  // The observers of the original value don't observe the replica.
+  m_observers.clear();
+
   // Copy all props.
-  for (auto &pair : m_properties) {
-    pair.second = pair.second->GetReplica();
+  for (PropertyEntry &entry : m_properties) {
+    entry.second = entry.second->GetReplica();
   }
+  NotifyPropertiesModified();
 }
 
 int EXP_Value::GetValueType()
@@ -375,8 +459,8 @@ PyObject *EXP_Value::ConvertKeysToPython(void)
   PyObject *pylist = PyList_New(m_properties.size());
 
   Py_ssize_t i = 0;
-  for (const auto &pair : m_properties) {
-    PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString(pair.first));
+  for (const PropertyEntry &entry : m_properties) {
+    PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString(entry.first.GetName()));
   }
 
   return pylist;
@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/Expressions/tests/EXP_Bytecode_test.cc
+ *  \ingroup expressions
+ */
+
+#include "testing/testing.h"
+
+#include "EXP_BoolValue.h"
+#include "EXP_Bytecode.h"
+#include "EXP_EmptyValue.h"
+#include "EXP_FloatValue.h"
+#include "EXP_InputParser.h"
+#include "EXP_IntValue.h"
+#include "EXP_StringValue.h"
+
+/// Context of the parsed expressions, holding the properties read by the identifiers.
+class BytecodeTest : public testing::Test {
+ protected:
+  EXP_Value *m_context;
+
+  virtual void SetUp()
+  {
+    m_context = new EXP_EmptyValue();
+  }
+
+  virtual void TearDown()
+  {
+    m_context->Release();
+  }
+
+  void SetProperty(const std::string &name, EXP_Value *value)
+  {
+    m_context->SetProperty(name, value);
+    value->Release();
+  }
+
+  EXP_Expression *Parse(const std::string &text)
+  {
+    EXP_Parser parser;
+    parser.SetContext(m_context->AddRef());
+    return parser.ProcessText(text);
+  }
+
+  /// Bind the inputs to the context properties as the expression controller does.
+  bool BindInputs(EXP_Bytecode &code)
+  {
+    for (unsigned int i = 0, size = code.GetNumInputs(); i < size; ++i) {
+      EXP_Value *property = m_context->GetProperty(code.GetInputName(i));
+      if (!property || !EXP_Bytecode::ConvertValue(property, code.GetInput(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Check that the program gives the same number as the expression tree.
+  void ExpectSameResult(const std::string &text)
+  {
+    SCOPED_TRACE(text);
+    EXP_Expression *expr = Parse(text);
+    ASSERT_NE(expr, nullptr);
+
+    EXP_Bytecode code;
+    ASSERT_TRUE(code.Compile(expr));
+    ASSERT_TRUE(BindInputs(code));
+    ASSERT_TRUE(code.Execute());
+
+    EXP_Value *value = expr->Calculate();
+    ASSERT_NE(value, nullptr);
+    ASSERT_FALSE(value->IsError());
+    EXPECT_DOUBLE_EQ(EXP_Bytecode::GetNumber(code.GetResult()), value->GetNumber());
+    value->Release();
+    expr->Release();
+  }
+};
+
+TEST_F(BytecodeTest, same_result_as_tree)
+{
+  const char *expressions[] = {
+      "1 + 2 * 3",
+      "(1 + 2) * 3",
+      "7 - 10 / 4",
+      "7 % 3",
+      "-a + 2",
+      "a * f",
+      "a > 2",
+      "a >= 3 AND f < 1.0",
+      "a < 2 OR b",
+      "NOT b",
+      "a == 3",
+      "a != 3",
+      "f == 0.5",
+      "s == \"test\"",
+      "s != \"other\"",
+      "IF(a > 2, 10, 20)",
+      "IF(b, a, f) * 2",
+      "IF(a < 0, 1, IF(a == 3, 2, 3))",
+  };
+
+  const cInt ints[] = {-4, 0, 3, 8};
+  const float floats[] = {-1.5f, 0.0f, 0.5f, 2.25f};
+  for (int i = 0; i < 4; ++i) {
+    SetProperty("a", new EXP_IntValue(ints[i]));
+    SetProperty("f", new EXP_FloatValue(floats[i]));
+    SetProperty("b", new EXP_BoolValue(i % 2 == 0));
+    SetProperty("s", new EXP_StringValue((i == 1) ? "test" : "other", "s"));
+
+    for (const char *text : expressions) {
+      ExpectSameResult(text);
+    }
+  }
+}
+
+TEST_F(BytecodeTest, inputs)
+{
+  SetProperty("a", new EXP_IntValue(2));
+
+  EXP_Expression *expr = Parse("a + a * a");
+  ASSERT_NE(expr, nullptr);
+  EXP_Bytecode code;
+  ASSERT_TRUE(code.Compile(expr));
+
+  // An identifier used several times is a single input.
+  ASSERT_EQ(code.GetNumInputs(), 1u);
+  EXPECT_EQ(code.GetInputName(0), "a");
+
+  // The program is executed again with new input values.
+  for (cInt value = 0; value < 5; ++value) {
+    EXP_Bytecode::Register &input = code.GetInput(0);
+    input.m_type = VALUE_INT_TYPE;
+    input.m_int = value;
+    ASSERT_TRUE(code.Execute());
+    EXPECT_EQ(code.GetResult().m_type, VALUE_INT_TYPE);
+    EXPECT_EQ(code.GetResult().m_int, value + value * value);
+  }
+
+  expr->Release();
+}
+
+TEST_F(BytecodeTest, unsupported_operations)
+{
+  SetProperty("a", new EXP_IntValue(0));
+  SetProperty("s", new EXP_StringValue("text", "s"));
+
+  // Operations allocating or producing an error stop the program, the caller uses the tree.
+  const char *expressions[] = {
+      "s + \"suffix\"",
+      "a AND 1",
+      "IF(a, 1, 2)",
+  };
+  for (const char *text : expressions) {
+    SCOPED_TRACE(text);
+    EXP_Expression *expr = Parse(text);
+    ASSERT_NE(expr, nullptr);
+
+    EXP_Bytecode code;
+    ASSERT_TRUE(code.Compile(expr));
+    ASSERT_TRUE(BindInputs(code));
+    EXPECT_FALSE(code.Execute());
+    expr->Release();
+  }
+
+  // Identifiers of sub-contexts aren't compiled.
+  EXP_Expression *expr = Parse("a.b + 1");
+  ASSERT_NE(expr, nullptr);
+  EXP_Bytecode code;
+  EXPECT_FALSE(code.Compile(expr));
+  expr->Release();
+}
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/Expressions/tests/EXP_PropertyName_test.cc
+ *  \ingroup expressions
+ */
+
+#include "testing/testing.h"
+
+#include <thread>
+#include <vector>
+
+#include "EXP_PropertyName.h"
+
+TEST(property_name, interned)
+{
+  const EXP_PropertyName name1("health");
+  const EXP_PropertyName name2(std::string("heal") + "th");
+  const EXP_PropertyName other("armor");
+
+  EXPECT_EQ(name1, name2);
+  EXPECT_NE(name1, other);
+  EXPECT_EQ(&name1.GetName(), &name2.GetName());
+  EXPECT_EQ(name1.GetHash(), EXP_PropertyName::Hash("health"));
+  EXPECT_EQ(EXP_PropertyName().GetName(), "");
+}
+
+TEST(property_name, copy_and_move)
+{
+  EXP_PropertyName name("speed");
+  EXP_PropertyName copy = name;
+  EXPECT_EQ(copy, name);
+
+  EXP_PropertyName moved = std::move(copy);
+  EXPECT_EQ(moved, name);
+  EXPECT_EQ(moved.GetName(), "speed");
+
+  copy = EXP_PropertyName("other");
+  copy = name;
+  EXPECT_EQ(copy, name);
+  copy = std::move(moved);
+  EXPECT_EQ(copy.GetName(), "speed");
+
+  // Names stored in a growing vector are moved.
+  std::vector<EXP_PropertyName> names;
+  for (int i = 0; i < 100; ++i) {
+    names.emplace_back("name" + std::to_string(i % 10));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(names[i].GetName(), "name" + std::to_string(i % 10));
+    EXPECT_EQ(names[i], names[i % 10]);
+  }
+}
+
+TEST(property_name, freed_with_last_name)
+{
+  // The text is interned again once all its names are destructed.
+  for (int i = 0; i < 3; ++i) {
+    const EXP_PropertyName name("generated" + std::to_string(i));
+    EXPECT_EQ(name.GetName(), "generated" + std::to_string(i));
+    EXPECT_EQ(name, EXP_PropertyName("generated" + std::to_string(i)));
+  }
+  const EXP_PropertyName name("generated0");
+  EXPECT_EQ(name.GetName(), "generated0");
+}
+
+TEST(property_name, threads)
+{
+  // Names are interned and released concurrently during asynchronous libraries loading.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 10000; ++i) {
+        const EXP_PropertyName name("thread" + std::to_string(i % 7));
+        const EXP_PropertyName copy = name;
+        EXPECT_EQ(copy.GetName(), "thread" + std::to_string(i % 7));
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
@@ -44,16 +44,14 @@ SCA_ActuatorEventManager::~SCA_ActuatorEventManager()
 
 void SCA_ActuatorEventManager::NextFrame()
 {
-  // check for changed actuator
-  for (SCA_ISensor *sensor : m_sensors) {
-    sensor->Activate(m_logicmgr);
-  }
+  // The actuator sensors are event driven, see ActivateScheduledSensors.
 }
 
 void SCA_ActuatorEventManager::UpdateFrame()
 {
-  // update the state of actuator before executing them
-  for (SCA_ISensor *sensor : m_sensors) {
+  /* Update the state of actuator before executing them, only the sensors scheduled by
+   * an actuator activation or still observing an active actuator are concerned. */
+  for (SCA_ISensor *sensor : m_scheduledSensors) {
     static_cast<SCA_ActuatorSensor *>(sensor)->Update();
   }
 }
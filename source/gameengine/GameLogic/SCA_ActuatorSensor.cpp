@@ -37,7 +37,7 @@
 SCA_ActuatorSensor::SCA_ActuatorSensor(SCA_EventManager *eventmgr,
                                        SCA_IObject *gameobj,
                                        const std::string &actname)
-    : SCA_ISensor(gameobj, eventmgr), m_checkactname(actname)
+    : SCA_ISensor(gameobj, eventmgr), m_checkactname(actname), m_observing(false)
 {
   m_actuator = GetParent()->FindActuator(m_checkactname);
   Init();
@@ -54,6 +54,7 @@ EXP_Value *SCA_ActuatorSensor::GetReplica()
 {
   SCA_ActuatorSensor *replica = new SCA_ActuatorSensor(*this);
   // m_range_expr must be recalculated on replica!
+  replica->m_observing = false;
   replica->ProcessReplica();
   replica->Init();
 
@@ -62,10 +63,56 @@ EXP_Value *SCA_ActuatorSensor::GetReplica()
 
 void SCA_ActuatorSensor::ReParent(SCA_IObject *parent)
 {
-  m_actuator = parent->FindActuator(m_checkactname);
+  SetActuator(parent->FindActuator(m_checkactname));
   SCA_ISensor::ReParent(parent);
 }
 
+void SCA_ActuatorSensor::SetActuator(SCA_IActuator *actuator)
+{
+  if (!m_observing) {
+    m_actuator = actuator;
+    return;
+  }
+
+  if (m_actuator) {
+    m_actuator->RemoveStateSensor(this);
+  }
+  m_actuator = actuator;
+  if (m_actuator) {
+    m_actuator->AddStateSensor(this);
+  }
+  Schedule();
+}
+
+bool SCA_ActuatorSensor::IsEventDriven() const
+{
+  return true;
+}
+
+bool SCA_ActuatorSensor::NeedsEvaluation() const
+{
+  // The intermediate result is updated every frame while the actuator is active.
+  return SCA_ISensor::NeedsEvaluation() || (m_actuator && m_actuator->IsActive());
+}
+
+void SCA_ActuatorSensor::RegisterToManager()
+{
+  m_observing = true;
+  if (m_actuator) {
+    m_actuator->AddStateSensor(this);
+  }
+  SCA_ISensor::RegisterToManager();
+}
+
+void SCA_ActuatorSensor::UnregisterToManager()
+{
+  if (m_actuator) {
+    m_actuator->RemoveStateSensor(this);
+  }
+  m_observing = false;
+  SCA_ISensor::UnregisterToManager();
+}
+
 bool SCA_ActuatorSensor::IsPositiveTrigger()
 {
   bool result = m_lastresult;
@@ -162,7 +209,7 @@ int SCA_ActuatorSensor::CheckActuator(EXP_PyObjectPlus *self, const PyAttributeD
   SCA_ActuatorSensor *sensor = reinterpret_cast<SCA_ActuatorSensor *>(self);
   SCA_IActuator *act = sensor->GetParent()->FindActuator(sensor->m_checkactname);
   if (act) {
-    sensor->m_actuator = act;
+    sensor->SetActuator(act);
     return 0;
   }
   PyErr_SetString(PyExc_AttributeError, "string does not correspond to an actuator");
@@ -38,6 +38,11 @@ class SCA_ActuatorSensor : public SCA_ISensor {
   Py_Header std::string m_checkactname;
   bool m_lastresult;
   bool m_midresult;
+  /// True if the sensor is in the state sensors of its actuator.
+  bool m_observing;
+
+  /// Change the checked actuator and move the observation.
+  void SetActuator(SCA_IActuator *actuator);
 
  protected:
   SCA_IActuator *m_actuator;
@@ -53,6 +58,10 @@ class SCA_ActuatorSensor : public SCA_ISensor {
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
   virtual void ReParent(SCA_IObject *parent);
+  virtual bool IsEventDriven() const;
+  virtual bool NeedsEvaluation() const;
+  virtual void RegisterToManager();
+  virtual void UnregisterToManager();
   void Update();
 
 #ifdef WITH_PYTHON
@@ -33,6 +33,7 @@
 
 #include "CM_List.h"
 #include "SCA_ISensor.h"
+#include "SCA_LogicManager.h"
 
 SCA_EventManager::SCA_EventManager(SCA_LogicManager *logicmgr, EVENT_MANAGER_TYPE mgrtype)
     : m_logicmgr(logicmgr), m_mgrtype(mgrtype)
@@ -43,18 +44,55 @@ SCA_EventManager::~SCA_EventManager()
 {
   // all sensors should be removed
   BLI_assert(m_sensors.empty());
+  BLI_assert(m_scheduledSensors.empty());
 }
 
 bool SCA_EventManager::RegisterSensor(class SCA_ISensor *sensor)
 {
+  if (sensor->IsEventDriven()) {
+    // Evaluate the sensor once to initialize its state.
+    ScheduleSensor(sensor);
+    return true;
+  }
   return CM_ListAddIfNotFound(m_sensors, sensor);
 }
 
 bool SCA_EventManager::RemoveSensor(class SCA_ISensor *sensor)
 {
+  if (sensor->IsEventDriven()) {
+    if (sensor->IsScheduled()) {
+      CM_ListRemoveIfFound(m_scheduledSensors, sensor);
+      sensor->SetScheduled(false);
+    }
+    return true;
+  }
   return CM_ListRemoveIfFound(m_sensors, sensor);
 }
 
+void SCA_EventManager::ScheduleSensor(SCA_ISensor *sensor)
+{
+  if (!sensor->IsScheduled()) {
+    sensor->SetScheduled(true);
+    m_scheduledSensors.push_back(sensor);
+  }
+}
+
+void SCA_EventManager::ActivateScheduledSensors()
+{
+  // The sensors scheduled during the activation are kept for the next frame.
+  m_activeSensors.swap(m_scheduledSensors);
+
+  for (SCA_ISensor *sensor : m_activeSensors) {
+    sensor->SetScheduled(false);
+    sensor->Activate(m_logicmgr);
+    if (sensor->NeedsEvaluation()) {
+      ScheduleSensor(sensor);
+    }
+  }
+
+  m_activeSensors.clear();
+}
+
 void SCA_EventManager::NextFrame(double curtime, double fixedtime)
 {
   NextFrame();
@@ -42,7 +42,12 @@ class SCA_EventManager {
   class SCA_LogicManager
       *m_logicmgr; /* all event manager subclasses use this (other then TimeEventManager) */
 
+  /// Polled sensors, activated every frame.
   std::vector<SCA_ISensor *> m_sensors;
+  /// Event driven sensors to activate at the next frame, see ScheduleSensor.
+  std::vector<SCA_ISensor *> m_scheduledSensors;
+  /// Event driven sensors being activated.
+  std::vector<SCA_ISensor *> m_activeSensors;
 
  public:
   enum EVENT_MANAGER_TYPE {
@@ -69,6 +74,10 @@ class SCA_EventManager {
   virtual void UpdateFrame();
   virtual void EndFrame();
   virtual bool RegisterSensor(class SCA_ISensor *sensor);
+  /// Activate the event driven sensor at the next frame.
+  void ScheduleSensor(SCA_ISensor *sensor);
+  /// Activate the scheduled sensors, keep those needing an evaluation at the next frame.
+  void ActivateScheduledSensors();
   int GetType();
   // SG_DList &GetSensors() { return m_sensors; }
 
@@ -35,6 +35,7 @@
 #include "SCA_ExpressionController.h"
 
 #include "CM_Message.h"
+#include "EXP_Bytecode.h"
 #include "EXP_InputParser.h"
 #include "SCA_ISensor.h"
 #include "SCA_LogicManager.h"
@@ -45,7 +46,11 @@
 
 SCA_ExpressionController::SCA_ExpressionController(SCA_IObject *gameobj,
                                                    const std::string &exprtext)
-    : SCA_IController(gameobj), m_exprText(exprtext), m_exprCache(nullptr)
+    : SCA_IController(gameobj),
+      m_exprText(exprtext),
+      m_exprCache(nullptr),
+      m_bytecode(nullptr),
+      m_inputsBound(false)
 {
 }
 
@@ -53,6 +58,7 @@ SCA_ExpressionController::~SCA_ExpressionController()
 {
   if (m_exprCache)
     m_exprCache->Release();
+  delete m_bytecode;
 }
 
 EXP_Value *SCA_ExpressionController::GetReplica()
@@ -60,6 +66,9 @@ EXP_Value *SCA_ExpressionController::GetReplica()
   SCA_ExpressionController *replica = new SCA_ExpressionController(*this);
   replica->m_exprText = m_exprText;
   replica->m_exprCache = nullptr;
+  replica->m_bytecode = nullptr;
+  replica->m_inputs.clear();
+  replica->m_inputsBound = false;
   // this will copy properties and so on...
   replica->ProcessReplica();
 
@@ -74,9 +83,73 @@ void SCA_ExpressionController::Delete()
     m_exprCache->Release();
     m_exprCache = nullptr;
   }
+  delete m_bytecode;
+  m_bytecode = nullptr;
   Release();
 }
 
+void SCA_ExpressionController::SensorLinksChanged()
+{
+  m_inputsBound = false;
+}
+
+void SCA_ExpressionController::BindInputs()
+{
+  const unsigned int numInputs = m_bytecode->GetNumInputs();
+  m_inputs.resize(numInputs);
+
+  for (unsigned int i = 0; i < numInputs; ++i) {
+    const std::string &name = m_bytecode->GetInputName(i);
+    Input &input = m_inputs[i];
+    input.m_sensor = nullptr;
+
+    // Same resolution order as FindIdentifier.
+    for (SCA_ISensor *sensor : m_linkedsensors) {
+      if (sensor->GetName() == name) {
+        input.m_sensor = sensor;
+        break;
+      }
+    }
+
+    input.m_property = input.m_sensor ? EXP_PropertyName() : EXP_PropertyName(name);
+  }
+
+  m_inputsBound = true;
+}
+
+bool SCA_ExpressionController::ExecuteBytecode(bool &result)
+{
+  if (!m_inputsBound) {
+    BindInputs();
+  }
+
+  SCA_IObject *parent = GetParent();
+  for (unsigned int i = 0, size = m_inputs.size(); i < size; ++i) {
+    const Input &input = m_inputs[i];
+    EXP_Bytecode::Register &reg = m_bytecode->GetInput(i);
+    if (input.m_sensor) {
+      reg.m_type = VALUE_BOOL_TYPE;
+      reg.m_bool = input.m_sensor->GetState();
+    }
+    else {
+      EXP_Value *property = parent->GetProperty(input.m_property);
+      // A missing property or an unsupported type produces an error or a value handled by the
+      // expression tree.
+      if (!property || !EXP_Bytecode::ConvertValue(property, reg)) {
+        return false;
+      }
+    }
+  }
+
+  if (!m_bytecode->Execute()) {
+    return false;
+  }
+
+  const float num = (float)EXP_Bytecode::GetNumber(m_bytecode->GetResult());
+  result = !MT_fuzzyZero(num);
+  return true;
+}
+
 void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
 {
 
@@ -85,8 +158,18 @@ void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
     EXP_Parser parser;
     parser.SetContext(this->AddRef());
     m_exprCache = parser.ProcessText(m_exprText);
+
+    if (m_exprCache) {
+      m_bytecode = new EXP_Bytecode();
+      if (!m_bytecode->Compile(m_exprCache)) {
+        delete m_bytecode;
+        m_bytecode = nullptr;
+      }
+      m_inputsBound = false;
+    }
   }
-  if (m_exprCache) {
+
+  if (m_exprCache && !(m_bytecode && ExecuteBytecode(expressionresult))) {
     EXP_Value *value = m_exprCache->Calculate();
     if (value) {
       if (value->IsError()) {
@@ -34,8 +34,10 @@
 
 #pragma once
 
+#include "EXP_PropertyName.h"
 #include "SCA_IController.h"
 
+class EXP_Bytecode;
 class EXP_Expression;
 
 class SCA_ExpressionController : public SCA_IController {
@@ -43,6 +45,28 @@ class SCA_ExpressionController : public SCA_IController {
   std::string m_exprText;
   EXP_Expression *m_exprCache;
 
+  /// Source of the value of an identifier, a linked sensor or else a property of the owner.
+  struct Input {
+    SCA_ISensor *m_sensor;
+    EXP_PropertyName m_property;
+  };
+
+  /**
+   * Program compiled from the expression, nullptr if the expression uses a node not supported
+   * by the program, in this case the expression tree is evaluated.
+   */
+  EXP_Bytecode *m_bytecode;
+  /// Source of each input of the program, bound at the first trigger after a link change.
+  std::vector<Input> m_inputs;
+  bool m_inputsBound;
+
+  void BindInputs();
+  /// Evaluate the program, return false if the expression tree must be evaluated instead.
+  bool ExecuteBytecode(bool &result);
+
+ protected:
+  virtual void SensorLinksChanged();
+
  public:
   SCA_ExpressionController(SCA_IObject *gameobj, const std::string &exprtext);
 
@@ -33,6 +33,7 @@
 
 #include "CM_List.h"
 #include "CM_Message.h"
+#include "SCA_ISensor.h"
 
 SCA_IActuator::SCA_IActuator(SCA_IObject *gameobj, KX_ACTUATOR_TYPE type)
     : SCA_ILogicBrick(gameobj), m_type(type), m_links(0), m_posevent(false), m_negevent(false)
@@ -107,6 +108,7 @@ void SCA_IActuator::ProcessReplica()
   SCA_ILogicBrick::ProcessReplica();
   RemoveAllEvents();
   m_linkedcontrollers.clear();
+  m_stateSensors.clear();
 }
 
 SCA_IActuator::~SCA_IActuator()
@@ -141,6 +143,23 @@ bool SCA_IActuator::IsType(KX_ACTUATOR_TYPE type)
   return m_type == type;
 }
 
+void SCA_IActuator::AddStateSensor(SCA_ISensor *sensor)
+{
+  CM_ListAddIfNotFound(m_stateSensors, sensor);
+}
+
+void SCA_IActuator::RemoveStateSensor(SCA_ISensor *sensor)
+{
+  CM_ListRemoveIfFound(m_stateSensors, sensor);
+}
+
+void SCA_IActuator::ScheduleStateSensors()
+{
+  for (SCA_ISensor *sensor : m_stateSensors) {
+    sensor->Schedule();
+  }
+}
+
 void SCA_IActuator::LinkToController(SCA_IController *controller)
 {
   m_linkedcontrollers.push_back(controller);
@@ -49,6 +49,8 @@ class SCA_IActuator : public SCA_ILogicBrick {
   bool m_negevent;
 
   std::vector<SCA_IController *> m_linkedcontrollers;
+  /// Sensors scheduled when the actuator is activated or deactivated.
+  std::vector<SCA_ISensor *> m_stateSensors;
 
   void RemoveAllEvents();
 
@@ -144,4 +146,9 @@ class SCA_IActuator : public SCA_ILogicBrick {
   virtual void DecLink();
   bool IsNoLink() const;
   bool IsType(KX_ACTUATOR_TYPE type);
+
+  void AddStateSensor(SCA_ISensor *sensor);
+  void RemoveStateSensor(SCA_ISensor *sensor);
+  /// Schedule the sensors observing the activation of the actuator.
+  void ScheduleStateSensors();
 };
@@ -56,6 +56,10 @@ std::vector<SCA_IActuator *> &SCA_IController::GetLinkedActuators()
   return m_linkedactuators;
 }
 
+void SCA_IController::SensorLinksChanged()
+{
+}
+
 void SCA_IController::UnlinkAllSensors()
 {
   for (SCA_ISensor *sensor : m_linkedsensors) {
@@ -65,6 +69,7 @@ void SCA_IController::UnlinkAllSensors()
     sensor->UnlinkController(this);
   }
   m_linkedsensors.clear();
+  SensorLinksChanged();
 }
 
 void SCA_IController::UnlinkAllActuators()
@@ -107,6 +112,7 @@ void SCA_IController::LinkToSensor(SCA_ISensor *sensor)
   if (IsActive()) {
     sensor->IncLink();
   }
+  SensorLinksChanged();
 }
 
 void SCA_IController::UnlinkSensor(SCA_ISensor *sensor)
@@ -115,6 +121,7 @@ void SCA_IController::UnlinkSensor(SCA_ISensor *sensor)
     if (IsActive()) {
       sensor->DecLink();
     }
+    SensorLinksChanged();
   }
   else {
     CM_LogicBrickWarning(this,
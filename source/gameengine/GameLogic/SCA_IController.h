@@ -48,6 +48,9 @@ class SCA_IController : public SCA_ILogicBrick {
   bool m_justActivated;
   bool m_bookmark;
 
+  /// Called when a sensor is linked or unlinked.
+  virtual void SensorLinksChanged();
+
  public:
   SCA_IController(SCA_IObject *gameobj);
   virtual ~SCA_IController();
@@ -58,7 +58,8 @@ SCA_ISensor::SCA_ISensor(SCA_IObject *gameobj, SCA_EventManager *eventmgr)
       m_suspended(false),
       m_links(0),
       m_state(false),
-      m_prev_state(false)
+      m_prev_state(false),
+      m_scheduled(false)
 {
 }
 
@@ -70,6 +71,7 @@ void SCA_ISensor::ProcessReplica()
 {
   SCA_ILogicBrick::ProcessReplica();
   m_linkedcontrollers.clear();
+  m_scheduled = false;
 }
 
 bool SCA_ISensor::IsPositiveTrigger()
@@ -86,6 +88,35 @@ bool SCA_ISensor::IsPositiveTrigger()
   return result;
 }
 
+bool SCA_ISensor::IsEventDriven() const
+{
+  return false;
+}
+
+bool SCA_ISensor::NeedsEvaluation() const
+{
+  /* The pulses are counted every frame, the level and tap modes depend on the controllers
+   * activation and the previous state must be updated once after a change. */
+  return m_pos_pulsemode || m_neg_pulsemode || m_level || m_tap || (m_state != m_prev_state);
+}
+
+void SCA_ISensor::Schedule()
+{
+  if (m_links && IsEventDriven()) {
+    m_eventmgr->ScheduleSensor(this);
+  }
+}
+
+bool SCA_ISensor::IsScheduled() const
+{
+  return m_scheduled;
+}
+
+void SCA_ISensor::SetScheduled(bool scheduled)
+{
+  m_scheduled = scheduled;
+}
+
 void SCA_ISensor::SetPulseMode(bool posmode, bool negmode, int skippedticks)
 {
   m_pos_pulsemode = posmode;
@@ -131,6 +162,7 @@ bool SCA_ISensor::IsSuspended()
 void SCA_ISensor::Resume()
 {
   m_suspended = false;
+  Schedule();
 }
 
 bool SCA_ISensor::GetState()
@@ -337,6 +369,7 @@ EXP_PYMETHODDEF_DOC_NOARGS(
 {
   Init();
   m_prev_state = false;
+  Schedule();
   Py_RETURN_NONE;
 }
 
@@ -387,10 +420,13 @@ PyMethodDef SCA_ISensor::Methods[] = {
 };
 
 PyAttributeDef SCA_ISensor::Attributes[] = {
-    EXP_PYATTRIBUTE_BOOL_RW("usePosPulseMode", SCA_ISensor, m_pos_pulsemode),
-    EXP_PYATTRIBUTE_BOOL_RW("useNegPulseMode", SCA_ISensor, m_neg_pulsemode),
-    EXP_PYATTRIBUTE_INT_RW("skippedTicks", 0, 100000, true, SCA_ISensor, m_skipped_ticks),
-    EXP_PYATTRIBUTE_BOOL_RW("invert", SCA_ISensor, m_invert),
+    EXP_PYATTRIBUTE_BOOL_RW_CHECK(
+        "usePosPulseMode", SCA_ISensor, m_pos_pulsemode, pyattr_check_schedule),
+    EXP_PYATTRIBUTE_BOOL_RW_CHECK(
+        "useNegPulseMode", SCA_ISensor, m_neg_pulsemode, pyattr_check_schedule),
+    EXP_PYATTRIBUTE_INT_RW_CHECK(
+        "skippedTicks", 0, 100000, true, SCA_ISensor, m_skipped_ticks, pyattr_check_schedule),
+    EXP_PYATTRIBUTE_BOOL_RW_CHECK("invert", SCA_ISensor, m_invert, pyattr_check_schedule),
     EXP_PYATTRIBUTE_BOOL_RW_CHECK("level", SCA_ISensor, m_level, pyattr_check_level),
     EXP_PYATTRIBUTE_BOOL_RW_CHECK("tap", SCA_ISensor, m_tap, pyattr_check_tap),
     EXP_PYATTRIBUTE_RO_FUNCTION("triggered", SCA_ISensor, pyattr_get_triggered),
@@ -460,6 +496,7 @@ int SCA_ISensor::pyattr_check_level(EXP_PyObjectPlus *self_v, const EXP_PYATTRIB
   if (self->m_level) {
     self->m_tap = false;
   }
+  self->Schedule();
   return 0;
 }
 
@@ -469,6 +506,15 @@ int SCA_ISensor::pyattr_check_tap(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUT
   if (self->m_tap) {
     self->m_level = false;
   }
+  self->Schedule();
+  return 0;
+}
+
+int SCA_ISensor::pyattr_check_schedule(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  // Evaluate the sensor with its new settings.
+  static_cast<SCA_ISensor *>(self_v)->Schedule();
   return 0;
 }
 
@@ -488,6 +534,7 @@ int SCA_ISensor::pyattr_set_frequency(EXP_PyObjectPlus *self_v,
   EXP_ShowDeprecationWarning("SCA_ISensor.frequency", "SCA_ISensor.skippedTicks");
   if (PyLong_Check(value)) {
     self->m_skipped_ticks = PyLong_AsLong(value);
+    self->Schedule();
     return PY_SET_ATTR_SUCCESS;
   }
   else {
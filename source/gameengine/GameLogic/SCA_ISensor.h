@@ -87,6 +87,9 @@ class SCA_ISensor : public SCA_ILogicBrick {
   /// Previous state (for tap option).
   bool m_prev_state;
 
+  /// Event driven sensor in the scheduled list of its event manager.
+  bool m_scheduled;
+
   std::vector<SCA_IController *> m_linkedcontrollers;
 
  public:
@@ -112,6 +115,21 @@ class SCA_ISensor : public SCA_ILogicBrick {
   virtual bool IsPositiveTrigger();
   virtual void Init();
 
+  /**
+   * Return true if the sensor is activated only when scheduled by a change of the sources
+   * it observes, false if it is activated every frame. Constant for a sensor type.
+   */
+  virtual bool IsEventDriven() const;
+  /**
+   * Return true if the event driven sensor must be activated again at the next frame without
+   * any change of its sources, e.g for pulses or to update its previous state.
+   */
+  virtual bool NeedsEvaluation() const;
+  /// Activate the event driven sensor at the next frame if it is registered.
+  void Schedule();
+  bool IsScheduled() const;
+  void SetScheduled(bool scheduled);
+
   virtual EXP_Value *GetReplica() = 0;
 
   /** Set parameters for the pulsing behavior.
@@ -187,6 +205,7 @@ class SCA_ISensor : public SCA_ILogicBrick {
 
   static int pyattr_check_level(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
   static int pyattr_check_tap(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_check_schedule(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 
   enum SensorStatus {
     KX_SENSOR_INACTIVE = 0,
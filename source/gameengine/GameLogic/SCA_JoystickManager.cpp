@@ -31,7 +31,8 @@
 
 #include "SCA_JoystickManager.h"
 
-#include "SCA_ISensor.h"
+#include "CM_List.h"
+#include "SCA_JoystickSensor.h"
 
 SCA_JoystickManager::SCA_JoystickManager(class SCA_LogicManager *logicmgr)
     : SCA_EventManager(logicmgr, JOY_EVENTMGR)
@@ -42,11 +43,46 @@ SCA_JoystickManager::~SCA_JoystickManager()
 {
 }
 
+bool SCA_JoystickManager::RegisterSensor(SCA_ISensor *sensor)
+{
+  CM_ListAddIfNotFound(m_joystickSensors, static_cast<SCA_JoystickSensor *>(sensor));
+  return SCA_EventManager::RegisterSensor(sensor);
+}
+
+bool SCA_JoystickManager::RemoveSensor(SCA_ISensor *sensor)
+{
+  CM_ListRemoveIfFound(m_joystickSensors, static_cast<SCA_JoystickSensor *>(sensor));
+  return SCA_EventManager::RemoveSensor(sensor);
+}
+
 void SCA_JoystickManager::NextFrame(double curtime, double deltatime)
 {
   for (SCA_ISensor *sensor : m_sensors) {
     sensor->Activate(m_logicmgr);
   }
+
+  if (m_joystickSensors.empty()) {
+    return;
+  }
+
+  // A joystick sensor only changes when its joystick received axis or button events.
+  bool events[JOYINDEX_MAX];
+  bool anyEvents = false;
+  for (short i = 0; i < JOYINDEX_MAX; ++i) {
+    DEV_Joystick *joy = GetJoystickDevice(i);
+    events[i] = joy && (joy->IsTrigAxis() || joy->IsTrigButton());
+    anyEvents |= events[i];
+  }
+
+  if (!anyEvents) {
+    return;
+  }
+
+  for (SCA_JoystickSensor *sensor : m_joystickSensors) {
+    if (events[sensor->GetJoyIndex()]) {
+      sensor->Schedule();
+    }
+  }
 }
 
 DEV_Joystick *SCA_JoystickManager::GetJoystickDevice(short int joyindex)
@@ -34,11 +34,17 @@
 #include "DEV_Joystick.h"
 #include "SCA_EventManager.h"
 
+class SCA_JoystickSensor;
+
 class SCA_JoystickManager : public SCA_EventManager {
+  /// Registered joystick sensors, scheduled when their joystick has events.
+  std::vector<SCA_JoystickSensor *> m_joystickSensors;
 
  public:
   SCA_JoystickManager(class SCA_LogicManager *logicmgr);
   virtual ~SCA_JoystickManager();
+  virtual bool RegisterSensor(SCA_ISensor *sensor);
+  virtual bool RemoveSensor(SCA_ISensor *sensor);
   virtual void NextFrame(double curtime, double deltatime);
   DEV_Joystick *GetJoystickDevice(short int joyindex);
 };
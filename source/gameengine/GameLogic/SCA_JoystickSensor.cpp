@@ -86,6 +86,11 @@ bool SCA_JoystickSensor::IsPositiveTrigger()
   return result;
 }
 
+bool SCA_JoystickSensor::IsEventDriven() const
+{
+  return true;
+}
+
 bool SCA_JoystickSensor::Evaluate()
 {
   DEV_Joystick *js = ((SCA_JoystickManager *)m_eventmgr)->GetJoystickDevice(m_joyindex);
@@ -154,6 +154,7 @@ class SCA_JoystickSensor : public SCA_ISensor {
 
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
+  virtual bool IsEventDriven() const;
   virtual void Init();
 
   short int GetJoyIndex(void)
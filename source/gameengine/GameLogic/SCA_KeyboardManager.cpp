@@ -34,6 +34,7 @@
 
 #include "SCA_KeyboardManager.h"
 
+#include "CM_List.h"
 #include "SCA_KeyboardSensor.h"
 
 SCA_KeyboardManager::SCA_KeyboardManager(SCA_LogicManager *logicmgr, SCA_IInputDevice *inputdev)
@@ -50,9 +51,44 @@ SCA_IInputDevice *SCA_KeyboardManager::GetInputDevice()
   return m_inputDevice;
 }
 
+bool SCA_KeyboardManager::RegisterSensor(SCA_ISensor *sensor)
+{
+  CM_ListAddIfNotFound(m_keyboardSensors, static_cast<SCA_KeyboardSensor *>(sensor));
+  return SCA_EventManager::RegisterSensor(sensor);
+}
+
+bool SCA_KeyboardManager::RemoveSensor(SCA_ISensor *sensor)
+{
+  CM_ListRemoveIfFound(m_keyboardSensors, static_cast<SCA_KeyboardSensor *>(sensor));
+  return SCA_EventManager::RemoveSensor(sensor);
+}
+
 void SCA_KeyboardManager::NextFrame()
 {
   for (SCA_ISensor *sensor : m_sensors) {
     sensor->Activate(m_logicmgr);
   }
+
+  if (m_keyboardSensors.empty()) {
+    return;
+  }
+
+  bool keyEvents = false;
+  for (int i = SCA_IInputDevice::BEGINKEY; i <= SCA_IInputDevice::ENDKEY; ++i) {
+    if (!m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)i).m_queue.empty()) {
+      keyEvents = true;
+      break;
+    }
+  }
+
+  // Without any key event or typed text, no keyboard sensor can change.
+  if (!keyEvents && m_inputDevice->GetText().empty()) {
+    return;
+  }
+
+  for (SCA_KeyboardSensor *sensor : m_keyboardSensors) {
+    if (sensor->HasInputEvents(m_inputDevice, keyEvents)) {
+      sensor->Schedule();
+    }
+  }
 }
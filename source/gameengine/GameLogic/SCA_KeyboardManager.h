@@ -36,13 +36,20 @@
 #include "SCA_EventManager.h"
 #include "SCA_IInputDevice.h"
 
+class SCA_KeyboardSensor;
+
 class SCA_KeyboardManager : public SCA_EventManager {
   class SCA_IInputDevice *m_inputDevice;
 
+  /// Registered keyboard sensors, scheduled when an input they read has events.
+  std::vector<SCA_KeyboardSensor *> m_keyboardSensors;
+
  public:
   SCA_KeyboardManager(class SCA_LogicManager *logicmgr, class SCA_IInputDevice *inputdev);
   virtual ~SCA_KeyboardManager();
 
+  virtual bool RegisterSensor(SCA_ISensor *sensor);
+  virtual bool RemoveSensor(SCA_ISensor *sensor);
   virtual void NextFrame();
   SCA_IInputDevice *GetInputDevice();
 };
@@ -103,6 +103,38 @@ bool SCA_KeyboardSensor::IsPositiveTrigger()
   return result;
 }
 
+bool SCA_KeyboardSensor::IsEventDriven() const
+{
+  return true;
+}
+
+bool SCA_KeyboardSensor::HasInputEvents(SCA_IInputDevice *inputdev, bool keyEvents) const
+{
+  // The typed text is logged in the target property.
+  if (!m_targetprop.empty() && !inputdev->GetText().empty()) {
+    return true;
+  }
+
+  if (m_bAllKeys) {
+    return keyEvents;
+  }
+
+  if (!inputdev->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_hotkey).m_queue.empty()) {
+    return true;
+  }
+  if (m_qual > 0 &&
+      !inputdev->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_qual).m_queue.empty())
+  {
+    return true;
+  }
+  if (m_qual2 > 0 &&
+      !inputdev->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_qual2).m_queue.empty())
+  {
+    return true;
+  }
+  return false;
+}
+
 bool SCA_KeyboardSensor::Evaluate()
 {
   bool result = false;
@@ -325,12 +357,29 @@ PyMethodDef SCA_KeyboardSensor::Methods[] = {
 PyAttributeDef SCA_KeyboardSensor::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("events", SCA_KeyboardSensor, pyattr_get_events),
     EXP_PYATTRIBUTE_RO_FUNCTION("inputs", SCA_KeyboardSensor, pyattr_get_inputs),
-    EXP_PYATTRIBUTE_BOOL_RW("useAllKeys", SCA_KeyboardSensor, m_bAllKeys),
-    EXP_PYATTRIBUTE_INT_RW("key", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_hotkey),
-    EXP_PYATTRIBUTE_SHORT_RW(
-        "hold1", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual),
-    EXP_PYATTRIBUTE_SHORT_RW(
-        "hold2", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual2),
+    EXP_PYATTRIBUTE_BOOL_RW_CHECK(
+        "useAllKeys", SCA_KeyboardSensor, m_bAllKeys, pyattr_check_schedule),
+    EXP_PYATTRIBUTE_INT_RW_CHECK("key",
+                                 0,
+                                 SCA_IInputDevice::ENDKEY,
+                                 true,
+                                 SCA_KeyboardSensor,
+                                 m_hotkey,
+                                 pyattr_check_schedule),
+    EXP_PYATTRIBUTE_SHORT_RW_CHECK("hold1",
+                                   0,
+                                   SCA_IInputDevice::ENDKEY,
+                                   true,
+                                   SCA_KeyboardSensor,
+                                   m_qual,
+                                   pyattr_check_schedule),
+    EXP_PYATTRIBUTE_SHORT_RW_CHECK("hold2",
+                                   0,
+                                   SCA_IInputDevice::ENDKEY,
+                                   true,
+                                   SCA_KeyboardSensor,
+                                   m_qual2,
+                                   pyattr_check_schedule),
     EXP_PYATTRIBUTE_STRING_RW(
         "toggleProperty", 0, MAX_PROP_NAME, false, SCA_KeyboardSensor, m_toggleprop),
     EXP_PYATTRIBUTE_STRING_RW(
@@ -35,6 +35,7 @@
 #include <list>
 
 #include "EXP_BoolValue.h"
+#include "SCA_IInputDevice.h"
 #include "SCA_ISensor.h"
 
 /**
@@ -92,6 +93,12 @@ class SCA_KeyboardSensor : public SCA_ISensor {
 
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
+  virtual bool IsEventDriven() const;
+
+  /** Return true if an input read by the sensor has events in this frame.
+   * \param keyEvents True if any key has events in this frame.
+   */
+  bool HasInputEvents(SCA_IInputDevice *inputdev, bool keyEvents) const;
 
 #ifdef WITH_PYTHON
   /* --------------------------------------------------------------------- */
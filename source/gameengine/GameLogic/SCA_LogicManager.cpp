@@ -119,6 +119,7 @@ void SCA_LogicManager::RemoveActuator(SCA_IActuator *actuator)
   actuator->UnlinkAllControllers();
   actuator->Deactivate();
   actuator->SetActive(false);
+  actuator->ScheduleStateSensors();
 }
 
 void SCA_LogicManager::RegisterToSensor(SCA_IController *controller, SCA_ISensor *sensor)
@@ -137,8 +138,10 @@ void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 {
   for (std::vector<SCA_EventManager *>::const_iterator ie = m_eventmanagers.begin();
        !(ie == m_eventmanagers.end());
-       ie++)
+       ie++) {
     (*ie)->NextFrame(curtime, fixedtime);
+    (*ie)->ActivateScheduledSensors();
+  }
 
   for (SG_QList *obj = (SG_QList *)m_triggeredControllerSet.Remove(); obj != nullptr;
        obj = (SG_QList *)m_triggeredControllerSet.Remove()) {
@@ -171,6 +174,7 @@ void SCA_LogicManager::UpdateFrame(double curtime)
         // this actuator is not active anymore, remove
         actua->QDelink();
         actua->SetActive(false);
+        actua->ScheduleStateSensors();
       }
       else if (actua->IsNoLink()) {
         // This actuator has no more links but it still active
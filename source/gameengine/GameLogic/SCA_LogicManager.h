@@ -98,6 +98,7 @@ class SCA_LogicManager {
     actua->SetActive(true);
     actua->Activate(m_activeActuators);
     actua->AddEvent(event);
+    actua->ScheduleStateSensors();
   }
 
   void AddTriggeredController(SCA_IController *controller, SCA_ISensor *sensor);
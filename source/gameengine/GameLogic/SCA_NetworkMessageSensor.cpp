@@ -49,6 +49,7 @@ SCA_NetworkMessageSensor::SCA_NetworkMessageSensor(
       m_NetworkScene(NetworkScene),
       m_subject(subject),
       m_frame_message_count(0),
+      m_registered(false),
       m_BodyList(nullptr),
       m_SubjectList(nullptr)
 {
@@ -62,72 +63,100 @@ void SCA_NetworkMessageSensor::Init()
 
 SCA_NetworkMessageSensor::~SCA_NetworkMessageSensor()
 {
+  if (m_registered) {
+    m_NetworkScene->UnregisterSensor(this);
+  }
+  ClearMessages();
+}
+
+void SCA_NetworkMessageSensor::ClearMessages()
+{
+  if (m_BodyList) {
+    m_BodyList->Release();
+    m_BodyList = nullptr;
+  }
+
+  if (m_SubjectList) {
+    m_SubjectList->Release();
+    m_SubjectList = nullptr;
+  }
+
+  m_messages = KX_NetworkMessageManager::MessageView();
 }
 
 EXP_Value *SCA_NetworkMessageSensor::GetReplica()
 {
   // This is the standard sensor implementation of GetReplica
   // There may be more network message sensor specific stuff to do here.
-  EXP_Value *replica = new SCA_NetworkMessageSensor(*this);
+  SCA_NetworkMessageSensor *replica = new SCA_NetworkMessageSensor(*this);
 
   if (replica == nullptr) {
     return nullptr;
   }
+  // The messages and their lists are not shared.
+  replica->m_messages = KX_NetworkMessageManager::MessageView();
+  replica->m_BodyList = nullptr;
+  replica->m_SubjectList = nullptr;
+  replica->m_registered = false;
   replica->ProcessReplica();
 
   return replica;
 }
 
-/// Return true only for flank (UP and DOWN)
-bool SCA_NetworkMessageSensor::Evaluate()
+bool SCA_NetworkMessageSensor::IsEventDriven() const
 {
-  bool result = false;
-  bool WasUp = m_IsUp;
+  return true;
+}
 
-  m_IsUp = false;
+bool SCA_NetworkMessageSensor::NeedsEvaluation() const
+{
+  // The sensor goes down at the first frame without messages.
+  return SCA_ISensor::NeedsEvaluation() || m_IsUp;
+}
 
-  if (m_BodyList) {
-    m_BodyList->Release();
-    m_BodyList = nullptr;
+void SCA_NetworkMessageSensor::RegisterToManager()
+{
+  m_NetworkScene->RegisterSensor(this, GetParent()->GetName(), m_subject);
+  m_registered = true;
+  SCA_ISensor::RegisterToManager();
+}
+
+void SCA_NetworkMessageSensor::UnregisterToManager()
+{
+  if (m_registered) {
+    m_NetworkScene->UnregisterSensor(this);
+    m_registered = false;
   }
+  SCA_ISensor::UnregisterToManager();
+}
 
-  if (m_SubjectList) {
-    m_SubjectList->Release();
-    m_SubjectList = nullptr;
+void SCA_NetworkMessageSensor::Replace_NetworkScene(KX_NetworkMessageScene *val)
+{
+  if (m_registered) {
+    m_NetworkScene->UnregisterSensor(this);
+    val->RegisterSensor(this, GetParent()->GetName(), m_subject);
   }
+  m_NetworkScene = val;
+}
 
-  std::string toname = GetParent()->GetName();
-  std::string &subject = this->m_subject;
+/// Return true only for flank (UP and DOWN)
+bool SCA_NetworkMessageSensor::Evaluate()
+{
+  bool result = false;
+  bool WasUp = m_IsUp;
 
-  const std::vector<KX_NetworkMessageManager::Message> messages = m_NetworkScene->FindMessages(
-      toname, subject);
+  ClearMessages();
 
-  m_frame_message_count = messages.size();
+  // The bodies and subjects lists are created only when accessed from python.
+  m_messages = m_NetworkScene->FindMessages(GetParent()->GetName(), m_subject);
+  m_frame_message_count = m_messages.GetSize();
+  m_IsUp = !m_messages.IsEmpty();
 
-  if (!messages.empty()) {
 #ifdef NAN_NET_DEBUG
+  if (m_IsUp) {
     std::cout << "SCA_NetworkMessageSensor found one or more messages" << std::endl;
-#endif
-    m_IsUp = true;
-    m_BodyList = new EXP_ListValue<EXP_StringValue>();
-    m_SubjectList = new EXP_ListValue<EXP_StringValue>();
   }
-
-  std::vector<KX_NetworkMessageManager::Message>::const_iterator mesit;
-  for (mesit = messages.begin(); mesit != messages.end(); mesit++) {
-    // save the body
-    const std::string &body = (*mesit).body;
-    // save the subject
-    const std::string &messub = (*mesit).subject;
-#ifdef NAN_NET_DEBUG
-    if (body) {
-      cout << "body [" << body << "]\n";
-    }
 #endif
-    m_BodyList->Add(new EXP_StringValue(body, "body"));
-    // Store Subject
-    m_SubjectList->Add(new EXP_StringValue(messub, "subject"));
-  }
 
   result = (WasUp != m_IsUp);
 
@@ -199,35 +228,58 @@ PyMethodDef SCA_NetworkMessageSensor::Methods[] = {
 };
 
 PyAttributeDef SCA_NetworkMessageSensor::Attributes[] = {
-    EXP_PYATTRIBUTE_STRING_RW("subject", 0, 100, false, SCA_NetworkMessageSensor, m_subject),
+    EXP_PYATTRIBUTE_STRING_RW_CHECK(
+        "subject", 0, 100, false, SCA_NetworkMessageSensor, m_subject, pyattr_check_subject),
     EXP_PYATTRIBUTE_INT_RO("frameMessageCount", SCA_NetworkMessageSensor, m_frame_message_count),
     EXP_PYATTRIBUTE_RO_FUNCTION("bodies", SCA_NetworkMessageSensor, pyattr_get_bodies),
     EXP_PYATTRIBUTE_RO_FUNCTION("subjects", SCA_NetworkMessageSensor, pyattr_get_subjects),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
+int SCA_NetworkMessageSensor::pyattr_check_subject(EXP_PyObjectPlus *self_v,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_NetworkMessageSensor *self = static_cast<SCA_NetworkMessageSensor *>(self_v);
+  if (self->m_registered) {
+    self->m_NetworkScene->RegisterSensor(self, self->GetParent()->GetName(), self->m_subject);
+  }
+  // Read the messages of the new subject.
+  self->Schedule();
+  return 0;
+}
+
 PyObject *SCA_NetworkMessageSensor::pyattr_get_bodies(EXP_PyObjectPlus *self_v,
                                                       const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   SCA_NetworkMessageSensor *self = static_cast<SCA_NetworkMessageSensor *>(self_v);
-  if (self->m_BodyList) {
-    return self->m_BodyList->GetProxy();
-  }
-  else {
+  if (self->m_messages.IsEmpty()) {
     return (new EXP_ListValue<EXP_StringValue>())->NewProxy(true);
   }
+
+  if (!self->m_BodyList) {
+    self->m_BodyList = new EXP_ListValue<EXP_StringValue>();
+    for (unsigned int i = 0, size = self->m_messages.GetSize(); i < size; ++i) {
+      self->m_BodyList->Add(new EXP_StringValue(std::string(self->m_messages.GetBody(i)), "body"));
+    }
+  }
+  return self->m_BodyList->GetProxy();
 }
 
 PyObject *SCA_NetworkMessageSensor::pyattr_get_subjects(EXP_PyObjectPlus *self_v,
                                                         const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   SCA_NetworkMessageSensor *self = static_cast<SCA_NetworkMessageSensor *>(self_v);
-  if (self->m_SubjectList) {
-    return self->m_SubjectList->GetProxy();
-  }
-  else {
+  if (self->m_messages.IsEmpty()) {
     return (new EXP_ListValue<EXP_StringValue>())->NewProxy(true);
   }
+
+  if (!self->m_SubjectList) {
+    self->m_SubjectList = new EXP_ListValue<EXP_StringValue>();
+    for (unsigned int i = 0, size = self->m_messages.GetSize(); i < size; ++i) {
+      self->m_SubjectList->Add(new EXP_StringValue(self->m_messages.GetSubject(i), "subject"));
+    }
+  }
+  return self->m_SubjectList->GetProxy();
 }
 
 #endif  // WITH_PYTHON
@@ -31,6 +31,7 @@
  */
 #pragma once
 
+#include "KX_NetworkMessageManager.h"
 #include "SCA_ISensor.h"
 
 class KX_NetworkMessageScene;
@@ -49,9 +50,19 @@ class SCA_NetworkMessageSensor : public SCA_ISensor {
 
   bool m_IsUp;
 
+  /// The sensor is registered to the network scene to be scheduled on messages.
+  bool m_registered;
+
+  /// Messages caught since the last frame, read without copy.
+  KX_NetworkMessageManager::MessageView m_messages;
+
+  /// Python lists of the bodies and subjects, created on first access.
   EXP_ListValue<EXP_StringValue> *m_BodyList;
   EXP_ListValue<EXP_StringValue> *m_SubjectList;
 
+  /// Release the Python lists and the messages.
+  void ClearMessages();
+
  public:
   SCA_NetworkMessageSensor(SCA_EventManager *eventmgr,            // our eventmanager
                            KX_NetworkMessageScene *NetworkScene,  // our scene
@@ -65,10 +76,12 @@ class SCA_NetworkMessageSensor : public SCA_ISensor {
   virtual void Init();
   void EndFrame();
 
-  virtual void Replace_NetworkScene(KX_NetworkMessageScene *val)
-  {
-    m_NetworkScene = val;
-  };
+  virtual bool IsEventDriven() const;
+  virtual bool NeedsEvaluation() const;
+  virtual void RegisterToManager();
+  virtual void UnregisterToManager();
+
+  virtual void Replace_NetworkScene(KX_NetworkMessageScene *val);
 
 #ifdef WITH_PYTHON
 
@@ -80,6 +93,7 @@ class SCA_NetworkMessageSensor : public SCA_ISensor {
   static PyObject *pyattr_get_bodies(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_subjects(EXP_PyObjectPlus *self_v,
                                        const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_check_subject(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 
 #endif /* WITH_PYTHON */
 };
@@ -50,6 +50,7 @@ SCA_PropertyActuator::SCA_PropertyActuator(SCA_IObject *gameobj,
     : SCA_IActuator(gameobj, KX_ACT_PROPERTY),
       m_type(acttype),
       m_propname(propname),
+      m_propkey(propname),
       m_exprtxt(expr),
       m_sourceObj(sourceObj)
 {
@@ -76,7 +77,7 @@ bool SCA_PropertyActuator::Update()
   if (bNegativeEvent) {
     if (m_type == KX_ACT_PROP_LEVEL) {
       EXP_Value *newval = new EXP_BoolValue(false);
-      EXP_Value *oldprop = propowner->GetProperty(m_propname);
+      EXP_Value *oldprop = propowner->GetProperty(m_propkey);
       if (oldprop) {
         oldprop->SetValue(newval);
       }
@@ -93,25 +94,25 @@ bool SCA_PropertyActuator::Update()
   if (m_type == KX_ACT_PROP_TOGGLE) {
     /* don't use */
     EXP_Value *newval;
-    EXP_Value *oldprop = propowner->GetProperty(m_propname);
+    EXP_Value *oldprop = propowner->GetProperty(m_propkey);
     if (oldprop) {
       newval = new EXP_BoolValue((oldprop->GetNumber() == 0.0) ? true : false);
       oldprop->SetValue(newval);
     }
     else { /* as not been assigned, evaluate as false, so assign true */
       newval = new EXP_BoolValue(true);
-      propowner->SetProperty(m_propname, newval);
+      propowner->SetProperty(m_propkey, newval);
     }
     newval->Release();
   }
   else if (m_type == KX_ACT_PROP_LEVEL) {
     EXP_Value *newval = new EXP_BoolValue(true);
-    EXP_Value *oldprop = propowner->GetProperty(m_propname);
+    EXP_Value *oldprop = propowner->GetProperty(m_propkey);
     if (oldprop) {
       oldprop->SetValue(newval);
     }
     else {
-      propowner->SetProperty(m_propname, newval);
+      propowner->SetProperty(m_propkey, newval);
     }
     newval->Release();
   }
@@ -121,18 +122,18 @@ bool SCA_PropertyActuator::Update()
       case KX_ACT_PROP_ASSIGN: {
 
         EXP_Value *newval = userexpr->Calculate();
-        EXP_Value *oldprop = propowner->GetProperty(m_propname);
+        EXP_Value *oldprop = propowner->GetProperty(m_propkey);
         if (oldprop) {
           oldprop->SetValue(newval);
         }
         else {
-          propowner->SetProperty(m_propname, newval);
+          propowner->SetProperty(m_propkey, newval);
         }
         newval->Release();
         break;
       }
       case KX_ACT_PROP_ADD: {
-        EXP_Value *oldprop = propowner->GetProperty(m_propname);
+        EXP_Value *oldprop = propowner->GetProperty(m_propkey);
         if (oldprop) {
           // int waarde = (int)oldprop->GetNumber();  /*unused*/
           EXP_Expression *expr = new EXP_Operator2Expr(
@@ -151,7 +152,7 @@ bool SCA_PropertyActuator::Update()
           EXP_Value *copyprop = m_sourceObj->GetProperty(m_exprtxt);
           if (copyprop) {
             EXP_Value *val = copyprop->GetReplica();
-            GetParent()->SetProperty(m_propname, val);
+            GetParent()->SetProperty(m_propkey, val);
             val->Release();
           }
         }
@@ -261,9 +262,20 @@ PyMethodDef SCA_PropertyActuator::Methods[] = {
     {nullptr, nullptr}  // Sentinel
 };
 
+int SCA_PropertyActuator::CheckPropName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  if (CheckProperty(self, attrdef)) {
+    return 1;
+  }
+
+  SCA_PropertyActuator *act = static_cast<SCA_PropertyActuator *>(self);
+  act->m_propkey = EXP_PropertyName(act->m_propname);
+  return 0;
+}
+
 PyAttributeDef SCA_PropertyActuator::Attributes[] = {
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
-        "propName", 0, MAX_PROP_NAME, false, SCA_PropertyActuator, m_propname, CheckProperty),
+        "propName", 0, MAX_PROP_NAME, false, SCA_PropertyActuator, m_propname, CheckPropName),
     EXP_PYATTRIBUTE_STRING_RW("value", 0, 100, false, SCA_PropertyActuator, m_exprtxt),
     EXP_PYATTRIBUTE_INT_RW("mode",
                            KX_ACT_PROP_NODEF + 1,
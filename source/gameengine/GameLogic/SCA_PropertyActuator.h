@@ -48,6 +48,8 @@ class SCA_PropertyActuator : public SCA_IActuator {
 
   int m_type;
   std::string m_propname;
+  /// Interned m_propname used to access the property.
+  EXP_PropertyName m_propkey;
   std::string m_exprtxt;
   SCA_IObject *m_sourceObj;  // for copy property actuator
 
@@ -71,4 +73,9 @@ class SCA_PropertyActuator : public SCA_IActuator {
   /* --------------------------------------------------------------------- */
   /* Python interface ---------------------------------------------------- */
   /* --------------------------------------------------------------------- */
+
+#ifdef WITH_PYTHON
+  /// Check that the property exists and update the interned property name.
+  static int CheckPropName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
+#endif
 };
@@ -38,6 +38,7 @@
 
 #include "CM_Format.h"
 #include "EXP_FloatValue.h"
+#include "EXP_StringValue.h"
 
 #include "BLI_compiler_attrs.h"
 
@@ -51,7 +52,13 @@ SCA_PropertySensor::SCA_PropertySensor(SCA_EventManager *eventmgr,
       m_checktype(checktype),
       m_checkpropval(propval),
       m_checkpropmaxval(propmaxval),
-      m_checkpropname(propname)
+      m_checkpropname(propname),
+      m_property(nullptr),
+      m_bound(false),
+      m_observing(false),
+      m_propertyTracked(false),
+      m_ownerRevision(0),
+      m_propertyRevision(0)
 {
   // EXP_Parser pars;
   // pars.SetContext(this->AddRef());
@@ -71,12 +78,17 @@ void SCA_PropertySensor::Init()
   m_recentresult = false;
   m_lastresult = m_invert ? true : false;
   m_reset = true;
+  // Check the property at the next evaluation after a reset.
+  m_bound = false;
 }
 
 EXP_Value *SCA_PropertySensor::GetReplica()
 {
   SCA_PropertySensor *replica = new SCA_PropertySensor(*this);
   // m_range_expr must be recalculated on replica!
+  replica->m_property = nullptr;
+  replica->m_bound = false;
+  replica->m_observing = false;
   replica->ProcessReplica();
   replica->Init();
 
@@ -92,8 +104,67 @@ bool SCA_PropertySensor::IsPositiveTrigger()
   return result;
 }
 
+void SCA_PropertySensor::ReParent(SCA_IObject *parent)
+{
+  if (m_observing) {
+    GetParent()->RemoveObserver(this);
+    parent->AddObserver(this);
+  }
+  SCA_ISensor::ReParent(parent);
+  m_bound = false;
+}
+
 SCA_PropertySensor::~SCA_PropertySensor()
 {
+  if (m_observing) {
+    GetParent()->RemoveObserver(this);
+  }
+  if (m_property) {
+    m_property->RemoveObserver(this);
+    m_property->Release();
+  }
+}
+
+bool SCA_PropertySensor::IsEventDriven() const
+{
+  return true;
+}
+
+bool SCA_PropertySensor::NeedsEvaluation() const
+{
+  /* The properties of a sub-context and the property types not counting their modifications
+   * are checked every frame. */
+  return SCA_ISensor::NeedsEvaluation() || !m_bound || (m_property && !m_propertyTracked);
+}
+
+void SCA_PropertySensor::RegisterToManager()
+{
+  m_observing = true;
+  // Add, remove or replace the property are notified by the owner.
+  GetParent()->AddObserver(this);
+  m_bound = false;
+  SCA_ISensor::RegisterToManager();
+}
+
+void SCA_PropertySensor::UnregisterToManager()
+{
+  GetParent()->RemoveObserver(this);
+  if (m_property) {
+    m_property->RemoveObserver(this);
+    m_property->Release();
+    m_property = nullptr;
+  }
+  m_bound = false;
+  m_observing = false;
+  SCA_ISensor::UnregisterToManager();
+}
+
+void SCA_PropertySensor::ValueModified(EXP_Value *value)
+{
+  if (value == GetParent()) {
+    m_bound = false;
+  }
+  Schedule();
 }
 
 bool SCA_PropertySensor::Evaluate()
@@ -109,8 +180,115 @@ bool SCA_PropertySensor::Evaluate()
   return (reset) ? true : false;
 }
 
+void SCA_PropertySensor::BindProperty()
+{
+  if (m_property) {
+    m_property->RemoveObserver(this);
+    m_property->Release();
+    m_property = nullptr;
+  }
+
+  SCA_IObject *parent = GetParent();
+  EXP_Value *orgprop = parent->FindIdentifier(m_checkpropname);
+  if (orgprop->IsError()) {
+    orgprop->Release();
+  }
+  else {
+    m_property = orgprop;
+    if (m_observing) {
+      m_property->AddObserver(this);
+    }
+  }
+
+  m_ownerRevision = parent->GetPropertiesRevision();
+  // The properties of a sub-context are resolved at each evaluation.
+  m_bound = (m_checkpropname.find('.') == std::string::npos);
+
+  m_propertyTracked = false;
+  if (m_property) {
+    switch (m_property->GetValueType()) {
+      case VALUE_INT_TYPE:
+      case VALUE_FLOAT_TYPE:
+      case VALUE_BOOL_TYPE:
+      case VALUE_STRING_TYPE: {
+        m_propertyTracked = true;
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  // The integer value matches only if its text is the same as the operand.
+  m_intValid = CM_StringTo(m_checkpropval, m_intValue) &&
+               (std::to_string(m_intValue) == m_checkpropval);
+  // Force strings to upper case, to avoid confusion in bool tests.
+  m_upperValue = boost::to_upper_copy(m_checkpropval);
+  m_boolValid = (m_upperValue == EXP_BoolValue::sTrueString ||
+                 m_upperValue == EXP_BoolValue::sFalseString);
+  m_boolValue = (m_upperValue == EXP_BoolValue::sTrueString);
+  m_floatValid = CM_StringTo(m_checkpropval, m_floatValue);
+  CM_StringTo(m_checkpropmaxval, m_maxValue);
+}
+
+bool SCA_PropertySensor::IsPropertyEqual() const
+{
+  switch (m_property->GetValueType()) {
+    case VALUE_INT_TYPE: {
+      return m_intValid && static_cast<EXP_IntValue *>(m_property)->GetInt() == m_intValue;
+    }
+    case VALUE_BOOL_TYPE: {
+      return m_boolValid && static_cast<EXP_BoolValue *>(m_property)->GetBool() == m_boolValue;
+    }
+    case VALUE_FLOAT_TYPE: {
+      /* Floating point values cant use strings usefully since you can have "0.0" == "0.0000",
+       * the text is compared only if the values are different. */
+      if (m_floatValid && static_cast<EXP_FloatValue *>(m_property)->GetFloat() == m_floatValue) {
+        return true;
+      }
+      return m_property->GetText() == m_checkpropval;
+    }
+    case VALUE_STRING_TYPE: {
+      const std::string &testprop = static_cast<EXP_StringValue *>(m_property)->GetString();
+      if ((testprop == EXP_BoolValue::sTrueString) || (testprop == EXP_BoolValue::sFalseString)) {
+        return testprop == m_upperValue;
+      }
+      return testprop == m_checkpropval;
+    }
+    default: {
+      const std::string testprop = m_property->GetText();
+      if ((testprop == EXP_BoolValue::sTrueString) || (testprop == EXP_BoolValue::sFalseString)) {
+        return testprop == m_upperValue;
+      }
+      return testprop == m_checkpropval;
+    }
+  }
+}
+
+float SCA_PropertySensor::GetPropertyNumber() const
+{
+  if (m_property->GetValueType() == VALUE_STRING_TYPE) {
+    float val;
+    CM_StringTo(static_cast<EXP_StringValue *>(m_property)->GetString(), val);
+    return val;
+  }
+  return m_property->GetNumber();
+}
+
 bool SCA_PropertySensor::CheckPropertyCondition()
 {
+  if (!m_bound || m_ownerRevision != GetParent()->GetPropertiesRevision()) {
+    BindProperty();
+  }
+  else if (!m_property || (m_propertyTracked && m_property->GetRevision() == m_propertyRevision)) {
+    // Nothing was written since the last evaluation, the result is unchanged.
+    if (m_checktype == KX_PROPSENSOR_CHANGED) {
+      m_recentresult = false;
+    }
+    return m_recentresult;
+  }
+
   m_recentresult = false;
   bool result = false;
   bool reverse = false;
@@ -119,31 +297,9 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       reverse = true;
       ATTR_FALLTHROUGH;
     case KX_PROPSENSOR_EQUAL: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
-        const std::string &testprop = orgprop->GetText();
-        // Force strings to upper case, to avoid confusion in
-        // bool tests. It's stupid the prop's identity is lost
-        // on the way here...
-        if ((testprop == EXP_BoolValue::sTrueString) ||
-            (testprop == EXP_BoolValue::sFalseString)) {
-          boost::to_upper(m_checkpropval);
-        }
-        result = (testprop == m_checkpropval);
-
-        /* Patch: floating point values cant use strings usefully since you can have "0.0" ==
-         * "0.0000" this could be made into a generic Value class function for comparing values
-         * with a string.
-         */
-        if (result == false && (orgprop->GetValueType() == VALUE_FLOAT_TYPE)) {
-          float f;
-          if (CM_StringTo(m_checkpropval, f)) {
-            result = (f == ((EXP_FloatValue *)orgprop)->GetFloat());
-          }
-        }
-        /* end patch */
+      if (m_property) {
+        result = IsPropertyEqual();
       }
-      orgprop->Release();
 
       if (reverse)
         result = !result;
@@ -154,37 +310,21 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       break;
     }
     case KX_PROPSENSOR_INTERVAL: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
-        float min;
-        float max;
-        float val;
-        CM_StringTo(m_checkpropval, min);
-        CM_StringTo(m_checkpropmaxval, max);
-
-        if (orgprop->GetValueType() == VALUE_STRING_TYPE) {
-          CM_StringTo(orgprop->GetText(), val);
-        }
-        else {
-          val = orgprop->GetNumber();
-        }
-
-        result = (min <= val) && (val <= max);
+      if (m_property) {
+        const float val = GetPropertyNumber();
+        result = (m_floatValue <= val) && (val <= m_maxValue);
       }
-      orgprop->Release();
 
       break;
     }
     case KX_PROPSENSOR_CHANGED: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-
-      if (!orgprop->IsError()) {
-        if (m_previoustext != orgprop->GetText()) {
-          m_previoustext = orgprop->GetText();
+      if (m_property) {
+        const std::string text = m_property->GetText();
+        if (m_previoustext != text) {
+          m_previoustext = text;
           result = true;
         }
       }
-      orgprop->Release();
 
       break;
     }
@@ -192,33 +332,25 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       reverse = true;
       ATTR_FALLTHROUGH;
     case KX_PROPSENSOR_GREATERTHAN: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
-        float ref;
-        CM_StringTo(m_checkpropval, ref);
-        float val;
-
-        if (orgprop->GetValueType() == VALUE_STRING_TYPE) {
-          CM_StringTo(orgprop->GetText(), val);
-        }
-        else {
-          val = orgprop->GetNumber();
-        }
-
+      if (m_property) {
+        const float val = GetPropertyNumber();
         if (reverse) {
-          result = val < ref;
+          result = val < m_floatValue;
         }
         else {
-          result = val > ref;
+          result = val > m_floatValue;
         }
       }
-      orgprop->Release();
 
       break;
     }
     default:; /* error */
   }
 
+  if (m_property) {
+    m_propertyRevision = m_property->GetRevision();
+  }
+
   // the concept of Edge and Level triggering has unwanted effect for KX_PROPSENSOR_CHANGED
   // see Game Engine bugtracker [ #3809 ]
   m_recentresult = result;
@@ -244,6 +376,28 @@ int SCA_PropertySensor::validValueForProperty(EXP_PyObjectPlus *self, const PyAt
    * function directly */
 
   /*  There is no type checking at this moment, unfortunately...           */
+  SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+  sensor->m_bound = false;
+  sensor->Schedule();
+  return 0;
+}
+
+int SCA_PropertySensor::CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  if (CheckProperty(self, attrdef) != 0) {
+    return 1;
+  }
+  SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+  sensor->m_bound = false;
+  sensor->Schedule();
+  return 0;
+}
+
+int SCA_PropertySensor::CheckMode(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+  sensor->m_bound = false;
+  sensor->Schedule();
   return 0;
 }
 
@@ -291,14 +445,20 @@ PyMethodDef SCA_PropertySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertySensor::Attributes[] = {
-    EXP_PYATTRIBUTE_INT_RW("mode",
-                           KX_PROPSENSOR_NODEF,
-                           KX_PROPSENSOR_MAX - 1,
-                           false,
-                           SCA_PropertySensor,
-                           m_checktype),
-    EXP_PYATTRIBUTE_STRING_RW_CHECK(
-        "propName", 0, MAX_PROP_NAME, false, SCA_PropertySensor, m_checkpropname, CheckProperty),
+    EXP_PYATTRIBUTE_INT_RW_CHECK("mode",
+                                 KX_PROPSENSOR_NODEF,
+                                 KX_PROPSENSOR_MAX - 1,
+                                 false,
+                                 SCA_PropertySensor,
+                                 m_checktype,
+                                 CheckMode),
+    EXP_PYATTRIBUTE_STRING_RW_CHECK("propName",
+                                    0,
+                                    MAX_PROP_NAME,
+                                    false,
+                                    SCA_PropertySensor,
+                                    m_checkpropname,
+                                    CheckPropertyName),
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
         "value", 0, 100, false, SCA_PropertySensor, m_checkpropval, validValueForProperty),
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
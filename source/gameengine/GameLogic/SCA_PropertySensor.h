@@ -32,9 +32,10 @@
 
 #pragma once
 
+#include "EXP_IntValue.h"
 #include "SCA_ISensor.h"
 
-class SCA_PropertySensor : public SCA_ISensor {
+class SCA_PropertySensor : public SCA_ISensor, public EXP_ValueObserver {
   Py_Header
       // class EXP_Expression*	m_rightexpr;
       int m_checktype;
@@ -45,6 +46,34 @@ class SCA_PropertySensor : public SCA_ISensor {
   bool m_lastresult;
   bool m_recentresult;
 
+  /// Checked property, referenced, nullptr if missing.
+  EXP_Value *m_property;
+  /// False when the property and the operands must be bound again.
+  bool m_bound;
+  /// True if the sensor observes its owner and the checked property.
+  bool m_observing;
+  /// True if the property type counts its modifications, see EXP_Value::GetRevision.
+  bool m_propertyTracked;
+  /// Properties revision of the owner when the property was bound.
+  unsigned int m_ownerRevision;
+  /// Revision of the property at the last evaluation.
+  unsigned int m_propertyRevision;
+
+  /// Comparison operands parsed from m_checkpropval and m_checkpropmaxval.
+  std::string m_upperValue;
+  cInt m_intValue;
+  float m_floatValue;
+  float m_maxValue;
+  bool m_intValid;
+  bool m_boolValue;
+  bool m_boolValid;
+  bool m_floatValid;
+
+  /// Resolve the checked property and parse the comparison operands.
+  void BindProperty();
+  bool IsPropertyEqual() const;
+  float GetPropertyNumber() const;
+
  protected:
  public:
   enum KX_PROPSENSOR_TYPE {
@@ -70,9 +99,16 @@ class SCA_PropertySensor : public SCA_ISensor {
 
   virtual ~SCA_PropertySensor();
   virtual EXP_Value *GetReplica();
+  virtual void ReParent(SCA_IObject *parent);
   virtual void Init();
   bool CheckPropertyCondition();
 
+  virtual bool IsEventDriven() const;
+  virtual bool NeedsEvaluation() const;
+  virtual void RegisterToManager();
+  virtual void UnregisterToManager();
+  virtual void ValueModified(EXP_Value *value);
+
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
   virtual EXP_Value *FindIdentifier(const std::string &identifiername);
@@ -87,6 +123,10 @@ class SCA_PropertySensor : public SCA_ISensor {
    * Test whether this is a sensible value (type check)
    */
   static int validValueForProperty(EXP_PyObjectPlus *self, const PyAttributeDef *);
+  /// Check the property name and bind the new property.
+  static int CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
+  /// Force the evaluation with the new mode.
+  static int CheckMode(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
 
 #endif
 };
@@ -30,14 +30,16 @@
 
 #include "SCA_SteeringActuator.h"
 
+#include <algorithm>
+
 #include "BLI_math_rotation.h"
 
 #include "EXP_ListWrapper.h"
 #include "KX_Globals.h"
 #include "KX_NavMeshObject.h"
 #include "KX_ObstacleSimulation.h"
+#include "KX_PathQueryManager.h"
 #include "KX_PyMath.h"
-#include "Recast.h"
 
 /* ------------------------------------------------------------------------- */
 /* Native functions                                                          */
@@ -67,6 +69,7 @@ SCA_SteeringActuator::SCA_SteeringActuator(SCA_IObject *gameobj,
       m_turnspeed(turnspeed),
       m_simulation(simulation),
       m_updateTime(0),
+      m_steerDelta(0),
       m_obstacle(nullptr),
       m_isActive(false),
       m_isSelfTerminated(isSelfTerminated),
@@ -113,6 +116,7 @@ EXP_Value *SCA_SteeringActuator::GetReplica()
 
 void SCA_SteeringActuator::ProcessReplica()
 {
+  m_pathQuery.reset();
   if (m_target)
     m_target->RegisterActuator(this);
   if (m_navmesh)
@@ -167,6 +171,10 @@ bool SCA_SteeringActuator::Update(double curtime)
   if (m_posevent && !m_isActive) {
     delta = 0.0;
     m_pathUpdateTime = -1.0;
+    // Don't follow the path of the previous activation while the new one is searched.
+    m_pathQuery.reset();
+    m_pathLen = 0;
+    m_wayPointIdx = -1;
     m_updateTime = curtime;
     m_isActive = true;
   }
@@ -215,12 +223,22 @@ bool SCA_SteeringActuator::Update(double curtime)
 
         static const MT_Scalar WAYPOINT_RADIUS(0.25f);
 
-        if (m_pathUpdateTime < 0 ||
-            (m_pathUpdatePeriod >= 0 &&
-             curtime - m_pathUpdateTime > ((double)m_pathUpdatePeriod / 1000.0))) {
+        /* The path is searched in background, the previous path is followed until the
+         * query is done. A new search isn't requested while the previous one is pending. */
+        if (!m_pathQuery &&
+            (m_pathUpdateTime < 0 ||
+             (m_pathUpdatePeriod >= 0 &&
+              curtime - m_pathUpdateTime > ((double)m_pathUpdatePeriod / 1000.0)))) {
           m_pathUpdateTime = curtime;
-          m_pathLen = m_navmesh->FindPath(mypos, targpos, m_path, MAX_PATH_LENGTH);
+          m_pathQuery = m_navmesh->FindPathAsync(mypos, targpos, MAX_PATH_LENGTH);
+        }
+
+        if (m_pathQuery && m_pathQuery->IsDone()) {
+          const std::vector<float> &path = m_pathQuery->GetPath();
+          std::copy(path.begin(), path.end(), m_path);
+          m_pathLen = m_pathQuery->GetPathLen();
           m_wayPointIdx = m_pathLen > 1 ? 1 : -1;
+          m_pathQuery.reset();
         }
 
         if (m_wayPointIdx > 0) {
@@ -255,37 +273,23 @@ bool SCA_SteeringActuator::Update(double curtime)
     if (!m_steerVec.fuzzyZero())
       m_steerVec.normalize();
     MT_Vector3 newvel = m_velocity * m_steerVec;
+    m_steerDelta = delta;
 
     // adjust velocity to avoid obstacles
     if (m_simulation && m_obstacle /*&& !newvel.fuzzyZero()*/) {
       if (m_enableVisualization)
         KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(1.0f, 0.0f, 0.0f, 1.0f));
-      m_simulation->AdjustObstacleVelocity(m_obstacle,
-                                           m_mode != KX_STEERING_PATHFOLLOWING ? m_navmesh :
-                                                                                 nullptr,
-                                           newvel,
-                                           m_acceleration * (float)delta,
-                                           m_turnspeed / (180.0f * (float)(M_PI * delta)));
-      if (m_enableVisualization)
-        KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(0.0f, 1.0f, 0.0f, 1.0f));
-    }
-
-    HandleActorFace(newvel);
-    if (isdyna) {
-      // temporary solution: set 2D steering velocity directly to obj
-      // correct way is to apply physical force
-      MT_Vector3 curvel = obj->GetLinearVelocity();
-
-      if (m_lockzvel)
-        newvel.z() = 0.0f;
-      else
-        newvel.z() = curvel.z();
-
-      obj->setLinearVelocity(newvel, false);
+      /* The velocity is adjusted against all the agents of the frame at once after the logic
+       * update, the simulation then calls ApplySteering. */
+      m_simulation->AddAgent(m_obstacle,
+                             m_mode != KX_STEERING_PATHFOLLOWING ? m_navmesh : nullptr,
+                             this,
+                             newvel,
+                             m_acceleration * (float)delta,
+                             m_turnspeed / (180.0f * (float)(M_PI * delta)));
     }
     else {
-      MT_Vector3 movement = delta * newvel;
-      obj->ApplyMovement(movement, false);
+      ApplySteering(newvel);
     }
   }
   else {
@@ -301,97 +305,42 @@ bool SCA_SteeringActuator::Update(double curtime)
   return true;
 }
 
-const MT_Vector3 &SCA_SteeringActuator::GetSteeringVec()
+void SCA_SteeringActuator::ApplySteering(const MT_Vector3 &velocity)
 {
-  static MT_Vector3 ZERO_VECTOR(0, 0, 0);
-  if (m_isActive)
-    return m_steerVec;
-  else
-    return ZERO_VECTOR;
-}
+  KX_GameObject *obj = (KX_GameObject *)GetParent();
+  MT_Vector3 newvel = velocity;
 
-inline float vdot2(const float *a, const float *b)
-{
-  return a[0] * b[0] + a[2] * b[2];
-}
-static bool barDistSqPointToTri(const float *p, const float *a, const float *b, const float *c)
-{
-  float v0[3], v1[3], v2[3];
-  rcVsub(v0, c, a);
-  rcVsub(v1, b, a);
-  rcVsub(v2, p, a);
-
-  const float dot00 = vdot2(v0, v0);
-  const float dot01 = vdot2(v0, v1);
-  const float dot02 = vdot2(v0, v2);
-  const float dot11 = vdot2(v1, v1);
-  const float dot12 = vdot2(v1, v2);
-
-  // Compute barycentric coordinates
-  float invDenom = 1.0f / (dot00 * dot11 - dot01 * dot01);
-  float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
-  float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
-
-  float ud = u < 0.f ? -u : (u > 1.f ? u - 1.f : 0.f);
-  float vd = v < 0.f ? -v : (v > 1.f ? v - 1.f : 0.f);
-  return ud * ud + vd * vd;
-}
+  if (m_simulation && m_obstacle && m_enableVisualization) {
+    const MT_Vector3 &mypos = obj->NodeGetWorldPosition();
+    KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(0.0f, 1.0f, 0.0f, 1.0f));
+  }
 
-inline void flipAxes(float *vec)
-{
-  std::swap(vec[1], vec[2]);
-}
+  HandleActorFace(newvel);
+  if (obj->IsDynamic()) {
+    // temporary solution: set 2D steering velocity directly to obj
+    // correct way is to apply physical force
+    MT_Vector3 curvel = obj->GetLinearVelocity();
 
-static bool getNavmeshNormal(dtStatNavMesh *navmesh, const MT_Vector3 &pos, MT_Vector3 &normal)
-{
-  static const float polyPickExt[3] = {2, 4, 2};
-  float spos[3];
-  pos.getValue(spos);
-  flipAxes(spos);
-  dtStatPolyRef sPolyRef = navmesh->findNearestPoly(spos, polyPickExt);
-  if (sPolyRef == 0)
-    return false;
-  const dtStatPoly *p = navmesh->getPoly(sPolyRef - 1);
-  const dtStatPolyDetail *pd = navmesh->getPolyDetail(sPolyRef - 1);
-
-  float distMin = FLT_MAX;
-  int idxMin = -1;
-  for (int i = 0; i < pd->ntris; ++i) {
-    const unsigned char *t = navmesh->getDetailTri(pd->tbase + i);
-    const float *v[3];
-    for (int j = 0; j < 3; ++j) {
-      if (t[j] < p->nv)
-        v[j] = navmesh->getVertex(p->v[t[j]]);
-      else
-        v[j] = navmesh->getDetailVertex(pd->vbase + (t[j] - p->nv));
-    }
-    float dist = barDistSqPointToTri(spos, v[0], v[1], v[2]);
-    if (dist < distMin) {
-      distMin = dist;
-      idxMin = i;
-    }
-  }
+    if (m_lockzvel)
+      newvel.z() = 0.0f;
+    else
+      newvel.z() = curvel.z();
 
-  if (idxMin >= 0) {
-    const unsigned char *t = navmesh->getDetailTri(pd->tbase + idxMin);
-    const float *v[3];
-    for (int j = 0; j < 3; ++j) {
-      if (t[j] < p->nv)
-        v[j] = navmesh->getVertex(p->v[t[j]]);
-      else
-        v[j] = navmesh->getDetailVertex(pd->vbase + (t[j] - p->nv));
-    }
-    MT_Vector3 tri[3];
-    for (size_t j = 0; j < 3; j++)
-      tri[j].setValue(v[j][0], v[j][2], v[j][1]);
-    MT_Vector3 a, b;
-    a = tri[1] - tri[0];
-    b = tri[2] - tri[0];
-    normal = b.cross(a).safe_normalized();
-    return true;
+    obj->setLinearVelocity(newvel, false);
+  }
+  else {
+    MT_Vector3 movement = m_steerDelta * newvel;
+    obj->ApplyMovement(movement, false);
   }
+}
 
-  return false;
+const MT_Vector3 &SCA_SteeringActuator::GetSteeringVec()
+{
+  static MT_Vector3 ZERO_VECTOR(0, 0, 0);
+  if (m_isActive)
+    return m_steerVec;
+  else
+    return ZERO_VECTOR;
 }
 
 void SCA_SteeringActuator::HandleActorFace(MT_Vector3 &velocity)
@@ -408,10 +357,9 @@ void SCA_SteeringActuator::HandleActorFace(MT_Vector3 &velocity)
   MT_Matrix3x3 mat;
 
   if (m_navmesh && m_normalUp) {
-    dtStatNavMesh *navmesh = m_navmesh->GetNavMesh();
     MT_Vector3 normal;
     MT_Vector3 trpos = m_navmesh->TransformToLocalCoords(curobj->NodeGetWorldPosition());
-    if (getNavmeshNormal(navmesh, trpos, normal)) {
+    if (m_navmesh->FindNormal(trpos, normal)) {
 
       left = (dir.cross(up)).safe_normalized();
       dir = (-left.cross(normal)).safe_normalized();
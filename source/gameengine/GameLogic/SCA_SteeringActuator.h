@@ -26,12 +26,15 @@
 
 #pragma once
 
+#include <memory>
+
 #include "MT_Matrix3x3.h"
 #include "SCA_IActuator.h"
 #include "SCA_LogicManager.h"
 
 class KX_GameObject;
 class KX_NavMeshObject;
+class KX_PathQuery;
 struct KX_Obstacle;
 class KX_ObstacleSimulation;
 const int MAX_PATH_LENGTH = 128;
@@ -50,6 +53,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
   KX_ObstacleSimulation *m_simulation;
 
   double m_updateTime;
+  /// Time step of the last update, used to apply the steering velocity.
+  double m_steerDelta;
   KX_Obstacle *m_obstacle;
   bool m_isActive;
   bool m_isSelfTerminated;
@@ -60,6 +65,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
   int m_pathLen;
   int m_pathUpdatePeriod;
   double m_pathUpdateTime;
+  /// Path searched in background, replacing m_path once done.
+  std::shared_ptr<KX_PathQuery> m_pathQuery;
   bool m_lockzvel;
   int m_wayPointIdx;
   MT_Matrix3x3 m_parentlocalmat;
@@ -99,6 +106,10 @@ class SCA_SteeringActuator : public SCA_IActuator {
   virtual void Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_map);
   virtual bool UnlinkObject(SCA_IObject *clientobj);
   const MT_Vector3 &GetSteeringVec();
+  /** Move the object at the steering velocity, called from Update or by the obstacle
+   * simulation once the velocity avoids the obstacles.
+   */
+  void ApplySteering(const MT_Vector3 &velocity);
 
 #ifdef WITH_PYTHON
 
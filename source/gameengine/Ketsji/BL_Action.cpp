@@ -398,18 +398,20 @@ void BL_Action::Update(float curtime, bool applyToObject)
   BLI_assert(m_localframe >= minFrame && m_localframe <= maxFrame);
 
   m_appliedToObject = applyToObject;
-  // In case of culled armatures (doesn't requesting to transform the object) we only manages time.
-  if (!applyToObject) {
-    return;
-  }
 
-  // Update controllers time. The controllers list is cleared when action is done
-  for (SG_Controller *cont : m_sg_contr_list) {
-    cont->SetSimulatedTime(m_localframe);  // update spatial controllers
-    cont->Update(m_localframe);
+  /* The controllers modify the scene graph and can apply physics forces,
+   * they are updated in UpdateIPOs which is never called from a thread.
+   * They are always requested as the object transform is used by the game logic. */
+  if (!m_sg_contr_list.empty()) {
     m_requestIpo = true;
   }
 
+  /* In case of culled or distant armatures (doesn't requesting to transform the object)
+   * we only manages time. */
+  if (!applyToObject) {
+    return;
+  }
+
   Object *ob = m_obj->GetBlenderObject();  // eevee
 
   /* Create an AnimationEvalContext based on the current local frame time (See comment in
@@ -630,10 +632,6 @@ void BL_Action::Update(float curtime, bool applyToObject)
       }
     }
   }
-  // If the action is done we can remove its scene graph IPO controller.
-  if (m_done) {
-    ClearControllerList();
-  }
 }
 
 /* To sync m_obj and children in SceneGraph after potential m_obj transform update in SG_Controller actions */
@@ -642,7 +640,18 @@ void BL_Action::Update(float curtime, bool applyToObject)
 void BL_Action::UpdateIPOs()
 {
   if (m_requestIpo) {
+    // Update controllers time. The controllers list is cleared when action is done
+    for (SG_Controller *cont : m_sg_contr_list) {
+      cont->SetSimulatedTime(m_localframe);  // update spatial controllers
+      cont->Update(m_localframe);
+    }
+
     m_obj->GetSGNode()->UpdateWorldData(0.0);
     m_requestIpo = false;
+
+    // If the action is done we can remove its scene graph IPO controller.
+    if (m_done) {
+      ClearControllerList();
+    }
   }
 }
@@ -114,7 +114,8 @@ class BL_Action {
    */
   void Update(float curtime, bool applyToObject);
   /**
-   * Sync m_obj and children in SceneGraph if fcurve transform action
+   * Update the scene graph controllers and sync m_obj and children in SceneGraph
+   * if fcurve transform action. Unlike Update it must be called from the main thread.
    */
   void UpdateIPOs();
 
@@ -31,7 +31,8 @@
 
 #define IS_TAGGED(_id) ((_id) && (((ID *)_id)->tag & LIB_TAG_DOIT))
 
-BL_ActionManager::BL_ActionManager(class KX_GameObject *obj) : m_obj(obj), m_suspended(false)
+BL_ActionManager::BL_ActionManager(class KX_GameObject *obj)
+    : m_obj(obj), m_suspended(false), m_lodUpdates(0)
 {
 }
 
@@ -167,11 +168,37 @@ bool BL_ActionManager::IsSuspended() const
   return m_suspended;
 }
 
+bool BL_ActionManager::UpdateLod(bool culled, unsigned short rate)
+{
+  if (culled) {
+    // Force the pose evaluation as soon as the object is visible.
+    m_lodUpdates = rate;
+    return false;
+  }
+
+  if (++m_lodUpdates >= rate) {
+    m_lodUpdates = 0;
+    return true;
+  }
+
+  return false;
+}
+
 void BL_ActionManager::Update(float curtime, bool applyToObject)
+{
+  UpdateActions(curtime, applyToObject);
+  UpdateIPOs();
+}
+
+void BL_ActionManager::UpdateActions(float curtime, bool applyToObject)
 {
   for (const auto &pair : m_layers) {
     pair.second->Update(curtime, applyToObject);
   }
+}
+
+void BL_ActionManager::UpdateIPOs()
+{
   /* It's to sync children with parent SGNode after fcurve update */
   for (const auto &pair : m_layers) {
     pair.second->UpdateIPOs();
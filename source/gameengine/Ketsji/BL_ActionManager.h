@@ -49,6 +49,9 @@ class BL_ActionManager {
   // Suspend action update?
   bool m_suspended;
 
+  /// Number of updates since the last pose evaluation, used by the animation LOD.
+  unsigned short m_lodUpdates;
+
   /**
    * Check if an action exists
    */
@@ -113,6 +116,16 @@ class BL_ActionManager {
   void Resume();
   bool IsSuspended() const;
 
+  /**
+   * Compute if the actions must be applied to the object for the next update
+   * according to the animation LOD.
+   * \param culled Set to true if the object is not visible, the actions are never applied and
+   * are applied at the first update the object is visible again.
+   * \param rate The actions are applied once every rate updates.
+   * \return True if the actions must be applied to the object.
+   */
+  bool UpdateLod(bool culled, unsigned short rate);
+
   /**
    * Update any running actions
    * \param curtime The current time used to compute the actions' frame.
@@ -120,4 +133,15 @@ class BL_ActionManager {
    * manages actions' frames.
    */
   void Update(float curtime, bool applyToObject);
+
+  /**
+   * Update any running actions without the scene graph synchronization,
+   * it is safe to call it for different objects in parallel.
+   * UpdateIPOs must be called after from the main thread.
+   */
+  void UpdateActions(float curtime, bool applyToObject);
+  /**
+   * Synchronize the scene graph with the actions updated by UpdateActions.
+   */
+  void UpdateIPOs();
 };
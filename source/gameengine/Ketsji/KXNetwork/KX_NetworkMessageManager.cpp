@@ -32,58 +32,514 @@
 
 #include "KX_NetworkMessageManager.h"
 
-KX_NetworkMessageManager::KX_NetworkMessageManager() : m_currentList(0)
+#include <algorithm>
+#include <cstring>
+
+#include "CM_Message.h"
+#include "KX_NetworkTransport.h"
+#include "SCA_ISensor.h"
+
+/* Framing of the datagrams: the magic and version, then for each message the receiver name,
+ * the subject and the body, each prefixed by its size stored as an unsigned LEB128 varint. */
+static const char packet_header[4] = {'K', 'X', 'N', 1};
+/// Maximum size of an encoded 32 bits varint.
+static const unsigned int varint_max_size = 5;
+
+static void write_string(std::string &packet, std::string_view str)
+{
+  unsigned int size = str.size();
+  while (size >= 0x80) {
+    packet.push_back((char)((size & 0x7F) | 0x80));
+    size >>= 7;
+  }
+  packet.push_back((char)size);
+  packet.append(str.data(), str.size());
+}
+
+static bool read_string(const char *&data, const char *end, std::string_view &str)
+{
+  unsigned int size = 0;
+  for (unsigned int shift = 0;; shift += 7) {
+    if (data == end || shift >= varint_max_size * 7) {
+      return false;
+    }
+    const unsigned char byte = *data++;
+    size |= (unsigned int)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+
+  if ((size_t)(end - data) < size) {
+    return false;
+  }
+  str = std::string_view(data, size);
+  data += size;
+  return true;
+}
+
+void KX_NetworkMessageManager::MessageList::Clear()
+{
+  // Keep the allocated memory for the next frame.
+  m_messages.clear();
+  m_bodies.clear();
+  m_receivers.clear();
+  m_subjects.clear();
+}
+
+void KX_NetworkMessageManager::MessageList::BuildIndex(const std::deque<std::string> &names)
+{
+  /* Messages of a receiver are ordered by subject name and then by sending order, as when
+   * they were stored in maps. */
+  std::stable_sort(
+      m_messages.begin(), m_messages.end(), [&names](const Message &a, const Message &b) {
+        if (a.to != b.to) {
+          return a.to < b.to;
+        }
+        return (a.subject != b.subject) && (names[a.subject] < names[b.subject]);
+      });
+
+  for (unsigned int i = 0, size = m_messages.size(); i < size; ++i) {
+    const Message &message = m_messages[i];
+    Range &receiver = m_receivers.emplace(message.to, Range{i, i}).first->second;
+    ++receiver.end;
+    const unsigned long long key = ((unsigned long long)message.to << 32) | message.subject;
+    Range &subject = m_subjects.emplace(key, Range{i, i}).first->second;
+    ++subject.end;
+  }
+}
+
+KX_NetworkMessageManager::MessageList::Range KX_NetworkMessageManager::MessageList::FindMessages(
+    unsigned int to) const
+{
+  const auto it = m_receivers.find(to);
+  if (it == m_receivers.end()) {
+    return {0, 0};
+  }
+  return it->second;
+}
+
+KX_NetworkMessageManager::MessageList::Range KX_NetworkMessageManager::MessageList::FindMessages(
+    unsigned int to, unsigned int subject) const
+{
+  const auto it = m_subjects.find(((unsigned long long)to << 32) | subject);
+  if (it == m_subjects.end()) {
+    return {0, 0};
+  }
+  return it->second;
+}
+
+const KX_NetworkMessageManager::Message &KX_NetworkMessageManager::MessageList::At(
+    unsigned int index) const
+{
+  return m_messages[index];
+}
+
+std::string_view KX_NetworkMessageManager::MessageList::GetBody(const Message &message) const
+{
+  return std::string_view(m_bodies.data() + message.bodyOffset, message.bodySize);
+}
+
+KX_NetworkMessageManager::MessageView::MessageView() : m_names(nullptr), m_ranges{{0, 0}, {0, 0}}
+{
+}
+
+unsigned int KX_NetworkMessageManager::MessageView::GetSize() const
+{
+  return (m_ranges[0].end - m_ranges[0].begin) + (m_ranges[1].end - m_ranges[1].begin);
+}
+
+bool KX_NetworkMessageManager::MessageView::IsEmpty() const
 {
+  return GetSize() == 0;
+}
+
+const KX_NetworkMessageManager::Message &KX_NetworkMessageManager::MessageView::At(
+    unsigned int index) const
+{
+  const unsigned int firstSize = m_ranges[0].end - m_ranges[0].begin;
+  if (index < firstSize) {
+    return m_list->At(m_ranges[0].begin + index);
+  }
+  return m_list->At(m_ranges[1].begin + index - firstSize);
+}
+
+std::string_view KX_NetworkMessageManager::MessageView::GetBody(unsigned int index) const
+{
+  return m_list->GetBody(At(index));
+}
+
+const std::string &KX_NetworkMessageManager::MessageView::GetSubject(unsigned int index) const
+{
+  return (*m_names)[At(index).subject];
+}
+
+KX_NetworkMessageManager::KX_NetworkMessageManager()
+    : m_currentList(std::make_shared<MessageList>()),
+      m_previousList(std::make_shared<MessageList>()),
+      m_allSubjectsSensors(0)
+{
+  // The empty name is used for messages without receiver or subject, it is never released.
+  AcquireName("");
 }
 
 KX_NetworkMessageManager::~KX_NetworkMessageManager()
 {
-  ClearMessages();
 }
 
-void KX_NetworkMessageManager::AddMessage(KX_NetworkMessageManager::Message message)
+void KX_NetworkMessageManager::SetTransport(std::unique_ptr<KX_NetworkTransport> transport)
 {
-  // Put the new message in map for the given receiver and subject.
-  m_messages[m_currentList][message.to][message.subject].push_back(message);
+  m_transport = std::move(transport);
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageManager::GetMessages(
-    std::string to, std::string subject)
+KX_NetworkTransport *KX_NetworkMessageManager::GetTransport() const
 {
-  std::vector<KX_NetworkMessageManager::Message> messages;
+  return m_transport.get();
+}
 
-  // look at messages without receiver.
-  std::map<std::string, std::vector<Message>> &messagesNoReceiver =
-      m_messages[1 - m_currentList][""];
-  std::map<std::string, std::vector<Message>> &messagesReceiver =
-      m_messages[1 - m_currentList][to];
-  if (subject.empty()) {
-    // Add all message without receiver and subject.
-    for (const auto &pair : messagesNoReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+unsigned int KX_NetworkMessageManager::AcquireName(const std::string &name)
+{
+  const auto it = m_nameIds.find(name);
+  if (it != m_nameIds.end()) {
+    ++m_nameRefs[it->second];
+    return it->second;
+  }
+
+  unsigned int id;
+  if (m_freeNameIds.empty()) {
+    id = m_names.size();
+    m_names.push_back(name);
+    m_nameRefs.push_back(1);
+  }
+  else {
+    id = m_freeNameIds.back();
+    m_freeNameIds.pop_back();
+    m_names[id] = name;
+    m_nameRefs[id] = 1;
+  }
+  m_nameIds.emplace(name, id);
+  return id;
+}
+
+void KX_NetworkMessageManager::ReleaseName(unsigned int id)
+{
+  if (--m_nameRefs[id] > 0 || id == 0) {
+    return;
+  }
+
+  m_nameIds.erase(m_names[id]);
+  // Free the memory of the name.
+  std::string().swap(m_names[id]);
+  m_freeNameIds.push_back(id);
+}
+
+int KX_NetworkMessageManager::FindNameId(const std::string &name) const
+{
+  const auto it = m_nameIds.find(name);
+  if (it == m_nameIds.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
+void KX_NetworkMessageManager::AddMessage(unsigned int to,
+                                          SCA_IObject *from,
+                                          unsigned int subject,
+                                          std::string_view body)
+{
+  MessageList &list = *m_currentList;
+  Message message;
+  message.to = to;
+  message.from = from;
+  message.subject = subject;
+  message.bodyOffset = list.m_bodies.size();
+  message.bodySize = body.size();
+  list.m_bodies.append(body.data(), body.size());
+  list.m_messages.push_back(message);
+}
+
+void KX_NetworkMessageManager::ReleaseNames(const MessageList &list)
+{
+  for (const Message &message : list.m_messages) {
+    ReleaseName(message.to);
+    ReleaseName(message.subject);
+  }
+}
+
+void KX_NetworkMessageManager::AddMessage(const std::string &to,
+                                          SCA_IObject *from,
+                                          const std::string &subject,
+                                          const std::string &body)
+{
+  AddMessage(AcquireName(to), from, AcquireName(subject), body);
+}
+
+void KX_NetworkMessageManager::SendMessages()
+{
+  const MessageList &list = *m_currentList;
+  std::string packet;
+
+  // All the messages of the frame are coalesced in as few datagrams as possible.
+  for (const Message &message : list.m_messages) {
+    const std::string &to = m_names[message.to];
+    const std::string &subject = m_names[message.subject];
+    const std::string_view body = list.GetBody(message);
+
+    const size_t size = varint_max_size * 3 + to.size() + subject.size() + body.size();
+    if (size + sizeof(packet_header) > KX_NetworkTransport::MaxPacketSize) {
+      CM_Warning("network message \"" << subject << "\" is too large to be sent, ignoring");
+      continue;
+    }
+
+    if (!packet.empty() && packet.size() + size > KX_NetworkTransport::MaxPacketSize) {
+      m_transport->Send(std::move(packet));
+      packet.clear();
+    }
+
+    if (packet.empty()) {
+      packet.append(packet_header, sizeof(packet_header));
+    }
+
+    write_string(packet, to);
+    write_string(packet, subject);
+    write_string(packet, body);
+  }
+
+  if (!packet.empty()) {
+    m_transport->Send(std::move(packet));
+  }
+}
+
+bool KX_NetworkMessageManager::DecodePacket(const std::string &packet)
+{
+  if (packet.size() < sizeof(packet_header) ||
+      memcmp(packet.data(), packet_header, sizeof(packet_header)) != 0)
+  {
+    return false;
+  }
+
+  const char *data = packet.data() + sizeof(packet_header);
+  const char *end = packet.data() + packet.size();
+  while (data != end) {
+    std::string_view to;
+    std::string_view subject;
+    std::string_view body;
+    if (!read_string(data, end, to) || !read_string(data, end, subject) ||
+        !read_string(data, end, body))
+    {
+      return false;
     }
-    // Add all message with the given receiver and no subject.
-    for (const auto &pair : messagesReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+
+    /* A received name is never added to the table unless a local sensor can read the message,
+     * so a remote sender can't grow the table. The receiver must be registered by a sensor, the
+     * subject too except for the sensors reading all subjects. */
+    const int toId = FindNameId(std::string(to));
+    if (toId == -1) {
+      continue;
+    }
+    const int subjectId = FindNameId(std::string(subject));
+    if (subjectId == -1 && !ReadsAllSubjects(toId)) {
+      continue;
+    }
+
+    AddMessage(AcquireName(std::string(to)), nullptr, AcquireName(std::string(subject)), body);
+  }
+
+  return true;
+}
+
+void KX_NetworkMessageManager::ReceiveMessages()
+{
+  m_transport->Receive(m_packets);
+
+  MessageList &list = *m_currentList;
+  for (const std::string &packet : m_packets) {
+    const unsigned int numMessages = list.m_messages.size();
+    const unsigned int bodiesSize = list.m_bodies.size();
+    if (!DecodePacket(packet)) {
+      // Drop all the messages of a malformed datagram.
+      for (unsigned int i = numMessages, size = list.m_messages.size(); i < size; ++i) {
+        ReleaseName(list.m_messages[i].to);
+        ReleaseName(list.m_messages[i].subject);
+      }
+      list.m_messages.resize(numMessages);
+      list.m_bodies.resize(bodiesSize);
+      CM_Warning("malformed network message datagram received, ignoring");
+    }
+  }
+
+  m_packets.clear();
+}
+
+KX_NetworkMessageManager::MessageView KX_NetworkMessageManager::GetMessages(
+    const std::string &to, const std::string &subject) const
+{
+  MessageView view;
+  const int toId = FindNameId(to);
+  const int subjectId = FindNameId(subject);
+  // Nothing was ever sent with this subject.
+  if (subjectId == -1) {
+    return view;
+  }
+
+  const MessageList &list = *m_previousList;
+  if (subject.empty()) {
+    // All messages without receiver and all messages with the given receiver.
+    view.m_ranges[0] = list.FindMessages(0);
+    if (toId != -1) {
+      view.m_ranges[1] = list.FindMessages(toId);
     }
   }
   else {
-    std::vector<KX_NetworkMessageManager::Message> &messagesNoReceiverSubject =
-        messagesNoReceiver[subject];
-    messages.insert(
-        messages.end(), messagesNoReceiverSubject.begin(), messagesNoReceiverSubject.end());
-    std::vector<KX_NetworkMessageManager::Message> &messagesReceiverSubject =
-        messagesReceiver[subject];
-    messages.insert(
-        messages.end(), messagesReceiverSubject.begin(), messagesReceiverSubject.end());
+    view.m_ranges[0] = list.FindMessages(0, subjectId);
+    if (toId != -1) {
+      view.m_ranges[1] = list.FindMessages(toId, subjectId);
+    }
+  }
+
+  // Only the views with messages keep the list alive.
+  if (!view.IsEmpty()) {
+    view.m_list = m_previousList;
+    view.m_names = &m_names;
   }
 
-  return messages;
+  return view;
+}
+
+void KX_NetworkMessageManager::RegisterSensor(SCA_ISensor *sensor,
+                                              const std::string &to,
+                                              const std::string &subject)
+{
+  UnregisterSensor(sensor);
+
+  const unsigned int toId = AcquireName(to);
+  const unsigned int subjectId = AcquireName(subject);
+  m_receiverSensors[toId].push_back({sensor, subjectId});
+  m_sensorReceivers.emplace(sensor, toId);
+  if (subjectId == 0) {
+    ++m_allSubjectsSensors;
+  }
+}
+
+void KX_NetworkMessageManager::UnregisterSensor(SCA_ISensor *sensor)
+{
+  const auto it = m_sensorReceivers.find(sensor);
+  if (it == m_sensorReceivers.end()) {
+    return;
+  }
+
+  const unsigned int toId = it->second;
+  m_sensorReceivers.erase(it);
+
+  const auto receiverIt = m_receiverSensors.find(toId);
+  std::vector<SensorEntry> &sensors = receiverIt->second;
+  for (std::vector<SensorEntry>::iterator entryIt = sensors.begin(); entryIt != sensors.end();
+       ++entryIt)
+  {
+    if (entryIt->sensor == sensor) {
+      if (entryIt->subject == 0) {
+        --m_allSubjectsSensors;
+      }
+      ReleaseName(entryIt->subject);
+      sensors.erase(entryIt);
+      break;
+    }
+  }
+  if (sensors.empty()) {
+    m_receiverSensors.erase(receiverIt);
+  }
+  ReleaseName(toId);
+}
+
+bool KX_NetworkMessageManager::ReadsAllSubjects(unsigned int to) const
+{
+  // The messages without receiver are read by all the sensors.
+  if (to == 0) {
+    return (m_allSubjectsSensors > 0);
+  }
+
+  const auto it = m_receiverSensors.find(to);
+  if (it == m_receiverSensors.end()) {
+    return false;
+  }
+  for (const SensorEntry &entry : it->second) {
+    if (entry.subject == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void KX_NetworkMessageManager::ScheduleSensors(unsigned int to,
+                                               const std::vector<SensorEntry> &sensors) const
+{
+  const MessageList &list = *m_previousList;
+  for (const SensorEntry &entry : sensors) {
+    // Same ranges as read by GetMessages.
+    const MessageList::Range ranges[2] = {
+        (entry.subject == 0) ? list.FindMessages(0) : list.FindMessages(0, entry.subject),
+        (entry.subject == 0) ? list.FindMessages(to) : list.FindMessages(to, entry.subject)};
+    if (ranges[0].end != ranges[0].begin || ranges[1].end != ranges[1].begin) {
+      entry.sensor->Schedule();
+    }
+  }
+}
+
+void KX_NetworkMessageManager::ScheduleSensors()
+{
+  const MessageList &list = *m_previousList;
+  if (list.m_messages.empty()) {
+    return;
+  }
+
+  // The messages without receiver can be read by any sensor.
+  if (list.m_receivers.find(0) != list.m_receivers.end()) {
+    for (const auto &item : m_receiverSensors) {
+      ScheduleSensors(item.first, item.second);
+    }
+  }
+  else {
+    for (const auto &item : list.m_receivers) {
+      const auto it = m_receiverSensors.find(item.first);
+      if (it != m_receiverSensors.end()) {
+        ScheduleSensors(it->first, it->second);
+      }
+    }
+  }
 }
 
 void KX_NetworkMessageManager::ClearMessages()
 {
-  // Clear previous list.
-  m_messages[1 - m_currentList].clear();
-  m_currentList = 1 - m_currentList;
+  /* The local messages are sent before adding the received ones, the messages from other
+   * processes are then read by the sensors in the same frame as the local ones. */
+  if (m_transport) {
+    SendMessages();
+    ReceiveMessages();
+  }
+
+  // The previous list is reused if no view uses it, otherwise it is kept until released.
+  m_retiredLists.push_back(std::move(m_previousList));
+  m_previousList = std::move(m_currentList);
+  m_previousList->BuildIndex(m_names);
+  ScheduleSensors();
+
+  for (std::vector<std::shared_ptr<MessageList>>::iterator it = m_retiredLists.begin();
+       it != m_retiredLists.end();)
+  {
+    if (it->use_count() > 1) {
+      ++it;
+      continue;
+    }
+
+    ReleaseNames(**it);
+    if (!m_currentList) {
+      m_currentList = std::move(*it);
+      m_currentList->Clear();
+    }
+    it = m_retiredLists.erase(it);
+  }
+
+  if (!m_currentList) {
+    m_currentList = std::make_shared<MessageList>();
+  }
 }
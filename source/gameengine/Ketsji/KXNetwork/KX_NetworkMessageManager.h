@@ -34,51 +34,190 @@ conflicts with KX_NetworkMessageManager::SendMessage */
 #  undef SendMessage
 #endif
 
-#include <map>
+#include <deque>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+class KX_NetworkTransport;
 class SCA_IObject;
+class SCA_ISensor;
 
 class KX_NetworkMessageManager {
  public:
   struct Message {
-    /// Receiver object(s) name.
-    std::string to;
+    /// Receiver object(s) name identifier.
+    unsigned int to;
     /// Sender game object.
     SCA_IObject *from;
-    /// Message subject, used as filter.
-    std::string subject;
-    /// Message body.
-    std::string body;
+    /// Message subject identifier, used as filter.
+    unsigned int subject;
+    /// Position of the body in the bodies of the message list.
+    unsigned int bodyOffset;
+    unsigned int bodySize;
+  };
+
+  /// Messages sent during one frame.
+  class MessageList {
+   public:
+    /// Range of messages in m_messages.
+    struct Range {
+      unsigned int begin;
+      unsigned int end;
+    };
+
+   private:
+    friend class KX_NetworkMessageManager;
+
+    /// All messages, sorted by receiver and subject name once the frame is over.
+    std::vector<Message> m_messages;
+    /// Bodies of all messages stored one after the other.
+    std::string m_bodies;
+    /// Messages of each receiver.
+    std::unordered_map<unsigned int, Range> m_receivers;
+    /// Messages of each receiver and subject, the key is the receiver in the high bits.
+    std::unordered_map<unsigned long long, Range> m_subjects;
+
+    void Clear();
+    /// Sort the messages and index them by receiver and subject.
+    void BuildIndex(const std::deque<std::string> &names);
+    Range FindMessages(unsigned int to) const;
+    Range FindMessages(unsigned int to, unsigned int subject) const;
+
+   public:
+    const Message &At(unsigned int index) const;
+    std::string_view GetBody(const Message &message) const;
+  };
+
+  /** View on the messages sent to a receiver with a subject, without copy.
+   * The view keeps its message list alive, the list is recycled once no view use it.
+   */
+  class MessageView {
+   private:
+    friend class KX_NetworkMessageManager;
+
+    std::shared_ptr<const MessageList> m_list;
+    /// Names of the manager, used to resolve the subjects.
+    const std::deque<std::string> *m_names;
+    /// Messages without receiver then messages for the receiver.
+    MessageList::Range m_ranges[2];
+
+   public:
+    MessageView();
+
+    unsigned int GetSize() const;
+    bool IsEmpty() const;
+    std::string_view GetBody(unsigned int index) const;
+    const std::string &GetSubject(unsigned int index) const;
+
+   private:
+    const Message &At(unsigned int index) const;
   };
 
  private:
-  /** List of all messages, filtered by receiver object(s) name and subject name.
-   * We use two lists, one handle sended message in the current frame and the other
-   * is used for handle message sended in the last frame for sensors.
+  /** Receiver and subject names, the index is their identifier, the empty name is 0.
+   * A deque keeps the names addresses stable.
+   */
+  std::deque<std::string> m_names;
+  std::unordered_map<std::string, unsigned int> m_nameIds;
+  /** Number of references of each name, a name is released and its identifier reused once
+   * no message uses it.
    */
-  std::map<std::string, std::map<std::string, std::vector<Message>>> m_messages[2];
+  std::vector<unsigned int> m_nameRefs;
+  std::vector<unsigned int> m_freeNameIds;
 
-  /** Since we use two list for the current and last frame we have to switch of
-   * current message list each frame. This value is only 0 or 1.
+  /** List of messages sent in the current frame, and list of messages sended in the last
+   * frame read by the sensors. The lists are swapped each frame.
    */
-  unsigned short m_currentList;
+  std::shared_ptr<MessageList> m_currentList;
+  std::shared_ptr<MessageList> m_previousList;
+  /// Previous lists still used by a message view, recycled once released.
+  std::vector<std::shared_ptr<MessageList>> m_retiredLists;
+
+  /// Message sensor scheduled when messages it reads are received.
+  struct SensorEntry {
+    SCA_ISensor *sensor;
+    unsigned int subject;
+  };
+  /// Registered message sensors of each receiver name.
+  std::unordered_map<unsigned int, std::vector<SensorEntry>> m_receiverSensors;
+  /// Receiver name of each registered message sensor.
+  std::unordered_map<SCA_ISensor *, unsigned int> m_sensorReceivers;
+  /// Number of registered sensors reading all subjects.
+  unsigned int m_allSubjectsSensors;
+
+  /// Transport of the messages to other processes, null when the messages stay local.
+  std::unique_ptr<KX_NetworkTransport> m_transport;
+  /// Datagrams received from the transport, kept to reuse the memory.
+  std::vector<std::string> m_packets;
+
+  /// Return the identifier of a name, added if not existing, and add a reference to it.
+  unsigned int AcquireName(const std::string &name);
+  /// Remove a reference to a name, the name is removed when not referenced anymore.
+  void ReleaseName(unsigned int id);
+  /// Return the identifier of a name, or -1 if the name is unknown.
+  int FindNameId(const std::string &name) const;
+
+  /// Add a message referencing the receiver and subject names.
+  void AddMessage(unsigned int to, SCA_IObject *from, unsigned int subject, std::string_view body);
+  /// Release the names referenced by the messages of a list before it is cleared or deleted.
+  void ReleaseNames(const MessageList &list);
+
+  /// Encode the messages of the current list in datagrams sent by the transport.
+  void SendMessages();
+  /// Decode the datagrams received by the transport in the current list.
+  void ReceiveMessages();
+  /** Decode the messages of one datagram, return false if the datagram is malformed.
+   * The messages no local sensor can read are ignored.
+   */
+  bool DecodePacket(const std::string &packet);
+
+  /// Return true if a sensor of a receiver reads the messages of all subjects.
+  bool ReadsAllSubjects(unsigned int to) const;
+  /// Schedule the sensors having messages to read in the list of the last frame.
+  void ScheduleSensors();
+  /// Schedule the sensors of a receiver having messages to read.
+  void ScheduleSensors(unsigned int to, const std::vector<SensorEntry> &sensors) const;
 
  public:
   KX_NetworkMessageManager();
   virtual ~KX_NetworkMessageManager();
 
   /** Add a message in the next message list.
-   * \param message The given message to add.
+   * \param to The receiver object(s) name.
+   * \param from The sender game object.
+   * \param subject The message subject.
+   * \param body The message body, copied in the message list.
    */
-  void AddMessage(Message message);
+  void AddMessage(const std::string &to,
+                  SCA_IObject *from,
+                  const std::string &subject,
+                  const std::string &body);
   /** Get all messages for a given receiver object name and message subject.
    * \param to The object(s) name.
    * \param subject The message subject/filter.
    */
-  const std::vector<Message> GetMessages(std::string to, std::string subject);
+  MessageView GetMessages(const std::string &to, const std::string &subject) const;
+
+  /** Schedule a message sensor at each frame it has messages to read.
+   * The receiver and subject names are kept while the sensor is registered.
+   * \param to The receiver object(s) name.
+   * \param subject The message subject, empty for all subjects.
+   */
+  void RegisterSensor(SCA_ISensor *sensor, const std::string &to, const std::string &subject);
+  void UnregisterSensor(SCA_ISensor *sensor);
 
-  /// Clear all messages
+  /** Set the transport exchanging the messages with other processes.
+   * Messages received from the transport have no sender object.
+   * \param transport The transport, null to keep the messages local.
+   */
+  void SetTransport(std::unique_ptr<KX_NetworkTransport> transport);
+  KX_NetworkTransport *GetTransport() const;
+
+  /** End the frame: send the messages of the frame to the transport, add the received
+   * messages and make all of them readable by the sensors.
+   */
   void ClearMessages();
 };
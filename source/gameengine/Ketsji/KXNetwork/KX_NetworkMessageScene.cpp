@@ -41,23 +41,29 @@ KX_NetworkMessageScene::~KX_NetworkMessageScene()
 {
 }
 
-void KX_NetworkMessageScene::SendMessage(std::string to,
+void KX_NetworkMessageScene::SendMessage(const std::string &to,
                                          SCA_IObject *from,
-                                         std::string subject,
-                                         std::string body)
+                                         const std::string &subject,
+                                         const std::string &body)
 {
-  KX_NetworkMessageManager::Message message;
-  message.to = to;
-  message.from = from;
-  message.subject = subject;
-  message.body = body;
-
-  // Put the new message in map for the given receiver and subject.
-  m_messageManager->AddMessage(message);
+  // Put the new message in the list of the current frame.
+  m_messageManager->AddMessage(to, from, subject, body);
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageScene::FindMessages(
-    std::string to, std::string subject)
+KX_NetworkMessageManager::MessageView KX_NetworkMessageScene::FindMessages(
+    const std::string &to, const std::string &subject)
 {
   return m_messageManager->GetMessages(to, subject);
 }
+
+void KX_NetworkMessageScene::RegisterSensor(SCA_ISensor *sensor,
+                                            const std::string &to,
+                                            const std::string &subject)
+{
+  m_messageManager->RegisterSensor(sensor, to, subject);
+}
+
+void KX_NetworkMessageScene::UnregisterSensor(SCA_ISensor *sensor)
+{
+  m_messageManager->UnregisterSensor(sensor);
+}
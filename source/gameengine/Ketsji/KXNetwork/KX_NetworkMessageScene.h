@@ -44,6 +44,7 @@ conflicts with KX_NetworkMessageScene::SendMessage */
 #include <vector>
 
 class SCA_IObject;
+class SCA_ISensor;
 
 class KX_NetworkMessageScene {
  private:
@@ -60,12 +61,22 @@ class KX_NetworkMessageScene {
    * \param subject The message subject, used as filter for receiver object(s).
    * \param message The body of the message.
    */
-  void SendMessage(std::string to, SCA_IObject *from, std::string subject, std::string body);
+  void SendMessage(const std::string &to,
+                   SCA_IObject *from,
+                   const std::string &subject,
+                   const std::string &body);
 
   /** Get all messages for a given receiver object name and message subject.
    * \param to The object(s) name.
    * \param subject The message subject/filter.
    */
-  const std::vector<KX_NetworkMessageManager::Message> FindMessages(std::string to,
-                                                                    std::string subject);
+  KX_NetworkMessageManager::MessageView FindMessages(const std::string &to,
+                                                     const std::string &subject);
+
+  /** Schedule a sensor at each frame messages for a receiver with a subject are received.
+   * \param to The object(s) name.
+   * \param subject The message subject/filter.
+   */
+  void RegisterSensor(SCA_ISensor *sensor, const std::string &to, const std::string &subject);
+  void UnregisterSensor(SCA_ISensor *sensor);
 };
@@ -0,0 +1,262 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is: all of this file.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KXNetwork/KX_NetworkTransport.cpp
+ *  \ingroup ketsjinet
+ */
+
+#ifdef WIN32
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#else
+#  include <arpa/inet.h>
+#  include <fcntl.h>
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <sys/select.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
+#include "KX_NetworkTransport.h"
+
+#include <cstring>
+
+#include "CM_Message.h"
+
+#ifdef WIN32
+#  define INVALID_SOCKET_VALUE INVALID_SOCKET
+#  define close_socket closesocket
+#else
+#  define INVALID_SOCKET_VALUE -1
+#  define close_socket close
+#endif
+
+/// Time the I/O thread waits for a datagram before flushing the outgoing queue, in microseconds.
+static const long udp_poll_timeout = 1000;
+/// Size of the largest UDP datagram payload.
+static const unsigned int udp_max_payload_size = 65536;
+
+KX_NetworkLoopbackTransport::KX_NetworkLoopbackTransport() : m_peer(this)
+{
+}
+
+KX_NetworkLoopbackTransport::~KX_NetworkLoopbackTransport()
+{
+}
+
+void KX_NetworkLoopbackTransport::Connect(KX_NetworkLoopbackTransport *peer)
+{
+  m_peer = peer ? peer : this;
+}
+
+void KX_NetworkLoopbackTransport::Send(std::string &&packet)
+{
+  m_peer->m_packets.push_back(std::move(packet));
+}
+
+void KX_NetworkLoopbackTransport::Receive(std::vector<std::string> &packets)
+{
+  for (std::string &packet : m_packets) {
+    packets.push_back(std::move(packet));
+  }
+  m_packets.clear();
+}
+
+KX_NetworkUdpTransport::KX_NetworkUdpTransport()
+    : m_socket(INVALID_SOCKET_VALUE), m_running(false)
+{
+#ifdef WIN32
+  WSADATA wsaData;
+  WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+}
+
+KX_NetworkUdpTransport::~KX_NetworkUdpTransport()
+{
+  Close();
+#ifdef WIN32
+  WSACleanup();
+#endif
+}
+
+bool KX_NetworkUdpTransport::Open(const std::string &address,
+                                  unsigned short port,
+                                  const std::vector<Peer> &peers)
+{
+  Close();
+
+  for (const Peer &peer : peers) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo *result = nullptr;
+    if (getaddrinfo(peer.address.c_str(), nullptr, &hints, &result) != 0 || !result) {
+      CM_Error("network transport: unable to resolve peer \"" << peer.address << "\"");
+      Close();
+      return false;
+    }
+
+    sockaddr_in peerAddress = *(sockaddr_in *)result->ai_addr;
+    peerAddress.sin_port = htons(peer.port);
+    m_peerAddresses.emplace_back((const char *)&peerAddress, sizeof(peerAddress));
+    freeaddrinfo(result);
+  }
+
+  m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (m_socket == INVALID_SOCKET_VALUE) {
+    CM_Error("network transport: unable to create socket");
+    Close();
+    return false;
+  }
+
+  sockaddr_in localAddress;
+  memset(&localAddress, 0, sizeof(localAddress));
+  localAddress.sin_family = AF_INET;
+  localAddress.sin_port = htons(port);
+  if (address.empty()) {
+    localAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+  }
+  else if (inet_pton(AF_INET, address.c_str(), &localAddress.sin_addr) != 1) {
+    CM_Error("network transport: invalid local address \"" << address << "\"");
+    Close();
+    return false;
+  }
+
+  if (bind(m_socket, (const sockaddr *)&localAddress, sizeof(localAddress)) != 0) {
+    CM_Error("network transport: unable to bind " << (address.empty() ? "*" : address) << ":"
+                                                   << port);
+    Close();
+    return false;
+  }
+
+  // The I/O thread never blocks on the socket except in select.
+#ifdef WIN32
+  u_long nonBlocking = 1;
+  ioctlsocket(m_socket, FIONBIO, &nonBlocking);
+#else
+  fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+  m_running = true;
+  m_thread = std::thread(&KX_NetworkUdpTransport::Run, this);
+
+  return true;
+}
+
+void KX_NetworkUdpTransport::Close()
+{
+  if (m_running) {
+    m_running = false;
+    m_thread.join();
+  }
+
+  if (m_socket != INVALID_SOCKET_VALUE) {
+    close_socket(m_socket);
+    m_socket = INVALID_SOCKET_VALUE;
+  }
+
+  m_peerAddresses.clear();
+  m_outgoing.clear();
+  m_incoming.clear();
+}
+
+void KX_NetworkUdpTransport::Run()
+{
+  std::vector<std::string> outgoing;
+  std::vector<std::string> incoming;
+  /* The buffer holds the largest UDP payload, a datagram larger than MaxPacketSize is then
+   * received entirely and dropped instead of being truncated. */
+  std::vector<char> buffer(udp_max_payload_size);
+
+  while (m_running) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      outgoing.swap(m_outgoing);
+    }
+
+    /* UDP doesn't guarantee delivery, a datagram that doesn't fit in the socket buffer is
+     * dropped instead of blocking the thread. */
+    for (const std::string &packet : outgoing) {
+      for (const std::string &peerAddress : m_peerAddresses) {
+        sendto(m_socket,
+               packet.data(),
+               (int)packet.size(),
+               0,
+               (const sockaddr *)peerAddress.data(),
+               (int)peerAddress.size());
+      }
+    }
+    outgoing.clear();
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(m_socket, &readSet);
+    timeval timeout = {0, udp_poll_timeout};
+    if (select((int)m_socket + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+      continue;
+    }
+
+    // Read all pending datagrams at once.
+    while (true) {
+      const int size = recvfrom(m_socket, buffer.data(), (int)buffer.size(), 0, nullptr, nullptr);
+      if (size <= 0) {
+        break;
+      }
+      if (size > (int)MaxPacketSize) {
+        continue;
+      }
+      incoming.emplace_back(buffer.data(), size);
+    }
+
+    if (!incoming.empty()) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (std::string &packet : incoming) {
+        m_incoming.push_back(std::move(packet));
+      }
+      incoming.clear();
+    }
+  }
+}
+
+void KX_NetworkUdpTransport::Send(std::string &&packet)
+{
+  if (!m_running) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_outgoing.push_back(std::move(packet));
+}
+
+void KX_NetworkUdpTransport::Receive(std::vector<std::string> &packets)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (std::string &packet : m_incoming) {
+    packets.push_back(std::move(packet));
+  }
+  m_incoming.clear();
+}
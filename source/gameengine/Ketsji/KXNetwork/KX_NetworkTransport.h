@@ -0,0 +1,123 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is: all of this file.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_NetworkTransport.h
+ *  \ingroup ketsjinet
+ *  \brief Ketsji Logic Extension: Network Message Transport classes
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Transport of the datagrams of the network message manager outside of the engine.
+ * A datagram holds all the messages sent during a frame, the transport doesn't know its
+ * content. Send and Receive are called from the main thread and must not block.
+ */
+class KX_NetworkTransport {
+ public:
+  enum Type { TRANSPORT_NONE = 0, TRANSPORT_LOOPBACK, TRANSPORT_UDP };
+
+  /// Maximum size of a datagram, a frame with more messages is split in several datagrams.
+  static constexpr unsigned int MaxPacketSize = 65000;
+
+  virtual ~KX_NetworkTransport() = default;
+
+  /// Queue a datagram to send to all the peers.
+  virtual void Send(std::string &&packet) = 0;
+  /// Append the datagrams received since the last call.
+  virtual void Receive(std::vector<std::string> &packets) = 0;
+};
+
+/** Transport delivering the datagrams in the same process, used for tests.
+ * The datagrams are received by the connected transport, or by the transport itself.
+ */
+class KX_NetworkLoopbackTransport : public KX_NetworkTransport {
+ private:
+  KX_NetworkLoopbackTransport *m_peer;
+  std::vector<std::string> m_packets;
+
+ public:
+  KX_NetworkLoopbackTransport();
+  virtual ~KX_NetworkLoopbackTransport();
+
+  /// Deliver the sent datagrams to peer instead of this transport.
+  void Connect(KX_NetworkLoopbackTransport *peer);
+
+  virtual void Send(std::string &&packet);
+  virtual void Receive(std::vector<std::string> &packets);
+};
+
+/** Transport sending the datagrams to a list of UDP peers.
+ * The socket is non-blocking and only used by a dedicated I/O thread, the main thread
+ * exchanges the datagrams with this thread through two queues.
+ */
+class KX_NetworkUdpTransport : public KX_NetworkTransport {
+ public:
+  struct Peer {
+    std::string address;
+    unsigned short port;
+  };
+
+ private:
+#ifdef WIN32
+  using Socket = unsigned long long;
+#else
+  using Socket = int;
+#endif
+
+  Socket m_socket;
+  /// Resolved peer addresses, stored as sockaddr_in.
+  std::vector<std::string> m_peerAddresses;
+
+  std::thread m_thread;
+  std::atomic<bool> m_running;
+
+  std::mutex m_mutex;
+  /// Datagrams to send, filled by the main thread.
+  std::vector<std::string> m_outgoing;
+  /// Datagrams received, emptied by the main thread.
+  std::vector<std::string> m_incoming;
+
+  void Run();
+  void Close();
+
+ public:
+  KX_NetworkUdpTransport();
+  virtual ~KX_NetworkUdpTransport();
+
+  /** Bind the socket and start the I/O thread.
+   * \param address The local address to bind, empty for all interfaces.
+   * \param port The local port to bind.
+   * \param peers The hosts receiving the datagrams.
+   * \return False if the socket can't be opened or a peer can't be resolved.
+   */
+  bool Open(const std::string &address, unsigned short port, const std::vector<Peer> &peers);
+
+  virtual void Send(std::string &&packet);
+  virtual void Receive(std::vector<std::string> &packets);
+};
@@ -0,0 +1,241 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KXNetwork/tests/KX_NetworkMessageManager_test.cc
+ *  \ingroup ketsjinet
+ */
+
+#include "testing/testing.h"
+
+#include "KX_NetworkMessageManager.h"
+#include "KX_NetworkTransport.h"
+#include "SCA_ISensor.h"
+
+/// Sensor only used to register a receiver and a subject, never linked so never scheduled.
+class TestMessageSensor : public SCA_ISensor {
+ public:
+  TestMessageSensor() : SCA_ISensor(nullptr, nullptr)
+  {
+  }
+
+  virtual bool Evaluate()
+  {
+    return false;
+  }
+
+  virtual EXP_Value *GetReplica()
+  {
+    return nullptr;
+  }
+};
+
+/// Loopback transport counting the datagrams sent.
+class TestTransport : public KX_NetworkLoopbackTransport {
+ public:
+  std::vector<size_t> m_sentSizes;
+
+  virtual void Send(std::string &&packet)
+  {
+    m_sentSizes.push_back(packet.size());
+    KX_NetworkLoopbackTransport::Send(std::move(packet));
+  }
+};
+
+static std::string encode_string(const std::string &str)
+{
+  // Sizes below 128 are encoded in a single byte.
+  return std::string(1, (char)str.size()) + str;
+}
+
+static std::string encode_message(const std::string &to,
+                                  const std::string &subject,
+                                  const std::string &body)
+{
+  return encode_string(to) + encode_string(subject) + encode_string(body);
+}
+
+static const std::string packet_header("KXN\x01", 4);
+
+TEST(network_message_manager, local_messages)
+{
+  KX_NetworkMessageManager manager;
+  manager.AddMessage("obj", nullptr, "b", "b1");
+  manager.AddMessage("obj", nullptr, "a", "a1");
+  manager.AddMessage("", nullptr, "a", "broadcast");
+  manager.AddMessage("other", nullptr, "a", "other");
+
+  // The messages are readable after the end of the frame.
+  EXPECT_TRUE(manager.GetMessages("obj", "a").IsEmpty());
+  manager.ClearMessages();
+
+  // Messages without receiver first, then the receiver messages.
+  KX_NetworkMessageManager::MessageView view = manager.GetMessages("obj", "a");
+  ASSERT_EQ(view.GetSize(), 2u);
+  EXPECT_EQ(view.GetBody(0), "broadcast");
+  EXPECT_EQ(view.GetBody(1), "a1");
+
+  // All subjects, sorted by subject name.
+  view = manager.GetMessages("obj", "");
+  ASSERT_EQ(view.GetSize(), 3u);
+  EXPECT_EQ(view.GetSubject(0), "a");
+  EXPECT_EQ(view.GetBody(1), "a1");
+  EXPECT_EQ(view.GetSubject(2), "b");
+
+  EXPECT_EQ(manager.GetMessages("nobody", "a").GetSize(), 1u);
+  EXPECT_TRUE(manager.GetMessages("obj", "c").IsEmpty());
+
+  // A view keeps its messages after the next frame.
+  manager.ClearMessages();
+  EXPECT_TRUE(manager.GetMessages("obj", "").IsEmpty());
+  EXPECT_EQ(view.GetSubject(2), "b");
+  EXPECT_EQ(view.GetBody(2), "b1");
+}
+
+TEST(network_message_manager, subject_names_reused)
+{
+  KX_NetworkMessageManager manager;
+  for (int i = 0; i < 100; ++i) {
+    const std::string subject = "subject" + std::to_string(i);
+    manager.AddMessage("obj", nullptr, subject, "body");
+    manager.ClearMessages();
+
+    KX_NetworkMessageManager::MessageView view = manager.GetMessages("obj", "");
+    ASSERT_EQ(view.GetSize(), 1u);
+    EXPECT_EQ(view.GetSubject(0), subject);
+    EXPECT_TRUE(manager.GetMessages("obj", "subject" + std::to_string(i - 1)).IsEmpty());
+  }
+}
+
+TEST(network_message_manager, loopback_round_trip)
+{
+  TestMessageSensor *sensor = new TestMessageSensor();
+
+  KX_NetworkMessageManager sender;
+  KX_NetworkMessageManager receiver;
+  receiver.RegisterSensor(sensor, "obj", "hello");
+
+  std::unique_ptr<TestTransport> senderTransport = std::make_unique<TestTransport>();
+  std::unique_ptr<TestTransport> receiverTransport = std::make_unique<TestTransport>();
+  senderTransport->Connect(receiverTransport.get());
+  TestTransport *transport = senderTransport.get();
+  sender.SetTransport(std::move(senderTransport));
+  receiver.SetTransport(std::move(receiverTransport));
+
+  // Enough messages to need several datagrams.
+  const int numMessages = 1000;
+  const std::string body(200, 'x');
+  for (int i = 0; i < numMessages; ++i) {
+    sender.AddMessage("obj", nullptr, "hello", std::to_string(i) + body);
+  }
+  // Too large to be sent.
+  sender.AddMessage("obj", nullptr, "hello", std::string(KX_NetworkTransport::MaxPacketSize, 'x'));
+
+  sender.ClearMessages();
+  receiver.ClearMessages();
+
+  // The messages of the frame are coalesced in as few datagrams as possible.
+  ASSERT_EQ(transport->m_sentSizes.size(), 4u);
+  for (size_t size : transport->m_sentSizes) {
+    EXPECT_LE(size, KX_NetworkTransport::MaxPacketSize);
+  }
+
+  KX_NetworkMessageManager::MessageView view = receiver.GetMessages("obj", "hello");
+  ASSERT_EQ(view.GetSize(), (unsigned int)numMessages);
+  for (int i = 0; i < numMessages; ++i) {
+    EXPECT_EQ(view.GetBody(i), std::to_string(i) + body);
+  }
+  EXPECT_EQ(view.GetSubject(0), "hello");
+
+  // The sender reads its own messages too.
+  EXPECT_EQ(sender.GetMessages("obj", "hello").GetSize(), (unsigned int)numMessages + 1);
+
+  receiver.UnregisterSensor(sensor);
+  sensor->Release();
+}
+
+TEST(network_message_manager, unknown_names_dropped)
+{
+  TestMessageSensor *helloSensor = new TestMessageSensor();
+  TestMessageSensor *allSensor = new TestMessageSensor();
+
+  KX_NetworkMessageManager receiver;
+  receiver.RegisterSensor(helloSensor, "obj", "hello");
+  receiver.RegisterSensor(allSensor, "all", "");
+
+  std::unique_ptr<TestTransport> ownTransport = std::make_unique<TestTransport>();
+  TestTransport *transport = ownTransport.get();
+  receiver.SetTransport(std::move(ownTransport));
+
+  // Unconnected, the transport receives its own datagrams.
+  transport->Send(packet_header + encode_message("obj", "hello", "kept") +
+                  encode_message("ghost", "hello", "no receiver") +
+                  encode_message("obj", "unknown", "no subject") +
+                  encode_message("all", "unknown", "all subjects") +
+                  encode_message("", "hello", "broadcast"));
+  receiver.ClearMessages();
+
+  KX_NetworkMessageManager::MessageView view = receiver.GetMessages("obj", "");
+  ASSERT_EQ(view.GetSize(), 2u);
+  EXPECT_EQ(view.GetBody(0), "broadcast");
+  EXPECT_EQ(view.GetBody(1), "kept");
+  EXPECT_EQ(receiver.GetMessages("ghost", "hello").GetSize(), 1u);
+
+  view = receiver.GetMessages("all", "");
+  ASSERT_EQ(view.GetSize(), 2u);
+  EXPECT_EQ(view.GetSubject(1), "unknown");
+  EXPECT_EQ(view.GetBody(1), "all subjects");
+
+  receiver.UnregisterSensor(helloSensor);
+  receiver.UnregisterSensor(allSensor);
+  helloSensor->Release();
+  allSensor->Release();
+}
+
+TEST(network_message_manager, malformed_datagram_dropped)
+{
+  TestMessageSensor *sensor = new TestMessageSensor();
+
+  KX_NetworkMessageManager receiver;
+  receiver.RegisterSensor(sensor, "obj", "");
+
+  std::unique_ptr<TestTransport> ownTransport = std::make_unique<TestTransport>();
+  TestTransport *transport = ownTransport.get();
+  receiver.SetTransport(std::move(ownTransport));
+
+  const std::string valid = packet_header + encode_message("obj", "a", "valid");
+  // The last body is shorter than its size.
+  std::string truncated = packet_header + encode_message("obj", "a", "lost") +
+                          encode_message("obj", "b", "truncated");
+  truncated.resize(truncated.size() - 2);
+
+  transport->Send(std::string(valid));
+  transport->Send(std::move(truncated));
+  transport->Send("XXXX" + encode_message("obj", "a", "bad header"));
+  receiver.ClearMessages();
+
+  KX_NetworkMessageManager::MessageView view = receiver.GetMessages("obj", "");
+  ASSERT_EQ(view.GetSize(), 1u);
+  EXPECT_EQ(view.GetBody(0), "valid");
+
+  receiver.UnregisterSensor(sensor);
+  sensor->Release();
+}
@@ -31,6 +31,8 @@
 
 #include "KX_CollisionEventManager.h"
 
+#include <algorithm>
+
 #include "KX_CollisionContactPoints.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
@@ -62,7 +64,7 @@ bool KX_CollisionEventManager::NewHandleCollision(PHY_IPhysicsController *ctrl1,
                                                   const PHY_ICollData *coll_data,
                                                   bool first)
 {
-  m_newCollisions.insert(NewCollision(ctrl1, ctrl2, coll_data, first));
+  m_newCollisions.emplace_back(ctrl1, ctrl2, coll_data, first);
 
   return false;
 }
@@ -179,34 +181,42 @@ void KX_CollisionEventManager::NextFrame()
     static_cast<SCA_CollisionSensor *>(sensor)->SynchronizeTransform();
   }
 
-  for (const NewCollision &collision : m_newCollisions) {
+  /* Several manifolds can be reported for the same pair of objects, sorting the collisions by
+   * pair key allows to notify the sensors once per pair. */
+  std::sort(m_newCollisions.begin(), m_newCollisions.end());
+
+  for (unsigned int i = 0, size = m_newCollisions.size(); i < size; ++i) {
+    const NewCollision &collision = m_newCollisions[i];
     // Controllers
     PHY_IPhysicsController *ctrl1 = collision.first;
     PHY_IPhysicsController *ctrl2 = collision.second;
-    // Sensor iterator
-    std::list<SCA_ISensor *>::iterator sit;
+    const bool newPair = (i == 0 || m_newCollisions[i - 1].key != collision.key);
 
     // First client info
-    KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
+    KX_ClientObjectInfo *client_info1 = static_cast<KX_ClientObjectInfo *>(
         ctrl1->GetNewClientInfo());
     // First gameobject
-    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info);
-    // Invoke sensor response for each object
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl1, ctrl2, nullptr);
-      }
-    }
-
+    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info1);
     // Second client info
-    client_info = static_cast<KX_ClientObjectInfo *>(ctrl2->GetNewClientInfo());
+    KX_ClientObjectInfo *client_info2 = static_cast<KX_ClientObjectInfo *>(
+        ctrl2->GetNewClientInfo());
     // Second gameobject
-    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info);
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl2, ctrl1, nullptr);
+    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info2);
+
+    // Invoke sensor response for each object
+    if (newPair) {
+      if (client_info1) {
+        for (SCA_ISensor *sensor : client_info1->m_sensors) {
+          static_cast<SCA_CollisionSensor *>(sensor)->NewHandleCollision(ctrl1, ctrl2, nullptr);
+        }
+      }
+      if (client_info2) {
+        for (SCA_ISensor *sensor : client_info2->m_sensors) {
+          static_cast<SCA_CollisionSensor *>(sensor)->NewHandleCollision(ctrl2, ctrl1, nullptr);
+        }
       }
     }
+
     // Run python callbacks
     const PHY_ICollData *colldata = collision.colldata;
     KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(colldata, collision.isFirst);
@@ -236,26 +246,15 @@ KX_CollisionEventManager::NewCollision::NewCollision(PHY_IPhysicsController *_fi
                                                      PHY_IPhysicsController *_second,
                                                      const PHY_ICollData *_colldata,
                                                      bool _isfirst)
-    : first(_first), second(_second), colldata(_colldata), isFirst(_isfirst)
-{
-}
-
-KX_CollisionEventManager::NewCollision::NewCollision(const NewCollision &to_copy)
-    : first(to_copy.first), second(to_copy.second), colldata(to_copy.colldata), isFirst(to_copy.isFirst)
+    : first(_first),
+      second(_second),
+      colldata(_colldata),
+      isFirst(_isfirst),
+      key(std::minmax(_first, _second))
 {
 }
 
 bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other) const
 {
-  // see strict weak ordering: https://support.microsoft.com/en-us/kb/949171
-  if (first == other.first) {
-    if (second == other.second) {
-      if (colldata == other.colldata) {
-        return isFirst < other.isFirst;
-      }
-      return colldata < other.colldata;
-    }
-    return second < other.second;
-  }
-  return first < other.first;
+  return key < other.key;
 }
@@ -31,7 +31,7 @@
 
 #pragma once
 
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "KX_GameObject.h"
@@ -43,7 +43,8 @@ class PHY_IPhysicsEnvironment;
 
 class KX_CollisionEventManager : public SCA_EventManager {
   /**
-   * Contains two colliding objects and the first contact point.
+   * Contains two colliding objects and their contact points, the collision data is owned by the
+   * physics environment and valid until the next physics step.
    */
   class NewCollision {
    public:
@@ -51,25 +52,20 @@ class KX_CollisionEventManager : public SCA_EventManager {
     PHY_IPhysicsController *second;
     const PHY_ICollData *colldata;
     bool isFirst;
+    /// The controllers ordered by address, identical for all the collisions of a same pair.
+    std::pair<PHY_IPhysicsController *, PHY_IPhysicsController *> key;
 
-    /**
-     * Creates a copy of the given PHY_ICollData; freeing that copy should be done by the owner of
-     * the NewCollision object.
-     *
-     * This allows us to efficiently store NewCollision objects in a std::set without creating more
-     * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't
-     * clone it again. */
     NewCollision(PHY_IPhysicsController *first,
                  PHY_IPhysicsController *second,
                  const PHY_ICollData *colldata,
                  bool isFirst);
-    NewCollision(const NewCollision &to_copy);
     bool operator<(const NewCollision &other) const;
   };
 
   PHY_IPhysicsEnvironment *m_physEnv;
 
-  std::set<NewCollision> m_newCollisions;
+  /// Collisions of the frame, sorted by pair key before being dispatched.
+  std::vector<NewCollision> m_newCollisions;
 
   static bool newCollisionResponse(void *client_data,
                                    PHY_IPhysicsController *ctrl1,
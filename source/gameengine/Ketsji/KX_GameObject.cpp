@@ -76,15 +76,24 @@ static MT_Matrix3x3 dummy_orientation = MT_Matrix3x3(
     1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
 
 KX_GameObject::ActivityCullingInfo::ActivityCullingInfo()
-    : m_flags(ACTIVITY_NONE), m_physicsRadius(0.0f), m_logicRadius(0.0f)
+    : m_flags(ACTIVITY_NONE),
+      m_physicsRadius(0.0f),
+      m_logicRadius(0.0f),
+      m_physicsCulled(false),
+      m_logicCulled(false),
+      m_position(0.0f, 0.0f, 0.0f),
+      m_slack(-1.0f),
+      m_cameraMotion(0.0)
 {
 }
 
 KX_GameObject::KX_GameObject()
     : SCA_IObject(),
       m_isReplica(false),            // eevee
+      m_pReplicaTemplateObject(nullptr),  // eevee
       m_visibleAtGameStart(false),   // eevee
       m_forceIgnoreParentTx(false),  // eevee
+      m_depsgraphSyncScheduled(false),  // eevee
       m_previousLodLevel(-1),        // eevee
       m_layer(0),
       m_lodManager(nullptr),
@@ -146,6 +155,7 @@ KX_GameObject::~KX_GameObject()
     if (ob->gameflag & OB_OVERLAY_COLLECTION) {
       ob->gameflag &= ~OB_OVERLAY_COLLECTION;
     }
+    ob->gameflag &= ~OB_CULLED;
   }
 
   if (m_pSGNode) {
@@ -248,6 +258,18 @@ void KX_GameObject::SyncTransformWithDepsgraph()
 void KX_GameObject::ForceIgnoreParentTx()
 {
   m_forceIgnoreParentTx = true;
+  // The children must be processed at next render even if this object didn't move.
+  GetScene()->AddDepsgraphSyncObject(this);
+}
+
+bool KX_GameObject::IsDepsgraphSyncScheduled() const
+{
+  return m_depsgraphSyncScheduled;
+}
+
+void KX_GameObject::SetDepsgraphSyncScheduled(bool scheduled)
+{
+  m_depsgraphSyncScheduled = scheduled;
 }
 
 void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_render_pass)
@@ -357,46 +379,37 @@ void KX_GameObject::ReplicateBlenderObject()
 
   if (ob) {
     bContext *C = KX_GetActiveEngine()->GetContext();
-    Main *bmain = CTX_data_main(C);
-    Object *newob;
-    BKE_id_copy_ex(bmain, &ob->id, (ID **)&newob, 0);
-    id_us_min(&newob->id);
-    Scene *scene = GetScene()->GetBlenderScene();
-    ViewLayer *view_layer = BKE_view_layer_default_view(scene);
-    BKE_collection_object_add_from(bmain,
-                                   scene,
-                                   BKE_view_layer_camera_find(scene, view_layer),
-                                   newob);  // add replica where is the active camera
-
-    /* Avoid to make instance_collections "containers" visibled
-     * when replicating as we want only the instances created in DupliGroupRecuse
-     * to be visibled */
-    if (!ob->instance_collection) {
-      newob->base_flag |= (BASE_ENABLED_AND_MAYBE_VISIBLE_IN_VIEWPORT |
-                           BASE_ENABLED_AND_VISIBLE_IN_DEFAULT_VIEWPORT);
-      newob->visibility_flag &= ~OB_HIDE_VIEWPORT;
-    }
+    KX_Scene *kxscene = GetScene();
+    Scene *scene = kxscene->GetBlenderScene();
 
-    /* This will call BKE_main_collection_sync_remap at frame end. */
-    GetScene()->TagForCollectionRemap();
+    /* Replicas of replicas share the pool of the first template object. */
+    Object *templateob = (m_isReplica && m_pReplicaTemplateObject) ? m_pReplicaTemplateObject : ob;
+
+    /* Reuse the Blender object of an ended replica when possible, it avoids an ID copy
+     * and a depsgraph relations update. */
+    Object *newob = kxscene->AcquirePooledReplicaObject(templateob);
+    if (!newob) {
+      newob = kxscene->NewReplicaObject(ob);
+    }
+    // The copy is culled by the next render pass only.
+    newob->gameflag &= ~OB_CULLED;
 
     /* Attempt to fix missing notifier in special cases (realtime compositor when overlay pass)
      * See: https://github.com/UPBGE/upbge/issues/1818 - Would maybe need more investigations
      * for a better fix... */
-    if (GetScene()->GetOverlayCamera()) {
+    if (kxscene->GetOverlayCamera()) {
       View3D *v3d = CTX_wm_view3d(C);
       bool is_realtime_compositor_enabled = scene->use_nodes && scene->nodetree &&
                                             v3d->shading.use_compositor !=
                                                 V3D_SHADING_USE_COMPOSITOR_DISABLED &&
                                             v3d->shading.type >= OB_MATERIAL;
       if (is_realtime_compositor_enabled) {
-        GetScene()->AppendToIdsToUpdateInOverlayPass(&scene->id, ID_RECALC_EDITORS);
+        kxscene->AppendToIdsToUpdateInOverlayPass(&scene->id, ID_RECALC_EDITORS);
       }
     }
 
-    DEG_relations_tag_update(bmain);
-
     m_pBlenderObject = newob;
+    m_pReplicaTemplateObject = templateob;
     m_isReplica = true;
   }
 }
@@ -404,11 +417,16 @@ void KX_GameObject::RemoveReplicaObject()
 {
   Object *ob = GetBlenderObject();
   if (ob && m_isReplica) {
-    bContext *C = KX_GetActiveEngine()->GetContext();
-    Main *bmain = CTX_data_main(C);
-    BKE_id_delete(bmain, ob);
+    KX_Scene *kxscene = GetScene();
+    /* During the game the Blender object is kept hidden for the next replica of the same
+     * template, it is only freed at scene exit. */
+    if (!kxscene->m_isRuntime || !kxscene->ReleaseReplicaObject(m_pReplicaTemplateObject, ob)) {
+      bContext *C = KX_GetActiveEngine()->GetContext();
+      Main *bmain = CTX_data_main(C);
+      BKE_id_delete(bmain, ob);
+      DEG_relations_tag_update(bmain);
+    }
     SetBlenderObject(nullptr);
-    DEG_relations_tag_update(bmain);
   }
 }
 
@@ -577,6 +595,8 @@ void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enab
   if (enable) {
     m_activityCullingInfo.m_flags = (ActivityCullingInfo::Flag)(m_activityCullingInfo.m_flags |
                                                                 flag);
+    // Force the evaluation of the new activity.
+    m_activityCullingInfo.m_slack = -1.0f;
   }
   else {
     m_activityCullingInfo.m_flags = (ActivityCullingInfo::Flag)(m_activityCullingInfo.m_flags &
@@ -881,6 +901,21 @@ void KX_GameObject::UpdateActionManager(float curtime, bool applyToObject)
   GetActionManager()->Update(curtime, applyToObject);
 }
 
+void KX_GameObject::UpdateActionManagerThread(float curtime, bool applyToObject)
+{
+  GetActionManager()->UpdateActions(curtime, applyToObject);
+}
+
+void KX_GameObject::UpdateActionIPOs()
+{
+  GetActionManager()->UpdateIPOs();
+}
+
+bool KX_GameObject::UpdateActionLod(bool culled, unsigned short rate)
+{
+  return GetActionManager()->UpdateLod(culled, rate);
+}
+
 float KX_GameObject::GetActionFrame(short layer)
 {
   return GetActionManager()->GetActionFrame(layer);
@@ -920,6 +955,10 @@ void KX_GameObject::ProcessReplica()
 
   m_pPhysicsController = nullptr;
   m_pSGNode = nullptr;
+  // The replica is not yet in the scene list of objects to synchronize with the depsgraph.
+  m_depsgraphSyncScheduled = false;
+  // The replica activity state is unknown, force its evaluation.
+  m_activityCullingInfo.m_slack = -1.0f;
 
   /* Dupli group and instance list are set later in replication.
    * See KX_Scene::DupliGroupRecurse. */
@@ -1093,7 +1132,13 @@ void KX_GameObject::RemoveMeshes()
 
 bool KX_GameObject::UseCulling() const
 {
-  return false;
+  // Culling uses the bounds of the evaluated mesh.
+  return m_pBlenderObject && m_pBlenderObject->type == OB_MESH;
+}
+
+SG_CullingNode &KX_GameObject::GetCullingNode()
+{
+  return m_cullingNode;
 }
 
 void KX_GameObject::SetLodManager(KX_LodManager *lodManager)
@@ -1124,36 +1169,42 @@ KX_LodManager *KX_GameObject::GetLodManager() const
   return m_lodManager;
 }
 
-void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
+short KX_GameObject::GetCurrentLodLevel() const
+{
+  return m_currentLodLevel;
+}
+
+void KX_GameObject::UpdateLod(short level)
 {
   if (!m_lodManager) {
     return;
   }
 
-  KX_Scene *scene = GetScene();
-  const float distance2 = NodeGetWorldPosition().distance2(cam_pos) * (lodfactor * lodfactor);
-  KX_LodLevel *lodLevel = m_lodManager->GetLevel(scene, m_currentLodLevel, distance2);
+  KX_LodLevel *lodLevel = m_lodManager->GetLevel(level);
+  RAS_MeshObject *mesh = lodLevel->GetMesh();
+  if (mesh != m_meshes[0]) {
+    GetScene()->ReplaceMesh(this, mesh, true, false);
+  }
+  m_currentLodLevel = level;
 
-  bool updatePhysicsShape = false;
   if (GetBlenderObject()->gameflag & OB_LOD_UPDATE_PHYSICS) {
     if (GetPhysicsController()) {
       /* As m_previousLodLevel is initialized to -1,
-       * the physics shape will be ensured on first frame
+       * the physics shape will be ensured on first update
        * to match the lodLevel or the absence of lodLevel
        */
       if (m_currentLodLevel != m_previousLodLevel) {
-        updatePhysicsShape = true;
         m_previousLodLevel = m_currentLodLevel;
+        GetPhysicsController()->ReinstancePhysicsShape(this, nullptr, false, true);
       }
     }
   }
+}
 
-  if (lodLevel) {
-    RAS_MeshObject *mesh = lodLevel->GetMesh();
-    if (mesh != m_meshes[0]) {
-      scene->ReplaceMesh(this, mesh, true, false);
-    }
-    m_currentLodLevel = lodLevel->GetLevel();
+void KX_GameObject::UpdateLodEvaluatedObject()
+{
+  if (!m_lodManager) {
+    return;
   }
 
   KX_LodLevel *currentLodLevel = m_lodManager->GetLevel(m_currentLodLevel);
@@ -1170,33 +1221,60 @@ void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
     /* Try to get the object with all modifiers applied */
     ob_eval->data = eval_lod_ob->data;
   }
+}
 
-  if (updatePhysicsShape) {
-    GetPhysicsController()->ReinstancePhysicsShape(this, nullptr, false, true);
-  }
+/** Compute the culled state of an activity using an hysteresis band and return the distance
+ * the object can move before changing of state. */
+static float update_activity_culled(float distance, float radius, float hysteresis, bool &culled)
+{
+  // A culled activity is restored inside the radius, an active one is culled beyond the band.
+  culled = distance > (culled ? radius : radius + hysteresis);
+  return culled ? distance - radius : radius + hysteresis - distance;
 }
 
-void KX_GameObject::UpdateActivity(float distance)
+void KX_GameObject::UpdateActivity(float distance, float hysteresis, double cameraMotion)
 {
+  ActivityCullingInfo &info = m_activityCullingInfo;
+  const bool force = (info.m_slack < 0.0f);
+  distance = std::sqrt(distance);
+
+  float slack = FLT_MAX;
+
   // Manage physics culling.
-  if (m_activityCullingInfo.m_flags & ActivityCullingInfo::ACTIVITY_PHYSICS) {
-    if (distance > m_activityCullingInfo.m_physicsRadius) {
-      SuspendPhysics(false, false);
-    }
-    else {
-      RestorePhysics(false);
+  if (info.m_flags & ActivityCullingInfo::ACTIVITY_PHYSICS) {
+    const bool culled = info.m_physicsCulled;
+    const float radius = std::sqrt(info.m_physicsRadius);
+    slack = std::min(slack,
+                     update_activity_culled(distance, radius, hysteresis, info.m_physicsCulled));
+    if (force || culled != info.m_physicsCulled) {
+      if (info.m_physicsCulled) {
+        SuspendPhysics(false, false);
+      }
+      else {
+        RestorePhysics(false);
+      }
     }
   }
 
   // Manage logic culling.
-  if (m_activityCullingInfo.m_flags & ActivityCullingInfo::ACTIVITY_LOGIC) {
-    if (distance > m_activityCullingInfo.m_logicRadius) {
-      SuspendLogicAndActions(false);
-    }
-    else {
-      RestoreLogicAndActions(false);
+  if (info.m_flags & ActivityCullingInfo::ACTIVITY_LOGIC) {
+    const bool culled = info.m_logicCulled;
+    const float radius = std::sqrt(info.m_logicRadius);
+    slack = std::min(slack,
+                     update_activity_culled(distance, radius, hysteresis, info.m_logicCulled));
+    if (force || culled != info.m_logicCulled) {
+      if (info.m_logicCulled) {
+        SuspendLogicAndActions(false);
+      }
+      else {
+        RestoreLogicAndActions(false);
+      }
     }
   }
+
+  info.m_position = NodeGetWorldPosition();
+  info.m_slack = slack;
+  info.m_cameraMotion = cameraMotion;
 }
 
 void KX_GameObject::UpdateTransform()
@@ -2920,11 +2998,11 @@ PyObject *KX_GameObject::pyattr_get_life(EXP_PyObjectPlus *self_v,
 {
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
 
-  EXP_Value *life = self->GetProperty("::timebomb");
-  if (life)
-    // this convert the timebomb seconds to frames, hard coded 60.0f (assuming 60fps)
+  float life;
+  if (self->GetScene()->GetTempObjectLife(self, life))
+    // this convert the life seconds to frames, hard coded 60.0f (assuming 60fps)
     // value hardcoded in KX_Scene::AddReplicaObject()
-    return PyFloat_FromDouble(life->GetNumber() * 60.0);
+    return PyFloat_FromDouble(life * 60.0);
   else
     Py_RETURN_NONE;
 }
@@ -3238,6 +3316,7 @@ int KX_GameObject::pyattr_set_physicsCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_physicsRadius = val * val;
+  self->GetActivityCullingInfo().m_slack = -1.0f;
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3263,6 +3342,7 @@ int KX_GameObject::pyattr_set_logicCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_logicRadius = val * val;
+  self->GetActivityCullingInfo().m_slack = -1.0f;
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -49,6 +49,7 @@
 #include "MT_Transform.h"
 #include "SCA_IObject.h"
 #include "SCA_LogicManager.h" /* for ConvertPythonToGameObject to search object names */
+#include "SG_CullingNode.h"
 #include "SG_Node.h"
 
 // Forward declarations.
@@ -100,14 +101,29 @@ class KX_GameObject : public SCA_IObject {
     float m_physicsRadius;
     /// Squared logic culling radius.
     float m_logicRadius;
+
+    /// True when the physics or logic is suspended by the activity culling.
+    bool m_physicsCulled;
+    bool m_logicCulled;
+    /// Object position at the last activity evaluation.
+    MT_Vector3 m_position;
+    /** Distance the object and the cameras can move since the last evaluation before
+     * crossing a culling radius, negative to force the evaluation. */
+    float m_slack;
+    /// Scene cameras motion at the last activity evaluation, see KX_Scene::UpdateObjectActivity.
+    double m_cameraMotion;
   };
 
  protected:
   /* EEVEE INTEGRATION */
   float m_prevobject_to_world[4][4];
   bool m_isReplica;
+  /// The non replica Blender object this object was copied from, key of the scene replica pool.
+  struct Object *m_pReplicaTemplateObject;
   bool m_visibleAtGameStart;
   bool m_forceIgnoreParentTx;
+  /// True when the object is in the scene list of objects to synchronize with the depsgraph.
+  bool m_depsgraphSyncScheduled;
   short m_previousLodLevel;
   /* END OF EEVEE INTEGRATION */
 
@@ -131,6 +147,9 @@ class KX_GameObject : public SCA_IObject {
   // Object activity culling settings converted from blender objects.
   ActivityCullingInfo m_activityCullingInfo;
 
+  // Bounding box and culling state for the camera rendered last.
+  SG_CullingNode m_cullingNode;
+
   PHY_IPhysicsController *m_pPhysicsController;
   SG_Node *m_pSGNode;
 
@@ -163,6 +182,8 @@ class KX_GameObject : public SCA_IObject {
   void AddDummyLodManager(RAS_MeshObject *meshObj, Object *ob);
   bool IsReplica();
   void ForceIgnoreParentTx();
+  bool IsDepsgraphSyncScheduled() const;
+  void SetDepsgraphSyncScheduled(bool scheduled);
   void SyncTransformWithDepsgraph();
   void SetIsReplicaObject();
   float *GetPrevObjectMatToWorld();
@@ -335,6 +356,22 @@ class KX_GameObject : public SCA_IObject {
    */
   void UpdateActionManager(float curtime, bool applyObject);
 
+  /**
+   * Update the object's actions without synchronizing the scene graph, it can
+   * be called from a thread. UpdateActionIPOs must be called after in the main thread.
+   * \param curtime The current time used to compute the actions frame.
+   * \param applyObject Set to true if the actions must transform this object.
+   */
+  void UpdateActionManagerThread(float curtime, bool applyObject);
+  void UpdateActionIPOs();
+
+  /**
+   * Compute if the actions must transform this object for the next update.
+   * \param culled Set to true if the object is not visible.
+   * \param rate The actions transform the object once every rate updates.
+   */
+  bool UpdateActionLod(bool culled, unsigned short rate);
+
   /*********************************
    * End Animation API
    *********************************/
@@ -652,15 +689,23 @@ class KX_GameObject : public SCA_IObject {
   /// Get current lod manager.
   KX_LodManager *GetLodManager() const;
 
+  short GetCurrentLodLevel() const;
+
   /**
-   * Updates the current lod level based on distance from camera.
+   * Use a new lod level, selected by the scene from the distance to the camera.
+   * \param level The lod level index in the lod manager.
    */
-  void UpdateLod(const MT_Vector3 &cam_pos, float lodfactor);
+  void UpdateLod(short level);
+  /// Make the evaluated object render the mesh of the current lod level.
+  void UpdateLodEvaluatedObject();
 
-  /** Update the activity culling of the object.
+  /** Update the activity culling of the object, the physics and logic are only suspended
+   * or restored when the object leaves or enters the culling radius.
    * \param distance Squared nearest distance to the cameras of this object.
+   * \param hysteresis Distance beyond the culling radius to reach before being suspended.
+   * \param cameraMotion Current scene cameras motion.
    */
-  void UpdateActivity(float distance);
+  void UpdateActivity(float distance, float hysteresis, double cameraMotion);
 
   /**
    * Pick out a mesh associated with the integer 'num'.
@@ -682,6 +727,8 @@ class KX_GameObject : public SCA_IObject {
   /// Return true when the object can be culled.
   bool UseCulling() const;
 
+  SG_CullingNode &GetCullingNode();
+
   /**
    * Was this object marked visible? (only for the explicit
    * visibility system).
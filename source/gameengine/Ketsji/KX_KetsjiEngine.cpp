@@ -153,6 +153,9 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_overrideCamZoom(1.0f),
       m_logger(KX_TimeCategoryLogger(m_clock, 25)),
       m_average_framerate(0.0),
+      m_depsgraphSyncedObjects(0),
+      m_cullingOccluders(0),
+      m_culledObjects(0),
       m_showBoundingBox(KX_DebugOption::DISABLE),
       m_showArmature(KX_DebugOption::DISABLE),
       m_showCameraFrustum(KX_DebugOption::DISABLE),
@@ -211,6 +214,17 @@ void KX_KetsjiEngine::EndCountDepsgraphTime()
   m_logger.StartLog(tc_rasterizer);
 }
 
+void KX_KetsjiEngine::AddDepsgraphSyncedObjects(unsigned int count)
+{
+  m_depsgraphSyncedObjects += count;
+}
+
+void KX_KetsjiEngine::AddCullingStats(unsigned int occluders, unsigned int culled)
+{
+  m_cullingOccluders += occluders;
+  m_culledObjects += culled;
+}
+
 std::vector<KX_Camera *> KX_KetsjiEngine::GetRenderingCameras()
 {
   return m_renderingCameras;
@@ -300,6 +314,9 @@ void KX_KetsjiEngine::EndFrame()
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
+  m_depsgraphSyncedObjects = 0;
+  m_cullingOccluders = 0;
+  m_culledObjects = 0;
 
   m_logger.StartLog(tc_rasterizer);
   m_rasterizer->EndFrame();
@@ -345,6 +362,9 @@ void KX_KetsjiEngine::EndFrameViewportRender()
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
+  m_depsgraphSyncedObjects = 0;
+  m_cullingOccluders = 0;
+  m_culledObjects = 0;
 
   m_logger.StartLog(tc_rasterizer);
   // m_rasterizer->EndFrame();
@@ -760,6 +780,30 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
   return renderpereye;
 }
 
+void KX_KetsjiEngine::AddCameraVisibilities(const std::vector<FrameRenderData> &frameDataList)
+{
+  for (const FrameRenderData &frameData : frameDataList) {
+    for (const SceneRenderData &sceneFrameData : frameData.m_sceneDataList) {
+      KX_Scene *scene = sceneFrameData.m_scene;
+      for (const CameraRenderData &cameraFrameData : sceneFrameData.m_cameraDataList) {
+        KX_Camera *rendercam = cameraFrameData.m_renderCamera;
+        const bool isOverlayPass = (rendercam == scene->GetOverlayCamera());
+        // Same viewport size as in KX_Scene::RenderAfterCameraSetup.
+        const bool customViewport = rendercam->GetViewport() && !isOverlayPass;
+        const RAS_Rect &viewport = cameraFrameData.m_viewport;
+
+        scene->AddCameraVisibility(
+            rendercam,
+            isOverlayPass ? rendercam : cameraFrameData.m_cullingCamera,
+            customViewport ? viewport.GetWidth() : m_canvas->GetWidth(),
+            customViewport ? viewport.GetHeight() : m_canvas->GetHeight(),
+            isOverlayPass,
+            true);
+      }
+    }
+  }
+}
+
 void KX_KetsjiEngine::Render()
 {
   m_logger.StartLog(tc_rasterizer);
@@ -775,6 +819,11 @@ void KX_KetsjiEngine::Render()
   std::vector<FrameRenderData> frameDataList;
   GetFrameRenderData(frameDataList);
 
+  // The viewport render draws with the blender viewport, without culling or lod.
+  if (!UseViewportRender()) {
+    AddCameraVisibilities(frameDataList);
+  }
+
   KX_Scene *firstscene = m_scenes->GetFront();
   const RAS_FrameSettings &framesettings = firstscene->GetFramingType();
 
@@ -805,6 +854,10 @@ void KX_KetsjiEngine::Render()
     }
   }
 
+  for (KX_Scene *scene : m_scenes) {
+    scene->ClearCameraVisibilities();
+  }
+
   if (!UseViewportRender()) {
     /* Clear the entire screen (draw a black background rect before drawing) */
     ARegion *region = CTX_wm_region(m_context);
@@ -1312,6 +1365,26 @@ void KX_KetsjiEngine::RenderDebugProperties()
           MT_Vector2(xcoord + (int)(2.2 * profile_indent), ycoord), boxSize, white);
       ycoord += const_ysize;
     }
+
+    // Objects synchronized with the depsgraph in this frame
+    debugDraw.RenderText2D("Synced objects:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+    debugtxt = (boost::format("%d") % m_depsgraphSyncedObjects).str();
+    debugDraw.RenderText2D(
+        debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+    ycoord += const_ysize;
+
+    // Occluders rasterized and objects culled for all the cameras in this frame
+    debugDraw.RenderText2D("Occluders:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+    debugtxt = (boost::format("%d") % m_cullingOccluders).str();
+    debugDraw.RenderText2D(
+        debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+    ycoord += const_ysize;
+
+    debugDraw.RenderText2D("Culled objects:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+    debugtxt = (boost::format("%d") % m_culledObjects).str();
+    debugDraw.RenderText2D(
+        debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+    ycoord += const_ysize;
   }
   // Add the ymargin for titles below the other section of debug info
   ycoord += title_y_top_margin;
@@ -233,6 +233,11 @@ class KX_KetsjiEngine {
   static const std::string m_profileLabels[tc_numCategories];
   /// Last estimated framerate
   double m_average_framerate;
+  /// Number of objects synchronized with the depsgraph during the current frame.
+  unsigned int m_depsgraphSyncedObjects;
+  /// Number of occluders rasterized and objects culled during the current frame.
+  unsigned int m_cullingOccluders;
+  unsigned int m_culledObjects;
 
   /// Enable debug draw of culling bounding boxes.
   KX_DebugOption m_showBoundingBox;
@@ -260,6 +265,8 @@ class KX_KetsjiEngine {
                                        bool usestereo);
   /// Compute frame render data per eyes (in case of stereo), scenes and camera.
   bool GetFrameRenderData(std::vector<FrameRenderData> &frameDataList);
+  /// Register the render passes of each scene, their visibility is computed in parallel.
+  void AddCameraVisibilities(const std::vector<FrameRenderData> &frameDataList);
 
   /// EEVEE scene rendering
   void RenderCamera(KX_Scene *scene, class RAS_FrameBuffer *background_fb, const CameraRenderData &cameraFrameData, unsigned short pass);
@@ -303,6 +310,10 @@ class KX_KetsjiEngine {
   // include depsgraph time in tc_depsgraph category
   void CountDepsgraphTime();
   void EndCountDepsgraphTime();
+  // count objects with transform synchronized with the depsgraph, shown in profile
+  void AddDepsgraphSyncedObjects(unsigned int count);
+  // count occluders rasterized and objects hidden by the culling, shown in profile
+  void AddCullingStats(unsigned int occluders, unsigned int culled);
   void EndFrameViewportRender();
   std::vector<KX_Camera *> GetRenderingCameras();
   /***** End of EEVEE integration *****/
@@ -42,14 +42,17 @@ KX_LodManager::LodLevelIterator::LodLevelIterator(const std::vector<KX_LodLevel
 {
 }
 
-inline float KX_LodManager::LodLevelIterator::GetHysteresis(unsigned short level) const
+/// Get the hysteresis distance of a level from the level or the scene.
+static float lod_level_hysteresis(const std::vector<KX_LodLevel *> &levels,
+                                  unsigned short level,
+                                  KX_Scene *scene)
 {
-  if (level < 1 || !m_scene->IsActivedLodHysteresis()) {
+  if (level < 1 || !scene->IsActivedLodHysteresis()) {
     return 0.0f;
   }
 
-  KX_LodLevel *lod = m_levels[level];
-  KX_LodLevel *prelod = m_levels[level - 1];
+  KX_LodLevel *lod = levels[level];
+  KX_LodLevel *prelod = levels[level - 1];
 
   float hysteresis = 0.0f;
   // if exists, LoD level hysteresis will override scene hysteresis
@@ -57,12 +60,17 @@ inline float KX_LodManager::LodLevelIterator::GetHysteresis(unsigned short level
     hysteresis = lod->GetHysteresis() / 100.0f;
   }
   else {
-    hysteresis = m_scene->GetLodHysteresisValue() / 100.0f;
+    hysteresis = scene->GetLodHysteresisValue() / 100.0f;
   }
 
   return MT_abs(prelod->GetDistance() - lod->GetDistance()) * hysteresis;
 }
 
+inline float KX_LodManager::LodLevelIterator::GetHysteresis(unsigned short level) const
+{
+  return lod_level_hysteresis(m_levels, level, m_scene);
+}
+
 inline int KX_LodManager::LodLevelIterator::operator++()
 {
   return m_index++;
@@ -169,6 +177,24 @@ KX_LodLevel *KX_LodManager::GetLevel(unsigned int index) const
   return m_levels[index];
 }
 
+float KX_LodManager::GetDistanceFactor() const
+{
+  return m_distanceFactor;
+}
+
+void KX_LodManager::GetLevelThresholds(KX_Scene *scene, float *up, float *down) const
+{
+  const unsigned short count = m_levels.size();
+  for (unsigned short i = 0; i < count; ++i) {
+    // Same distances as LodLevelIterator comparison operators.
+    up[i] = (i == count - 1) ?
+                FLT_MAX :
+                square_f(m_levels[i + 1]->GetDistance() +
+                         lod_level_hysteresis(m_levels, i + 1, scene));
+    down[i] = square_f(m_levels[i]->GetDistance() - lod_level_hysteresis(m_levels, i, scene));
+  }
+}
+
 KX_LodLevel *KX_LodManager::GetLevel(KX_Scene *scene, short previouslod, float distance2)
 {
   if (m_levels.size() == 1) {
@@ -67,12 +67,6 @@ class KX_LodManager : public EXP_Value {
 
   std::vector<KX_LodLevel *> m_levels;
 
-  /** Get the hysteresis from the level or the scene.
-   * \param scene Scene used to get default hysteresis.
-   * \param level Level index used to get hysteresis.
-   */
-  float GetHysteresis(KX_Scene *scene, unsigned short level);
-
   int m_refcount;
 
   /// Factor applied to the distance from the camera to the object.
@@ -98,6 +92,16 @@ class KX_LodManager : public EXP_Value {
    */
   KX_LodLevel *GetLevel(unsigned int index) const;
 
+  /// Return the factor applied to the distance from the camera to the object.
+  float GetDistanceFactor() const;
+
+  /** Get the squared distances used to select the lod levels, see KX_LodTable.
+   * \param scene Scene used to get default hysteresis.
+   * \param up Squared distance to reach the next level, per level.
+   * \param down Squared distance below which the previous level is used, per level.
+   */
+  void GetLevelThresholds(KX_Scene *scene, float *up, float *down) const;
+
   /** Get lod level cooresponding to distance and previous level.
    * \param scene Scene used to get default hysteresis.
    * \param previouslod Previous lod computed by this function before.
@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/Ketsji/KX_LodTable.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_LodTable.h"
+
+#include <algorithm>
+
+#include "KX_GameObject.h"
+#include "KX_LodManager.h"
+
+KX_LodTable::KX_LodTable() : m_unusedThresholds(0), m_invalid(true), m_modified(false)
+{
+}
+
+void KX_LodTable::Invalidate()
+{
+  m_invalid = true;
+}
+
+void KX_LodTable::AddRow(KX_GameObject *gameobj, KX_Scene *scene)
+{
+  KX_LodManager *lodManager = gameobj->GetLodManager();
+  const unsigned short count = lodManager->GetLevelCount();
+  const unsigned int offset = m_up.size();
+  const float factor = lodManager->GetDistanceFactor();
+
+  m_objects.push_back(gameobj);
+  m_factors.push_back(factor * factor);
+  m_offsets.push_back(offset);
+  m_counts.push_back(count);
+  // Force the level to be applied at the first update.
+  m_levels.push_back(-1);
+  for (unsigned short i = 0; i < 3; ++i) {
+    m_positions[i].push_back(0.0f);
+  }
+
+  m_up.resize(offset + count);
+  m_down.resize(offset + count);
+  lodManager->GetLevelThresholds(scene, &m_up[offset], &m_down[offset]);
+}
+
+void KX_LodTable::Build(const std::vector<KX_GameObject *> &objects, KX_Scene *scene)
+{
+  m_objects.clear();
+  m_factors.clear();
+  m_offsets.clear();
+  m_counts.clear();
+  m_levels.clear();
+  m_up.clear();
+  m_down.clear();
+  for (unsigned short i = 0; i < 3; ++i) {
+    m_positions[i].clear();
+  }
+  m_unusedThresholds = 0;
+
+  for (KX_GameObject *gameobj : objects) {
+    if (gameobj->GetLodManager()) {
+      AddRow(gameobj, scene);
+    }
+  }
+
+  m_invalid = false;
+}
+
+void KX_LodTable::Compact()
+{
+  std::vector<float> up;
+  std::vector<float> down;
+  up.reserve(m_up.size() - m_unusedThresholds);
+  down.reserve(m_down.size() - m_unusedThresholds);
+
+  for (unsigned int n = 0, size = m_objects.size(); n < size; ++n) {
+    const unsigned int offset = m_offsets[n];
+    const unsigned short count = m_counts[n];
+    m_offsets[n] = up.size();
+    up.insert(up.end(), m_up.begin() + offset, m_up.begin() + offset + count);
+    down.insert(down.end(), m_down.begin() + offset, m_down.begin() + offset + count);
+  }
+
+  m_up.swap(up);
+  m_down.swap(down);
+  m_unusedThresholds = 0;
+}
+
+void KX_LodTable::AddObject(KX_GameObject *gameobj, KX_Scene *scene)
+{
+  // The next build reads all the objects.
+  if (m_invalid) {
+    return;
+  }
+
+  // The lod manager of the object could have changed.
+  RemoveObject(gameobj);
+  if (gameobj->GetLodManager()) {
+    AddRow(gameobj, scene);
+    m_modified = true;
+  }
+}
+
+void KX_LodTable::RemoveObject(KX_GameObject *gameobj)
+{
+  if (m_invalid) {
+    return;
+  }
+
+  std::vector<KX_GameObject *>::iterator it = std::find(
+      m_objects.begin(), m_objects.end(), gameobj);
+  if (it == m_objects.end()) {
+    return;
+  }
+
+  const unsigned int n = it - m_objects.begin();
+  const unsigned int last = m_objects.size() - 1;
+  m_unusedThresholds += m_counts[n];
+
+  // The thresholds of the last row stay in place, only its offset is moved.
+  m_objects[n] = m_objects[last];
+  m_factors[n] = m_factors[last];
+  m_offsets[n] = m_offsets[last];
+  m_counts[n] = m_counts[last];
+  m_levels[n] = m_levels[last];
+  m_objects.pop_back();
+  m_factors.pop_back();
+  m_offsets.pop_back();
+  m_counts.pop_back();
+  m_levels.pop_back();
+  for (unsigned short i = 0; i < 3; ++i) {
+    m_positions[i][n] = m_positions[i][last];
+    m_positions[i].pop_back();
+  }
+
+  if (m_unusedThresholds > m_up.size() / 2) {
+    Compact();
+  }
+
+  m_modified = true;
+}
+
+void KX_LodTable::Prepare(const std::vector<KX_GameObject *> &objects, KX_Scene *scene)
+{
+  if (m_invalid) {
+    Build(objects, scene);
+  }
+  m_modified = false;
+
+  for (unsigned int n = 0, size = m_objects.size(); n < size; ++n) {
+    const MT_Vector3 &position = m_objects[n]->NodeGetWorldPosition();
+    m_positions[0][n] = position.x();
+    m_positions[1][n] = position.y();
+    m_positions[2][n] = position.z();
+  }
+}
+
+void KX_LodTable::Select(const MT_Vector3 &campos,
+                         float lodfactor,
+                         std::vector<float> &distances,
+                         std::vector<short> &levels) const
+{
+  const unsigned int size = m_objects.size();
+  distances.resize(size);
+  levels.resize(size);
+
+  // Squared distances of all objects, the loop over contiguous arrays is vectorized.
+  {
+    const float *__restrict px = m_positions[0].data();
+    const float *__restrict py = m_positions[1].data();
+    const float *__restrict pz = m_positions[2].data();
+    const float *__restrict factors = m_factors.data();
+    float *__restrict dist = distances.data();
+    const float cx = campos.x();
+    const float cy = campos.y();
+    const float cz = campos.z();
+    const float camfactor = lodfactor * lodfactor;
+
+    for (unsigned int n = 0; n < size; ++n) {
+      const float dx = px[n] - cx;
+      const float dy = py[n] - cy;
+      const float dz = pz[n] - cz;
+      dist[n] = (dx * dx + dy * dy + dz * dz) * camfactor * factors[n];
+    }
+  }
+
+  for (unsigned int n = 0; n < size; ++n) {
+    const short previous = m_levels[n];
+    const unsigned short count = m_counts[n];
+    const float *up = &m_up[m_offsets[n]];
+    const float *down = &m_down[m_offsets[n]];
+    const float distance = distances[n];
+
+    /* Same selection as KX_LodManager::GetLevel: move to the next levels while the distance
+     * reaches their threshold, else to the previous levels while it is below theirs. */
+    short level = (previous == -1) ?
+                      std::min<short>(m_objects[n]->GetCurrentLodLevel(), count - 1) :
+                      previous;
+    if (distance >= up[level]) {
+      while (level < count - 1 && distance >= up[level]) {
+        ++level;
+      }
+    }
+    else {
+      while (level > 0 && distance < down[level]) {
+        --level;
+      }
+    }
+
+    levels[n] = level;
+  }
+}
+
+bool KX_LodTable::Apply(const std::vector<short> &levels)
+{
+  const unsigned int size = m_objects.size();
+  if (m_invalid || m_modified || levels.size() != size) {
+    return false;
+  }
+
+  for (unsigned int n = 0; n < size; ++n) {
+    KX_GameObject *gameobj = m_objects[n];
+    if (levels[n] != m_levels[n]) {
+      m_levels[n] = levels[n];
+      gameobj->UpdateLod(levels[n]);
+    }
+    gameobj->UpdateLodEvaluatedObject();
+  }
+
+  return true;
+}
+
+void KX_LodTable::Update(const std::vector<KX_GameObject *> &objects,
+                         KX_Scene *scene,
+                         const MT_Vector3 &campos,
+                         float lodfactor)
+{
+  Prepare(objects, scene);
+  Select(campos, lodfactor, m_distances, m_selectedLevels);
+  Apply(m_selectedLevels);
+}
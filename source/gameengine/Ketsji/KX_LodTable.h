@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file KX_LodTable.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "MT_Vector3.h"
+
+class KX_GameObject;
+class KX_Scene;
+
+/**
+ * Packed table of the objects using levels of detail in a scene.
+ * The level thresholds of all objects are stored in flat arrays, the distances to the
+ * camera are computed in a single loop over the object positions and the level of each
+ * object is selected without any virtual call. Only the objects whose level changed
+ * swap their mesh. Objects added or removed update only their own row.
+ */
+class KX_LodTable {
+ private:
+  std::vector<KX_GameObject *> m_objects;
+  /// Squared distance factor of each object lod manager.
+  std::vector<float> m_factors;
+  /// Index of the first level of each object in m_up and m_down.
+  std::vector<unsigned int> m_offsets;
+  /// Number of levels of each object.
+  std::vector<unsigned short> m_counts;
+  /// Current level of each object.
+  std::vector<short> m_levels;
+  /// Squared distance to reach the next level and to go back to the previous level.
+  std::vector<float> m_up;
+  std::vector<float> m_down;
+
+  /// Object positions, filled by Prepare.
+  std::vector<float> m_positions[3];
+  /// Squared distances and levels selected by Update.
+  std::vector<float> m_distances;
+  std::vector<short> m_selectedLevels;
+
+  /// Number of thresholds in m_up and m_down left by removed rows.
+  unsigned int m_unusedThresholds;
+
+  /// True when the table must be rebuilt from the scene objects.
+  bool m_invalid;
+  /// True when rows were added or removed since the last Prepare.
+  bool m_modified;
+
+  void Build(const std::vector<KX_GameObject *> &objects, KX_Scene *scene);
+  void AddRow(KX_GameObject *gameobj, KX_Scene *scene);
+  /// Pack the thresholds of the rows without the ones of the removed rows.
+  void Compact();
+
+ public:
+  KX_LodTable();
+  ~KX_LodTable() = default;
+
+  /// Rebuild the table at the next update, e.g. when the hysteresis changed.
+  void Invalidate();
+
+  /// Add the row of an object, or replace it when the object lod manager changed.
+  void AddObject(KX_GameObject *gameobj, KX_Scene *scene);
+  /// Remove the row of an object, the last row takes its place.
+  void RemoveObject(KX_GameObject *gameobj);
+
+  /**
+   * Rebuild the table if needed and store the object positions, must be called before Select.
+   * \param objects The scene objects using levels of detail.
+   */
+  void Prepare(const std::vector<KX_GameObject *> &objects, KX_Scene *scene);
+
+  /**
+   * Select the lod level of all the objects for a camera without applying them, several
+   * cameras can be processed in parallel.
+   * \param campos The camera position.
+   * \param lodfactor The camera distance factor.
+   * \param distances Storage for the squared distances of the objects.
+   * \param levels The selected levels.
+   */
+  void Select(const MT_Vector3 &campos,
+              float lodfactor,
+              std::vector<float> &distances,
+              std::vector<short> &levels) const;
+
+  /**
+   * Apply the levels returned by Select.
+   * \return False if the table was invalidated or modified since the levels were selected.
+   */
+  bool Apply(const std::vector<short> &levels);
+
+  /// Prepare, select and apply the lod levels of all the objects for a camera.
+  void Update(const std::vector<KX_GameObject *> &objects,
+              KX_Scene *scene,
+              const MT_Vector3 &campos,
+              float lodfactor);
+};
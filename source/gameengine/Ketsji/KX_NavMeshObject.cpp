@@ -33,6 +33,7 @@
 #include "BLI_sort.h"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_meshdata_types.h"
+#include "DNA_scene_types.h"
 #include "MEM_guardedalloc.h"
 
 #include "BL_Converter.h"
@@ -40,13 +41,17 @@
 #include "DetourStatNavMeshBuilder.h"
 #include "KX_Globals.h"
 #include "KX_ObstacleSimulation.h"
+#include "KX_PathQueryManager.h"
 #include "KX_PyMath.h"
+#include "KX_Scene.h"
 #include "RAS_IVertex.h"
 #include "RAS_Polygon.h"
 #include "Recast.h"
 
 #define MAX_PATH_LEN 256
 static const float polyPickExt[3] = {2, 4, 2};
+/// Quantization step of the tiled navigation mesh vertices.
+static const float tileCellSize = 0.05f;
 
 static void calcMeshBounds(const float *vert, int nverts, float *bmin, float *bmax)
 {
@@ -575,14 +580,18 @@ static int polyFindVertex(const unsigned short *p,
   return res;
 }
 
-KX_NavMeshObject::KX_NavMeshObject() : KX_GameObject(), m_navMesh(nullptr)
+KX_NavMeshObject::KX_NavMeshObject()
+    : KX_GameObject(),
+      m_navMesh(nullptr),
+      m_tiledNavMesh(nullptr),
+      m_tileBuilder(nullptr),
+      m_tileRange{0, 0, -1, -1}
 {
 }
 
 KX_NavMeshObject::~KX_NavMeshObject()
 {
-  if (m_navMesh)
-    delete m_navMesh;
+  FreeNavMesh();
 }
 
 KX_PythonProxy *KX_NavMeshObject::NewInstance()
@@ -593,7 +602,10 @@ KX_PythonProxy *KX_NavMeshObject::NewInstance()
 void KX_NavMeshObject::ProcessReplica()
 {
   KX_GameObject::ProcessReplica();
-  m_navMesh = nullptr; /* without this, building frees the navmesh we copied from */
+  /* without this, building frees the navmesh we copied from */
+  m_navMesh = nullptr;
+  m_tiledNavMesh = nullptr;
+  m_tileBuilder = nullptr;
   if (!BuildNavMesh()) {
     CM_FunctionError("unable to build navigation mesh");
     return;
@@ -780,18 +792,163 @@ bool KX_NavMeshObject::BuildVertIndArrays(float *&vertices,
   return true;
 }
 
-bool KX_NavMeshObject::BuildNavMesh()
+void KX_NavMeshObject::FreeNavMesh()
 {
   if (m_navMesh) {
     delete m_navMesh;
     m_navMesh = nullptr;
   }
 
+  // Wait for the background builds before releasing the tiles.
+  if (m_tileBuilder) {
+    delete m_tileBuilder;
+    m_tileBuilder = nullptr;
+  }
+  if (m_tiledNavMesh) {
+    delete m_tiledNavMesh;
+    m_tiledNavMesh = nullptr;
+  }
+}
+
+bool KX_NavMeshObject::BuildTileSource(KX_NavMeshTileBuilder::Source &source)
+{
+  float *vertices = nullptr, *dvertices = nullptr;
+  unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
+  int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
+  int vertsPerPoly = 0;
+  const bool built = BuildVertIndArrays(vertices,
+                                        nverts,
+                                        polys,
+                                        npolys,
+                                        dmeshes,
+                                        dvertices,
+                                        ndvertsuniq,
+                                        dtris,
+                                        ndtris,
+                                        vertsPerPoly) &&
+                     vertsPerPoly >= 3 && nverts > 0 && npolys > 0;
+
+  if (built) {
+    if (dmeshes == nullptr) {
+      for (int i = 0; i < nverts; i++) {
+        flipAxes(&vertices[i * 3]);
+      }
+    }
+
+    source.vertsPerPoly = vertsPerPoly;
+    source.verts.assign(vertices, vertices + nverts * 3);
+    source.polys.resize(npolys * vertsPerPoly);
+    source.polyTris.resize(npolys + 1);
+    for (int i = 0; i < npolys; i++) {
+      const unsigned short *p = &polys[i * vertsPerPoly * 2];
+      const int nv = polyNumVerts(p, vertsPerPoly);
+      std::copy(p, p + vertsPerPoly, &source.polys[i * vertsPerPoly]);
+      source.polyTris[i] = source.tris.size() / 9;
+
+      if (dmeshes) {
+        const unsigned short *dmesh = &dmeshes[i * 4];
+        for (int j = 0; j < dmesh[3]; j++) {
+          const unsigned short *t = &dtris[(dmesh[2] + j) * 3 * 2];
+          for (int k = 0; k < 3; k++) {
+            const float *v = (t[k] < nv) ? &vertices[p[t[k]] * 3] :
+                                           &dvertices[(dmesh[0] + t[k] - nv) * 3];
+            source.tris.insert(source.tris.end(), v, v + 3);
+          }
+        }
+      }
+      else {
+        // The detailed mesh is fake, use the polygon triangles.
+        for (int j = 1; j < nv - 1; j++) {
+          for (const int k : {0, j, j + 1}) {
+            const float *v = &vertices[p[k] * 3];
+            source.tris.insert(source.tris.end(), v, v + 3);
+          }
+        }
+      }
+    }
+    source.polyTris[npolys] = source.tris.size() / 9;
+    calcMeshBounds(vertices, nverts, source.bmin, source.bmax);
+  }
+  else {
+    CM_Error("can't build navigation mesh data for object: " << m_name);
+  }
+
+  if (vertices) {
+    delete[] vertices;
+  }
+  if (dvertices) {
+    delete[] dvertices;
+  }
+  if (polys) {
+    MEM_freeN(polys);
+  }
+  if (dmeshes) {
+    MEM_freeN(dmeshes);
+  }
+  if (dtris) {
+    MEM_freeN(dtris);
+  }
+
+  return built;
+}
+
+bool KX_NavMeshObject::BuildTiledNavMesh(float tileSize)
+{
+  KX_NavMeshTileBuilder::Source source;
+  if (!BuildTileSource(source)) {
+    return false;
+  }
+
+  m_tileBuilder = new KX_NavMeshTileBuilder(source.bmin, tileSize, tileCellSize);
+  int minx, miny, maxx, maxy;
+  m_tileBuilder->GetTileRange(source.bmin, source.bmax, minx, miny, maxx, maxy);
+  if ((maxx - minx + 1) * (maxy - miny + 1) > DT_MAX_TILES) {
+    CM_Error("navigation mesh of object " << m_name << " needs more than " << DT_MAX_TILES
+                                          << " tiles, increase the tile size");
+    delete m_tileBuilder;
+    m_tileBuilder = nullptr;
+    return false;
+  }
+
+  /* The portal height is the height difference allowed between the polygons linked at a
+   * tile border. */
+  const RecastData &recastData = GetScene()->GetBlenderScene()->gm.recastData;
+  m_tiledNavMesh = new dtTiledNavMesh;
+  m_tiledNavMesh->init(m_tileBuilder->GetOrigin(),
+                       m_tileBuilder->GetTileSize(),
+                       std::max(recastData.agentmaxclimb, tileCellSize));
+
+  std::vector<KX_NavMeshTileBuilder::Tile> tiles;
+  m_tileBuilder->BuildTiles(source, minx, miny, maxx, maxy, tiles);
+  for (const KX_NavMeshTileBuilder::Tile &tile : tiles) {
+    if (tile.data &&
+        !m_tiledNavMesh->addTileAt(tile.x, tile.y, tile.data, tile.dataSize, true)) {
+      delete[] tile.data;
+    }
+  }
+
+  m_tileRange[0] = minx;
+  m_tileRange[1] = miny;
+  m_tileRange[2] = maxx;
+  m_tileRange[3] = maxy;
+
+  return true;
+}
+
+bool KX_NavMeshObject::BuildNavMesh()
+{
+  FreeNavMesh();
+
   if (GetMeshCount() == 0) {
     CM_Error("can't find mesh for navmesh object: " << m_name);
     return false;
   }
 
+  const float tileSize = GetScene()->GetBlenderScene()->gm.recastData.tilesize;
+  if (tileSize > 0.0f) {
+    return BuildTiledNavMesh(tileSize);
+  }
+
   float *vertices = nullptr, *dvertices = nullptr;
   unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
   int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
@@ -1024,11 +1181,307 @@ dtStatNavMesh *KX_NavMeshObject::GetNavMesh()
   return m_navMesh;
 }
 
+dtTiledNavMesh *KX_NavMeshObject::GetTiledNavMesh()
+{
+  return m_tiledNavMesh;
+}
+
+void KX_NavMeshObject::UpdateObstacles()
+{
+  KX_ObstacleSimulation *obssimulation = GetScene()->GetObstacleSimulation();
+  if (obssimulation) {
+    obssimulation->DestroyObstacleForObj(this);
+    obssimulation->AddObstaclesForNavMesh(this);
+  }
+}
+
+void KX_NavMeshObject::RebuildNavMesh()
+{
+  KX_PathQueryManager *pathQueryManager = GetScene()->GetPathQueryManager();
+  pathQueryManager->WaitNavMesh(this);
+  BuildNavMesh();
+  pathQueryManager->ResetNavMesh(this);
+  UpdateObstacles();
+}
+
+void KX_NavMeshObject::RebuildTiles(const MT_Vector3 &min, const MT_Vector3 &max)
+{
+  if (!m_tileBuilder) {
+    RebuildNavMesh();
+    return;
+  }
+
+  // The polygons are copied on the main thread as they are read from the mesh.
+  std::shared_ptr<KX_NavMeshTileBuilder::Source> source =
+      std::make_shared<KX_NavMeshTileBuilder::Source>();
+  if (!BuildTileSource(*source)) {
+    return;
+  }
+
+  // Bounds of the box in the navigation mesh coordinates.
+  float bmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float bmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (int i = 0; i < 8; i++) {
+    const MT_Vector3 corner((i & 1) ? max.x() : min.x(),
+                            (i & 2) ? max.y() : min.y(),
+                            (i & 4) ? max.z() : min.z());
+    float pos[3];
+    TransformToLocalCoords(corner).getValue(pos);
+    flipAxes(pos);
+    for (int k = 0; k < 3; k++) {
+      bmin[k] = std::min(bmin[k], pos[k]);
+      bmax[k] = std::max(bmax[k], pos[k]);
+    }
+  }
+
+  int minx, miny, maxx, maxy;
+  m_tileBuilder->GetTileRange(bmin, bmax, minx, miny, maxx, maxy);
+
+  /* The tiles outside of the previous tiles and of the new polygons are empty and don't need
+   * to be built. */
+  int tileRange[4];
+  m_tileBuilder->GetTileRange(
+      source->bmin, source->bmax, tileRange[0], tileRange[1], tileRange[2], tileRange[3]);
+  tileRange[0] = std::min(m_tileRange[0], tileRange[0]);
+  tileRange[1] = std::min(m_tileRange[1], tileRange[1]);
+  tileRange[2] = std::max(m_tileRange[2], tileRange[2]);
+  tileRange[3] = std::max(m_tileRange[3], tileRange[3]);
+
+  /* All the tiles of the navigation mesh are in its tile range, the range must fit in the tile
+   * pool for every new tile to find a free slot. */
+  if ((tileRange[2] - tileRange[0] + 1) * (tileRange[3] - tileRange[1] + 1) > DT_MAX_TILES) {
+    CM_Error("navigation mesh rebuild of object " << m_name << " needs more than "
+                                                  << DT_MAX_TILES << " tiles, ignoring");
+    return;
+  }
+  for (int i = 0; i < 4; i++) {
+    m_tileRange[i] = tileRange[i];
+  }
+
+  minx = std::max(minx, m_tileRange[0]);
+  miny = std::max(miny, m_tileRange[1]);
+  maxx = std::min(maxx, m_tileRange[2]);
+  maxy = std::min(maxy, m_tileRange[3]);
+  if (minx > maxx || miny > maxy) {
+    return;
+  }
+
+  m_tileBuilder->BuildTilesAsync(source, minx, miny, maxx, maxy);
+}
+
+void KX_NavMeshObject::UpdateTiles()
+{
+  if (!m_tileBuilder) {
+    return;
+  }
+
+  std::vector<KX_NavMeshTileBuilder::Tile> tiles;
+  m_tileBuilder->GetBuiltTiles(tiles);
+  if (tiles.empty()) {
+    return;
+  }
+
+  // The path searches running in background read the tiles.
+  KX_PathQueryManager *pathQueryManager = GetScene()->GetPathQueryManager();
+  pathQueryManager->WaitNavMesh(this);
+
+  for (const KX_NavMeshTileBuilder::Tile &tile : tiles) {
+    /* The previous tile data is taken back from the navigation mesh instead of being freed, it
+     * is added again if the new tile can't be. */
+    unsigned char *oldData = nullptr;
+    int oldDataSize = 0;
+    dtTile *oldTile = m_tiledNavMesh->getTileAt(tile.x, tile.y);
+    if (oldTile) {
+      oldTile->ownsData = false;
+      m_tiledNavMesh->removeTileAt(tile.x, tile.y, &oldData, &oldDataSize);
+    }
+
+    if (!tile.data) {
+      delete[] oldData;
+    }
+    else if (m_tiledNavMesh->addTileAt(tile.x, tile.y, tile.data, tile.dataSize, true)) {
+      delete[] oldData;
+    }
+    else {
+      CM_Error("unable to add tile (" << tile.x << ", " << tile.y
+                                      << ") to the navigation mesh of object " << m_name
+                                      << ", keeping the previous tile");
+      delete[] tile.data;
+      if (oldData) {
+        m_tiledNavMesh->addTileAt(tile.x, tile.y, oldData, oldDataSize, true);
+      }
+    }
+  }
+
+  pathQueryManager->ResetNavMesh(this);
+  UpdateObstacles();
+}
+
+inline float vdot2(const float *a, const float *b)
+{
+  return a[0] * b[0] + a[2] * b[2];
+}
+static float barDistSqPointToTri(const float *p, const float *a, const float *b, const float *c)
+{
+  float v0[3], v1[3], v2[3];
+  rcVsub(v0, c, a);
+  rcVsub(v1, b, a);
+  rcVsub(v2, p, a);
+
+  const float dot00 = vdot2(v0, v0);
+  const float dot01 = vdot2(v0, v1);
+  const float dot02 = vdot2(v0, v2);
+  const float dot11 = vdot2(v1, v1);
+  const float dot12 = vdot2(v1, v2);
+
+  // Compute barycentric coordinates
+  float invDenom = 1.0f / (dot00 * dot11 - dot01 * dot01);
+  float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
+  float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
+
+  float ud = u < 0.f ? -u : (u > 1.f ? u - 1.f : 0.f);
+  float vd = v < 0.f ? -v : (v > 1.f ? v - 1.f : 0.f);
+  return ud * ud + vd * vd;
+}
+
+/** Compute the normal of the detail triangle of a polygon nearest to pos, the triangle
+ * vertices lower than nv are polygon vertices.
+ */
+static bool detailNormal(const float *pos,
+                         const unsigned short *polyVerts,
+                         int nv,
+                         const float *verts,
+                         const float *dverts,
+                         const unsigned char *dtris,
+                         int ntris,
+                         MT_Vector3 &normal)
+{
+  float distMin = FLT_MAX;
+  int idxMin = -1;
+  const float *v[3];
+  for (int i = 0; i < ntris; ++i) {
+    const unsigned char *t = &dtris[i * 4];
+    for (int j = 0; j < 3; ++j) {
+      v[j] = (t[j] < nv) ? &verts[polyVerts[t[j]] * 3] : &dverts[(t[j] - nv) * 3];
+    }
+    float dist = barDistSqPointToTri(pos, v[0], v[1], v[2]);
+    if (dist < distMin) {
+      distMin = dist;
+      idxMin = i;
+    }
+  }
+
+  if (idxMin < 0) {
+    return false;
+  }
+
+  const unsigned char *t = &dtris[idxMin * 4];
+  MT_Vector3 tri[3];
+  for (int j = 0; j < 3; ++j) {
+    const float *vj = (t[j] < nv) ? &verts[polyVerts[t[j]] * 3] : &dverts[(t[j] - nv) * 3];
+    tri[j].setValue(vj[0], vj[2], vj[1]);
+  }
+  MT_Vector3 a, b;
+  a = tri[1] - tri[0];
+  b = tri[2] - tri[0];
+  normal = b.cross(a).safe_normalized();
+  return true;
+}
+
+bool KX_NavMeshObject::FindNormal(const MT_Vector3 &lpos, MT_Vector3 &normal)
+{
+  float spos[3];
+  lpos.getValue(spos);
+  flipAxes(spos);
+
+  if (m_tiledNavMesh) {
+    const dtTilePolyRef ref = m_tiledNavMesh->findNearestPoly(spos, polyPickExt);
+    if (ref == 0) {
+      return false;
+    }
+    unsigned int salt, it, ip;
+    dtDecodeTileId(ref, salt, it, ip);
+    const dtTileHeader *header = m_tiledNavMesh->getTile(it)->header;
+    const dtTilePoly &p = header->polys[ip];
+    const dtTilePolyDetail &pd = header->dmeshes[ip];
+    return detailNormal(spos,
+                        p.v,
+                        p.nv,
+                        header->verts,
+                        &header->dverts[pd.vbase * 3],
+                        &header->dtris[pd.tbase * 4],
+                        pd.ntris,
+                        normal);
+  }
+
+  if (m_navMesh) {
+    const dtStatPolyRef ref = m_navMesh->findNearestPoly(spos, polyPickExt);
+    if (ref == 0) {
+      return false;
+    }
+    const dtStatPoly *p = m_navMesh->getPoly(ref - 1);
+    const dtStatPolyDetail *pd = m_navMesh->getPolyDetail(ref - 1);
+    return detailNormal(spos,
+                        p->v,
+                        p->nv,
+                        m_navMesh->getVertex(0),
+                        m_navMesh->getDetailVertex(pd->vbase),
+                        m_navMesh->getDetailTri(pd->tbase),
+                        pd->ntris,
+                        normal);
+  }
+
+  return false;
+}
+
 void KX_NavMeshObject::DrawNavMesh(NavMeshRenderMode renderMode)
 {
+  UpdateTiles();
+
+  MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
+
+  if (m_tiledNavMesh) {
+    for (int ti = 0; ti < DT_MAX_TILES; ti++) {
+      const dtTileHeader *header = m_tiledNavMesh->getTile(ti)->header;
+      if (!header) {
+        continue;
+      }
+
+      for (int pi = 0; pi < header->npolys; pi++) {
+        const dtTilePoly &poly = header->polys[pi];
+        if (renderMode == RM_TRIS) {
+          const dtTilePolyDetail &pd = header->dmeshes[pi];
+          for (int j = 0; j < pd.ntris; ++j) {
+            const unsigned char *t = &header->dtris[(pd.tbase + j) * 4];
+            MT_Vector3 tri[3];
+            for (int k = 0; k < 3; ++k) {
+              const float *v = (t[k] < poly.nv) ?
+                                   &header->verts[poly.v[t[k]] * 3] :
+                                   &header->dverts[(pd.vbase + t[k] - poly.nv) * 3];
+              tri[k] = TransformToWorldCoords(MT_Vector3(v[0], v[2], v[1]));
+            }
+            for (int k = 0; k < 3; k++)
+              KX_RasterizerDrawDebugLine(tri[k], tri[(k + 1) % 3], color);
+          }
+        }
+        else if (renderMode == RM_POLYS || renderMode == RM_WALLS) {
+          for (int i = 0, j = (int)poly.nv - 1; i < (int)poly.nv; j = i++) {
+            if (renderMode == RM_WALLS && !KX_NavMeshTileBuilder::IsWall(header, pi, j))
+              continue;
+            const float *vif = &header->verts[poly.v[i] * 3];
+            const float *vjf = &header->verts[poly.v[j] * 3];
+            MT_Vector3 vi = TransformToWorldCoords(MT_Vector3(vif[0], vif[2], vif[1]));
+            MT_Vector3 vj = TransformToWorldCoords(MT_Vector3(vjf[0], vjf[2], vjf[1]));
+            KX_RasterizerDrawDebugLine(vi, vj, color);
+          }
+        }
+      }
+    }
+    return;
+  }
+
   if (!m_navMesh)
     return;
-  MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
 
   switch (renderMode) {
     case RM_POLYS:
@@ -1105,12 +1558,58 @@ MT_Vector3 KX_NavMeshObject::TransformToWorldCoords(const MT_Vector3 &lpos)
   return wpos;
 }
 
+template <class NavMesh, class PolyRef>
+static float raycast(NavMesh *navmesh, const float *spos, const float *epos)
+{
+  PolyRef sPolyRef = navmesh->findNearestPoly(spos, polyPickExt);
+  float t = 0;
+  PolyRef polys[MAX_PATH_LEN];
+  navmesh->raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
+  return t;
+}
+
+template <class NavMesh, class PolyRef>
+static unsigned int findNearestPoly(NavMesh *navmesh, const float *pos)
+{
+  return (unsigned int)navmesh->findNearestPoly(pos, polyPickExt);
+}
+
+unsigned int KX_NavMeshObject::FindNearestPoly(const float pos[3])
+{
+  if (m_tiledNavMesh) {
+    return findNearestPoly<dtTiledNavMesh, dtTilePolyRef>(m_tiledNavMesh, pos);
+  }
+  if (m_navMesh) {
+    return findNearestPoly<dtStatNavMesh, dtStatPolyRef>(m_navMesh, pos);
+  }
+  return 0;
+}
+
+void KX_NavMeshObject::TransformPathToWorldCoords(float *path, int pathLen)
+{
+  TransformPathToWorldCoords(NodeGetWorldTransform(), path, pathLen);
+}
+
+void KX_NavMeshObject::TransformPathToWorldCoords(const MT_Transform &worldTransform,
+                                                  float *path,
+                                                  int pathLen)
+{
+  for (int i = 0; i < pathLen; i++) {
+    flipAxes(&path[i * 3]);
+    MT_Vector3 waypoint(&path[i * 3]);
+    waypoint = worldTransform(waypoint);
+    waypoint.getValue(&path[i * 3]);
+  }
+}
+
 int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
                                const MT_Vector3 &to,
                                float *path,
                                int maxPathLen)
 {
-  if (!m_navMesh)
+  UpdateTiles();
+
+  if (!m_navMesh && !m_tiledNavMesh)
     return 0;
   MT_Vector3 localfrom = TransformToLocalCoords(from);
   MT_Vector3 localto = TransformToLocalCoords(to);
@@ -1119,33 +1618,37 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
-  dtStatPolyRef ePolyRef = m_navMesh->findNearestPoly(epos, polyPickExt);
-
-  int pathLen = 0;
-  if (sPolyRef && ePolyRef) {
-    dtStatPolyRef *polys = new dtStatPolyRef[maxPathLen];
-    int npolys;
-    npolys = m_navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
-    if (npolys) {
-      pathLen = m_navMesh->findStraightPath(spos, epos, polys, npolys, path, maxPathLen);
-      for (int i = 0; i < pathLen; i++) {
-        flipAxes(&path[i * 3]);
-        MT_Vector3 waypoint(&path[i * 3]);
-        waypoint = TransformToWorldCoords(waypoint);
-        waypoint.getValue(&path[i * 3]);
-      }
-    }
 
-    delete[] polys;
-  }
+  const int pathLen = GetScene()->GetPathQueryManager()->FindPath(
+      this, spos, epos, path, maxPathLen);
+  TransformPathToWorldCoords(path, pathLen);
 
   return pathLen;
 }
 
+std::shared_ptr<KX_PathQuery> KX_NavMeshObject::FindPathAsync(const MT_Vector3 &from,
+                                                              const MT_Vector3 &to,
+                                                              int maxPathLen)
+{
+  UpdateTiles();
+
+  MT_Vector3 localfrom = TransformToLocalCoords(from);
+  MT_Vector3 localto = TransformToLocalCoords(to);
+  float spos[3], epos[3];
+  localfrom.getValue(spos);
+  flipAxes(spos);
+  localto.getValue(epos);
+  flipAxes(epos);
+
+  return GetScene()->GetPathQueryManager()->RequestPath(
+      this, NodeGetWorldTransform(), spos, epos, maxPathLen);
+}
+
 float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
 {
-  if (!m_navMesh)
+  UpdateTiles();
+
+  if (!m_navMesh && !m_tiledNavMesh)
     return 0.f;
   MT_Vector3 localfrom = TransformToLocalCoords(from);
   MT_Vector3 localto = TransformToLocalCoords(to);
@@ -1154,11 +1657,8 @@ float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
-  float t = 0;
-  static dtStatPolyRef polys[MAX_PATH_LEN];
-  m_navMesh->raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
-  return t;
+  return m_tiledNavMesh ? raycast<dtTiledNavMesh, dtTilePolyRef>(m_tiledNavMesh, spos, epos) :
+                          raycast<dtStatNavMesh, dtStatPolyRef>(m_navMesh, spos, epos);
 }
 
 void KX_NavMeshObject::DrawPath(const float *path, int pathLen, const MT_Vector4 &color)
@@ -1226,6 +1726,8 @@ PyTypeObject KX_NavMeshObject::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Nav
                                        game_object_new};
 
 PyAttributeDef KX_NavMeshObject::Attributes[] = {
+    EXP_PYATTRIBUTE_RO_FUNCTION("tileSize", KX_NavMeshObject, pyattr_get_tile_size),
+    EXP_PYATTRIBUTE_RO_FUNCTION("isBuildingTiles", KX_NavMeshObject, pyattr_get_building_tiles),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -1235,6 +1737,7 @@ PyMethodDef KX_NavMeshObject::Methods[] = {
     EXP_PYMETHODTABLE(KX_NavMeshObject, raycast),
     EXP_PYMETHODTABLE(KX_NavMeshObject, draw),
     EXP_PYMETHODTABLE(KX_NavMeshObject, rebuild),
+    EXP_PYMETHODTABLE(KX_NavMeshObject, rebuildTiles),
     {nullptr, nullptr}  // Sentinel
 };
 
@@ -1291,8 +1794,38 @@ EXP_PYMETHODDEF_DOC(KX_NavMeshObject,
 
 EXP_PYMETHODDEF_DOC_NOARGS(KX_NavMeshObject, rebuild, "rebuild(): rebuild navigation mesh\n")
 {
-  BuildNavMesh();
+  RebuildNavMesh();
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC(KX_NavMeshObject,
+                    rebuildTiles,
+                    "rebuildTiles(min, max): rebuild in background the navigation mesh tiles\n"
+                    "overlapping the box from min to max\n")
+{
+  PyObject *ob_min, *ob_max;
+  if (!PyArg_ParseTuple(args, "OO:rebuildTiles", &ob_min, &ob_max))
+    return nullptr;
+  MT_Vector3 min, max;
+  if (!PyVecTo(ob_min, min) || !PyVecTo(ob_max, max))
+    return nullptr;
+
+  RebuildTiles(min, max);
   Py_RETURN_NONE;
 }
 
+PyObject *KX_NavMeshObject::pyattr_get_tile_size(EXP_PyObjectPlus *self_v,
+                                                 const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyFloat_FromDouble(self->m_tileBuilder ? self->m_tileBuilder->GetTileSize() : 0.0f);
+}
+
+PyObject *KX_NavMeshObject::pyattr_get_building_tiles(EXP_PyObjectPlus *self_v,
+                                                      const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyBool_FromLong(self->m_tileBuilder && self->m_tileBuilder->IsBuilding());
+}
+
 #endif  // WITH_PYTHON
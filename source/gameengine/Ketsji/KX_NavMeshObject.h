@@ -26,18 +26,28 @@
  */
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "DetourStatNavMesh.h"
+#include "DetourTileNavMesh.h"
 #include "EXP_PyObjectPlus.h"
 #include "KX_GameObject.h"
+#include "KX_NavMeshTileBuilder.h"
 
+class KX_PathQuery;
 
 class KX_NavMeshObject : public KX_GameObject {
   Py_Header
 
       protected : dtStatNavMesh *m_navMesh;
 
+  /// Navigation mesh used instead of m_navMesh when the scene navigation tile size isn't zero.
+  dtTiledNavMesh *m_tiledNavMesh;
+  KX_NavMeshTileBuilder *m_tileBuilder;
+  /// Range of the tiles built since the load, as min x, min y, max x and max y.
+  int m_tileRange[4];
+
   bool BuildVertIndArrays(float *&vertices,
                           int &nverts,
                           unsigned short *&polys,
@@ -48,6 +58,14 @@ class KX_NavMeshObject : public KX_GameObject {
                           unsigned short *&dtris,
                           int &ndtris,
                           int &vertsPerPoly);
+  /// Copy the navigation polygons for the tile builds.
+  bool BuildTileSource(KX_NavMeshTileBuilder::Source &source);
+  bool BuildTiledNavMesh(float tileSize);
+  void FreeNavMesh();
+  /// Recreate the navigation mesh obstacles after a change of the navigation mesh.
+  void UpdateObstacles();
+  /// Build again the navigation mesh once the path searches reading it are finished.
+  void RebuildNavMesh();
 
  public:
   KX_NavMeshObject();
@@ -58,7 +76,36 @@ class KX_NavMeshObject : public KX_GameObject {
 
   bool BuildNavMesh();
   dtStatNavMesh *GetNavMesh();
+  dtTiledNavMesh *GetTiledNavMesh();
+
+  /** Rebuild in background the tiles overlapping a world space box, the previous tiles are
+   * used until UpdateTiles swaps the new ones. Rebuild the whole navigation mesh when it
+   * isn't tiled.
+   */
+  void RebuildTiles(const MT_Vector3 &min, const MT_Vector3 &max);
+  /** Swap the tiles finished by the background rebuilds in the navigation mesh, called
+   * before the queries and never while the obstacle simulation iterates its obstacles.
+   */
+  void UpdateTiles();
+  /// Find the normal of the navigation mesh under a position in local coordinates.
+  bool FindNormal(const MT_Vector3 &lpos, MT_Vector3 &normal);
+
+  /// Return the reference of the polygon nearest to a position in Detour coordinates.
+  unsigned int FindNearestPoly(const float pos[3]);
+  /// Convert a path in Detour coordinates to world space in place.
+  void TransformPathToWorldCoords(float *path, int pathLen);
+  /// Convert a path in Detour coordinates to world space with a given navigation mesh transform.
+  static void TransformPathToWorldCoords(const MT_Transform &worldTransform,
+                                         float *path,
+                                         int pathLen);
+
   int FindPath(const MT_Vector3 &from, const MT_Vector3 &to, float *path, int maxPathLen);
+  /** Queue a path search in background, the query is done in one of the next frames.
+   * The search shares the corridors found by the previous searches.
+   */
+  std::shared_ptr<KX_PathQuery> FindPathAsync(const MT_Vector3 &from,
+                                              const MT_Vector3 &to,
+                                              int maxPathLen);
   float Raycast(const MT_Vector3 &from, const MT_Vector3 &to);
 
   enum NavMeshRenderMode { RM_WALLS, RM_POLYS, RM_TRIS, RM_MAX };
@@ -78,5 +125,11 @@ class KX_NavMeshObject : public KX_GameObject {
   EXP_PYMETHOD_DOC(KX_NavMeshObject, raycast);
   EXP_PYMETHOD_DOC(KX_NavMeshObject, draw);
   EXP_PYMETHOD_DOC_NOARGS(KX_NavMeshObject, rebuild);
+  EXP_PYMETHOD_DOC(KX_NavMeshObject, rebuildTiles);
+
+  static PyObject *pyattr_get_tile_size(EXP_PyObjectPlus *self_v,
+                                        const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_building_tiles(EXP_PyObjectPlus *self_v,
+                                             const EXP_PYATTRIBUTE_DEF *attrdef);
 #endif /* WITH_PYTHON */
 };
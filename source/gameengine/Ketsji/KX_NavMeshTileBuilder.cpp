@@ -0,0 +1,540 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_NavMeshTileBuilder.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_NavMeshTileBuilder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#include "BLI_task.h"
+
+#include "CM_Message.h"
+#include "DetourTileNavMesh.h"
+#include "DetourTileNavMeshBuilder.h"
+#include "Recast.h"
+
+/** Clip a convex polygon by the half space where dist is positive, the new vertices are
+ * interpolated on the three axes. Return the number of vertices in out.
+ */
+static int clipPolygon(const float *in, int n, const float *dist, float *out)
+{
+  int m = 0;
+  for (int i = 0, j = n - 1; i < n; j = i++) {
+    const bool insidej = dist[j] >= 0.0f;
+    const bool insidei = dist[i] >= 0.0f;
+    if (insidej != insidei) {
+      const float s = dist[j] / (dist[j] - dist[i]);
+      const float *vj = &in[j * 3];
+      const float *vi = &in[i * 3];
+      float *v = &out[m++ * 3];
+      v[0] = vj[0] + (vi[0] - vj[0]) * s;
+      v[1] = vj[1] + (vi[1] - vj[1]) * s;
+      v[2] = vj[2] + (vi[2] - vj[2]) * s;
+    }
+    if (insidei) {
+      memcpy(&out[m++ * 3], &in[i * 3], sizeof(float) * 3);
+    }
+  }
+  return m;
+}
+
+/// Clip a convex polygon by the plane axis = value, keeping the side pointed by side.
+static int clipPolygonAxis(
+    const float *in, int n, int axis, float value, float side, float *out, float *dist)
+{
+  for (int i = 0; i < n; ++i) {
+    dist[i] = (in[i * 3 + axis] - value) * side;
+  }
+  return clipPolygon(in, n, dist, out);
+}
+
+/// Return twice the signed area of a polygon on the XZ plane.
+static float polygonArea(const float *verts, int n)
+{
+  float area = 0.0f;
+  for (int i = 0, j = n - 1; i < n; j = i++) {
+    area += verts[j * 3] * verts[i * 3 + 2] - verts[i * 3] * verts[j * 3 + 2];
+  }
+  return area;
+}
+
+KX_NavMeshTileBuilder::KX_NavMeshTileBuilder(const float orig[3], float tileSize, float cellSize)
+    : m_cellSize(cellSize), m_numPendingBuilds(0)
+{
+  memcpy(m_orig, orig, sizeof(m_orig));
+  // The vertices are quantized on 16 bits relatively to the tile corner.
+  m_tileCells = std::clamp((int)(tileSize / cellSize + 0.5f), 1, 0xfffe);
+  m_pool = BLI_task_pool_create_background_serial(nullptr, TASK_PRIORITY_LOW);
+}
+
+KX_NavMeshTileBuilder::~KX_NavMeshTileBuilder()
+{
+  BLI_task_pool_cancel(m_pool);
+  BLI_task_pool_free(m_pool);
+
+  for (Tile &tile : m_builtTiles) {
+    delete[] tile.data;
+  }
+}
+
+float KX_NavMeshTileBuilder::GetTileSize() const
+{
+  return m_cellSize * m_tileCells;
+}
+
+const float *KX_NavMeshTileBuilder::GetOrigin() const
+{
+  return m_orig;
+}
+
+void KX_NavMeshTileBuilder::GetTileRange(
+    const float bmin[3], const float bmax[3], int &minx, int &miny, int &maxx, int &maxy) const
+{
+  const float size = GetTileSize();
+  minx = (int)floorf((bmin[0] - m_orig[0]) / size);
+  miny = (int)floorf((bmin[2] - m_orig[2]) / size);
+  maxx = (int)floorf((bmax[0] - m_orig[0]) / size);
+  maxy = (int)floorf((bmax[2] - m_orig[2]) / size);
+}
+
+bool KX_NavMeshTileBuilder::IsWall(const dtTileHeader *header, int poly, int edge)
+{
+  const dtTilePoly &p = header->polys[poly];
+  if (p.n[edge] == 0) {
+    return true;
+  }
+  if (!(p.n[edge] & 0x8000)) {
+    return false;
+  }
+
+  // A portal is only opened by the links to the polygons of the neighbor tile.
+  for (int i = 0; i < p.nlinks; ++i) {
+    if (header->links[p.links + i].e == edge) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool KX_NavMeshTileBuilder::BuildTile(const Source &source,
+                                      const std::vector<int> &polys,
+                                      Tile &tile) const
+{
+  tile.data = nullptr;
+  tile.dataSize = 0;
+
+  const float size = GetTileSize();
+  const float tmin[3] = {m_orig[0] + tile.x * size, 0.0f, m_orig[2] + tile.y * size};
+  const float tmax[3] = {tmin[0] + size, 0.0f, tmin[2] + size};
+  const int nvp = source.vertsPerPoly;
+
+  // A convex polygon gains at most one vertex per clipping plane.
+  const int maxVerts = std::max(nvp + 4, 3 + DT_TILE_VERTS_PER_POLYGON);
+  std::vector<float> bufa(maxVerts * 3);
+  std::vector<float> bufb(maxVerts * 3);
+  std::vector<float> dist(maxVerts);
+
+  /* Clip the polygons to the tile and split the clipped polygons in fans of convex pieces
+   * small enough for the tile polygons. */
+  std::vector<float> pieceVerts;
+  std::vector<int> pieceStarts;
+  std::vector<int> piecePolys;
+  float ymin = FLT_MAX;
+  float ymax = -FLT_MAX;
+
+  for (const int pi : polys) {
+    const unsigned short *p = &source.polys[pi * nvp];
+    int n = 0;
+    for (; n < nvp && p[n] != 0xffff; ++n) {
+      memcpy(&bufa[n * 3], &source.verts[p[n] * 3], sizeof(float) * 3);
+    }
+
+    n = clipPolygonAxis(bufa.data(), n, 0, tmin[0], 1.0f, bufb.data(), dist.data());
+    n = clipPolygonAxis(bufb.data(), n, 0, tmax[0], -1.0f, bufa.data(), dist.data());
+    n = clipPolygonAxis(bufa.data(), n, 2, tmin[2], 1.0f, bufb.data(), dist.data());
+    n = clipPolygonAxis(bufb.data(), n, 2, tmax[2], -1.0f, bufa.data(), dist.data());
+    if (n < 3) {
+      continue;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      ymin = std::min(ymin, bufa[i * 3 + 1]);
+      ymax = std::max(ymax, bufa[i * 3 + 1]);
+    }
+
+    for (int start = 1; start < n - 1;) {
+      const int end = std::min(start + DT_TILE_VERTS_PER_POLYGON - 2, n - 1);
+      pieceStarts.push_back(pieceVerts.size() / 3);
+      piecePolys.push_back(pi);
+      pieceVerts.insert(pieceVerts.end(), &bufa[0], &bufa[3]);
+      pieceVerts.insert(pieceVerts.end(), &bufa[start * 3], &bufa[(end + 1) * 3]);
+      start = end;
+    }
+  }
+
+  if (piecePolys.empty()) {
+    return true;
+  }
+  pieceStarts.push_back(pieceVerts.size() / 3);
+
+  const float cs = m_cellSize;
+  const float ics = 1.0f / cs;
+  if ((ymax - ymin) * ics >= 0xffff) {
+    CM_Error("navigation mesh tile (" << tile.x << ", " << tile.y << ") is too high");
+    return false;
+  }
+
+  // Quantize the pieces, the vertices shared by the pieces and by the tiles are welded.
+  std::unordered_map<uint64_t, unsigned short> vertMap;
+  std::vector<unsigned short> verts;
+  std::vector<unsigned short> tilePolys;
+  std::vector<int> tilePieces;
+
+  for (unsigned int k = 0, numPieces = piecePolys.size(); k < numPieces; ++k) {
+    const int start = pieceStarts[k];
+    const int n = pieceStarts[k + 1] - start;
+    const float *pv = &pieceVerts[start * 3];
+
+    unsigned short idx[DT_TILE_VERTS_PER_POLYGON];
+    int qv[DT_TILE_VERTS_PER_POLYGON * 3];
+    int nv = 0;
+    for (int i = 0; i < n; ++i) {
+      const float *v = &pv[i * 3];
+      const int ix = std::clamp((int)floorf((v[0] - tmin[0]) * ics + 0.5f), 0, m_tileCells);
+      const int iy = (int)floorf((v[1] - ymin) * ics + 0.5f);
+      const int iz = std::clamp((int)floorf((v[2] - tmin[2]) * ics + 0.5f), 0, m_tileCells);
+      const uint64_t key = (uint64_t)ix | ((uint64_t)iy << 16) | ((uint64_t)iz << 32);
+
+      const auto it = vertMap.find(key);
+      unsigned short index;
+      if (it != vertMap.end()) {
+        index = it->second;
+      }
+      else {
+        if (verts.size() / 3 >= 0xfffe) {
+          CM_Error("navigation mesh tile (" << tile.x << ", " << tile.y
+                                            << ") has too many vertices");
+          return false;
+        }
+        index = verts.size() / 3;
+        vertMap.emplace(key, index);
+        verts.push_back(ix);
+        verts.push_back(iy);
+        verts.push_back(iz);
+      }
+
+      if (nv == 0 || idx[nv - 1] != index) {
+        qv[nv * 3] = ix;
+        qv[nv * 3 + 1] = iy;
+        qv[nv * 3 + 2] = iz;
+        idx[nv++] = index;
+      }
+    }
+    while (nv > 1 && idx[nv - 1] == idx[0]) {
+      --nv;
+    }
+    if (nv < 3) {
+      continue;
+    }
+
+    // Drop the slivers collapsed or flipped by the quantization.
+    int64_t qarea = 0;
+    for (int i = 0, j = nv - 1; i < nv; j = i++) {
+      qarea += (int64_t)qv[j * 3] * qv[i * 3 + 2] - (int64_t)qv[i * 3] * qv[j * 3 + 2];
+    }
+    const float area = polygonArea(pv, n);
+    if (qarea == 0 || (qarea > 0) != (area > 0.0f)) {
+      continue;
+    }
+
+    bool simple = true;
+    for (int i = 0; i < nv && simple; ++i) {
+      for (int j = i + 1; j < nv; ++j) {
+        if (idx[i] == idx[j]) {
+          simple = false;
+          break;
+        }
+      }
+    }
+    if (!simple) {
+      continue;
+    }
+
+    const size_t base = tilePolys.size();
+    tilePolys.resize(base + DT_TILE_VERTS_PER_POLYGON * 2, 0xffff);
+    std::copy(idx, idx + nv, &tilePolys[base]);
+    tilePieces.push_back(k);
+  }
+
+  const int npolys = tilePieces.size();
+  if (npolys == 0) {
+    return true;
+  }
+  if (npolys > DT_MAX_POLYGONS) {
+    CM_Error("navigation mesh tile (" << tile.x << ", " << tile.y << ") has " << npolys
+                                      << " polygons, the maximum is " << DT_MAX_POLYGONS
+                                      << ", use a smaller tile size");
+    return false;
+  }
+
+  const int nverts = verts.size() / 3;
+  if (!buildMeshAdjacency(tilePolys.data(), npolys, nverts, DT_TILE_VERTS_PER_POLYGON)) {
+    return false;
+  }
+
+  /* Clip the detail triangles of the source polygon by each tile polygon. The first
+   * vertices of a detail mesh are the polygon vertices, as expected by the tile data. */
+  std::vector<unsigned short> dmeshes(npolys * 4);
+  std::vector<float> dverts;
+  std::vector<unsigned char> dtris;
+
+  for (int i = 0; i < npolys; ++i) {
+    const unsigned short *p = &tilePolys[i * DT_TILE_VERTS_PER_POLYGON * 2];
+    int nv = 0;
+    float pv[DT_TILE_VERTS_PER_POLYGON * 3];
+    for (; nv < DT_TILE_VERTS_PER_POLYGON && p[nv] != 0xffff; ++nv) {
+      const unsigned short *iv = &verts[p[nv] * 3];
+      pv[nv * 3] = tmin[0] + iv[0] * cs;
+      pv[nv * 3 + 1] = ymin + iv[1] * cs;
+      pv[nv * 3 + 2] = tmin[2] + iv[2] * cs;
+    }
+    const float side = (polygonArea(pv, nv) > 0.0f) ? 1.0f : -1.0f;
+
+    const int vbase = dverts.size() / 3;
+    const int tbase = dtris.size() / 4;
+    dverts.insert(dverts.end(), pv, pv + nv * 3);
+
+    const int pi = piecePolys[tilePieces[i]];
+    bool valid = true;
+    for (int t = source.polyTris[pi], end = source.polyTris[pi + 1]; t < end && valid; ++t) {
+      memcpy(bufa.data(), &source.tris[t * 9], sizeof(float) * 9);
+      int n = 3;
+      float *in = bufa.data();
+      float *out = bufb.data();
+      for (int j = nv - 1, k = 0; k < nv && n >= 3; j = k++) {
+        const float *a = &pv[j * 3];
+        const float *b = &pv[k * 3];
+        for (int l = 0; l < n; ++l) {
+          const float *v = &in[l * 3];
+          dist[l] = side * ((b[0] - a[0]) * (v[2] - a[2]) - (b[2] - a[2]) * (v[0] - a[0]));
+        }
+        n = clipPolygon(in, n, dist.data(), out);
+        std::swap(in, out);
+      }
+      if (n < 3) {
+        continue;
+      }
+
+      const int first = dverts.size() / 3 - vbase;
+      if (first + n > 0xff) {
+        valid = false;
+        break;
+      }
+      dverts.insert(dverts.end(), in, in + n * 3);
+      for (int l = 1; l < n - 1; ++l) {
+        dtris.push_back(first);
+        dtris.push_back(first + l);
+        dtris.push_back(first + l + 1);
+        dtris.push_back(0);
+      }
+    }
+
+    // Fall back to a flat triangulation of the polygon when its detail mesh can't be stored.
+    if (!valid || (int)dtris.size() / 4 == tbase) {
+      dverts.resize((vbase + nv) * 3);
+      dtris.resize(tbase * 4);
+      for (int l = 1; l < nv - 1; ++l) {
+        dtris.push_back(0);
+        dtris.push_back(l);
+        dtris.push_back(l + 1);
+        dtris.push_back(0);
+      }
+    }
+
+    const int ndverts = dverts.size() / 3;
+    const int ndtris = dtris.size() / 4;
+    if (ndverts > 0xffff || ndtris > 0xffff) {
+      CM_Error("navigation mesh tile (" << tile.x << ", " << tile.y
+                                        << ") has a too detailed mesh");
+      return false;
+    }
+    dmeshes[i * 4] = vbase;
+    dmeshes[i * 4 + 1] = ndverts - vbase;
+    dmeshes[i * 4 + 2] = tbase;
+    dmeshes[i * 4 + 3] = ndtris - tbase;
+  }
+
+  const float bmin[3] = {tmin[0], ymin, tmin[2]};
+  const float bmax[3] = {tmax[0], ymax, tmax[2]};
+  return dtCreateNavMeshTileData(verts.data(),
+                                 nverts,
+                                 tilePolys.data(),
+                                 npolys,
+                                 DT_TILE_VERTS_PER_POLYGON,
+                                 dmeshes.data(),
+                                 dverts.data(),
+                                 dverts.size() / 3,
+                                 dtris.data(),
+                                 dtris.size() / 4,
+                                 bmin,
+                                 bmax,
+                                 cs,
+                                 cs,
+                                 m_tileCells,
+                                 0,
+                                 &tile.data,
+                                 &tile.dataSize);
+}
+
+void KX_NavMeshTileBuilder::BuildTiles(
+    const Source &source, int minx, int miny, int maxx, int maxy, std::vector<Tile> &tiles) const
+{
+  const int width = maxx - minx + 1;
+  const int height = maxy - miny + 1;
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  const int numTiles = width * height;
+
+  // Sort the polygons by the tiles they overlap.
+  std::vector<std::vector<int>> tilePolys(numTiles);
+  const int nvp = source.vertsPerPoly;
+  for (int pi = 0, npolys = source.polys.size() / nvp; pi < npolys; ++pi) {
+    const unsigned short *p = &source.polys[pi * nvp];
+    float bmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float bmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (int i = 0; i < nvp && p[i] != 0xffff; ++i) {
+      const float *v = &source.verts[p[i] * 3];
+      for (int k = 0; k < 3; ++k) {
+        bmin[k] = std::min(bmin[k], v[k]);
+        bmax[k] = std::max(bmax[k], v[k]);
+      }
+    }
+
+    int pminx, pminy, pmaxx, pmaxy;
+    GetTileRange(bmin, bmax, pminx, pminy, pmaxx, pmaxy);
+    for (int y = std::max(pminy, miny), ymax = std::min(pmaxy, maxy); y <= ymax; ++y) {
+      for (int x = std::max(pminx, minx), xmax = std::min(pmaxx, maxx); x <= xmax; ++x) {
+        tilePolys[(y - miny) * width + x - minx].push_back(pi);
+      }
+    }
+  }
+
+  std::vector<Tile> built(numTiles);
+  std::vector<char> succeeded(numTiles);
+  for (int i = 0; i < numTiles; ++i) {
+    built[i].x = minx + i % width;
+    built[i].y = miny + i / width;
+  }
+
+  struct TaskData {
+    const KX_NavMeshTileBuilder *builder;
+    const Source *source;
+    const std::vector<int> *polys;
+    Tile *tiles;
+    char *succeeded;
+
+    static void Run(void *__restrict userdata,
+                    const int i,
+                    const TaskParallelTLS *__restrict /*tls*/)
+    {
+      TaskData *data = (TaskData *)userdata;
+      data->succeeded[i] = data->builder->BuildTile(*data->source, data->polys[i], data->tiles[i]);
+    }
+  } data = {this, &source, tilePolys.data(), built.data(), succeeded.data()};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (numTiles > 1);
+  BLI_task_parallel_range(0, numTiles, &data, TaskData::Run, &settings);
+
+  // A tile failing to build is skipped to keep the previous one.
+  for (int i = 0; i < numTiles; ++i) {
+    if (succeeded[i]) {
+      tiles.push_back(built[i]);
+    }
+  }
+}
+
+struct KX_NavMeshTileBuildTask {
+  KX_NavMeshTileBuilder *builder;
+  std::shared_ptr<const KX_NavMeshTileBuilder::Source> source;
+  int minx;
+  int miny;
+  int maxx;
+  int maxy;
+};
+
+void KX_NavMeshTileBuilder::BuildTask(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  KX_NavMeshTileBuildTask *task = (KX_NavMeshTileBuildTask *)taskdata;
+  KX_NavMeshTileBuilder *builder = task->builder;
+
+  std::vector<Tile> tiles;
+  builder->BuildTiles(*task->source, task->minx, task->miny, task->maxx, task->maxy, tiles);
+
+  std::lock_guard<std::mutex> lock(builder->m_mutex);
+  builder->m_builtTiles.insert(builder->m_builtTiles.end(), tiles.begin(), tiles.end());
+  --builder->m_numPendingBuilds;
+}
+
+void KX_NavMeshTileBuilder::FreeTask(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  delete (KX_NavMeshTileBuildTask *)taskdata;
+}
+
+void KX_NavMeshTileBuilder::BuildTilesAsync(const std::shared_ptr<const Source> &source,
+                                            int minx,
+                                            int miny,
+                                            int maxx,
+                                            int maxy)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_numPendingBuilds;
+  }
+
+  KX_NavMeshTileBuildTask *task = new KX_NavMeshTileBuildTask{
+      this, source, minx, miny, maxx, maxy};
+  BLI_task_pool_push(m_pool, BuildTask, task, true, FreeTask);
+}
+
+void KX_NavMeshTileBuilder::GetBuiltTiles(std::vector<Tile> &tiles)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  tiles.insert(tiles.end(), m_builtTiles.begin(), m_builtTiles.end());
+  m_builtTiles.clear();
+}
+
+bool KX_NavMeshTileBuilder::IsBuilding()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return (m_numPendingBuilds > 0 || !m_builtTiles.empty());
+}
@@ -0,0 +1,115 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_NavMeshTileBuilder.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct TaskPool;
+struct dtTileHeader;
+
+/** Builder of the tiles of a dtTiledNavMesh from a copy of the navigation polygons.
+ * The polygons are clipped at the tile borders, the clipped edges become the portals linking
+ * the tile to its neighbors. The tiles are built in parallel, either waiting for them or in a
+ * background thread, in which case the main thread collects the finished tiles with
+ * GetBuiltTiles and swaps them in the navigation mesh.
+ */
+class KX_NavMeshTileBuilder {
+ public:
+  /// Navigation polygons in Detour coordinates (Y up), shared with the builds and never modified.
+  struct Source {
+    std::vector<float> verts;
+    /// vertsPerPoly vertex indices per polygon, the unused indices are 0xffff.
+    std::vector<unsigned short> polys;
+    int vertsPerPoly;
+    /// Detail triangles of the polygons, 9 coordinates per triangle.
+    std::vector<float> tris;
+    /// Index of the first detail triangle of each polygon, followed by the number of triangles.
+    std::vector<int> polyTris;
+    float bmin[3];
+    float bmax[3];
+  };
+
+  struct Tile {
+    int x;
+    int y;
+    /// Detour tile data allocated with new[], nullptr for a tile without polygons.
+    unsigned char *data;
+    int dataSize;
+  };
+
+ private:
+  /// Corner of the tile (0, 0).
+  float m_orig[3];
+  /// Quantization step of the tile vertices.
+  float m_cellSize;
+  /// Size of a tile in cells.
+  int m_tileCells;
+
+  /// Serial background pool, the builds finish in the order they were queued.
+  TaskPool *m_pool;
+  std::mutex m_mutex;
+  std::vector<Tile> m_builtTiles;
+  unsigned int m_numPendingBuilds;
+
+  bool BuildTile(const Source &source, const std::vector<int> &polys, Tile &tile) const;
+
+  static void BuildTask(TaskPool *pool, void *taskdata);
+  static void FreeTask(TaskPool *pool, void *taskdata);
+
+ public:
+  KX_NavMeshTileBuilder(const float orig[3], float tileSize, float cellSize);
+  ~KX_NavMeshTileBuilder();
+
+  /// Return the size of a tile, rounded to a number of cells.
+  float GetTileSize() const;
+  const float *GetOrigin() const;
+
+  /// Return the range of the tiles overlapping a box in Detour coordinates.
+  void GetTileRange(
+      const float bmin[3], const float bmax[3], int &minx, int &miny, int &maxx, int &maxy) const;
+
+  /** Build the tiles in the range [minx, maxx] x [miny, maxy] in parallel and wait for them.
+   * The tiles without polygons are returned with a null data.
+   */
+  void BuildTiles(
+      const Source &source, int minx, int miny, int maxx, int maxy, std::vector<Tile> &tiles) const;
+  /// Queue a background build of the tiles in a range, the tiles are given by GetBuiltTiles.
+  void BuildTilesAsync(const std::shared_ptr<const Source> &source,
+                       int minx,
+                       int miny,
+                       int maxx,
+                       int maxy);
+  /// Move the tiles of the finished background builds at the end of tiles.
+  void GetBuiltTiles(std::vector<Tile> &tiles);
+  /// Return true if a background build isn't finished or its tiles weren't collected.
+  bool IsBuilding();
+
+  /// Return true if a polygon edge is a wall, including the tile borders without neighbor.
+  static bool IsWall(const dtTileHeader *header, int poly, int edge);
+};
@@ -86,6 +86,11 @@ SG_ParentRelation *KX_NormalParentRelation::NewCopy()
   return new KX_NormalParentRelation();
 }
 
+bool KX_NormalParentRelation::IsNormalRelation()
+{
+  return true;
+}
+
 KX_VertexParentRelation::KX_VertexParentRelation()
 {
 }
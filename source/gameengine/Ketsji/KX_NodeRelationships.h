@@ -55,6 +55,9 @@ class KX_NormalParentRelation : public SG_ParentRelation {
 
   /// Method inherited from KX_ParentRelation
   SG_ParentRelation *NewCopy();
+
+  /// Method inherited from KX_ParentRelation
+  bool IsNormalRelation();
 };
 
 class KX_VertexParentRelation : public SG_ParentRelation {
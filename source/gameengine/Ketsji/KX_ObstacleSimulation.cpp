@@ -28,12 +28,18 @@
 
 #include "KX_ObstacleSimulation.h"
 
+#include <algorithm>
+#include <cfloat>
+
 #include "BLI_math_geom.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_simd.h"
+#include "BLI_task.h"
 
 #include "KX_Globals.h"
 #include "KX_NavMeshObject.h"
+#include "SCA_SteeringActuator.h"
 
 namespace {
 inline float perp(const MT_Vector2 &a, const MT_Vector2 &b)
@@ -190,8 +196,40 @@ static float interpolateToi(float a, const float *dir, const float *toi, const i
   return 0;
 }
 
+/// Minimum number of agents to solve them in parallel.
+static const unsigned int AGENT_PARALLEL_THRESHOLD = 16;
+/// Constant term of the padding circles, never hit by a sweep.
+static const float NO_CIRCLE = 1.0e30f;
+
+static inline unsigned int grid_hash(int x, int y)
+{
+  return ((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u);
+}
+
+static MT_Vector3 nearestPointToSegment(const MT_Vector3 &pos,
+                                        const MT_Vector3 &p1,
+                                        const MT_Vector3 &p2)
+{
+  MT_Vector3 ab = p2 - p1;
+  if (ab.fuzzyZero()) {
+    return p1;
+  }
+
+  const MT_Scalar dist = ab.length();
+  MT_Vector3 abdir = ab / dist;
+  MT_Scalar proj = abdir.dot(pos - p1);
+  CLAMP(proj, 0, dist);
+  return p1 + abdir * proj;
+}
+
 KX_ObstacleSimulation::KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization)
-    : m_levelHeight(levelHeight), m_enableVisualization(enableVisualization)
+    : m_numAgents(0),
+      m_gridCellSize(1.0f),
+      m_gridMask(0),
+      m_maxObstacleRadius(0.0f),
+      m_maxObstacleSpeed(0.0f),
+      m_levelHeight(levelHeight),
+      m_enableVisualization(enableVisualization)
 {
 }
 
@@ -227,6 +265,8 @@ void KX_ObstacleSimulation::AddObstacleForObj(KX_GameObject *gameobj)
   obstacle->m_type = KX_OBSTACLE_OBJ;
   obstacle->m_shape = KX_OBSTACLE_CIRCLE;
   obstacle->m_rad = blenderobject->obstacleRad;
+
+  m_objectObstacles[gameobj] = obstacle;
 }
 
 void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
@@ -252,10 +292,53 @@ void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
       }
     }
   }
+
+  dtTiledNavMesh *tiledNavMesh = navmeshobj->GetTiledNavMesh();
+  if (tiledNavMesh) {
+    for (int ti = 0; ti < DT_MAX_TILES; ti++) {
+      const dtTileHeader *header = tiledNavMesh->getTile(ti)->header;
+      if (!header) {
+        continue;
+      }
+
+      for (int pi = 0; pi < header->npolys; pi++) {
+        const dtTilePoly &poly = header->polys[pi];
+        for (int i = 0, j = (int)poly.nv - 1; i < (int)poly.nv; j = i++) {
+          if (!KX_NavMeshTileBuilder::IsWall(header, pi, j))
+            continue;
+          const float *vj = &header->verts[poly.v[j] * 3];
+          const float *vi = &header->verts[poly.v[i] * 3];
+
+          KX_Obstacle *obstacle = CreateObstacle(navmeshobj);
+          obstacle->m_type = KX_OBSTACLE_NAV_MESH;
+          obstacle->m_shape = KX_OBSTACLE_SEGMENT;
+          obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
+          obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
+          obstacle->m_rad = 0;
+        }
+      }
+    }
+  }
 }
 
 void KX_ObstacleSimulation::DestroyObstacleForObj(KX_GameObject *gameobj)
 {
+  m_objectObstacles.erase(gameobj);
+
+  // Drop the agents of the frame using the removed obstacles.
+  for (unsigned int i = 0; i < m_numAgents;) {
+    if (m_agents[i].obstacle->m_gameObj == gameobj) {
+      m_obstacleAgents.erase(m_agents[i].obstacle);
+      std::swap(m_agents[i], m_agents[--m_numAgents]);
+      if (i < m_numAgents) {
+        m_obstacleAgents[m_agents[i].obstacle] = i;
+      }
+    }
+    else {
+      ++i;
+    }
+  }
+
   for (size_t i = 0; i < m_obstacles.size();) {
     if (m_obstacles[i]->m_gameObj == gameobj) {
       KX_Obstacle *obstacle = m_obstacles[i];
@@ -292,20 +375,304 @@ void KX_ObstacleSimulation::UpdateObstacles()
 
 KX_Obstacle *KX_ObstacleSimulation::GetObstacle(KX_GameObject *gameobj)
 {
-  for (size_t i = 0; i < m_obstacles.size(); i++) {
-    if (m_obstacles[i]->m_gameObj == gameobj)
-      return m_obstacles[i];
+  const auto it = m_objectObstacles.find(gameobj);
+  if (it == m_objectObstacles.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+void KX_ObstacleSimulation::AddAgent(KX_Obstacle *activeObst,
+                                     KX_NavMeshObject *activeNavMeshObj,
+                                     SCA_SteeringActuator *actuator,
+                                     const MT_Vector3 &velocity,
+                                     MT_Scalar maxDeltaSpeed,
+                                     MT_Scalar maxDeltaAngle)
+{
+  /* The agents write the velocities of their obstacle while solved in parallel, a second
+   * actuator of the same obstacle replaces the previous agent instead of racing with it. */
+  const auto it = m_obstacleAgents.emplace(activeObst, m_numAgents);
+  if (it.second) {
+    // Reuse the agents of the previous frames with their neighbors buffers.
+    if (m_numAgents == m_agents.size()) {
+      m_agents.emplace_back();
+    }
+    ++m_numAgents;
+  }
+
+  Agent &agent = m_agents[it.first->second];
+  agent.obstacle = activeObst;
+  agent.navmesh = activeNavMeshObj;
+  agent.actuator = actuator;
+  agent.velocity = velocity;
+  agent.maxDeltaSpeed = maxDeltaSpeed;
+  agent.maxDeltaAngle = maxDeltaAngle;
+  agent.reach = 0.0f;
+
+  // The desired velocities of all the agents are known before any agent is solved.
+  vset(activeObst->dvel, velocity.x(), velocity.y());
+}
+
+void KX_ObstacleSimulation::PrepareObstacles()
+{
+  const unsigned int nobs = m_obstacles.size();
+  m_worldPos.resize(nobs);
+  m_worldPos2.resize(nobs);
+  m_maxObstacleRadius = 0.0f;
+  m_maxObstacleSpeed = 0.0f;
+
+  for (unsigned int i = 0; i < nobs; ++i) {
+    const KX_Obstacle *ob = m_obstacles[i];
+    if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
+      // Transform the segments once instead of once per sample.
+      if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
+        KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
+        m_worldPos[i] = navmeshobj->TransformToWorldCoords(ob->m_pos);
+        m_worldPos2[i] = navmeshobj->TransformToWorldCoords(ob->m_pos2);
+      }
+      else {
+        m_worldPos[i] = ob->m_pos;
+        m_worldPos2[i] = ob->m_pos2;
+      }
+    }
+    else {
+      m_worldPos[i] = ob->m_pos;
+      m_worldPos2[i] = ob->m_pos;
+      m_maxObstacleSpeed = std::max(m_maxObstacleSpeed, len_v2(ob->vel));
+    }
+    m_maxObstacleRadius = std::max(m_maxObstacleRadius, (float)ob->m_rad);
+  }
+}
+
+void KX_ObstacleSimulation::BuildGrid(float cellSize)
+{
+  const unsigned int nobs = m_obstacles.size();
+  unsigned int numBuckets = 16;
+  while (numBuckets < nobs * 2) {
+    numBuckets <<= 1;
+  }
+
+  m_gridCellSize = cellSize;
+  m_gridMask = numBuckets - 1;
+  m_gridBuckets.assign(numBuckets + 1, 0);
+
+  const float invCellSize = 1.0f / cellSize;
+  // Each obstacle is stored in all the cells overlapped by its bounding box.
+  auto forEachCell = [&](unsigned int i, auto func) {
+    const MT_Vector3 &p1 = m_worldPos[i];
+    const MT_Vector3 &p2 = m_worldPos2[i];
+    const float rad = m_obstacles[i]->m_rad;
+    const int x0 = (int)floorf((std::min(p1.x(), p2.x()) - rad) * invCellSize);
+    const int y0 = (int)floorf((std::min(p1.y(), p2.y()) - rad) * invCellSize);
+    const int x1 = (int)floorf((std::max(p1.x(), p2.x()) + rad) * invCellSize);
+    const int y1 = (int)floorf((std::max(p1.y(), p2.y()) + rad) * invCellSize);
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        func(grid_hash(x, y) & m_gridMask);
+      }
+    }
+  };
+
+  for (unsigned int i = 0; i < nobs; ++i) {
+    forEachCell(i, [this](unsigned int bucket) { ++m_gridBuckets[bucket]; });
+  }
+
+  // Convert the counts to bucket ends, the filling moves them to the bucket starts.
+  for (unsigned int i = 1; i < numBuckets; ++i) {
+    m_gridBuckets[i] += m_gridBuckets[i - 1];
+  }
+  m_gridBuckets[numBuckets] = m_gridBuckets[numBuckets - 1];
+  m_gridItems.resize(m_gridBuckets[numBuckets]);
+
+  for (unsigned int i = 0; i < nobs; ++i) {
+    forEachCell(i, [this, i](unsigned int bucket) { m_gridItems[--m_gridBuckets[bucket]] = i; });
+  }
+}
+
+void KX_ObstacleSimulation::FindNeighbors(Agent &agent) const
+{
+  const KX_Obstacle *activeObst = agent.obstacle;
+  Neighbors &neighbors = agent.neighbors;
+  neighbors.numCircles = 0;
+  neighbors.sx.clear();
+  neighbors.sy.clear();
+  neighbors.c.clear();
+  neighbors.vx.clear();
+  neighbors.vy.clear();
+  neighbors.rvo.clear();
+  neighbors.dpx.clear();
+  neighbors.dpy.clear();
+  neighbors.npx.clear();
+  neighbors.npy.clear();
+  neighbors.segments.clear();
+  neighbors.candidates.clear();
+
+  const MT_Vector3 &pos = activeObst->m_pos;
+  const float activePos[2] = {pos.x(), pos.y()};
+  const float extent = agent.reach + activeObst->m_rad + m_maxObstacleRadius;
+  const float invCellSize = 1.0f / m_gridCellSize;
+  const int x0 = (int)floorf((activePos[0] - extent) * invCellSize);
+  const int y0 = (int)floorf((activePos[1] - extent) * invCellSize);
+  const int x1 = (int)floorf((activePos[0] + extent) * invCellSize);
+  const int y1 = (int)floorf((activePos[1] + extent) * invCellSize);
+
+  for (int y = y0; y <= y1; ++y) {
+    for (int x = x0; x <= x1; ++x) {
+      const unsigned int bucket = grid_hash(x, y) & m_gridMask;
+      neighbors.candidates.insert(neighbors.candidates.end(),
+                                  m_gridItems.begin() + m_gridBuckets[bucket],
+                                  m_gridItems.begin() + m_gridBuckets[bucket + 1]);
+    }
+  }
+
+  // Obstacles overlapping several cells or sharing a bucket are found several times.
+  std::sort(neighbors.candidates.begin(), neighbors.candidates.end());
+  neighbors.candidates.erase(
+      std::unique(neighbors.candidates.begin(), neighbors.candidates.end()),
+      neighbors.candidates.end());
+
+  for (const unsigned int index : neighbors.candidates) {
+    const KX_Obstacle *ob = m_obstacles[index];
+    // filter obstacles by type
+    if (ob == activeObst ||
+        (ob->m_type == KX_OBSTACLE_NAV_MESH && ob->m_gameObj != agent.navmesh)) {
+      continue;
+    }
+
+    const float dist = activeObst->m_rad + ob->m_rad + agent.reach;
+    if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
+      // filter obstacles by position
+      if (fabsf(pos.z() - ob->m_pos.z()) > m_levelHeight) {
+        continue;
+      }
+
+      float dp[2] = {(float)ob->m_pos.x() - activePos[0], (float)ob->m_pos.y() - activePos[1]};
+      const float dist2 = len_squared_v2(dp);
+      if (dist2 > sqr(dist)) {
+        continue;
+      }
+
+      neighbors.sx.push_back(dp[0]);
+      neighbors.sy.push_back(dp[1]);
+      neighbors.c.push_back(dist2 - sqr(activeObst->m_rad + ob->m_rad));
+      neighbors.vx.push_back(ob->vel[0]);
+      neighbors.vy.push_back(ob->vel[1]);
+      // Stationary, use VO, else moving, use RVO.
+      neighbors.rvo.push_back((len_v2(ob->vel) < 0.01f * 0.01f) ? 0.0f : 1.0f);
+
+      // Side of the obstacle to pass, constant over all the samples.
+      const float orig[2] = {0, 0};
+      float dv[2], np[2];
+      normalize_v2(dp);
+      sub_v2_v2v2(dv, ob->dvel, activeObst->dvel);
+      /* TODO: use line_point_side_v2 */
+      if (area_tri_signed_v2(orig, dp, dv) < 0.01f) {
+        np[0] = -dp[1];
+        np[1] = dp[0];
+      }
+      else {
+        np[0] = dp[1];
+        np[1] = -dp[0];
+      }
+      neighbors.dpx.push_back(dp[0]);
+      neighbors.dpy.push_back(dp[1]);
+      neighbors.npx.push_back(np[0]);
+      neighbors.npy.push_back(np[1]);
+      ++neighbors.numCircles;
+    }
+    else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
+      const MT_Vector3 &p1 = m_worldPos[index];
+      const MT_Vector3 &p2 = m_worldPos2[index];
+      // filter obstacles by position
+      const MT_Vector3 p = nearestPointToSegment(pos, p1, p2);
+      if (fabsf(pos.z() - p.z()) > m_levelHeight) {
+        continue;
+      }
+
+      const float a[2] = {p1.x(), p1.y()};
+      const float b[2] = {p2.x(), p2.y()};
+      if (dist_squared_to_line_segment_v2(activePos, a, b) > sqr(dist)) {
+        continue;
+      }
+
+      neighbors.segments.push_back(index);
+    }
+  }
+
+  // Pad the circles to sweep them 4 at once, the padding circles are never hit.
+  while (neighbors.sx.size() % 4) {
+    neighbors.sx.push_back(0.0f);
+    neighbors.sy.push_back(0.0f);
+    neighbors.c.push_back(NO_CIRCLE);
+    neighbors.vx.push_back(0.0f);
+    neighbors.vy.push_back(0.0f);
+    neighbors.rvo.push_back(0.0f);
+    neighbors.dpx.push_back(0.0f);
+    neighbors.dpy.push_back(0.0f);
+    neighbors.npx.push_back(0.0f);
+    neighbors.npy.push_back(0.0f);
   }
+}
+
+float KX_ObstacleSimulation::GetAgentReach(const Agent & /*agent*/) const
+{
+  return 0.0f;
+}
 
-  return nullptr;
+void KX_ObstacleSimulation::SolveAgent(Agent & /*agent*/) const
+{
 }
 
-void KX_ObstacleSimulation::AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                                   KX_NavMeshObject *activeNavMeshObj,
-                                                   MT_Vector3 &velocity,
-                                                   MT_Scalar maxDeltaSpeed,
-                                                   MT_Scalar maxDeltaAngle)
+void KX_ObstacleSimulation::UpdateAgents()
 {
+  if (m_numAgents == 0) {
+    return;
+  }
+
+  PrepareObstacles();
+
+  // The cells are sized to the average neighbors query.
+  float cellSize = 0.0f;
+  for (unsigned int i = 0; i < m_numAgents; ++i) {
+    Agent &agent = m_agents[i];
+    agent.reach = GetAgentReach(agent);
+    cellSize += agent.reach + agent.obstacle->m_rad + m_maxObstacleRadius;
+  }
+  BuildGrid(std::max(cellSize / m_numAgents, 0.1f));
+
+  struct TaskData {
+    const KX_ObstacleSimulation *simulation;
+    Agent *agents;
+
+    static void Solve(void *__restrict userdata,
+                      const int i,
+                      const TaskParallelTLS *__restrict /*tls*/)
+    {
+      const TaskData *data = static_cast<TaskData *>(userdata);
+      Agent &agent = data->agents[i];
+      data->simulation->FindNeighbors(agent);
+      data->simulation->SolveAgent(agent);
+    }
+  };
+
+  TaskData data = {this, m_agents.data()};
+
+  /* An agent only writes its own velocities, the obstacles and the desired velocities
+   * of the other agents are only read, all the agents are solved in parallel. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (m_numAgents > AGENT_PARALLEL_THRESHOLD);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, m_numAgents, &data, TaskData::Solve, &settings);
+
+  // The velocities are applied to the objects from the main thread.
+  const unsigned int numAgents = m_numAgents;
+  m_numAgents = 0;
+  m_obstacleAgents.clear();
+  for (unsigned int i = 0; i < numAgents; ++i) {
+    const Agent &agent = m_agents[i];
+    agent.actuator->ApplySteering(agent.velocity);
+  }
 }
 
 void KX_ObstacleSimulation::DrawObstacles()
@@ -335,44 +702,182 @@ void KX_ObstacleSimulation::DrawObstacles()
   }
 }
 
-static MT_Vector3 nearestPointToObstacle(MT_Vector3 &pos, KX_Obstacle *obstacle)
+/** Sweep the agent against 4 circles at once for a sample velocity.
+ * The velocity relative to a circle is svel + rvo * (svel - vel - circle velocity).
+ * Keep the nearest time of impact ahead in tmin and the latest exit of an overlapped
+ * circle in tmine.
+ */
+static void sweepCirclesVO(const KX_ObstacleSimulation::Neighbors &neighbors,
+                           const float svel[2],
+                           const float vel[2],
+                           float &tmin,
+                           float &tmine)
 {
-  switch (obstacle->m_shape) {
-    case KX_OBSTACLE_SEGMENT: {
-      MT_Vector3 ab = obstacle->m_pos2 - obstacle->m_pos;
-      if (!ab.fuzzyZero()) {
-        const MT_Scalar dist = ab.length();
-        MT_Vector3 abdir = ab.normalized();
-        MT_Vector3 v = pos - obstacle->m_pos;
-        MT_Scalar proj = abdir.dot(v);
-        CLAMP(proj, 0, dist);
-        MT_Vector3 res = obstacle->m_pos + abdir * proj;
-        return res;
-      }
-      ATTR_FALLTHROUGH;
+  static const float EPS = 0.0001f;
+  const unsigned int size = neighbors.sx.size();
+
+#if BLI_HAVE_SSE2
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 eps = _mm_set1_ps(EPS);
+  const __m128 svx = _mm_set1_ps(svel[0]);
+  const __m128 svy = _mm_set1_ps(svel[1]);
+  const __m128 rx = _mm_set1_ps(svel[0] - vel[0]);
+  const __m128 ry = _mm_set1_ps(svel[1] - vel[1]);
+  __m128 tmin4 = _mm_set1_ps(tmin);
+  __m128 tmine4 = _mm_set1_ps(tmine);
+  for (unsigned int i = 0; i < size; i += 4) {
+    const __m128 rvo = _mm_loadu_ps(&neighbors.rvo[i]);
+    const __m128 vabx = _mm_add_ps(
+        svx, _mm_mul_ps(rvo, _mm_sub_ps(rx, _mm_loadu_ps(&neighbors.vx[i]))));
+    const __m128 vaby = _mm_add_ps(
+        svy, _mm_mul_ps(rvo, _mm_sub_ps(ry, _mm_loadu_ps(&neighbors.vy[i]))));
+    const __m128 a = _mm_add_ps(_mm_mul_ps(vabx, vabx), _mm_mul_ps(vaby, vaby));
+    const __m128 b = _mm_add_ps(_mm_mul_ps(vabx, _mm_loadu_ps(&neighbors.sx[i])),
+                                _mm_mul_ps(vaby, _mm_loadu_ps(&neighbors.sy[i])));
+    const __m128 d = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, _mm_loadu_ps(&neighbors.c[i])));
+    const __m128 hit = _mm_and_ps(_mm_cmpge_ps(a, eps), _mm_cmpge_ps(d, zero));
+    const __m128 sq = _mm_sqrt_ps(_mm_max_ps(d, zero));
+    const __m128 htmin = _mm_div_ps(_mm_sub_ps(b, sq), a);
+    const __m128 htmax = _mm_div_ps(_mm_add_ps(b, sq), a);
+
+    // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
+    const __m128 ahead = _mm_and_ps(hit, _mm_cmpgt_ps(htmin, zero));
+    tmin4 = _mm_min_ps(tmin4, _mm_or_ps(_mm_and_ps(ahead, htmin), _mm_andnot_ps(ahead, tmin4)));
+    // The agent overlaps the obstacle, keep track of first safe exit.
+    const __m128 overlap = _mm_and_ps(_mm_andnot_ps(ahead, hit), _mm_cmpgt_ps(htmax, zero));
+    tmine4 = _mm_max_ps(tmine4, _mm_and_ps(overlap, htmax));
+  }
+
+  float tmins[4], tmines[4];
+  _mm_storeu_ps(tmins, tmin4);
+  _mm_storeu_ps(tmines, tmine4);
+  tmin = std::min(std::min(tmins[0], tmins[1]), std::min(tmins[2], tmins[3]));
+  tmine = std::max(std::max(tmines[0], tmines[1]), std::max(tmines[2], tmines[3]));
+#else
+  for (unsigned int i = 0; i < size; ++i) {
+    const float rvo = neighbors.rvo[i];
+    const float vabx = svel[0] + rvo * (svel[0] - vel[0] - neighbors.vx[i]);
+    const float vaby = svel[1] + rvo * (svel[1] - vel[1] - neighbors.vy[i]);
+    const float a = vabx * vabx + vaby * vaby;
+    if (a < EPS) {
+      continue;
+    }
+    const float b = vabx * neighbors.sx[i] + vaby * neighbors.sy[i];
+    const float d = b * b - a * neighbors.c[i];
+    if (d < 0.0f) {
+      continue;
+    }
+    const float htmin = (b - sqrtf(d)) / a;
+    const float htmax = (b + sqrtf(d)) / a;
+
+    if (htmin > 0.0f) {
+      // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
+      if (htmin < tmin)
+        tmin = htmin;
+    }
+    else if (htmax > 0.0f) {
+      // The agent overlaps the obstacle, keep track of first safe exit.
+      if (htmax > tmine)
+        tmine = htmax;
     }
-    case KX_OBSTACLE_CIRCLE:
-    default:
-      return obstacle->m_pos;
   }
+#endif
 }
 
-static bool filterObstacle(KX_Obstacle *activeObst,
-                           KX_NavMeshObject *activeNavMeshObj,
-                           KX_Obstacle *otherObst,
-                           float levelHeight)
+/** Sweep the agent against 4 circles at once for a candidate velocity using RVO.
+ * Keep the nearest time of impact in tmin, overlapped circles are avoided more, and
+ * accumulate the side bias of all circles in side.
+ */
+static void sweepCirclesRVO(const KX_ObstacleSimulation::Neighbors &neighbors,
+                            const float vcand[2],
+                            const float vel[2],
+                            float &tmin,
+                            float &side)
 {
-  // filter obstacles by type
-  if ((otherObst == activeObst) ||
-      (otherObst->m_type == KX_OBSTACLE_NAV_MESH && otherObst->m_gameObj != activeNavMeshObj))
-    return false;
+  static const float EPS = 0.0001f;
+  const unsigned int size = neighbors.sx.size();
+
+#if BLI_HAVE_SSE2
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 eps = _mm_set1_ps(EPS);
+  const __m128 rx = _mm_set1_ps(2.0f * vcand[0] - vel[0]);
+  const __m128 ry = _mm_set1_ps(2.0f * vcand[1] - vel[1]);
+  __m128 tmin4 = _mm_set1_ps(tmin);
+  __m128 side4 = zero;
+  for (unsigned int i = 0; i < size; i += 4) {
+    const __m128 vabx = _mm_sub_ps(rx, _mm_loadu_ps(&neighbors.vx[i]));
+    const __m128 vaby = _mm_sub_ps(ry, _mm_loadu_ps(&neighbors.vy[i]));
+
+    // Side
+    const __m128 dpv = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&neighbors.dpx[i]), vabx),
+                                  _mm_mul_ps(_mm_loadu_ps(&neighbors.dpy[i]), vaby));
+    const __m128 npv = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&neighbors.npx[i]), vabx),
+                                  _mm_mul_ps(_mm_loadu_ps(&neighbors.npy[i]), vaby));
+    const __m128 sidev = _mm_mul_ps(_mm_min_ps(dpv, npv), _mm_set1_ps(2.0f));
+    side4 = _mm_add_ps(side4, _mm_min_ps(_mm_max_ps(sidev, zero), one));
+
+    const __m128 a = _mm_add_ps(_mm_mul_ps(vabx, vabx), _mm_mul_ps(vaby, vaby));
+    const __m128 b = _mm_add_ps(_mm_mul_ps(vabx, _mm_loadu_ps(&neighbors.sx[i])),
+                                _mm_mul_ps(vaby, _mm_loadu_ps(&neighbors.sy[i])));
+    const __m128 d = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, _mm_loadu_ps(&neighbors.c[i])));
+    const __m128 hit = _mm_and_ps(_mm_cmpge_ps(a, eps), _mm_cmpge_ps(d, zero));
+    const __m128 sq = _mm_sqrt_ps(_mm_max_ps(d, zero));
+    __m128 htmin = _mm_div_ps(_mm_sub_ps(b, sq), a);
+    const __m128 htmax = _mm_div_ps(_mm_add_ps(b, sq), a);
+
+    // Handle overlapping obstacles, avoid more when overlapped.
+    const __m128 overlap = _mm_and_ps(_mm_cmplt_ps(htmin, zero), _mm_cmpgt_ps(htmax, zero));
+    htmin = _mm_or_ps(_mm_and_ps(overlap, _mm_mul_ps(htmin, _mm_sub_ps(zero, half))),
+                      _mm_andnot_ps(overlap, htmin));
+
+    // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
+    const __m128 ahead = _mm_and_ps(hit, _mm_cmpge_ps(htmin, zero));
+    tmin4 = _mm_min_ps(tmin4, _mm_or_ps(_mm_and_ps(ahead, htmin), _mm_andnot_ps(ahead, tmin4)));
+  }
 
-  // filter obstacles by position
-  MT_Vector3 p = nearestPointToObstacle(activeObst->m_pos, otherObst);
-  if (fabsf(activeObst->m_pos.z() - p.z()) > levelHeight)
-    return false;
+  float tmins[4], sides[4];
+  _mm_storeu_ps(tmins, tmin4);
+  _mm_storeu_ps(sides, side4);
+  tmin = std::min(std::min(tmins[0], tmins[1]), std::min(tmins[2], tmins[3]));
+  side += (sides[0] + sides[1]) + (sides[2] + sides[3]);
+#else
+  for (unsigned int i = 0; i < size; ++i) {
+    // Moving, use RVO
+    const float vab[2] = {2.0f * vcand[0] - vel[0] - neighbors.vx[i],
+                          2.0f * vcand[1] - vel[1] - neighbors.vy[i]};
+
+    // Side
+    const float dp[2] = {neighbors.dpx[i], neighbors.dpy[i]};
+    const float np[2] = {neighbors.npx[i], neighbors.npy[i]};
+    side += clamp(std::min(dot_v2v2(dp, vab), dot_v2v2(np, vab)) * 2.0f, 0.0f, 1.0f);
+
+    const float a = dot_v2v2(vab, vab);
+    if (a < EPS) {
+      continue;
+    }
+    const float b = vab[0] * neighbors.sx[i] + vab[1] * neighbors.sy[i];
+    const float d = b * b - a * neighbors.c[i];
+    if (d < 0.0f) {
+      continue;
+    }
+    float htmin = (b - sqrtf(d)) / a;
+    const float htmax = (b + sqrtf(d)) / a;
+
+    // Handle overlapping obstacles.
+    if (htmin < 0.0f && htmax > 0.0f) {
+      // Avoid more when overlapped.
+      htmin = -htmin * 0.5f;
+    }
 
-  return true;
+    if (htmin >= 0.0f) {
+      // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
+      if (htmin < tmin)
+        tmin = htmin;
+    }
+  }
+#endif
 }
 
 ///////////*********TOI_rays**********/////////////////
@@ -388,34 +893,35 @@ KX_ObstacleSimulationTOI::KX_ObstacleSimulationTOI(MT_Scalar levelHeight, bool e
 {
 }
 
-void KX_ObstacleSimulationTOI::AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                                      KX_NavMeshObject *activeNavMeshObj,
-                                                      MT_Vector3 &velocity,
-                                                      MT_Scalar maxDeltaSpeed,
-                                                      MT_Scalar maxDeltaAngle)
+float KX_ObstacleSimulationTOI::GetAgentReach(const Agent &agent) const
 {
-  int nobs = m_obstacles.size();
-  int obstidx = std::find(m_obstacles.begin(), m_obstacles.end(), activeObst) -
-                m_obstacles.begin();
-  if (obstidx == nobs)
-    return;
+  /* The velocity relative to a neighbor is at most twice a sampled velocity minus the
+   * desired or current velocity and the velocity of the neighbor. */
+  const KX_Obstacle *activeObst = agent.obstacle;
+  const float vmax = len_v2(activeObst->dvel);
+  const float speed = (2.0f * GetMaxSampleSpeedFactor() + 1.0f) * vmax +
+                      len_v2(activeObst->vel) + m_maxObstacleSpeed;
+  return speed * m_maxToi;
+}
 
-  vset(activeObst->dvel, velocity.x(), velocity.y());
+void KX_ObstacleSimulationTOI::SolveAgent(Agent &agent) const
+{
+  KX_Obstacle *activeObst = agent.obstacle;
 
   // apply RVO
-  sampleRVO(activeObst, activeNavMeshObj, maxDeltaAngle);
+  sampleRVO(agent);
 
   // Fake dynamic constraint.
   float dv[2];
   float vel[2];
   sub_v2_v2v2(dv, activeObst->nvel, activeObst->vel);
   float ds = len_v2(dv);
-  if (ds > maxDeltaSpeed || ds < -maxDeltaSpeed)
-    mul_v2_fl(dv, fabs(maxDeltaSpeed / ds));
+  if (ds > agent.maxDeltaSpeed || ds < -agent.maxDeltaSpeed)
+    mul_v2_fl(dv, fabs(agent.maxDeltaSpeed / ds));
   add_v2_v2v2(vel, activeObst->vel, dv);
 
-  velocity.x() = vel[0];
-  velocity.y() = vel[1];
+  agent.velocity.x() = vel[0];
+  agent.velocity.y() = vel[1];
 }
 
 ///////////*********TOI_rays**********/////////////////
@@ -443,10 +949,18 @@ KX_ObstacleSimulationTOI_rays::KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeig
   m_collisionWeight = 100.0f;
 }
 
-void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
-                                              KX_NavMeshObject *activeNavMeshObj,
-                                              const float maxDeltaAngle)
+float KX_ObstacleSimulationTOI_rays::GetMaxSampleSpeedFactor() const
 {
+  // The samples only change the direction.
+  return 1.0f;
+}
+
+void KX_ObstacleSimulationTOI_rays::sampleRVO(Agent &agent) const
+{
+  KX_Obstacle *activeObst = agent.obstacle;
+  const Neighbors &neighbors = agent.neighbors;
+  const float maxDeltaAngle = agent.maxDeltaAngle;
+
   MT_Vector2 vel(activeObst->dvel[0], activeObst->dvel[1]);
   float vmax = (float)vel.length();
   float odir = (float)atan2(vel.y(), vel.x());
@@ -466,7 +980,6 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
   const int iforw = m_maxSamples / 2;
   const float aoff = (float)iforw / (float)m_maxSamples;
 
-  size_t nobs = m_obstacles.size();
   for (int iter = 0; iter < m_maxSamples; ++iter) {
     // Calculate sample velocity
     const float ndir = ((float)iter / (float)m_maxSamples) - aoff;
@@ -478,57 +991,21 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
     // Find min time of impact and exit amongst all obstacles.
     float tmin = m_maxToi;
     float tmine = 0.0f;
-    for (int i = 0; i < nobs; ++i) {
-      KX_Obstacle *ob = m_obstacles[i];
-      bool res = filterObstacle(activeObst, activeNavMeshObj, ob, m_levelHeight);
-      if (!res)
-        continue;
-
-      float htmin, htmax;
 
-      if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
-        MT_Vector2 vab;
-        if (len_v2(ob->vel) < 0.01f * 0.01f) {
-          // Stationary, use VO
-          vab = svel;
-        }
-        else {
-          // Moving, use RVO
-          vab = 2 * svel - vel - MT_Vector2(ob->vel);
-        }
+    const float svelv[2] = {svel.x(), svel.y()};
+    sweepCirclesVO(neighbors, svelv, activeObst->dvel, tmin, tmine);
 
-        if (!sweepCircleCircle(activeObst->m_pos.to2d(),
-                               activeObst->m_rad,
-                               vab,
-                               ob->m_pos.to2d(),
-                               ob->m_rad,
-                               htmin,
-                               htmax)) {
-          continue;
-        }
-      }
-      else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
-        MT_Vector3 p1 = ob->m_pos;
-        MT_Vector3 p2 = ob->m_pos2;
-        // apply world transform
-        if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
-          KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
-          p1 = navmeshobj->TransformToWorldCoords(p1);
-          p2 = navmeshobj->TransformToWorldCoords(p2);
-        }
-
-        if (!sweepCircleSegment(activeObst->m_pos.to2d(),
-                                activeObst->m_rad,
-                                svel,
-                                p1.to2d(),
-                                p2.to2d(),
-                                ob->m_rad,
-                                htmin,
-                                htmax)) {
-          continue;
-        }
-      }
-      else {
+    for (const unsigned int index : neighbors.segments) {
+      const KX_Obstacle *ob = m_obstacles[index];
+      float htmin, htmax;
+      if (!sweepCircleSegment(activeObst->m_pos.to2d(),
+                              activeObst->m_rad,
+                              svel,
+                              m_worldPos[index].to2d(),
+                              m_worldPos2[index].to2d(),
+                              ob->m_rad,
+                              htmin,
+                              htmax)) {
         continue;
       }
 
@@ -592,9 +1069,10 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
 ///////////********* TOI_cells**********/////////////////
 
 static void processSamples(KX_Obstacle *activeObst,
-                           KX_NavMeshObject *activeNavMeshObj,
-                           KX_Obstacles &obstacles,
-                           float levelHeight,
+                           const KX_ObstacleSimulation::Neighbors &neighbors,
+                           const KX_Obstacles &obstacles,
+                           const std::vector<MT_Vector3> &worldPos,
+                           const std::vector<MT_Vector3> &worldPos2,
                            const float vmax,
                            const float *spos,
                            const float cs,
@@ -622,114 +1100,50 @@ static void processSamples(KX_Obstacle *activeObst,
     // Find min time of impact and exit amongst all obstacles.
     float tmin = maxToi;
     float side = 0;
-    int nside = 0;
+    const int nside = neighbors.numCircles;
 
-    for (int i = 0; i < obstacles.size(); ++i) {
-      KX_Obstacle *ob = obstacles[i];
-      bool found = filterObstacle(activeObst, activeNavMeshObj, ob, levelHeight);
-      if (!found)
-        continue;
-      float htmin, htmax;
-
-      if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
-        float vab[2];
-
-        // Moving, use RVO
-        mul_v2_v2fl(vab, vcand, 2);
-        sub_v2_v2v2(vab, vab, activeObst->vel);
-        sub_v2_v2v2(vab, vab, ob->vel);
-
-        // Side
-        // NOTE: dp, and dv are constant over the whole calculation,
-        // they can be precomputed per object.
-        const float *pa = activeObstPos;
-        float pb[2];
-        vset(pb, ob->m_pos.x(), ob->m_pos.y());
-
-        const float orig[2] = {0, 0};
-        float dp[2], dv[2], np[2];
-        sub_v2_v2v2(dp, pb, pa);
-        normalize_v2(dp);
-        sub_v2_v2v2(dv, ob->dvel, activeObst->dvel);
-
-        /* TODO: use line_point_side_v2 */
-        if (area_tri_signed_v2(orig, dp, dv) < 0.01f) {
-          np[0] = -dp[1];
-          np[1] = dp[0];
-        }
-        else {
-          np[0] = dp[1];
-          np[1] = -dp[0];
-        }
+    sweepCirclesRVO(neighbors, vcand, activeObst->vel, tmin, side);
 
-        side += clamp(std::min(dot_v2v2(dp, vab), dot_v2v2(np, vab)) * 2.0f, 0.0f, 1.0f);
-        nside++;
+    for (const unsigned int index : neighbors.segments) {
+      const KX_Obstacle *ob = obstacles[index];
+      float htmin, htmax;
 
-        if (!sweepCircleCircle(activeObst->m_pos.to2d(),
-                               activeObst->m_rad,
-                               MT_Vector2(vab),
-                               ob->m_pos.to2d(),
-                               ob->m_rad,
-                               htmin,
-                               htmax)) {
+      float p[2], q[2];
+      vset(p, worldPos[index].x(), worldPos[index].y());
+      vset(q, worldPos2[index].x(), worldPos2[index].y());
+
+      // NOTE: the segments are assumed to come from a navmesh which is shrunken by
+      // the agent radius, hence the use of really small radius.
+      // This can be handle more efficiently by using seg-seg test instead.
+      // If the whole segment is to be treated as obstacle, use agent->rad instead of 0.01f!
+      const float r = 0.01f;  // agent->rad
+      if (dist_squared_to_line_segment_v2(activeObstPos, p, q) < sqr(r + ob->m_rad)) {
+        float sdir[2], snorm[2];
+        sub_v2_v2v2(sdir, q, p);
+        snorm[0] = sdir[1];
+        snorm[1] = -sdir[0];
+        // If the velocity is pointing towards the segment, no collision.
+        if (dot_v2v2(snorm, vcand) < 0.0f)
           continue;
-        }
-
-        // Handle overlapping obstacles.
-        if (htmin < 0.0f && htmax > 0.0f) {
-          // Avoid more when overlapped.
-          htmin = -htmin * 0.5f;
-        }
-      }
-      else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
-        MT_Vector3 p1 = ob->m_pos;
-        MT_Vector3 p2 = ob->m_pos2;
-        // apply world transform
-        if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
-          KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
-          p1 = navmeshobj->TransformToWorldCoords(p1);
-          p2 = navmeshobj->TransformToWorldCoords(p2);
-        }
-        float p[2], q[2];
-        vset(p, p1.x(), p1.y());
-        vset(q, p2.x(), p2.y());
-
-        // NOTE: the segments are assumed to come from a navmesh which is shrunken by
-        // the agent radius, hence the use of really small radius.
-        // This can be handle more efficiently by using seg-seg test instead.
-        // If the whole segment is to be treated as obstacle, use agent->rad instead of 0.01f!
-        const float r = 0.01f;  // agent->rad
-        if (dist_squared_to_line_segment_v2(activeObstPos, p, q) < sqr(r + ob->m_rad)) {
-          float sdir[2], snorm[2];
-          sub_v2_v2v2(sdir, q, p);
-          snorm[0] = sdir[1];
-          snorm[1] = -sdir[0];
-          // If the velocity is pointing towards the segment, no collision.
-          if (dot_v2v2(snorm, vcand) < 0.0f)
-            continue;
-          // Else immediate collision.
-          htmin = 0.0f;
-          htmax = 10.0f;
-        }
-        else {
-          if (!sweepCircleSegment(MT_Vector2(activeObstPos),
-                                  r,
-                                  MT_Vector2(vcand),
-                                  MT_Vector2(p),
-                                  MT_Vector2(q),
-                                  ob->m_rad,
-                                  htmin,
-                                  htmax))
-            continue;
-        }
-
-        // Avoid less when facing walls.
-        htmin *= 2.0f;
+        // Else immediate collision.
+        htmin = 0.0f;
+        htmax = 10.0f;
       }
       else {
-        continue;
+        if (!sweepCircleSegment(MT_Vector2(activeObstPos),
+                                r,
+                                MT_Vector2(vcand),
+                                MT_Vector2(p),
+                                MT_Vector2(q),
+                                ob->m_rad,
+                                htmin,
+                                htmax))
+          continue;
       }
 
+      // Avoid less when facing walls.
+      htmin *= 2.0f;
+
       if (htmin >= 0.0f) {
         // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
         if (htmin < tmin)
@@ -755,14 +1169,21 @@ static void processSamples(KX_Obstacle *activeObst,
   }
 }
 
-void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
-                                               KX_NavMeshObject *activeNavMeshObj,
-                                               const float maxDeltaAngle)
+float KX_ObstacleSimulationTOI_cells::GetMaxSampleSpeedFactor() const
 {
+  // The cells are kept in the desired speed extended by half a cell.
+  return 1.5f;
+}
+
+void KX_ObstacleSimulationTOI_cells::sampleRVO(Agent &agent) const
+{
+  KX_Obstacle *activeObst = agent.obstacle;
+  const Neighbors &neighbors = agent.neighbors;
+
   vset(activeObst->nvel, 0.f, 0.f);
   float vmax = len_v2(activeObst->dvel);
 
-  float *spos = new float[2 * m_maxSamples];
+  std::vector<float> spos(2 * m_maxSamples);
   int nspos = 0;
 
   if (!m_adaptive) {
@@ -785,11 +1206,12 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
       }
     }
     processSamples(activeObst,
-                   activeNavMeshObj,
+                   neighbors,
                    m_obstacles,
-                   m_levelHeight,
+                   m_worldPos,
+                   m_worldPos2,
                    vmax,
-                   spos,
+                   spos.data(),
                    cs / 2,
                    nspos,
                    activeObst->nvel,
@@ -826,11 +1248,12 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
       }
 
       processSamples(activeObst,
-                     activeNavMeshObj,
+                     neighbors,
                      m_obstacles,
-                     m_levelHeight,
+                     m_worldPos,
+                     m_worldPos2,
                      vmax,
-                     spos,
+                     spos.data(),
                      cs / 2,
                      nspos,
                      res,
@@ -844,8 +1267,6 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
     }
     copy_v2_v2(activeObst->nvel, res);
   }
-
-  delete[] spos;
 }
 
 KX_ObstacleSimulationTOI_cells::KX_ObstacleSimulationTOI_cells(MT_Scalar levelHeight,
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 
 #include "MT_Vector2.h"
@@ -62,15 +63,91 @@ struct KX_Obstacle {
 };
 typedef std::vector<KX_Obstacle *> KX_Obstacles;
 
+class SCA_SteeringActuator;
+
 class KX_ObstacleSimulation {
+ public:
+  /// Nearby obstacles of an agent, the circles are stored by component to be swept 4 at once.
+  struct Neighbors {
+    /// Number of circles, the arrays are padded to a multiple of 4 with circles never hit.
+    unsigned int numCircles;
+    /// Position relative to the agent.
+    std::vector<float> sx;
+    std::vector<float> sy;
+    /// Squared distance minus squared radius sum, the constant term of the sweep.
+    std::vector<float> c;
+    /// Velocity of the obstacle.
+    std::vector<float> vx;
+    std::vector<float> vy;
+    /// 0 if the obstacle is stationary and the velocity obstacle is used, else 1 for RVO.
+    std::vector<float> rvo;
+    /// Direction to the obstacle and its normal toward the passing side.
+    std::vector<float> dpx;
+    std::vector<float> dpy;
+    std::vector<float> npx;
+    std::vector<float> npy;
+
+    /// Indices of the segment obstacles.
+    std::vector<unsigned int> segments;
+    /// Obstacles found in the spatial hash, before filtering.
+    std::vector<unsigned int> candidates;
+  };
+
+  /// Obstacle asking for a velocity in the current frame.
+  struct Agent {
+    KX_Obstacle *obstacle;
+    KX_NavMeshObject *navmesh;
+    SCA_SteeringActuator *actuator;
+    /// Desired velocity, replaced by the adjusted velocity once solved.
+    MT_Vector3 velocity;
+    float maxDeltaSpeed;
+    float maxDeltaAngle;
+    /// Distance the agent and its neighbors can travel toward each other while sampling.
+    float reach;
+    /// Neighbors buffer kept between frames to reuse the memory.
+    Neighbors neighbors;
+  };
+
  protected:
   KX_Obstacles m_obstacles;
+  /// Obstacle of each game object, navigation meshes own several obstacles and aren't stored.
+  std::unordered_map<KX_GameObject *, KX_Obstacle *> m_objectObstacles;
+
+  /// Agents of the current frame, only the first m_numAgents are used.
+  std::vector<Agent> m_agents;
+  unsigned int m_numAgents;
+  /// Agent of each obstacle in the current frame, an obstacle is solved by a single agent.
+  std::unordered_map<KX_Obstacle *, unsigned int> m_obstacleAgents;
+
+  /** Spatial hash of the obstacles, built once per frame. The obstacles of a bucket are
+   * stored in m_gridItems from m_gridBuckets[bucket] to m_gridBuckets[bucket + 1].
+   */
+  float m_gridCellSize;
+  unsigned int m_gridMask;
+  std::vector<unsigned int> m_gridBuckets;
+  std::vector<unsigned int> m_gridItems;
+  /// World space end points of the segments, indexed as m_obstacles.
+  std::vector<MT_Vector3> m_worldPos;
+  std::vector<MT_Vector3> m_worldPos2;
+  /// Largest radius and speed of the circle obstacles, used to bound the neighbor queries.
+  float m_maxObstacleRadius;
+  float m_maxObstacleSpeed;
 
   MT_Scalar m_levelHeight;
   bool m_enableVisualization;
 
   KX_Obstacle *CreateObstacle(KX_GameObject *gameobj);
 
+  /// Compute the world space segments and the obstacles bounds.
+  void PrepareObstacles();
+  void BuildGrid(float cellSize);
+  /// Gather the obstacles closer than the agent reach.
+  void FindNeighbors(Agent &agent) const;
+  /// Return the reach of an agent, obstacles further than it can't change its velocity.
+  virtual float GetAgentReach(const Agent &agent) const;
+  /// Compute the new velocity of an agent in its obstacle nvel, called from multiple threads.
+  virtual void SolveAgent(Agent &agent) const;
+
  public:
   KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization);
   virtual ~KX_ObstacleSimulation();
@@ -83,11 +160,19 @@ class KX_ObstacleSimulation {
   void AddObstaclesForNavMesh(KX_NavMeshObject *navmesh);
   KX_Obstacle *GetObstacle(KX_GameObject *gameobj);
   void UpdateObstacles();
-  virtual void AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                      KX_NavMeshObject *activeNavMeshObj,
-                                      MT_Vector3 &velocity,
-                                      MT_Scalar maxDeltaSpeed,
-                                      MT_Scalar maxDeltaAngle);
+
+  /** Ask for an obstacle avoiding velocity, the actuator receives it in ApplySteering
+   * once all the agents of the frame are solved by UpdateAgents. When several actuators
+   * steer the same obstacle in a frame only the last one added is solved and applied.
+   */
+  void AddAgent(KX_Obstacle *activeObst,
+                KX_NavMeshObject *activeNavMeshObj,
+                SCA_SteeringActuator *actuator,
+                const MT_Vector3 &velocity,
+                MT_Scalar maxDeltaSpeed,
+                MT_Scalar maxDeltaAngle);
+  /// Solve the velocities of all the agents added during the frame in parallel.
+  void UpdateAgents();
 };
 class KX_ObstacleSimulationTOI : public KX_ObstacleSimulation {
  protected:
@@ -99,24 +184,20 @@ class KX_ObstacleSimulationTOI : public KX_ObstacleSimulation {
   float m_toiWeight;        // Sample selection TOI weight
   float m_collisionWeight;  // Sample selection collision weight
 
-  virtual void sampleRVO(KX_Obstacle *activeObst,
-                         KX_NavMeshObject *activeNavMeshObj,
-                         const float maxDeltaAngle) = 0;
+  /// Factor of the desired speed bounding the speed of the sampled velocities.
+  virtual float GetMaxSampleSpeedFactor() const = 0;
+  virtual void sampleRVO(Agent &agent) const = 0;
+  virtual float GetAgentReach(const Agent &agent) const;
+  virtual void SolveAgent(Agent &agent) const;
 
  public:
   KX_ObstacleSimulationTOI(MT_Scalar levelHeight, bool enableVisualization);
-  virtual void AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                      KX_NavMeshObject *activeNavMeshObj,
-                                      MT_Vector3 &velocity,
-                                      MT_Scalar maxDeltaSpeed,
-                                      MT_Scalar maxDeltaAngle);
 };
 
 class KX_ObstacleSimulationTOI_rays : public KX_ObstacleSimulationTOI {
  protected:
-  virtual void sampleRVO(KX_Obstacle *activeObst,
-                         KX_NavMeshObject *activeNavMeshObj,
-                         const float maxDeltaAngle);
+  virtual float GetMaxSampleSpeedFactor() const;
+  virtual void sampleRVO(Agent &agent) const;
 
  public:
   KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeight, bool enableVisualization);
@@ -127,9 +208,8 @@ class KX_ObstacleSimulationTOI_cells : public KX_ObstacleSimulationTOI {
   float m_bias;
   bool m_adaptive;
   int m_sampleRadius;
-  virtual void sampleRVO(KX_Obstacle *activeObst,
-                         KX_NavMeshObject *activeNavMeshObj,
-                         const float maxDeltaAngle);
+  virtual float GetMaxSampleSpeedFactor() const;
+  virtual void sampleRVO(Agent &agent) const;
 
  public:
   KX_ObstacleSimulationTOI_cells(MT_Scalar levelHeight, bool enableVisualization);
@@ -0,0 +1,406 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/Ketsji/KX_OcclusionBuffer.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_OcclusionBuffer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "BLI_simd.h"
+
+#include "RAS_IVertex.h"
+#include "RAS_MeshObject.h"
+#include "RAS_Polygon.h"
+
+KX_OcclusionBuffer::KX_OcclusionBuffer()
+    : m_width(0), m_height(0), m_tilesX(0), m_tilesY(0), m_numLevels(0), m_numOccluders(0)
+{
+  std::fill(m_worldToClip, m_worldToClip + 16, 0.0f);
+}
+
+void KX_OcclusionBuffer::Setup(int resolution,
+                               int width,
+                               int height,
+                               const MT_Matrix4x4 &worldToClip)
+{
+  const int maxsize = std::max(std::max(width, height), 1);
+  // Keep the viewport aspect ratio and round the size to whole tiles.
+  m_tilesX = std::max(1, (resolution * width / maxsize + TILE_SIZE - 1) / TILE_SIZE);
+  m_tilesY = std::max(1, (resolution * height / maxsize + TILE_SIZE - 1) / TILE_SIZE);
+  m_width = m_tilesX * TILE_SIZE;
+  m_height = m_tilesY * TILE_SIZE;
+
+  m_depth.assign(m_width * m_height, 1.0f);
+
+  for (unsigned short i = 0; i < 4; ++i) {
+    for (unsigned short j = 0; j < 4; ++j) {
+      m_worldToClip[i * 4 + j] = worldToClip[i][j];
+    }
+  }
+
+  m_numLevels = 0;
+  m_numOccluders = 0;
+}
+
+/**
+ * Write the depth of a triangle in a tile, the covered pixels are the pixels where the three
+ * edge functions are positive.
+ * \param edges The coefficients a, b, c of the edge functions a * x + b * y + c.
+ * \param plane The coefficients of the depth plane, same form as the edges.
+ * \param covered True if the whole tile is inside the triangle.
+ */
+static void rasterize_tile(float *tile,
+                           float x0,
+                           float y0,
+                           const float edges[3][3],
+                           const float plane[3],
+                           bool covered)
+{
+  const int size = KX_OcclusionBuffer::TILE_SIZE;
+
+#if BLI_HAVE_SSE2
+  const __m128 zero = _mm_setzero_ps();
+  for (int col = 0; col < size; col += 4) {
+    const __m128 px = _mm_add_ps(_mm_set1_ps(x0 + col), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+    const __m128 e0x = _mm_mul_ps(_mm_set1_ps(edges[0][0]), px);
+    const __m128 e1x = _mm_mul_ps(_mm_set1_ps(edges[1][0]), px);
+    const __m128 e2x = _mm_mul_ps(_mm_set1_ps(edges[2][0]), px);
+    const __m128 zx = _mm_mul_ps(_mm_set1_ps(plane[0]), px);
+
+    for (int row = 0; row < size; ++row) {
+      const float py = y0 + row + 0.5f;
+      float *dst = tile + row * size + col;
+
+      const __m128 z = _mm_max_ps(_mm_add_ps(zx, _mm_set1_ps(plane[1] * py + plane[2])), zero);
+      const __m128 old = _mm_loadu_ps(dst);
+      __m128 depth = _mm_min_ps(old, z);
+
+      if (!covered) {
+        __m128 mask = _mm_cmpge_ps(_mm_add_ps(e0x, _mm_set1_ps(edges[0][1] * py + edges[0][2])),
+                                   zero);
+        mask = _mm_and_ps(
+            mask,
+            _mm_cmpge_ps(_mm_add_ps(e1x, _mm_set1_ps(edges[1][1] * py + edges[1][2])), zero));
+        mask = _mm_and_ps(
+            mask,
+            _mm_cmpge_ps(_mm_add_ps(e2x, _mm_set1_ps(edges[2][1] * py + edges[2][2])), zero));
+        depth = _mm_or_ps(_mm_and_ps(mask, depth), _mm_andnot_ps(mask, old));
+      }
+
+      _mm_storeu_ps(dst, depth);
+    }
+  }
+#else
+  for (int row = 0; row < size; ++row) {
+    const float py = y0 + row + 0.5f;
+    float *dst = tile + row * size;
+    for (int col = 0; col < size; ++col) {
+      const float px = x0 + col + 0.5f;
+      if (!covered) {
+        bool inside = true;
+        for (unsigned short i = 0; i < 3; ++i) {
+          inside &= (edges[i][0] * px + edges[i][1] * py + edges[i][2]) >= 0.0f;
+        }
+        if (!inside) {
+          continue;
+        }
+      }
+      const float z = std::max(plane[0] * px + plane[1] * py + plane[2], 0.0f);
+      dst[col] = std::min(dst[col], z);
+    }
+  }
+#endif
+}
+
+void KX_OcclusionBuffer::RasterizeTriangle(const float a[3],
+                                           const float b[3],
+                                           const float c[3],
+                                           float face)
+{
+  float area = (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+  if ((face * area) < 0.0f || std::fabs(area) < 1e-6f) {
+    return;
+  }
+  // Double sided faces can have a negative area, make the triangle counter clockwise.
+  if (area < 0.0f) {
+    std::swap(b, c);
+    area = -area;
+  }
+
+  const float *verts[3] = {a, b, c};
+  float edges[3][3];
+  for (unsigned short i = 0; i < 3; ++i) {
+    const float *p0 = verts[i];
+    const float *p1 = verts[(i + 1) % 3];
+    edges[i][0] = p0[1] - p1[1];
+    edges[i][1] = p1[0] - p0[0];
+    edges[i][2] = -(edges[i][0] * p0[0] + edges[i][1] * p0[1]);
+  }
+
+  const float dzdx = ((b[2] - a[2]) * (c[1] - a[1]) - (c[2] - a[2]) * (b[1] - a[1])) / area;
+  const float dzdy = ((c[2] - a[2]) * (b[0] - a[0]) - (b[2] - a[2]) * (c[0] - a[0])) / area;
+  const float plane[3] = {dzdx, dzdy, a[2] - dzdx * a[0] - dzdy * a[1]};
+
+  const int minx = std::max(0, (int)std::floor(std::min({a[0], b[0], c[0]})));
+  const int maxx = std::min(m_width - 1, (int)std::ceil(std::max({a[0], b[0], c[0]})));
+  const int miny = std::max(0, (int)std::floor(std::min({a[1], b[1], c[1]})));
+  const int maxy = std::min(m_height - 1, (int)std::ceil(std::max({a[1], b[1], c[1]})));
+  if (minx > maxx || miny > maxy) {
+    return;
+  }
+
+  for (int ty = miny / TILE_SIZE, tymax = maxy / TILE_SIZE; ty <= tymax; ++ty) {
+    const float y0 = ty * TILE_SIZE;
+    const float ylo = y0 + 0.5f;
+    const float yhi = y0 + TILE_SIZE - 0.5f;
+
+    for (int tx = minx / TILE_SIZE, txmax = maxx / TILE_SIZE; tx <= txmax; ++tx) {
+      const float x0 = tx * TILE_SIZE;
+      const float xlo = x0 + 0.5f;
+      const float xhi = x0 + TILE_SIZE - 0.5f;
+
+      /* The edge functions are linear, their extremums over the tile are found at the corners
+       * given by the sign of their coefficients. */
+      bool outside = false;
+      bool covered = true;
+      for (unsigned short i = 0; i < 3; ++i) {
+        const float *e = edges[i];
+        const float emax = e[0] * ((e[0] > 0.0f) ? xhi : xlo) +
+                           e[1] * ((e[1] > 0.0f) ? yhi : ylo) + e[2];
+        const float emin = e[0] * ((e[0] > 0.0f) ? xlo : xhi) +
+                           e[1] * ((e[1] > 0.0f) ? ylo : yhi) + e[2];
+        outside |= (emax < 0.0f);
+        covered &= (emin >= 0.0f);
+      }
+
+      if (!outside) {
+        float *tile = &m_depth[(ty * m_tilesX + tx) * TILE_SIZE * TILE_SIZE];
+        rasterize_tile(tile, x0, y0, edges, plane, covered);
+      }
+    }
+  }
+}
+
+void KX_OcclusionBuffer::DrawTriangle(const float a[4],
+                                      const float b[4],
+                                      const float c[4],
+                                      float face)
+{
+  const float *verts[3] = {a, b, c};
+
+  // Reject the triangles fully outside of a side plane or of the far plane.
+  for (unsigned short axis = 0; axis < 3; ++axis) {
+    if (a[axis] > a[3] && b[axis] > b[3] && c[axis] > c[3]) {
+      return;
+    }
+    if (axis < 2 && a[axis] < -a[3] && b[axis] < -b[3] && c[axis] < -c[3]) {
+      return;
+    }
+  }
+
+  // Clip against the near plane, a triangle becomes at most a quad.
+  float poly[4][4];
+  int numverts = 0;
+  for (unsigned short i = 0; i < 3; ++i) {
+    const float *p0 = verts[i];
+    const float *p1 = verts[(i + 1) % 3];
+    const float d0 = p0[2] + p0[3];
+    const float d1 = p1[2] + p1[3];
+
+    if (d0 >= 0.0f) {
+      std::copy(p0, p0 + 4, poly[numverts++]);
+    }
+    if ((d0 >= 0.0f) != (d1 >= 0.0f)) {
+      const float t = d0 / (d0 - d1);
+      for (unsigned short j = 0; j < 4; ++j) {
+        poly[numverts][j] = p0[j] + (p1[j] - p0[j]) * t;
+      }
+      ++numverts;
+    }
+  }
+
+  if (numverts < 3) {
+    return;
+  }
+
+  float screen[4][3];
+  for (int i = 0; i < numverts; ++i) {
+    if (poly[i][3] <= FLT_EPSILON) {
+      return;
+    }
+    const float invw = 1.0f / poly[i][3];
+    screen[i][0] = (poly[i][0] * invw * 0.5f + 0.5f) * m_width;
+    screen[i][1] = (poly[i][1] * invw * 0.5f + 0.5f) * m_height;
+    screen[i][2] = poly[i][2] * invw * 0.5f + 0.5f;
+  }
+
+  RasterizeTriangle(screen[0], screen[1], screen[2], face);
+  if (numverts == 4) {
+    RasterizeTriangle(screen[0], screen[2], screen[3], face);
+  }
+}
+
+void KX_OcclusionBuffer::AddOccluder(RAS_MeshObject *mesh,
+                                     const MT_Matrix4x4 &objectToWorld,
+                                     bool negativeScale)
+{
+  float modelToClip[16];
+  for (unsigned short i = 0; i < 4; ++i) {
+    for (unsigned short j = 0; j < 4; ++j) {
+      modelToClip[i * 4 + j] = m_worldToClip[i * 4] * objectToWorld[0][j] +
+                               m_worldToClip[i * 4 + 1] * objectToWorld[1][j] +
+                               m_worldToClip[i * 4 + 2] * objectToWorld[2][j] +
+                               m_worldToClip[i * 4 + 3] * objectToWorld[3][j];
+    }
+  }
+
+  const float face = negativeScale ? -1.0f : 1.0f;
+
+  for (int i = 0, size = mesh->NumPolygons(); i < size; ++i) {
+    RAS_Polygon *poly = mesh->GetPolygon(i);
+    const int numverts = std::min(poly->VertexCount(), 4);
+    if (!poly->IsVisible() || numverts < 3) {
+      continue;
+    }
+
+    float clip[4][4];
+    for (int j = 0; j < numverts; ++j) {
+      const float *co = poly->GetVertex(j)->getXYZ();
+      for (unsigned short k = 0; k < 4; ++k) {
+        const float *m = &modelToClip[k * 4];
+        clip[j][k] = m[0] * co[0] + m[1] * co[1] + m[2] * co[2] + m[3];
+      }
+    }
+
+    const float polyFace = poly->IsTwoside() ? 0.0f : face;
+    DrawTriangle(clip[0], clip[1], clip[2], polyFace);
+    if (numverts == 4) {
+      DrawTriangle(clip[0], clip[2], clip[3], polyFace);
+    }
+  }
+
+  ++m_numOccluders;
+}
+
+void KX_OcclusionBuffer::Finalize()
+{
+  m_numLevels = 0;
+  if (m_numOccluders == 0) {
+    return;
+  }
+
+  int width = m_tilesX;
+  int height = m_tilesY;
+  while (true) {
+    if (m_levels.size() <= m_numLevels) {
+      m_levels.emplace_back();
+    }
+    Level &level = m_levels[m_numLevels];
+    level.m_width = width;
+    level.m_height = height;
+    level.m_depth.resize(width * height);
+
+    if (m_numLevels == 0) {
+      const int tileArea = TILE_SIZE * TILE_SIZE;
+      for (int i = 0, size = width * height; i < size; ++i) {
+        const float *tile = &m_depth[i * tileArea];
+        level.m_depth[i] = *std::max_element(tile, tile + tileArea);
+      }
+    }
+    else {
+      const Level &prev = m_levels[m_numLevels - 1];
+      for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+          float depth = 0.0f;
+          for (int py = y * 2, pymax = std::min(py + 2, prev.m_height); py < pymax; ++py) {
+            for (int px = x * 2, pxmax = std::min(px + 2, prev.m_width); px < pxmax; ++px) {
+              depth = std::max(depth, prev.m_depth[py * prev.m_width + px]);
+            }
+          }
+          level.m_depth[y * width + x] = depth;
+        }
+      }
+    }
+
+    ++m_numLevels;
+    if (width == 1 && height == 1) {
+      break;
+    }
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+  }
+}
+
+bool KX_OcclusionBuffer::IsOccluded(const std::array<MT_Vector3, 8> &box) const
+{
+  if (m_numLevels == 0) {
+    return false;
+  }
+
+  float minx = FLT_MAX;
+  float miny = FLT_MAX;
+  float minz = FLT_MAX;
+  float maxx = -FLT_MAX;
+  float maxy = -FLT_MAX;
+  const float *m = m_worldToClip;
+  for (const MT_Vector3 &point : box) {
+    float clip[4];
+    for (unsigned short i = 0; i < 4; ++i) {
+      clip[i] = m[i * 4] * point.x() + m[i * 4 + 1] * point.y() + m[i * 4 + 2] * point.z() +
+                m[i * 4 + 3];
+    }
+    // The box crosses the near plane, it can't be hidden.
+    if (clip[2] < -clip[3] || clip[3] <= FLT_EPSILON) {
+      return false;
+    }
+
+    const float invw = 1.0f / clip[3];
+    const float x = (clip[0] * invw * 0.5f + 0.5f) * m_width;
+    const float y = (clip[1] * invw * 0.5f + 0.5f) * m_height;
+    minx = std::min(minx, x);
+    maxx = std::max(maxx, x);
+    miny = std::min(miny, y);
+    maxy = std::max(maxy, y);
+    minz = std::min(minz, clip[2] * invw * 0.5f + 0.5f);
+  }
+
+  // Outside of the view, let the frustum culling decide.
+  if (maxx < 0.0f || maxy < 0.0f || minx >= m_width || miny >= m_height) {
+    return false;
+  }
+
+  int x0 = std::max(0, (int)minx) / TILE_SIZE;
+  int x1 = std::min(m_width - 1, (int)maxx) / TILE_SIZE;
+  int y0 = std::max(0, (int)miny) / TILE_SIZE;
+  int y1 = std::min(m_height - 1, (int)maxy) / TILE_SIZE;
+
+  // Go up in the pyramid until the box covers at most 4x4 texels.
+  unsigned int levelIndex = 0;
+  while ((x1 - x0 > 3 || y1 - y0 > 3) && levelIndex + 1 < m_numLevels) {
+    x0 >>= 1;
+    x1 >>= 1;
+    y0 >>= 1;
+    y1 >>= 1;
+    ++levelIndex;
+  }
+
+  const Level &level = m_levels[levelIndex];
+  for (int y = y0; y <= y1; ++y) {
+    for (int x = x0; x <= x1; ++x) {
+      if (level.m_depth[y * level.m_width + x] >= minz) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+unsigned int KX_OcclusionBuffer::GetNumOccluders() const
+{
+  return m_numOccluders;
+}
@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file KX_OcclusionBuffer.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "MT_Matrix4x4.h"
+#include "MT_Vector3.h"
+
+class RAS_MeshObject;
+
+/**
+ * Software depth buffer used to cull the objects hidden behind occluders.
+ * The buffer is split in tiles of TILE_SIZE x TILE_SIZE pixels stored contiguously. Occluder
+ * triangles are rasterized tile by tile: the tiles outside of the triangle are skipped, the
+ * tiles fully inside skip the edge tests and the others test four pixels at once using SSE2
+ * when available. The farthest depth of each tile is then reduced in a pyramid used to test
+ * the screen bounds of an occludee with a few reads.
+ */
+class KX_OcclusionBuffer {
+ public:
+  enum { TILE_SIZE = 8 };
+
+ private:
+  struct Level {
+    int m_width;
+    int m_height;
+    /// Farthest depth of the texels of the finer level covered by each texel.
+    std::vector<float> m_depth;
+  };
+
+  int m_width;
+  int m_height;
+  int m_tilesX;
+  int m_tilesY;
+  /// Depth of each pixel in [0, 1], tile by tile.
+  std::vector<float> m_depth;
+  /// Depth pyramid, the first level has one texel per tile.
+  std::vector<Level> m_levels;
+  unsigned int m_numLevels;
+
+  /// Camera world to clip matrix, row major.
+  float m_worldToClip[16];
+  /// Number of occluders rasterized since the last setup.
+  unsigned int m_numOccluders;
+
+  /// Clip a triangle in clip space against the near plane and rasterize it.
+  void DrawTriangle(const float a[4], const float b[4], const float c[4], float face);
+  /// Rasterize a triangle in screen space, face is 0 for two sided faces.
+  void RasterizeTriangle(const float a[3], const float b[3], const float c[3], float face);
+
+ public:
+  KX_OcclusionBuffer();
+  ~KX_OcclusionBuffer() = default;
+
+  /**
+   * Clear the buffer for a new query.
+   * \param resolution The size in pixels of the largest viewport dimension.
+   * \param width The viewport width, used for the aspect ratio.
+   * \param height The viewport height, used for the aspect ratio.
+   * \param worldToClip The camera projection matrix multiplied by the modelview matrix.
+   */
+  void Setup(int resolution, int width, int height, const MT_Matrix4x4 &worldToClip);
+
+  /**
+   * Rasterize the visible polygons of a mesh.
+   * \param objectToWorld The transform of the object using the mesh.
+   * \param negativeScale True if the object transform flips the faces.
+   */
+  void AddOccluder(RAS_MeshObject *mesh, const MT_Matrix4x4 &objectToWorld, bool negativeScale);
+
+  /// Build the depth pyramid, must be called once all the occluders are added.
+  void Finalize();
+
+  /// Return true if the box given by its world space corners is hidden by the occluders.
+  bool IsOccluded(const std::array<MT_Vector3, 8> &box) const;
+
+  unsigned int GetNumOccluders() const;
+};
@@ -0,0 +1,466 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_PathQueryManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_PathQueryManager.h"
+
+#include <algorithm>
+
+#include "BLI_task.h"
+#include "BLI_time.h"
+
+#include "DetourNode.h"
+#include "KX_NavMeshObject.h"
+
+/// Maximum number of polygons in a corridor.
+static const int max_corridor_polys = 256;
+/// Maximum number of corridors kept in the cache.
+static const unsigned int max_cache_size = 4096;
+/// Worker time given to the searches each frame, in seconds.
+static const double path_query_time_budget = 0.002;
+/// Search duration assumed before the first search finishes, in seconds.
+static const double default_job_time = 0.0002;
+
+template <class NavMesh, class PolyRef>
+static void searchCorridor(NavMesh *navmesh,
+                           unsigned int startRef,
+                           unsigned int endRef,
+                           const float *spos,
+                           const float *epos,
+                           dtNodePool *nodePool,
+                           dtNodeQueue *openList,
+                           std::vector<unsigned int> &corridor)
+{
+  PolyRef polys[max_corridor_polys];
+  const int npolys = nodePool ? navmesh->findPath((PolyRef)startRef,
+                                                  (PolyRef)endRef,
+                                                  spos,
+                                                  epos,
+                                                  polys,
+                                                  max_corridor_polys,
+                                                  nodePool,
+                                                  openList) :
+                                navmesh->findPath((PolyRef)startRef,
+                                                  (PolyRef)endRef,
+                                                  spos,
+                                                  epos,
+                                                  polys,
+                                                  max_corridor_polys);
+  corridor.assign(polys, polys + npolys);
+}
+
+template <class NavMesh, class PolyRef>
+static int straightPath(NavMesh *navmesh,
+                        const std::vector<unsigned int> &corridor,
+                        const float *spos,
+                        const float *epos,
+                        float *path,
+                        int maxPathLen)
+{
+  if (corridor.empty()) {
+    return 0;
+  }
+
+  PolyRef polys[max_corridor_polys];
+  std::copy(corridor.begin(), corridor.end(), polys);
+  return navmesh->findStraightPath(spos, epos, polys, (int)corridor.size(), path, maxPathLen);
+}
+
+/// Search a corridor with the given search nodes, or the navigation mesh ones if null.
+static void searchCorridor(KX_NavMeshObject *navmesh,
+                           unsigned int startRef,
+                           unsigned int endRef,
+                           const float *spos,
+                           const float *epos,
+                           dtNodePool *nodePool,
+                           dtNodeQueue *openList,
+                           std::vector<unsigned int> &corridor)
+{
+  if (dtTiledNavMesh *tiledNavMesh = navmesh->GetTiledNavMesh()) {
+    searchCorridor<dtTiledNavMesh, dtTilePolyRef>(
+        tiledNavMesh, startRef, endRef, spos, epos, nodePool, openList, corridor);
+  }
+  else if (dtStatNavMesh *statNavMesh = navmesh->GetNavMesh()) {
+    searchCorridor<dtStatNavMesh, dtStatPolyRef>(
+        statNavMesh, startRef, endRef, spos, epos, nodePool, openList, corridor);
+  }
+  else {
+    corridor.clear();
+  }
+}
+
+static int straightPath(KX_NavMeshObject *navmesh,
+                        const std::vector<unsigned int> &corridor,
+                        const float *spos,
+                        const float *epos,
+                        float *path,
+                        int maxPathLen)
+{
+  if (dtTiledNavMesh *tiledNavMesh = navmesh->GetTiledNavMesh()) {
+    return straightPath<dtTiledNavMesh, dtTilePolyRef>(
+        tiledNavMesh, corridor, spos, epos, path, maxPathLen);
+  }
+  else if (dtStatNavMesh *statNavMesh = navmesh->GetNavMesh()) {
+    return straightPath<dtStatNavMesh, dtStatPolyRef>(
+        statNavMesh, corridor, spos, epos, path, maxPathLen);
+  }
+  return 0;
+}
+
+KX_PathQuery::KX_PathQuery(KX_NavMeshObject *navmesh,
+                           const MT_Transform &worldTransform,
+                           const float spos[3],
+                           const float epos[3],
+                           int maxPathLen)
+    : m_navmesh(navmesh),
+      m_spos{spos[0], spos[1], spos[2]},
+      m_epos{epos[0], epos[1], epos[2]},
+      m_maxPathLen(maxPathLen),
+      m_worldTransform(worldTransform),
+      m_done(false)
+{
+}
+
+bool KX_PathQuery::IsDone() const
+{
+  return m_done;
+}
+
+const std::vector<float> &KX_PathQuery::GetPath() const
+{
+  return m_path;
+}
+
+int KX_PathQuery::GetPathLen() const
+{
+  return (int)m_path.size() / 3;
+}
+
+bool KX_PathQueryManager::CacheKey::operator<(const CacheKey &other) const
+{
+  if (navmesh != other.navmesh) {
+    return navmesh < other.navmesh;
+  }
+  if (startRef != other.startRef) {
+    return startRef < other.startRef;
+  }
+  return endRef < other.endRef;
+}
+
+KX_PathQueryManager::KX_PathQueryManager()
+    : m_averageJobTime(default_job_time)
+{
+  m_pool = BLI_task_pool_create_background(this, TASK_PRIORITY_LOW);
+}
+
+KX_PathQueryManager::~KX_PathQueryManager()
+{
+  // Wait for the running searches, the queries without result are left not done.
+  BLI_task_pool_work_and_wait(m_pool);
+  BLI_task_pool_free(m_pool);
+
+  for (Job *job : m_runningJobs) {
+    delete job;
+  }
+  for (Job *job : m_pendingJobs) {
+    delete job;
+  }
+
+  for (SearchState *state : m_states) {
+    delete state->nodePool;
+    delete state->openList;
+    delete state;
+  }
+}
+
+KX_PathQueryManager::SearchState *KX_PathQueryManager::AcquireSearchState()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_freeStates.empty()) {
+    SearchState *state = m_freeStates.back();
+    m_freeStates.pop_back();
+    return state;
+  }
+
+  // As many states as searches running at once, so about one per worker thread.
+  SearchState *state = new SearchState{new dtNodePool(2048, 256), new dtNodeQueue(2048)};
+  m_states.push_back(state);
+  return state;
+}
+
+void KX_PathQueryManager::ReleaseSearchState(SearchState *state)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_freeStates.push_back(state);
+}
+
+void KX_PathQueryManager::RunJob(TaskPool *pool, void *taskdata)
+{
+  KX_PathQueryManager *manager = static_cast<KX_PathQueryManager *>(
+      BLI_task_pool_user_data(pool));
+  Job *job = static_cast<Job *>(taskdata);
+  const double starttime = BLI_time_now_seconds();
+
+  /* The navigation mesh is only read, it isn't modified until WaitNavMesh collected this
+   * job. The queries of the job aren't read by the main thread before they are done. */
+  KX_NavMeshObject *navmesh = job->key.navmesh;
+  const KX_PathQuery &first = *job->queries.front();
+  SearchState *state = manager->AcquireSearchState();
+  searchCorridor(navmesh,
+                 job->key.startRef,
+                 job->key.endRef,
+                 first.m_spos,
+                 first.m_epos,
+                 state->nodePool,
+                 state->openList,
+                 job->corridor);
+  manager->ReleaseSearchState(state);
+
+  for (const std::shared_ptr<KX_PathQuery> &query : job->queries) {
+    query->m_path.resize(query->m_maxPathLen * 3);
+    const int pathLen = straightPath(
+        navmesh, job->corridor, query->m_spos, query->m_epos, query->m_path.data(), query->m_maxPathLen);
+    query->m_path.resize(pathLen * 3);
+  }
+
+  job->duration = BLI_time_now_seconds() - starttime;
+
+  {
+    std::lock_guard<std::mutex> lock(manager->m_mutex);
+    manager->m_finishedJobs.push_back(job);
+    job->done = true;
+  }
+  manager->m_jobDone.notify_all();
+}
+
+void KX_PathQueryManager::FinishQuery(KX_PathQuery &query)
+{
+  /* The navigation mesh may have moved since the request, the path is converted with the
+   * transform its positions were converted with. */
+  KX_NavMeshObject::TransformPathToWorldCoords(
+      query.m_worldTransform, query.m_path.data(), query.GetPathLen());
+  query.m_done = true;
+}
+
+void KX_PathQueryManager::AddToCache(const CacheKey &key,
+                                     const std::vector<unsigned int> &corridor)
+{
+  if (corridor.empty()) {
+    return;
+  }
+
+  // The cache is flushed when full, the corridors used often are found again quickly.
+  if (m_cache.size() >= max_cache_size) {
+    m_cache.clear();
+  }
+  m_cache[key] = corridor;
+}
+
+void KX_PathQueryManager::EraseCache(KX_NavMeshObject *navmesh)
+{
+  m_cache.erase(m_cache.lower_bound({navmesh, 0, 0}), m_cache.upper_bound({navmesh, ~0u, ~0u}));
+}
+
+void KX_PathQueryManager::SubmitQuery(const std::shared_ptr<KX_PathQuery> &query)
+{
+  KX_NavMeshObject *navmesh = query->m_navmesh;
+  const CacheKey key = {
+      navmesh, navmesh->FindNearestPoly(query->m_spos), navmesh->FindNearestPoly(query->m_epos)};
+
+  if (key.startRef == 0 || key.endRef == 0) {
+    query->m_done = true;
+    return;
+  }
+
+  const auto cacheIt = m_cache.find(key);
+  if (cacheIt != m_cache.end()) {
+    query->m_path.resize(query->m_maxPathLen * 3);
+    const int pathLen = straightPath(navmesh,
+                                     cacheIt->second,
+                                     query->m_spos,
+                                     query->m_epos,
+                                     query->m_path.data(),
+                                     query->m_maxPathLen);
+    query->m_path.resize(pathLen * 3);
+    FinishQuery(*query);
+    return;
+  }
+
+  Job *&job = m_pendingKeys[key];
+  if (!job) {
+    job = new Job{key, {}, {}, 0.0, false};
+    m_pendingJobs.push_back(job);
+  }
+  job->queries.push_back(query);
+}
+
+std::shared_ptr<KX_PathQuery> KX_PathQueryManager::RequestPath(KX_NavMeshObject *navmesh,
+                                                               const MT_Transform &worldTransform,
+                                                               const float spos[3],
+                                                               const float epos[3],
+                                                               int maxPathLen)
+{
+  std::shared_ptr<KX_PathQuery> query = std::make_shared<KX_PathQuery>(
+      navmesh, worldTransform, spos, epos, maxPathLen);
+  SubmitQuery(query);
+  return query;
+}
+
+int KX_PathQueryManager::FindPath(
+    KX_NavMeshObject *navmesh, const float spos[3], const float epos[3], float *path, int maxPathLen)
+{
+  const CacheKey key = {navmesh, navmesh->FindNearestPoly(spos), navmesh->FindNearestPoly(epos)};
+  if (key.startRef == 0 || key.endRef == 0) {
+    return 0;
+  }
+
+  const auto cacheIt = m_cache.find(key);
+  if (cacheIt != m_cache.end()) {
+    return straightPath(navmesh, cacheIt->second, spos, epos, path, maxPathLen);
+  }
+
+  // The search nodes of the navigation mesh are only used by the main thread.
+  std::vector<unsigned int> corridor;
+  searchCorridor(navmesh, key.startRef, key.endRef, spos, epos, nullptr, nullptr, corridor);
+  AddToCache(key, corridor);
+
+  return straightPath(navmesh, corridor, spos, epos, path, maxPathLen);
+}
+
+void KX_PathQueryManager::CollectJobs()
+{
+  std::vector<Job *> jobs;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    jobs.swap(m_finishedJobs);
+  }
+
+  for (Job *job : jobs) {
+    m_runningJobs.erase(std::find(m_runningJobs.begin(), m_runningJobs.end(), job));
+    m_averageJobTime = m_averageJobTime * 0.9 + job->duration * 0.1;
+
+    AddToCache(job->key, job->corridor);
+    for (const std::shared_ptr<KX_PathQuery> &query : job->queries) {
+      FinishQuery(*query);
+    }
+
+    delete job;
+  }
+}
+
+void KX_PathQueryManager::DispatchJobs()
+{
+  // At least one job is pushed each frame, whatever its estimated duration.
+  unsigned int numJobs = 0;
+  while (!m_pendingJobs.empty() && (numJobs == 0 || numJobs * m_averageJobTime < path_query_time_budget)) {
+    Job *job = m_pendingJobs.front();
+    m_pendingJobs.pop_front();
+    m_pendingKeys.erase(job->key);
+
+    // A job running while this one was queued may have found the same corridor.
+    if (m_cache.find(job->key) != m_cache.end()) {
+      for (const std::shared_ptr<KX_PathQuery> &query : job->queries) {
+        SubmitQuery(query);
+      }
+      delete job;
+      continue;
+    }
+
+    m_runningJobs.push_back(job);
+    BLI_task_pool_push(m_pool, RunJob, job, false, nullptr);
+    ++numJobs;
+  }
+}
+
+void KX_PathQueryManager::WaitNavMesh(KX_NavMeshObject *navmesh)
+{
+  // Only the jobs of this navigation mesh are waited for, the other searches keep running.
+  bool found = false;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this, navmesh, &found]() {
+      for (const Job *job : m_runningJobs) {
+        if (job->key.navmesh == navmesh) {
+          found = true;
+          if (!job->done) {
+            return false;
+          }
+        }
+      }
+      return true;
+    });
+  }
+
+  if (found) {
+    CollectJobs();
+  }
+}
+
+void KX_PathQueryManager::ResetNavMesh(KX_NavMeshObject *navmesh)
+{
+  EraseCache(navmesh);
+
+  // The polygons of the pending jobs changed, their queries are submitted again.
+  std::vector<Job *> jobs;
+  for (auto it = m_pendingJobs.begin(); it != m_pendingJobs.end();) {
+    if ((*it)->key.navmesh == navmesh) {
+      m_pendingKeys.erase((*it)->key);
+      jobs.push_back(*it);
+      it = m_pendingJobs.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  for (Job *job : jobs) {
+    for (const std::shared_ptr<KX_PathQuery> &query : job->queries) {
+      SubmitQuery(query);
+    }
+    delete job;
+  }
+}
+
+void KX_PathQueryManager::RemoveNavMesh(KX_NavMeshObject *navmesh)
+{
+  WaitNavMesh(navmesh);
+
+  EraseCache(navmesh);
+
+  for (auto it = m_pendingJobs.begin(); it != m_pendingJobs.end();) {
+    Job *job = *it;
+    if (job->key.navmesh == navmesh) {
+      m_pendingKeys.erase(job->key);
+      for (const std::shared_ptr<KX_PathQuery> &query : job->queries) {
+        query->m_done = true;
+      }
+      delete job;
+      it = m_pendingJobs.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
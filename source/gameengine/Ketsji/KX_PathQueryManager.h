@@ -0,0 +1,170 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_PathQueryManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "MT_Transform.h"
+
+struct TaskPool;
+class dtNodePool;
+class dtNodeQueue;
+class KX_NavMeshObject;
+
+/** Path query polled by its requester until IsDone returns true.
+ * The query is only accessed from the main thread, its path is written by a worker
+ * before the manager flags it as done.
+ */
+class KX_PathQuery {
+  friend class KX_PathQueryManager;
+
+ private:
+  KX_NavMeshObject *m_navmesh;
+  /// Start and goal in Detour coordinates (Y up).
+  float m_spos[3];
+  float m_epos[3];
+  int m_maxPathLen;
+  /// Transform of the navigation mesh at the request, the path is converted to world space with it.
+  MT_Transform m_worldTransform;
+  /// Path points, 3 coordinates per point, in world space once the query is done.
+  std::vector<float> m_path;
+  bool m_done;
+
+ public:
+  KX_PathQuery(KX_NavMeshObject *navmesh,
+               const MT_Transform &worldTransform,
+               const float spos[3],
+               const float epos[3],
+               int maxPathLen);
+
+  bool IsDone() const;
+  /// Return the path points, empty if no path was found or the navigation mesh was removed.
+  const std::vector<float> &GetPath() const;
+  int GetPathLen() const;
+};
+
+/** Scene service searching the navigation mesh paths in background tasks.
+ * The queries with the same start and goal polygons are batched in a single search and the
+ * polygon corridors found are cached, a query hitting the cache is answered immediately.
+ * The jobs are dispatched after the logic update within a time budget estimated from the
+ * previous searches, the remaining jobs wait for the next frames. A navigation mesh must
+ * call WaitNavMesh before being modified and ResetNavMesh after.
+ */
+class KX_PathQueryManager {
+ private:
+  struct CacheKey {
+    KX_NavMeshObject *navmesh;
+    unsigned int startRef;
+    unsigned int endRef;
+
+    bool operator<(const CacheKey &other) const;
+  };
+
+  /// Search of a corridor shared by the queries with the same polygons.
+  struct Job {
+    CacheKey key;
+    std::vector<std::shared_ptr<KX_PathQuery>> queries;
+    std::vector<unsigned int> corridor;
+    double duration;
+    /// Set by the worker once the job is in m_finishedJobs, protected by m_mutex.
+    bool done;
+  };
+
+  /// Detour search nodes, used by a single job at once.
+  struct SearchState {
+    dtNodePool *nodePool;
+    dtNodeQueue *openList;
+  };
+
+  TaskPool *m_pool;
+  /// Running average of the search durations, in seconds.
+  double m_averageJobTime;
+
+  std::deque<Job *> m_pendingJobs;
+  /// Pending job of each key, to batch the queries.
+  std::map<CacheKey, Job *> m_pendingKeys;
+  /// Jobs pushed to the pool and not yet collected.
+  std::vector<Job *> m_runningJobs;
+
+  /// Corridors found, keyed on the start and goal polygons.
+  std::map<CacheKey, std::vector<unsigned int>> m_cache;
+
+  std::mutex m_mutex;
+  /// Notified each time a worker finishes a job.
+  std::condition_variable m_jobDone;
+  std::vector<Job *> m_finishedJobs;
+  std::vector<SearchState *> m_freeStates;
+  std::vector<SearchState *> m_states;
+
+  SearchState *AcquireSearchState();
+  void ReleaseSearchState(SearchState *state);
+
+  /// Answer a query from the cache or queue a job for it.
+  void SubmitQuery(const std::shared_ptr<KX_PathQuery> &query);
+  /// Convert the path of a query to world space with its requested transform and flag it as done.
+  void FinishQuery(KX_PathQuery &query);
+  void AddToCache(const CacheKey &key, const std::vector<unsigned int> &corridor);
+  void EraseCache(KX_NavMeshObject *navmesh);
+
+  static void RunJob(TaskPool *pool, void *taskdata);
+
+ public:
+  KX_PathQueryManager();
+  ~KX_PathQueryManager();
+
+  /** Queue a path query between two positions in Detour coordinates, the path is converted to
+   * world space with the navigation mesh transform given at the request.
+   * Must not be called between WaitNavMesh and ResetNavMesh of the same navigation mesh.
+   */
+  std::shared_ptr<KX_PathQuery> RequestPath(KX_NavMeshObject *navmesh,
+                                            const MT_Transform &worldTransform,
+                                            const float spos[3],
+                                            const float epos[3],
+                                            int maxPathLen);
+  /** Find a path immediately with the cache or the navigation mesh search nodes.
+   * \return The number of points written in path, in Detour coordinates.
+   */
+  int FindPath(
+      KX_NavMeshObject *navmesh, const float spos[3], const float epos[3], float *path, int maxPathLen);
+
+  /// Finish the queries of the jobs done by the workers, called before the logic update.
+  void CollectJobs();
+  /// Push the pending jobs fitting in the time budget, called after the logic update.
+  void DispatchJobs();
+
+  /// Wait for the running searches reading a navigation mesh and collect the finished jobs.
+  void WaitNavMesh(KX_NavMeshObject *navmesh);
+  /// Drop the corridors of a modified navigation mesh and submit again its pending queries.
+  void ResetNavMesh(KX_NavMeshObject *navmesh);
+  /// Finish the queries of a removed navigation mesh without path and forget it.
+  void RemoveNavMesh(KX_NavMeshObject *navmesh);
+};
@@ -108,6 +108,7 @@
 #include "KX_MeshProxy.h" /* for creating a new library of mesh objects */
 #include "KX_NavMeshObject.h"
 #include "KX_NetworkMessageScene.h"  //Needed for sendMessage()
+#include "KX_NetworkTransport.h"
 #include "KX_PyConstraintBinding.h"
 #include "KX_PyMath.h"
 #include "KX_PythonInitTypes.h"
@@ -314,6 +315,98 @@ static PyObject *gPySendMessage(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(gPySetNetworkTransport_doc,
+             "setNetworkTransport(transport, port=0, peers=[], address=\"\")\n"
+             "exchanges the messages with other game engine processes"
+             " transport = KX_NETWORK_TRANSPORT_NONE, KX_NETWORK_TRANSPORT_LOOPBACK or"
+             " KX_NETWORK_TRANSPORT_UDP"
+             " port = Local UDP port"
+             " peers = List of (address, port) receiving the messages"
+             " address = Local address to bind, empty for all interfaces");
+static PyObject *gPySetNetworkTransport(PyObject *, PyObject *args, PyObject *kwds)
+{
+  int type;
+  int port = 0;
+  PyObject *pypeers = nullptr;
+  const char *address = "";
+
+  static const char *kwlist[] = {"transport", "port", "peers", "address", nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "i|iOs:setNetworkTransport",
+                                   const_cast<char **>(kwlist),
+                                   &type,
+                                   &port,
+                                   &pypeers,
+                                   &address))
+  {
+    return nullptr;
+  }
+
+  std::unique_ptr<KX_NetworkTransport> transport;
+  switch (type) {
+    case KX_NetworkTransport::TRANSPORT_NONE: {
+      break;
+    }
+    case KX_NetworkTransport::TRANSPORT_LOOPBACK: {
+      transport.reset(new KX_NetworkLoopbackTransport());
+      break;
+    }
+    case KX_NetworkTransport::TRANSPORT_UDP: {
+      if (port < 0 || port > 0xFFFF) {
+        PyErr_SetString(PyExc_ValueError,
+                        "setNetworkTransport(transport, port, peers, address): invalid port");
+        return nullptr;
+      }
+
+      std::vector<KX_NetworkUdpTransport::Peer> peers;
+      if (pypeers) {
+        PyObject *seq = PySequence_Fast(
+            pypeers, "setNetworkTransport(transport, port, peers, address): peers must be a list");
+        if (!seq) {
+          return nullptr;
+        }
+
+        for (Py_ssize_t i = 0, size = PySequence_Fast_GET_SIZE(seq); i < size; ++i) {
+          const char *peerAddress;
+          int peerPort;
+          if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "si", &peerAddress, &peerPort) ||
+              peerPort < 0 || peerPort > 0xFFFF)
+          {
+            Py_DECREF(seq);
+            PyErr_SetString(PyExc_ValueError,
+                            "setNetworkTransport(transport, port, peers, address): peers must "
+                            "be (address, port) tuples");
+            return nullptr;
+          }
+          peers.push_back({peerAddress, (unsigned short)peerPort});
+        }
+        Py_DECREF(seq);
+      }
+
+      KX_NetworkUdpTransport *udpTransport = new KX_NetworkUdpTransport();
+      transport.reset(udpTransport);
+      if (!udpTransport->Open(address, port, peers)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "setNetworkTransport(transport, port, peers, address): unable to open "
+                        "the UDP transport, see console");
+        return nullptr;
+      }
+      break;
+    }
+    default: {
+      PyErr_SetString(PyExc_ValueError,
+                      "setNetworkTransport(transport, port, peers, address): invalid transport");
+      return nullptr;
+    }
+  }
+
+  KX_GetActiveEngine()->GetNetworkMessageManager()->SetTransport(std::move(transport));
+
+  Py_RETURN_NONE;
+}
+
 // this gets a pointer to an array filled with floats
 static PyObject *gPyGetSpectrum(PyObject *)
 {
@@ -789,6 +882,10 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)gPyLoadGlobalDict_doc},
     {"sendMessage", (PyCFunction)gPySendMessage, METH_VARARGS, (const char *)gPySendMessage_doc},
+    {"setNetworkTransport",
+     (PyCFunction)gPySetNetworkTransport,
+     METH_VARARGS | METH_KEYWORDS,
+     (const char *)gPySetNetworkTransport_doc},
     {"getCurrentController",
      (PyCFunction)SCA_PythonController::sPyGetCurrentController,
      METH_NOARGS,
@@ -1728,6 +1825,12 @@ PyMODINIT_FUNC initGameLogicPythonBinding()
   KX_MACRO_addTypesToDict(d, KX_STATE_OP_CLR, SCA_StateActuator::OP_CLR);
   KX_MACRO_addTypesToDict(d, KX_STATE_OP_NEG, SCA_StateActuator::OP_NEG);
 
+  /* Network message transports */
+  KX_MACRO_addTypesToDict(d, KX_NETWORK_TRANSPORT_NONE, KX_NetworkTransport::TRANSPORT_NONE);
+  KX_MACRO_addTypesToDict(
+      d, KX_NETWORK_TRANSPORT_LOOPBACK, KX_NetworkTransport::TRANSPORT_LOOPBACK);
+  KX_MACRO_addTypesToDict(d, KX_NETWORK_TRANSPORT_UDP, KX_NetworkTransport::TRANSPORT_UDP);
+
   /* Game Actuator Modes */
   KX_MACRO_addTypesToDict(d, KX_GAME_LOAD, SCA_GameActuator::KX_GAME_LOAD);
   KX_MACRO_addTypesToDict(d, KX_GAME_START, SCA_GameActuator::KX_GAME_START);
@@ -41,6 +41,7 @@
 #include "BKE_modifier.hh"
 #include "BKE_object.hh"
 #include "BKE_screen.hh"
+#include "BLI_math_vector.h"
 #include "BLI_task.h"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_camera_types.h"
@@ -74,9 +75,12 @@
 #include "KX_Light.h"
 #include "KX_LodManager.h"
 #include "KX_MotionState.h"
+#include "KX_NavMeshObject.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_NodeRelationships.h"
 #include "KX_ObstacleSimulation.h"
+#include "KX_OcclusionBuffer.h"
+#include "KX_PathQueryManager.h"
 #include "KX_PyMath.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
@@ -96,6 +100,9 @@
 #  include "bpy_rna.h"
 #endif
 
+/// Name of the property storing the initial life of the temporary objects.
+static const EXP_PropertyName timebombPropName("::timebomb");
+
 static void *KX_SceneReplicationFunc(SG_Node *node, void *gameobj, void *scene)
 {
   KX_GameObject *replica =
@@ -124,11 +131,17 @@ bool KX_Scene::KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *s
   return node->Reschedule(((KX_Scene *)scene)->m_sghead);
 }
 
+static void KX_SceneRenderDirtyFunc(SG_Node *node, void *gameobj, void *scene)
+{
+  ((KX_Scene *)scene)->AddDepsgraphSyncObject((KX_GameObject *)gameobj);
+}
+
 SG_Callbacks KX_Scene::m_callbacks = SG_Callbacks(KX_SceneReplicationFunc,
                                                   KX_SceneDestructionFunc,
                                                   KX_GameObject::UpdateTransformFunc,
                                                   KX_Scene::KX_ScenegraphUpdateFunc,
-                                                  KX_Scene::KX_ScenegraphRescheduleFunc);
+                                                  KX_Scene::KX_ScenegraphRescheduleFunc,
+                                                  KX_SceneRenderDirtyFunc);
 
 KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
                    const std::string &sceneName,
@@ -143,6 +156,8 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_sceneConverter(nullptr),              // eevee
       m_isPythonMainLoop(false),              // eevee
       m_collectionRemap(false),               // eevee (to uncheck viewport restrictflag)
+      m_replicaBaseFlagsChanged(false),       // eevee (to show/hide pooled replica objects)
+      m_depsgraphFullSync(true),              // eevee (to sync all objects at first render)
       m_keyboardmgr(nullptr),
       m_mousemgr(nullptr),
       m_physicsEnvironment(0),
@@ -158,7 +173,19 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
+  m_cullingObjectsValid = false;
+  m_numCameraVisibilities = 0;
+  m_lodLevelsStale = false;
   m_activityCulling = false;
+  m_activityCullingHysteresis = 0.0f;
+  m_activityCullingPrevHysteresis = 0.0f;
+  m_activityCullingCameraMotion = 0.0;
+  m_parallelSceneGraph = false;
+  m_batchSceneGraph = false;
+  m_tempObjectTime = 0.0;
+  m_animationCulling = false;
+  m_animationLodDistance = 0.0f;
+  m_animationLodRate = 4;
   m_objectlist = new EXP_ListValue<KX_GameObject>();
   m_parentlist = new EXP_ListValue<KX_GameObject>();
   m_lightlist = new EXP_ListValue<KX_LightObject>();
@@ -205,7 +232,11 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_obstacleSimulation = nullptr;
   }
 
+  m_pathQueryManager = new KX_PathQueryManager();
+
   m_animationPool = BLI_task_pool_create(&m_animationPoolData, TASK_PRIORITY_LOW);
+  m_sceneGraphPool = BLI_task_pool_create(&m_sceneGraphPoolData, TASK_PRIORITY_HIGH);
+  m_visibilityPool = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
 
 #ifdef WITH_PYTHON
   m_attr_dict = nullptr;
@@ -382,13 +413,25 @@ KX_Scene::~KX_Scene()
     BKE_view_layer_synced_ensure(scene, BKE_view_layer_default_view(scene));
   }
 
+  FreeReplicaObjectPool(false);
+
   if (m_obstacleSimulation)
     delete m_obstacleSimulation;
 
+  delete m_pathQueryManager;
+
   if (m_animationPool) {
     BLI_task_pool_free(m_animationPool);
   }
 
+  if (m_sceneGraphPool) {
+    BLI_task_pool_free(m_sceneGraphPool);
+  }
+
+  if (m_visibilityPool) {
+    BLI_task_pool_free(m_visibilityPool);
+  }
+
   if (m_objectlist)
     m_objectlist->Release();
 
@@ -739,14 +782,15 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
     m_collectionRemap = false;
   }
 
+  if (m_replicaBaseFlagsChanged) {
+    /* Pooled replica objects were hidden or shown, see ReleaseReplicaObject. */
+    DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+    m_replicaBaseFlagsChanged = false;
+  }
+
   /* Notify the depsgraph if object transform changed in the scene
    * for next drawing loop. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    /* Update compatibles blender physics simulations */
-    Object *ob = gameobj->GetBlenderObject();
-    TagBlenderPhysicsObject(scene, ob);
-    gameobj->TagForTransformUpdate(is_overlay_pass, is_last_render_pass);
-  }
+  TagDepsgraphSyncObjects(scene, is_overlay_pass, is_last_render_pass);
 
   /* Notify depsgraph for other changes */
   TagForExtraIdsUpdate(bmain, cam);
@@ -759,9 +803,7 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
   /* Update evaluated object object_to_world according to SceneGraph. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->TagForTransformUpdateEvaluated();
-  }
+  UpdateDepsgraphSyncObjectsEvaluated(is_last_render_pass);
 
   engine->EndCountDepsgraphTime();
 
@@ -864,7 +906,22 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
                               winmat,
                               NULL);
 
-    UpdateObjectLods(cam);
+    // A camera rendered without being registered by the engine is computed alone.
+    if (!FindCameraVisibility(cam)) {
+      KX_Camera *cullingCam = (m_overrideCullingCamera && !is_overlay_pass) ?
+                                  m_overrideCullingCamera :
+                                  cam;
+      AddCameraVisibility(cam,
+                          cullingCam,
+                          window.xmax - window.xmin,
+                          window.ymax - window.ymin,
+                          is_overlay_pass,
+                          true);
+    }
+    /* Compute the visibility of all the passes of the frame at the first pass, once the
+     * depsgraph is updated. */
+    ComputeCameraVisibilities(depsgraph);
+    ApplyCameraVisibility(*FindCameraVisibility(cam));
   }
 
   /* Disable some post processing effects for overlay collections render pass */
@@ -945,7 +1002,18 @@ void KX_Scene::RenderAfterCameraSetupImageRender(KX_Camera *cam, const rcti *win
                             winmat,
                             NULL);
 
+  /* The image render cameras are only known when their texture is refreshed, their visibility
+   * is computed here and forgotten after the draw. The lod levels are left unchanged. */
+  AddCameraVisibility(
+      cam, cam, window->xmax - window->xmin, window->ymax - window->ymin, false, false);
+  ComputeCameraVisibilities(depsgraph);
+  ApplyCameraVisibility(m_cameraVisibilities[m_numCameraVisibilities - 1]);
+
   DRW_game_render_loop(C, m_currentGPUViewport, depsgraph, window, false, false);
+
+  if (--m_numCameraVisibilities == 0) {
+    ClearCameraVisibilities();
+  }
 }
 
 void KX_Scene::SetBlenderSceneConverter(BL_SceneConverter *sc_converter)
@@ -1196,6 +1264,7 @@ void KX_Scene::AddObjToLodObjList(KX_GameObject *gameobj)
   if (it == m_kxobWithLod.end()) {
     m_kxobWithLod.push_back(gameobj);
   }
+  m_lodTable.AddObject(gameobj, this);
 }
 
 void KX_Scene::RemoveObjFromLodObjList(KX_GameObject *gameobj)
@@ -1204,6 +1273,7 @@ void KX_Scene::RemoveObjFromLodObjList(KX_GameObject *gameobj)
       m_kxobWithLod.begin(), m_kxobWithLod.end(), gameobj);
   if (it != m_kxobWithLod.end()) {
     m_kxobWithLod.erase(it);
+    m_lodTable.RemoveObject(gameobj);
   }
 }
 
@@ -1227,6 +1297,180 @@ void KX_Scene::TagForCollectionRemap()
   m_collectionRemap = true;
 }
 
+Object *KX_Scene::NewReplicaObject(Object *ob)
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = GetBlenderScene();
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+
+  Object *newob;
+  BKE_id_copy_ex(bmain, &ob->id, (ID **)&newob, 0);
+  id_us_min(&newob->id);
+  BKE_collection_object_add_from(bmain,
+                                 scene,
+                                 BKE_view_layer_camera_find(scene, view_layer),
+                                 newob);  // add replica where is the active camera
+
+  /* Avoid to make instance_collections "containers" visibled
+   * when replicating as we want only the instances created in DupliGroupRecuse
+   * to be visibled */
+  if (!ob->instance_collection) {
+    newob->base_flag |= (BASE_ENABLED_AND_MAYBE_VISIBLE_IN_VIEWPORT |
+                         BASE_ENABLED_AND_VISIBLE_IN_DEFAULT_VIEWPORT);
+    newob->visibility_flag &= ~OB_HIDE_VIEWPORT;
+  }
+
+  /* This will call BKE_main_collection_sync_remap at frame end. */
+  TagForCollectionRemap();
+
+  DEG_relations_tag_update(bmain);
+
+  return newob;
+}
+
+Object *KX_Scene::AcquirePooledReplicaObject(Object *templateob)
+{
+  std::map<Object *, std::vector<Object *>>::iterator it = m_replicaObjectPool.find(templateob);
+  if (it == m_replicaObjectPool.end() || it->second.empty()) {
+    return nullptr;
+  }
+
+  Object *ob = it->second.back();
+  it->second.pop_back();
+
+  /* The object could have been parented to another replica in its previous life,
+   * restore the template parenting, remap_parents_recursive will update it if needed. */
+  if (ob->parent != templateob->parent) {
+    ob->parent = templateob->parent;
+    ModifierData *md = (ModifierData *)ob->modifiers.first;
+    ModifierData *templatemd = (ModifierData *)templateob->modifiers.first;
+    for (; md && templatemd; md = md->next, templatemd = templatemd->next) {
+      if (md->type == eModifierType_Armature && templatemd->type == eModifierType_Armature) {
+        ((ArmatureModifierData *)md)->object = ((ArmatureModifierData *)templatemd)->object;
+      }
+    }
+    bContext *C = KX_GetActiveEngine()->GetContext();
+    DEG_relations_tag_update(CTX_data_main(C));
+  }
+
+  /* The color could have been set by KX_GameObject::SetObjectColor and the evaluated data
+   * swapped by KX_GameObject::UpdateLodEvaluatedObject, restore the template ones. */
+  copy_v4_v4(ob->color, templateob->color);
+  ob->data = templateob->data;
+  DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY | ID_RECALC_SHADING);
+
+  /* Instance collection "containers" were never visibled, see NewReplicaObject. */
+  if (!ob->instance_collection) {
+    Scene *scene = GetBlenderScene();
+    ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+    BKE_view_layer_synced_ensure(scene, view_layer);
+    Base *base = BKE_view_layer_base_find(view_layer, ob);
+    if (base) {
+      base->flag &= ~BASE_HIDDEN;
+      BKE_view_layer_need_resync_tag(view_layer);
+      m_replicaBaseFlagsChanged = true;
+    }
+  }
+
+  return ob;
+}
+
+bool KX_Scene::ReleaseReplicaObject(Object *templateob, Object *ob)
+{
+  /* Objects linked in other collections (e.g overlay collections) are not reusable as is. */
+  if (!templateob || ID_REAL_USERS(&ob->id) > 1) {
+    return false;
+  }
+
+  Scene *scene = GetBlenderScene();
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+  BKE_view_layer_synced_ensure(scene, view_layer);
+  Base *base = BKE_view_layer_base_find(view_layer, ob);
+  if (!base) {
+    return false;
+  }
+
+  /* Only hide the base, changing the object visibility flags would rebuild the depsgraph
+   * relations. */
+  base->flag |= BASE_HIDDEN;
+  BKE_view_layer_need_resync_tag(view_layer);
+  m_replicaBaseFlagsChanged = true;
+
+  m_replicaObjectPool[templateob].push_back(ob);
+
+  return true;
+}
+
+static void preallocate_replica_objects_recursive(
+    KX_Scene *scene,
+    SG_Node *node,
+    unsigned int count,
+    std::vector<std::pair<Object *, Object *>> &replicas)
+{
+  KX_GameObject *gameobj = static_cast<KX_GameObject *>(node->GetSGClientObject());
+  if (gameobj && gameobj->GetBlenderObject()) {
+    Object *ob = gameobj->GetBlenderObject();
+    for (unsigned int i = 0; i < count; ++i) {
+      replicas.emplace_back(ob, scene->NewReplicaObject(ob));
+    }
+  }
+
+  for (SG_Node *child : node->GetSGChildren()) {
+    preallocate_replica_objects_recursive(scene, child, count, replicas);
+  }
+}
+
+void KX_Scene::PreallocateReplicaObjects(KX_GameObject *gameobj, unsigned int count)
+{
+  if (!gameobj->GetSGNode() || count == 0) {
+    return;
+  }
+
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+
+  // Pairs of template and replica objects.
+  std::vector<std::pair<Object *, Object *>> replicas;
+  preallocate_replica_objects_recursive(this, gameobj->GetSGNode(), count, replicas);
+
+  /* The bases of the new objects are needed to hide them. */
+  BKE_main_collection_sync_remap(bmain);
+  m_collectionRemap = false;
+
+  for (const std::pair<Object *, Object *> &pair : replicas) {
+    if (!ReleaseReplicaObject(pair.first, pair.second)) {
+      BKE_id_delete(bmain, pair.second);
+    }
+  }
+}
+
+void KX_Scene::FreeReplicaObjectPool(bool onlyTagged)
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+
+  bool freed = false;
+  for (std::map<Object *, std::vector<Object *>>::iterator it = m_replicaObjectPool.begin();
+       it != m_replicaObjectPool.end();)
+  {
+    if (onlyTagged && !IS_TAGGED(it->first)) {
+      ++it;
+      continue;
+    }
+
+    for (Object *ob : it->second) {
+      BKE_id_delete(bmain, ob);
+      freed = true;
+    }
+    it = m_replicaObjectPool.erase(it);
+  }
+
+  if (freed) {
+    DEG_relations_tag_update(bmain);
+  }
+}
+
 KX_GameObject *KX_Scene::GetGameObjectFromObject(Object *ob)
 {
   return m_sceneConverter->FindGameObject(ob);
@@ -1345,21 +1589,26 @@ bool KX_Scene::SomethingIsMoving()
 void KX_Scene::AppendToIdsToUpdateInAllRenderPasses(ID *id, IDRecalcFlag flag)
 {
   std::pair<ID *, IDRecalcFlag> it = {id, flag};
+  // Actions can be updated from threads.
+  m_idsToUpdateLock.Lock();
   if (std::find(m_idsToUpdateInAllRenderPasses.begin(),
                 m_idsToUpdateInAllRenderPasses.end(),
                 it) == m_idsToUpdateInAllRenderPasses.end()) {
     m_idsToUpdateInAllRenderPasses.push_back(it);
   }
+  m_idsToUpdateLock.Unlock();
 }
 
 void KX_Scene::AppendToIdsToUpdateInOverlayPass(ID *id, IDRecalcFlag flag)
 {
   std::pair<ID *, IDRecalcFlag> it = {id, flag};
+  m_idsToUpdateLock.Lock();
   if (std::find(m_idsToUpdateInOverlayPass.begin(),
                 m_idsToUpdateInOverlayPass.end(),
                 it) == m_idsToUpdateInOverlayPass.end()) {
     m_idsToUpdateInOverlayPass.push_back(it);
   }
+  m_idsToUpdateLock.Unlock();
 }
 
 void KX_Scene::TagForExtraIdsUpdate(Main *bmain, KX_Camera *cam)
@@ -1410,6 +1659,84 @@ void KX_Scene::TagBlenderPhysicsObject(Scene *scene, Object *ob)
   }
 }
 
+void KX_Scene::AddDepsgraphSyncObject(KX_GameObject *gameobj)
+{
+  m_depsgraphSyncLock.Lock();
+  if (!gameobj->IsDepsgraphSyncScheduled()) {
+    gameobj->SetDepsgraphSyncScheduled(true);
+    m_depsgraphSyncObjects.push_back(gameobj);
+  }
+  m_depsgraphSyncLock.Unlock();
+}
+
+void KX_Scene::TagDepsgraphSyncObjects(Scene *scene,
+                                       bool is_overlay_pass,
+                                       bool is_last_render_pass)
+{
+  if (m_depsgraphFullSync) {
+    for (KX_GameObject *gameobj : m_depsgraphSyncObjects) {
+      gameobj->SetDepsgraphSyncScheduled(false);
+    }
+    m_depsgraphSyncObjects.clear();
+    m_depsgraphAlwaysSyncObjects.clear();
+
+    for (KX_GameObject *gameobj : GetObjectList()) {
+      AddDepsgraphSyncObject(gameobj);
+    }
+    m_depsgraphFullSync = false;
+  }
+
+  /* Update compatibles blender physics simulations, they can concern any object. */
+  if (scene->gm.flag & (GAME_USE_INTERACTIVE_DYNAPAINT | GAME_USE_INTERACTIVE_RIGIDBODY)) {
+    for (KX_GameObject *gameobj : GetObjectList()) {
+      Object *ob = gameobj->GetBlenderObject();
+      TagBlenderPhysicsObject(scene, ob);
+      if (ob->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY) {
+        CM_ListAddIfNotFound(m_depsgraphAlwaysSyncObjects, gameobj);
+      }
+    }
+  }
+
+  for (KX_GameObject *gameobj : m_depsgraphSyncObjects) {
+    gameobj->TagForTransformUpdate(is_overlay_pass, is_last_render_pass);
+
+    /* Objects with a transform computed by the depsgraph must be synchronized even
+     * when they don't move in the scene graph. */
+    Object *ob = gameobj->GetBlenderObject();
+    if (ob && ((ob->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY) ||
+               !OrigObCanBeTransformedInRealtime(ob)))
+    {
+      CM_ListAddIfNotFound(m_depsgraphAlwaysSyncObjects, gameobj);
+    }
+  }
+}
+
+void KX_Scene::UpdateDepsgraphSyncObjectsEvaluated(bool is_last_render_pass)
+{
+  for (KX_GameObject *gameobj : m_depsgraphSyncObjects) {
+    gameobj->TagForTransformUpdateEvaluated();
+  }
+
+  unsigned int numSynced = m_depsgraphSyncObjects.size();
+  for (KX_GameObject *gameobj : m_depsgraphAlwaysSyncObjects) {
+    if (!gameobj->IsDepsgraphSyncScheduled()) {
+      gameobj->TagForTransformUpdateEvaluated();
+      ++numSynced;
+    }
+  }
+
+  /* Keep the objects until the end of all render passes as
+   * they are tagged for transform update for each render pass. */
+  if (is_last_render_pass) {
+    KX_GetActiveEngine()->AddDepsgraphSyncedObjects(numSynced);
+
+    for (KX_GameObject *gameobj : m_depsgraphSyncObjects) {
+      gameobj->SetDepsgraphSyncScheduled(false);
+    }
+    m_depsgraphSyncObjects.clear();
+  }
+}
+
 KX_GameObject *KX_Scene::AddDuplicaObject(KX_GameObject *gameobj,
                                           KX_GameObject *reference,
                                           float lifespan)
@@ -1444,17 +1771,12 @@ KX_GameObject *KX_Scene::AddDuplicaObject(KX_GameObject *gameobj,
 
       KX_GameObject *replica = m_sceneConverter->FindGameObject(basen->object);
 
-      // add a timebomb to this object
       // lifespan of zero means 'this object lives forever'
       if (lifespan > 0.0f) {
-        // for now, convert between so called frames and realtime
-        m_tempObjectList.push_back(replica);
         // this convert the life from frames to sort-of seconds, hard coded 0.02 that assumes we
         // have 50 frames per second if you change this value, make sure you change it in
         // KX_GameObject::pyattr_get_life property too
-        EXP_Value *fval = new EXP_FloatValue(lifespan * 0.02f);
-        replica->SetProperty("::timebomb", fval);
-        fval->Release();
+        AddTempObject(replica, lifespan * 0.02f);
       }
 
       if (reference) {
@@ -1819,6 +2141,11 @@ static void remap_parents_recursive(KX_GameObject *parent)
 {
   std::vector<KX_GameObject *>children = parent->GetChildren();
   for (KX_GameObject *child : children) {
+    if (child->GetBlenderObject()->parent != parent->GetBlenderObject()) {
+      /* Pooled replica objects keep their relations when nothing changed. */
+      bContext *C = KX_GetActiveEngine()->GetContext();
+      DEG_relations_tag_update(CTX_data_main(C));
+    }
     child->GetBlenderObject()->parent = parent->GetBlenderObject();
     if (parent->GetBlenderObject()->type == OB_ARMATURE) {
       ModifierData *mod;
@@ -2006,17 +2333,12 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   // lets create a replica
   KX_GameObject *replica = (KX_GameObject *)AddNodeReplicaObject(nullptr, originalobj);
 
-  // add a timebomb to this object
   // lifespan of zero means 'this object lives forever'
   if (lifespan > 0.0f) {
-    // for now, convert between so called frames and realtime
-    m_tempObjectList.push_back(replica);
     // this convert the life from frames to sort-of seconds, hard coded 0.016666667 that assumes we have
     // 60 frames per second if you change this value, make sure you change it in
     // KX_GameObject::pyattr_get_life property too
-    EXP_Value *fval = new EXP_FloatValue(lifespan * 0.016666667f);
-    replica->SetProperty("::timebomb", fval);
-    fval->Release();
+    AddTempObject(replica, lifespan * 0.016666667f);
   }
 
   // add to 'rootparent' list (this is the list of top hierarchy objects, updated each frame)
@@ -2196,10 +2518,27 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
     m_obstacleSimulation->DestroyObstacleForObj(gameobj);
   }
 
+  Object *blenderobject = gameobj->GetBlenderObject();
+  if (blenderobject && blenderobject->type == OB_MESH && (blenderobject->gameflag & OB_NAVMESH)) {
+    m_pathQueryManager->RemoveNavMesh(static_cast<KX_NavMeshObject *>(gameobj));
+  }
+
   m_proxyManager.Unregister(gameobj);
 
   gameobj->RemoveMeshes();
 
+  if (gameobj->IsDepsgraphSyncScheduled()) {
+    CM_ListRemoveIfFound(m_depsgraphSyncObjects, gameobj);
+  }
+  CM_ListRemoveIfFound(m_depsgraphAlwaysSyncObjects, gameobj);
+  // The visibility of the passes of this frame refers to the objects by index.
+  if (m_cullingObjectsValid) {
+    std::replace(m_cullingObjects.begin(),
+                 m_cullingObjects.end(),
+                 gameobj,
+                 static_cast<KX_GameObject *>(nullptr));
+  }
+
   bool ret = true;
   if (m_lightlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
@@ -2223,7 +2562,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
   // WARNING: 'gameobj' maybe be freed now, only compare, don't access.
   CM_ListRemoveIfFound(m_animatedlist, gameobj);
   CM_ListRemoveIfFound(m_euthanasyobjects, gameobj);
-  CM_ListRemoveIfFound(m_tempObjectList, gameobj);
+  m_tempObjectExpiry.erase(gameobj);
 
   if (gameobj == m_active_camera) {
     // no AddRef done on m_active_camera so no Release
@@ -2308,13 +2647,242 @@ void KX_Scene::SetCameraOnTop(KX_Camera *cam)
   m_cameralist->Add(cam);
 }
 
-void KX_Scene::PhysicsCullingCallback(KX_ClientObjectInfo *objectInfo, void *cullingInfo)
+/// Update the culling state of an object and its flag read by the draw loop.
+static void set_object_culled(KX_GameObject *gameobj, bool culled)
+{
+  gameobj->GetCullingNode().SetCulled(culled);
+
+  Object *ob = gameobj->GetBlenderObject();
+  if (culled) {
+    ob->gameflag |= OB_CULLED;
+  }
+  else {
+    ob->gameflag &= ~OB_CULLED;
+  }
+}
+
+void KX_Scene::AddCameraVisibility(KX_Camera *renderCamera,
+                                   KX_Camera *cullingCamera,
+                                   int width,
+                                   int height,
+                                   bool isOverlayPass,
+                                   bool useLod)
+{
+  if (m_numCameraVisibilities == m_cameraVisibilities.size()) {
+    m_cameraVisibilities.emplace_back();
+  }
+
+  CameraVisibility &visibility = m_cameraVisibilities[m_numCameraVisibilities++];
+  visibility.m_renderCamera = renderCamera;
+  visibility.m_frustum = cullingCamera->GetFrustum();
+  visibility.m_width = width;
+  visibility.m_height = height;
+  visibility.m_isOverlayPass = isOverlayPass;
+  visibility.m_useLod = useLod;
+  visibility.m_computed = false;
+  visibility.m_lodPosition = renderCamera->NodeGetWorldPosition();
+  visibility.m_lodFactor = renderCamera->GetLodDistanceFactor();
+}
+
+KX_Scene::CameraVisibility *KX_Scene::FindCameraVisibility(KX_Camera *cam)
+{
+  for (unsigned int i = 0; i < m_numCameraVisibilities; ++i) {
+    if (m_cameraVisibilities[i].m_renderCamera == cam) {
+      return &m_cameraVisibilities[i];
+    }
+  }
+  return nullptr;
+}
+
+void KX_Scene::ClearCameraVisibilities()
+{
+  m_numCameraVisibilities = 0;
+  m_cullingObjects.clear();
+  m_cullingObjectsValid = false;
+}
+
+void KX_Scene::UpdateCullingObjects(Depsgraph *depsgraph)
+{
+  m_cullingObjects.clear();
+  m_cullingObjectsValid = true;
+
+  if (!m_dbvt_culling) {
+    return;
+  }
+
+  for (KX_GameObject *gameobj : m_objectlist) {
+    if (!gameobj->UseCulling()) {
+      continue;
+    }
+
+    const std::optional<blender::Bounds<blender::float3>> bounds =
+        BKE_object_boundbox_eval_cached_get(
+            DEG_get_evaluated_object(depsgraph, gameobj->GetBlenderObject()));
+    if (!bounds) {
+      set_object_culled(gameobj, false);
+      continue;
+    }
+
+    gameobj->GetCullingNode().GetAabb().Set(
+        MT_Vector3(bounds->min.x, bounds->min.y, bounds->min.z),
+        MT_Vector3(bounds->max.x, bounds->max.y, bounds->max.z));
+    m_cullingObjects.push_back(gameobj);
+  }
+}
+
+static void compute_visibility_thread_func(TaskPool *__restrict pool, void *taskdata)
+{
+  KX_Scene *scene = (KX_Scene *)BLI_task_pool_user_data(pool);
+  scene->ComputeCameraVisibility(*(KX_Scene::CameraVisibility *)taskdata);
+}
+
+void KX_Scene::ComputeCameraVisibilities(Depsgraph *depsgraph)
 {
-  KX_GameObject *gameobj = objectInfo->m_gameobject;
-  if (!gameobj->GetVisible() || !gameobj->UseCulling()) {
-    // ideally, invisible objects should be removed from the culling tree temporarily
+  // The objects are gathered once per frame, the passes added later reuse them.
+  if (!m_cullingObjectsValid) {
+    m_lodTable.Prepare(m_kxobWithLod, this);
+    m_lodLevelsStale = false;
+    UpdateCullingObjects(depsgraph);
+  }
+
+  // The items are not reallocated anymore, they can be used as task data.
+  unsigned int numTasks = 0;
+  for (unsigned int i = 0; i < m_numCameraVisibilities; ++i) {
+    CameraVisibility &visibility = m_cameraVisibilities[i];
+    if (!visibility.m_computed) {
+      BLI_task_pool_push(
+          m_visibilityPool, compute_visibility_thread_func, &visibility, false, nullptr);
+      ++numTasks;
+    }
+  }
+
+  if (numTasks == 0) {
     return;
   }
+
+  BLI_task_pool_work_and_wait(m_visibilityPool);
+
+  unsigned int numOccluders = 0;
+  unsigned int numCulled = 0;
+  for (unsigned int i = 0; i < m_numCameraVisibilities; ++i) {
+    CameraVisibility &visibility = m_cameraVisibilities[i];
+    if (!visibility.m_computed) {
+      visibility.m_computed = true;
+      numOccluders += visibility.m_numOccluders;
+      numCulled += visibility.m_numCulled;
+    }
+  }
+
+  KX_GetActiveEngine()->AddCullingStats(numOccluders, numCulled);
+}
+
+void KX_Scene::ComputeCameraVisibility(CameraVisibility &visibility) const
+{
+  if (visibility.m_useLod) {
+    m_lodTable.Select(visibility.m_lodPosition,
+                      visibility.m_lodFactor,
+                      visibility.m_lodDistances,
+                      visibility.m_lodLevels);
+  }
+
+  visibility.m_numCulled = 0;
+  visibility.m_numOccluders = 0;
+
+  if (!m_dbvt_culling) {
+    return;
+  }
+
+  const unsigned int size = m_cullingObjects.size();
+  visibility.m_culled.assign(size, 0);
+  visibility.m_candidates.clear();
+
+  const SG_Frustum &frustum = visibility.m_frustum;
+  KX_OcclusionBuffer &buffer = visibility.m_occlusionBuffer;
+  const bool useOcclusion = (m_dbvt_occlusion_res > 0);
+  if (useOcclusion) {
+    buffer.Setup(
+        m_dbvt_occlusion_res, visibility.m_width, visibility.m_height, frustum.GetMatrix());
+  }
+
+  for (unsigned int i = 0; i < size; ++i) {
+    KX_GameObject *gameobj = m_cullingObjects[i];
+    // Removed object or object of the other render pass, never drawn.
+    if (!gameobj || ((gameobj->GetBlenderObject()->gameflag & OB_OVERLAY_COLLECTION) != 0) !=
+                        visibility.m_isOverlayPass)
+    {
+      continue;
+    }
+
+    const SG_BBox &aabb = gameobj->GetCullingNode().GetAabb();
+    const MT_Matrix4x4 objectToWorld(gameobj->NodeGetWorldTransform());
+    if (frustum.AabbInsideFrustum(aabb.GetMin(), aabb.GetMax(), objectToWorld) ==
+        SG_Frustum::OUTSIDE)
+    {
+      visibility.m_culled[i] = 1;
+      ++visibility.m_numCulled;
+    }
+    else if (useOcclusion) {
+      // Occluders are never occlusion culled, even invisible ones hide the objects behind.
+      if (gameobj->GetOccluder()) {
+        for (int j = 0, count = gameobj->GetMeshCount(); j < count; ++j) {
+          buffer.AddOccluder(gameobj->GetMesh(j), objectToWorld, gameobj->IsNegativeScaling());
+        }
+      }
+      else if (gameobj->GetVisible()) {
+        visibility.m_candidates.push_back(i);
+      }
+    }
+  }
+
+  if (!useOcclusion || buffer.GetNumOccluders() == 0) {
+    return;
+  }
+
+  buffer.Finalize();
+  visibility.m_numOccluders = buffer.GetNumOccluders();
+
+  for (unsigned int i : visibility.m_candidates) {
+    KX_GameObject *gameobj = m_cullingObjects[i];
+    const SG_BBox &aabb = gameobj->GetCullingNode().GetAabb();
+    const MT_Vector3 &min = aabb.GetMin();
+    const MT_Vector3 &max = aabb.GetMax();
+    const MT_Transform trans = gameobj->NodeGetWorldTransform();
+
+    std::array<MT_Vector3, 8> box;
+    for (unsigned short j = 0; j < 8; ++j) {
+      box[j] = trans(MT_Vector3((j & 1) ? max.x() : min.x(),
+                                (j & 2) ? max.y() : min.y(),
+                                (j & 4) ? max.z() : min.z()));
+    }
+
+    if (buffer.IsOccluded(box)) {
+      visibility.m_culled[i] = 1;
+      ++visibility.m_numCulled;
+    }
+  }
+}
+
+void KX_Scene::ApplyCameraVisibility(const CameraVisibility &visibility)
+{
+  /* The lod table could have been invalidated by a python callback since the selection, the
+   * levels of all the passes are then selected again when they are drawn. */
+  if (visibility.m_useLod) {
+    if (m_lodLevelsStale || !m_lodTable.Apply(visibility.m_lodLevels)) {
+      m_lodLevelsStale = true;
+      UpdateObjectLods(visibility.m_renderCamera);
+    }
+  }
+
+  if (!m_dbvt_culling) {
+    return;
+  }
+
+  for (unsigned int i = 0, size = m_cullingObjects.size(); i < size; ++i) {
+    KX_GameObject *gameobj = m_cullingObjects[i];
+    if (gameobj) {
+      set_object_culled(gameobj, visibility.m_culled[i]);
+    }
+  }
 }
 
 void KX_Scene::RenderDebugProperties(RAS_DebugDraw &debugDraw,
@@ -2371,103 +2939,166 @@ void KX_Scene::RenderDebugProperties(RAS_DebugDraw &debugDraw,
 // logic stuff
 void KX_Scene::LogicBeginFrame(double curtime, double framestep)
 {
-  // have a look at temp objects ...
-  for (KX_GameObject *gameobj : m_tempObjectList) {
-    EXP_FloatValue *propval = (EXP_FloatValue *)gameobj->GetProperty("::timebomb");
+  m_tempObjectTime += framestep;
 
-    if (propval) {
-      const float timeleft = propval->GetNumber() - framestep;
+  // Remove only the temp objects expiring at this frame.
+  while (!m_tempObjectQueue.empty() && m_tempObjectQueue.top().first <= m_tempObjectTime) {
+    const TempObjectEntry entry = m_tempObjectQueue.top();
+    m_tempObjectQueue.pop();
 
-      if (timeleft > 0) {
-        propval->SetFloat(timeleft);
-      }
-      else {
-        // remove obj, remove the object from tempObjectList in NewRemoveObject only.
-        DelayedRemoveObject(gameobj);
-      }
-    }
-    else {
-      // all object is the tempObjectList should have a clock
-      BLI_assert(false);
+    const auto it = m_tempObjectExpiry.find(entry.second);
+    // Ignore the objects already removed or added again with a different life.
+    if (it == m_tempObjectExpiry.end() || it->second != entry.first) {
+      continue;
     }
+
+    // remove obj, remove the object from m_tempObjectExpiry in NewRemoveObject only.
+    DelayedRemoveObject(entry.second);
   }
+
   m_logicmgr->BeginFrame(curtime, framestep);
 }
 
-void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
+void KX_Scene::AddTempObject(KX_GameObject *gameobj, float life)
 {
-  CM_ListAddIfNotFound(m_animatedlist, gameobj);
+  const double expiry = m_tempObjectTime + life;
+  m_tempObjectExpiry[gameobj] = expiry;
+  m_tempObjectQueue.emplace(expiry, gameobj);
+
+  /* Kept for the scripts checking this property, it's not decremented anymore, the remaining
+   * life is given by GetTempObjectLife. */
+  EXP_Value *fval = new EXP_FloatValue(life);
+  gameobj->SetProperty(timebombPropName, fval);
+  fval->Release();
 }
 
-// static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
-//{
-//  KX_GameObject *gameobj, *parent;
-//  bool needs_update;
-//  KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData
-//  *)BLI_task_pool_user_data(pool); double curtime = data->curtime;
+bool KX_Scene::GetTempObjectLife(KX_GameObject *gameobj, float &life) const
+{
+  const auto it = m_tempObjectExpiry.find(gameobj);
+  if (it == m_tempObjectExpiry.end()) {
+    return false;
+  }
 
-//  gameobj = (KX_GameObject *)taskdata;
+  life = it->second - m_tempObjectTime;
+  return true;
+}
 
-//  // Non-armature updates are fast enough, so just update them
-//  needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
+void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
+{
+  CM_ListAddIfNotFound(m_animatedlist, gameobj);
+}
+
+static void update_anim_thread_func(TaskPool *__restrict pool, void *taskdata)
+{
+  KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData *)BLI_task_pool_user_data(
+      pool);
+  std::pair<KX_GameObject *, bool> *task = (std::pair<KX_GameObject *, bool> *)taskdata;
 
-//  if (!needs_update) {
-//    // If we got here, we're looking to update an armature, so check its children meshes
-//    // to see if we need to bother with a more expensive pose update
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
+  // Evaluate the actions and the pose, the scene graph is synchronized after in the main thread.
+  task->first->UpdateActionManagerThread(data->curtime, task->second);
+}
 
-//    bool has_mesh = false, has_non_mesh = false;
+/// Return true if the armature has child meshes and none of them is inside the frustum.
+static bool armature_is_culled(KX_GameObject *gameobj, const SG_Frustum &frustum)
+{
+  bool hasMesh = false;
+  for (KX_GameObject *child : gameobj->GetChildren()) {
+    Object *ob = child->GetBlenderObject();
+    if (!ob || ob->type != OB_MESH) {
+      continue;
+    }
+    hasMesh = true;
 
-//    // Check for meshes that haven't been culled
-//    for (KX_GameObject *child : children) {
-//      // if (!child->GetCulled()) { // eevee disable armature animation culling
-//      needs_update = true;
-//      break;
-//      //}
+    const std::optional<blender::Bounds<blender::float3>> bounds =
+        BKE_object_boundbox_eval_cached_get(ob);
+    if (!bounds) {
+      return false;
+    }
 
-//      if (child->GetMeshCount() == 0)
-//        has_non_mesh = true;
-//      else
-//        has_mesh = true;
-//    }
+    const blender::float3 center = bounds->center();
+    const blender::float3 size = bounds->size();
+    const MT_Vector3 &scale = child->NodeGetWorldScaling();
+    const float maxScale = std::max(
+        {std::fabs(scale.x()), std::fabs(scale.y()), std::fabs(scale.z())});
+    const MT_Vector3 worldCenter = child->NodeGetWorldTransform()(
+        MT_Vector3(center.x, center.y, center.z));
 
-//    // If we didn't find a non-culled mesh, check to see
-//    // if we even have any meshes, and update if this
-//    // armature has only non-mesh children.
-//    if (!needs_update && !has_mesh && has_non_mesh)
-//      needs_update = true;
-//  }
+    const float radius = MT_Vector3(size.x, size.y, size.z).length() * 0.5f * maxScale;
 
-//  // If the object is a culled armature, then we manage only the animation time and end of its
-//  // animations.
-//  gameobj->UpdateActionManager(curtime, needs_update);
+    if (frustum.SphereInsideFrustum(worldCenter, radius) != SG_Frustum::OUTSIDE)
+    {
+      return false;
+    }
+  }
 
-//  if (needs_update) {
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
-//    parent = gameobj->GetParent();
-//  }
-//}
+  return hasMesh;
+}
 
 void KX_Scene::UpdateAnimations(double curtime)
 {
-  // m_animationPoolData.curtime = curtime;
+  m_animationPoolData.curtime = curtime;
+
+  KX_Camera *cam = m_active_camera;
+  const bool useLod = cam && (m_animationCulling || m_animationLodDistance > 0.0f);
+  const MT_Vector3 camPos = cam ? cam->NodeGetWorldPosition() : MT_Vector3(0.0f, 0.0f, 0.0f);
 
+  /* Armature actions only write into their own pose, they are evaluated in parallel.
+   * The other actions can write into shared datablocks (node trees, shape keys),
+   * they are updated in the main thread. */
+  m_animationTasks.clear();
   for (KX_GameObject *gameobj : m_animatedlist) {
-    // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
-    // TASK_PRIORITY_LOW);
-    if (!gameobj->IsActionsSuspended()) {
+    if (gameobj->IsActionsSuspended()) {
+      continue;
+    }
+
+    if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+      bool applyObject = true;
+      /* Animation LOD: culled armatures only update their actions time, distant armatures
+       * evaluate their pose at a reduced rate. The actions frame only depends on the time,
+       * the pose is caught up at the first evaluation once visible or near again. */
+      if (useLod) {
+        const bool culled = m_animationCulling && armature_is_culled(gameobj, cam->GetFrustum());
+        const bool distant = m_animationLodDistance > 0.0f &&
+                             (gameobj->NodeGetWorldPosition() - camPos).length() >
+                                 m_animationLodDistance;
+        applyObject = gameobj->UpdateActionLod(culled, distant ? m_animationLodRate : 1);
+      }
+      m_animationTasks.emplace_back(gameobj, applyObject);
+    }
+    else {
       gameobj->UpdateActionManager(curtime, true);
     }
   }
 
-  // BLI_task_pool_work_and_wait(m_animationPool);
+  // The tasks list is complete and not reallocated anymore, its items can be used as task data.
+  for (std::pair<KX_GameObject *, bool> &task : m_animationTasks) {
+    BLI_task_pool_push(m_animationPool, update_anim_thread_func, &task, false, nullptr);
+  }
+
+  BLI_task_pool_work_and_wait(m_animationPool);
+
+  // Scene graph synchronization of the actions evaluated in parallel.
+  for (const std::pair<KX_GameObject *, bool> &task : m_animationTasks) {
+    task.first->UpdateActionIPOs();
+  }
 }
 
 void KX_Scene::LogicUpdateFrame(double curtime)
 {
   m_proxyManager.Update();
 
+  // Give the paths found in background since the last frame to the steering actuators.
+  m_pathQueryManager->CollectJobs();
+
   m_logicmgr->UpdateFrame(curtime);
+
+  // Solve the obstacle avoidance of all the steering actuators updated by the logic.
+  if (m_obstacleSimulation) {
+    m_obstacleSimulation->UpdateAgents();
+  }
+
+  // Search the paths requested by the logic while the frame is rendered.
+  m_pathQueryManager->DispatchJobs();
 }
 
 void KX_Scene::LogicEndFrame()
@@ -2496,11 +3127,86 @@ void KX_Scene::LogicEndFrame()
 /**
  * UpdateParents: SceneGraph transformation update.
  */
+/// Minimum number of independent hierarchies to update them in parallel.
+static const unsigned int SCENEGRAPH_PARALLEL_THRESHOLD = 64;
+
+static void update_scenegraph_thread_func(TaskPool *__restrict pool, void *taskdata)
+{
+  KX_Scene::SceneGraphPoolData *data = (KX_Scene::SceneGraphPoolData *)BLI_task_pool_user_data(
+      pool);
+  SG_Node *node = (SG_Node *)taskdata;
+
+  // The familly lock serializes the updates of the hierarchies sharing a top parent.
+  node->UpdateWorldDataThread(data->curtime);
+}
+
+static bool scenegraph_has_scheduled_ancestor(SG_Node *node)
+{
+  for (SG_Node *parent = node->GetSGParent(); parent; parent = parent->GetSGParent()) {
+    // A node linked in a list is scheduled, see SG_Node::Schedule.
+    if (!parent->Empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void KX_Scene::CollectSceneGraphUpdateRoots()
+{
+  /* A scheduled node with a scheduled ancestor is updated by the ancestor recursion,
+   * the other scheduled nodes are the roots of independent sub-hierarchies. */
+  m_sceneGraphUpdateRoots.clear();
+  SG_DList::iterator<SG_Node> it(m_sghead);
+  for (it.begin(); !it.end(); ++it) {
+    SG_Node *node = *it;
+    if (!scenegraph_has_scheduled_ancestor(node)) {
+      m_sceneGraphUpdateRoots.push_back(node);
+    }
+  }
+}
+
+void KX_Scene::UpdateParentsParallel(double curtime)
+{
+  /* The independent sub-hierarchies are updated in parallel,
+   * always parents before children as in the serial update. */
+  CollectSceneGraphUpdateRoots();
+
+  // Not worth the thread overhead, let the serial update do the work.
+  if (m_sceneGraphUpdateRoots.size() < SCENEGRAPH_PARALLEL_THRESHOLD) {
+    return;
+  }
+
+  m_sceneGraphPoolData.curtime = curtime;
+  for (SG_Node *node : m_sceneGraphUpdateRoots) {
+    BLI_task_pool_push(m_sceneGraphPool, update_scenegraph_thread_func, node, false, nullptr);
+  }
+  BLI_task_pool_work_and_wait(m_sceneGraphPool);
+}
+
+void KX_Scene::UpdateParentsBatch(double curtime)
+{
+  CollectSceneGraphUpdateRoots();
+
+  for (SG_Node *node : m_sceneGraphUpdateRoots) {
+    node->Delink();
+  }
+
+  m_transformStore.UpdateWorldData(m_sceneGraphUpdateRoots, curtime);
+}
+
 void KX_Scene::UpdateParents(double curtime)
 {
   // we use the SG dynamic list
   SG_Node *node;
 
+  if (m_parallelSceneGraph) {
+    UpdateParentsParallel(curtime);
+  }
+  if (m_batchSceneGraph) {
+    UpdateParentsBatch(curtime);
+  }
+
+  // Update serially the remaining nodes, e.g. scheduled during the parallel or batch update.
   while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
     node->UpdateWorldData(curtime);
   }
@@ -2520,17 +3226,13 @@ RAS_MaterialBucket *KX_Scene::FindBucket(class RAS_IPolyMaterial *polymat, bool
 
 void KX_Scene::UpdateObjectLods(KX_Camera *cam)
 {
-  const MT_Vector3 &cam_pos = cam->NodeGetWorldPosition();
-  const float lodfactor = cam->GetLodDistanceFactor();
-
-  for (KX_GameObject *gameobj : m_kxobWithLod) {
-    gameobj->UpdateLod(cam_pos, lodfactor);
-  }
+  m_lodTable.Update(m_kxobWithLod, this, cam->NodeGetWorldPosition(), cam->GetLodDistanceFactor());
 }
 
 void KX_Scene::SetLodHysteresis(bool active)
 {
   m_isActivedHysteresis = active;
+  m_lodTable.Invalidate();
 }
 
 bool KX_Scene::IsActivedLodHysteresis(void)
@@ -2541,6 +3243,7 @@ bool KX_Scene::IsActivedLodHysteresis(void)
 void KX_Scene::SetLodHysteresisValue(int hysteresisvalue)
 {
   m_lodHysteresisValue = hysteresisvalue;
+  m_lodTable.Invalidate();
 }
 
 int KX_Scene::GetLodHysteresisValue(void)
@@ -2554,34 +3257,63 @@ void KX_Scene::UpdateObjectActivity(void)
     return;
   }
 
+  std::vector<KX_Camera *> cameras;
   std::vector<MT_Vector3> camPositions;
 
   for (KX_Camera *cam : m_cameralist) {
     if (cam->GetActivityCulling()) {
+      cameras.push_back(cam);
       camPositions.push_back(cam->NodeGetWorldPosition());
     }
   }
 
   // None cameras are using object activity culling?
   if (camPositions.size() == 0) {
+    m_activityCullingCameras.clear();
+    m_activityCullingCameraPositions.clear();
     return;
   }
 
+  /* All objects are evaluated when the cameras or the hysteresis changed, else the cameras
+   * motion is accumulated and an object is only evaluated once its own displacement plus the
+   * cameras motion since its last evaluation can cross one of its culling radius. */
+  const bool reset = (cameras != m_activityCullingCameras ||
+                      m_activityCullingHysteresis != m_activityCullingPrevHysteresis);
+  if (!reset) {
+    float motion = 0.0f;
+    for (unsigned short i = 0, size = camPositions.size(); i < size; ++i) {
+      motion = max_ff((camPositions[i] - m_activityCullingCameraPositions[i]).length(), motion);
+    }
+    m_activityCullingCameraMotion += motion;
+  }
+
+  m_activityCullingCameras.swap(cameras);
+  m_activityCullingCameraPositions.swap(camPositions);
+  m_activityCullingPrevHysteresis = m_activityCullingHysteresis;
+
   for (KX_GameObject *gameobj : m_objectlist) {
+    const KX_GameObject::ActivityCullingInfo &info = gameobj->GetActivityCullingInfo();
     // If the object doesn't manage activity culling we don't compute distance.
-    if (gameobj->GetActivityCullingInfo().m_flags ==
-        KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
+    if (info.m_flags == KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
       continue;
     }
 
-    // For each camera compute the distance to objects and keep the minimum distance.
     const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
+
+    if (!reset && info.m_slack >= 0.0f) {
+      const float slack = info.m_slack - (m_activityCullingCameraMotion - info.m_cameraMotion);
+      if (slack > 0.0f && (obpos - info.m_position).length2() < slack * slack) {
+        continue;
+      }
+    }
+
+    // For each camera compute the distance to objects and keep the minimum distance.
     float dist = FLT_MAX;
-    for (const MT_Vector3 &campos : camPositions) {
+    for (const MT_Vector3 &campos : m_activityCullingCameraPositions) {
       // Keep the minimum distance.
       dist = min_ff((obpos - campos).length2(), dist);
     }
-    gameobj->UpdateActivity(dist);
+    gameobj->UpdateActivity(dist, m_activityCullingHysteresis, m_activityCullingCameraMotion);
   }
 }
 
@@ -2766,6 +3498,12 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   GetFontList()->MergeList(other->GetFontList());
   other->GetFontList()->ReleaseAndRemoveAll();
 
+  /* The merged objects could be scheduled in the other scene depsgraph synchronization list,
+   * synchronize all objects instead. */
+  other->m_depsgraphSyncObjects.clear();
+  other->m_depsgraphAlwaysSyncObjects.clear();
+  m_depsgraphFullSync = true;
+
   /* move materials across, assume they both use the same scene-converters
    * Do this after lights are merged so materials can use the lights in shaders
    */
@@ -2896,6 +3634,7 @@ PyTypeObject KX_Scene::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Scene",
 
 PyMethodDef KX_Scene::Methods[] = {
     EXP_PYMETHODTABLE(KX_Scene, addObject),
+    EXP_PYMETHODTABLE(KX_Scene, preallocateObject),
     EXP_PYMETHODTABLE(KX_Scene, end),
     EXP_PYMETHODTABLE(KX_Scene, restart),
     EXP_PYMETHODTABLE(KX_Scene, replace),
@@ -2908,6 +3647,7 @@ PyMethodDef KX_Scene::Methods[] = {
     EXP_PYMETHODTABLE(KX_Scene, addOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, removeOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, getGameObjectFromObject),
+    EXP_PYMETHODTABLE(KX_Scene, rayCastBatch),
 
     /* dict style access */
     EXP_PYMETHODTABLE(KX_Scene, get),
@@ -3250,6 +3990,14 @@ PyAttributeDef KX_Scene::Attributes[] = {
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
     EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
+    EXP_PYATTRIBUTE_FLOAT_RW(
+        "activityCullingHysteresis", 0.0f, FLT_MAX, KX_Scene, m_activityCullingHysteresis),
+    EXP_PYATTRIBUTE_BOOL_RW("parallelSceneGraph", KX_Scene, m_parallelSceneGraph),
+    EXP_PYATTRIBUTE_BOOL_RW("batchSceneGraph", KX_Scene, m_batchSceneGraph),
+    EXP_PYATTRIBUTE_BOOL_RW("animationCulling", KX_Scene, m_animationCulling),
+    EXP_PYATTRIBUTE_FLOAT_RW(
+        "animationLodDistance", 0.0f, FLT_MAX, KX_Scene, m_animationLodDistance),
+    EXP_PYATTRIBUTE_SHORT_RW("animationLodRate", 1, 1000, true, KX_Scene, m_animationLodRate),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
     EXP_PYATTRIBUTE_RO_FUNCTION("logger", KX_Scene, KX_PythonProxy::pyattr_get_logger),
     EXP_PYATTRIBUTE_RO_FUNCTION("loggerName", KX_Scene, KX_PythonProxy::pyattr_get_logger_name),
@@ -3310,6 +4058,42 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   return replica->GetProxy();
 }
 
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    preallocateObject,
+                    "preallocateObject(object, count)\n"
+                    "Prepare count hidden copies of the object to be reused by addObject.\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+  int count;
+
+  if (!PyArg_ParseTuple(args, "Oi:preallocateObject", &pyob, &count)) {
+    return nullptr;
+  }
+
+  if (!ConvertPythonToGameObject(
+          m_logicmgr, pyob, &ob, false, "scene.preallocateObject(object, count): KX_Scene")) {
+    return nullptr;
+  }
+
+  if (!m_inactivelist->SearchValue(ob)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.preallocateObject(object, count): KX_Scene: object must be in an "
+                    "inactive layer");
+    return nullptr;
+  }
+
+  if (count < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.preallocateObject(object, count): KX_Scene: count must be positive");
+    return nullptr;
+  }
+
+  PreallocateReplicaObjects(ob, count);
+
+  Py_RETURN_NONE;
+}
+
 EXP_PYMETHODDEF_DOC(KX_Scene,
                     end,
                     "end()\n"
@@ -3602,6 +4386,137 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+/// Ray filter of rayCastBatch, called from the physics worker threads.
+class KX_RayCastBatchFilter : public PHY_IRayCastFilterCallback {
+ private:
+  const unsigned int m_mask;
+
+ public:
+  KX_RayCastBatchFilter(unsigned int mask) : PHY_IRayCastFilterCallback(nullptr), m_mask(mask)
+  {
+  }
+
+  virtual bool needBroadphaseRayCast(PHY_IPhysicsController *controller)
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(controller->GetNewClientInfo());
+    if (!info || !info->m_gameobject) {
+      return false;
+    }
+    return (m_mask == ((1u << OB_MAX_COL_MASKS) - 1) ||
+            (info->m_gameobject->GetCollisionGroup() & m_mask));
+  }
+
+  virtual void reportHit(PHY_RayCastResult *result)
+  {
+  }
+};
+
+/// Read a contiguous buffer of float or double triplets.
+static bool ray_points_from_buffer(PyObject *value,
+                                   std::vector<MT_Vector3> &points,
+                                   const char *error_prefix)
+{
+  Py_buffer buffer;
+  if (PyObject_GetBuffer(value, &buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+    PyErr_Format(PyExc_TypeError, "%s: expected a contiguous buffer of floats", error_prefix);
+    return false;
+  }
+
+  const char *format = buffer.format ? buffer.format : "B";
+  // Skip the native byte order and alignment character.
+  if (ELEM(format[0], '@', '=')) {
+    ++format;
+  }
+
+  const bool isFloat = (STREQ(format, "f") && buffer.itemsize == sizeof(float));
+  const bool isDouble = (STREQ(format, "d") && buffer.itemsize == sizeof(double));
+  const Py_ssize_t size = buffer.len / buffer.itemsize;
+  if ((!isFloat && !isDouble) || (size % 3) != 0) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s: expected a buffer of float or double with a multiple of 3 items",
+                 error_prefix);
+    PyBuffer_Release(&buffer);
+    return false;
+  }
+
+  points.resize(size / 3);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    points[i / 3][i % 3] = isFloat ? ((float *)buffer.buf)[i] : ((double *)buffer.buf)[i];
+  }
+
+  PyBuffer_Release(&buffer);
+  return true;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    rayCastBatch,
+                    "rayCastBatch(origins, targets, mask): cast a ray for each origin and target "
+                    "pair and return a list of (object, point, normal) tuples\n"
+                    " origins, targets = buffers of float or double of same size holding "
+                    "the ray points as consecutive triplets\n"
+                    " mask = collision mask: only objects with a collision group in the mask "
+                    "are tested, 0 < mask < 65536\n")
+{
+  PyObject *pyorigins;
+  PyObject *pytargets;
+  int mask = (1 << OB_MAX_COL_MASKS) - 1;
+
+  if (!PyArg_ParseTuple(args, "OO|i:rayCastBatch", &pyorigins, &pytargets, &mask)) {
+    return nullptr;
+  }
+
+  if (mask == 0 || mask & ~((1 << OB_MAX_COL_MASKS) - 1)) {
+    PyErr_Format(PyExc_ValueError,
+                 "scene.rayCastBatch(origins, targets, mask): KX_Scene, mask argument must be "
+                 "an int bitfield, 0 < mask < %i",
+                 (1 << OB_MAX_COL_MASKS));
+    return nullptr;
+  }
+
+  std::vector<MT_Vector3> origins;
+  std::vector<MT_Vector3> targets;
+  if (!ray_points_from_buffer(pyorigins, origins, "scene.rayCastBatch(origins, ...)") ||
+      !ray_points_from_buffer(pytargets, targets, "scene.rayCastBatch(..., targets, ...)"))
+  {
+    return nullptr;
+  }
+
+  if (origins.size() != targets.size()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.rayCastBatch(origins, targets, mask): KX_Scene, origins and targets "
+                    "must have the same size");
+    return nullptr;
+  }
+
+  const unsigned int count = origins.size();
+  std::vector<PHY_RayCastBatchResult> results(count);
+  KX_RayCastBatchFilter filter(mask);
+  m_physicsEnvironment->RayTestBatch(
+      filter, origins.data(), targets.data(), count, results.data());
+
+  PyObject *list = PyList_New(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    const PHY_RayCastBatchResult &result = results[i];
+    PyObject *item = PyTuple_New(3);
+    if (result.m_controller) {
+      KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+          result.m_controller->GetNewClientInfo());
+      PyTuple_SET_ITEM(item, 0, info->m_gameobject->GetProxy());
+      PyTuple_SET_ITEM(item, 1, PyObjectFrom(result.m_hitPoint));
+      PyTuple_SET_ITEM(item, 2, PyObjectFrom(result.m_hitNormal));
+    }
+    else {
+      for (unsigned short j = 0; j < 3; ++j) {
+        Py_INCREF(Py_None);
+        PyTuple_SET_ITEM(item, j, Py_None);
+      }
+    }
+    PyList_SET_ITEM(list, i, item);
+  }
+
+  return list;
+}
+
 bool ConvertPythonToScene(PyObject *value,
                           KX_Scene **scene,
                           bool py_none_ok,
@@ -31,14 +31,20 @@
 
 #pragma once
 
+#include <functional>
 #include <list>
+#include <queue>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
+#include "CM_Thread.h"
 #include "DNA_ID.h"  // For IDRecalcFlag
 
 #include "EXP_PyObjectPlus.h"
 #include "EXP_Value.h"
+#include "KX_LodTable.h"
+#include "KX_OcclusionBuffer.h"
 #include "KX_PhysicsEngineEnums.h"
 #include "KX_PythonProxy.h"
 #include "KX_PythonProxyManager.h"
@@ -48,6 +54,7 @@
 #include "SCA_IScene.h"
 #include "SG_Frustum.h"
 #include "SG_Node.h"
+#include "SG_TransformStore.h"
 
 /**
  * \section Forward declarations
@@ -83,6 +90,7 @@ class KX_2DFilterManager;
 class BL_SceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
+class KX_PathQueryManager;
 struct TaskPool;
 
 /*********EEVEE INTEGRATION************/
@@ -111,6 +119,35 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     double curtime;
   };
 
+  struct SceneGraphPoolData {
+    double curtime;
+  };
+
+  /// Culled objects and lod levels of a render pass, computed before the passes are drawn.
+  struct CameraVisibility {
+    KX_Camera *m_renderCamera;
+    /// Frustum of the culling camera, copied as the cameras compute it lazily.
+    SG_Frustum m_frustum;
+    int m_width;
+    int m_height;
+    bool m_isOverlayPass;
+    bool m_useLod;
+    bool m_computed;
+    MT_Vector3 m_lodPosition;
+    float m_lodFactor;
+
+    /// Culled state of each object of KX_Scene::m_cullingObjects.
+    std::vector<unsigned char> m_culled;
+    /// Indices of the objects in the frustum to test against the occluders.
+    std::vector<unsigned int> m_candidates;
+    KX_OcclusionBuffer m_occlusionBuffer;
+    unsigned int m_numCulled;
+    unsigned int m_numOccluders;
+
+    std::vector<float> m_lodDistances;
+    std::vector<short> m_lodLevels;
+  };
+
  private:
   Py_Header
 
@@ -135,8 +172,18 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   BL_SceneConverter *m_sceneConverter;
   bool m_isPythonMainLoop;
   std::vector<KX_GameObject *> m_kxobWithLod;
+  /// Packed lod data of m_kxobWithLod.
+  KX_LodTable m_lodTable;
   std::map<Object *, char> m_obRestrictFlags;
   bool m_collectionRemap;
+  /**
+   * Hidden Blender objects of ended replicas sorted by the template object they were
+   * copied from. They are reused by the next replicas of the same template to avoid
+   * an ID copy and a depsgraph relations update for each added object.
+   */
+  std::map<Object *, std::vector<Object *>> m_replicaObjectPool;
+  /// True when a pooled replica object was hidden or shown since the last render.
+  bool m_replicaBaseFlagsChanged;
   std::vector<BackupObj *> m_backupObList;
   int m_backupOverlayFlag;
   int m_backupOverlayGameFlag;
@@ -150,11 +197,36 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   std::vector<std::pair<ID *, IDRecalcFlag>> m_idsToUpdateInAllRenderPasses;
   std::vector<std::pair<ID *, IDRecalcFlag>> m_idsToUpdateInOverlayPass;
+  /// Protect the lists of IDs to update, filled by actions evaluated in parallel.
+  CM_ThreadSpinLock m_idsToUpdateLock;
+
+  /**
+   * Objects moved since the last frame render, only their transform is
+   * synchronized with the depsgraph. Filled by the scene graph render dirty callback.
+   */
+  std::vector<KX_GameObject *> m_depsgraphSyncObjects;
+  /// Objects taking their transform from the depsgraph (rigid body, fluid...), synced each pass.
+  std::vector<KX_GameObject *> m_depsgraphAlwaysSyncObjects;
+  /// True to synchronize all objects at the next render pass, e.g. at scene start or merge.
+  bool m_depsgraphFullSync;
+  CM_ThreadSpinLock m_depsgraphSyncLock;
   /*************************************************/
 
   RAS_BucketManager *m_bucketmanager;
 
-  std::vector<KX_GameObject *> m_tempObjectList;
+  /**
+   * \section Temporary objects, removed once their life is over.
+   */
+  typedef std::pair<double, KX_GameObject *> TempObjectEntry;
+  /// Logic time elapsed in this scene, the temporary objects expiry times are relative to it.
+  double m_tempObjectTime;
+  /// Expiry time of each temporary object.
+  std::unordered_map<KX_GameObject *, double> m_tempObjectExpiry;
+  /** Temporary objects sorted by expiry time, the entries not matching m_tempObjectExpiry
+   * belong to objects already removed and are ignored. */
+  std::priority_queue<TempObjectEntry, std::vector<TempObjectEntry>, std::greater<TempObjectEntry>>
+      m_tempObjectQueue;
+  /*************************************************/
 
   /**
    * The list of objects which have been removed during the
@@ -267,6 +339,44 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   bool m_activityCulling;
 
+  /**
+   * Distance beyond the activity culling radius an object must reach to be suspended.
+   */
+  float m_activityCullingHysteresis;
+  /// Hysteresis used at the last activity culling update.
+  float m_activityCullingPrevHysteresis;
+  /// Cameras using activity culling and their positions at the last activity culling update.
+  std::vector<KX_Camera *> m_activityCullingCameras;
+  std::vector<MT_Vector3> m_activityCullingCameraPositions;
+  /// Sum of the maximum cameras displacement of each activity culling update.
+  double m_activityCullingCameraMotion;
+
+  /**
+   * Toggle to update independent scene graph hierarchies in parallel.
+   */
+  bool m_parallelSceneGraph;
+
+  /**
+   * Toggle to update the scene graph level by level using m_transformStore.
+   */
+  bool m_batchSceneGraph;
+
+  /**
+   * Toggle to skip the pose evaluation of armatures without visible child mesh.
+   */
+  bool m_animationCulling;
+
+  /**
+   * Distance to the active camera from which armatures poses are evaluated at a
+   * reduced rate, 0 to disable.
+   */
+  float m_animationLodDistance;
+
+  /**
+   * Number of animation updates between two pose evaluations of a distant armature.
+   */
+  short m_animationLodRate;
+
   /**
    * Toggle to enable or disable culling via DBVT broadphase of Bullet.
    */
@@ -277,6 +387,16 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   int m_dbvt_occlusion_res;
 
+  /// Mesh objects with their bounds updated for the culling of the current frame.
+  std::vector<KX_GameObject *> m_cullingObjects;
+  bool m_cullingObjectsValid;
+  /// Visibility of the render passes of the current frame, the items are reused between frames.
+  std::vector<CameraVisibility> m_cameraVisibilities;
+  unsigned int m_numCameraVisibilities;
+  TaskPool *m_visibilityPool;
+  /// True when the lod table was rebuilt after the levels of the passes were selected.
+  bool m_lodLevelsStale;
+
   /**
    * The framing settings used by this scene
    */
@@ -289,19 +409,32 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   RAS_Rect m_viewport;
 
-  /**
-   * Visibility testing functions.
-   */
-  static void PhysicsCullingCallback(KX_ClientObjectInfo *objectInfo, void *cullingInfo);
+  /// Store the bounds of the mesh objects to cull, done once per frame.
+  void UpdateCullingObjects(struct Depsgraph *depsgraph);
+  /// Compute the visibility of the passes added since the last computation, one task each.
+  void ComputeCameraVisibilities(struct Depsgraph *depsgraph);
+  CameraVisibility *FindCameraVisibility(KX_Camera *cam);
+  /// Flag the culled objects with OB_CULLED for the draw loop and apply the lod levels.
+  void ApplyCameraVisibility(const CameraVisibility &visibility);
 
   struct Scene *m_blenderScene;
 
   KX_2DFilterManager *m_filterManager;
 
   KX_ObstacleSimulation *m_obstacleSimulation;
+  KX_PathQueryManager *m_pathQueryManager;
 
   AnimationPoolData m_animationPoolData;
   TaskPool *m_animationPool;
+  /// Armatures updated in parallel and if their actions are applied, see animation LOD.
+  std::vector<std::pair<KX_GameObject *, bool>> m_animationTasks;
+
+  SceneGraphPoolData m_sceneGraphPoolData;
+  TaskPool *m_sceneGraphPool;
+  /// Scheduled nodes without scheduled ancestor, updated in parallel or by batch.
+  std::vector<SG_Node *> m_sceneGraphUpdateRoots;
+  /// Transforms of the nodes updated by batch.
+  SG_TransformStore m_transformStore;
 
   /**
    * LOD Hysteresis settings
@@ -357,6 +490,12 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void BackupRestrictFlag(Object *ob, char restrictFlag);
   void RestoreRestrictFlags();
   void TagForCollectionRemap();
+  Object *NewReplicaObject(Object *ob);
+  Object *AcquirePooledReplicaObject(Object *templateob);
+  bool ReleaseReplicaObject(Object *templateob, Object *ob);
+  void PreallocateReplicaObjects(KX_GameObject *gameobj, unsigned int count);
+  /// Free the pooled replica objects, only the ones copied from tagged objects if onlyTagged.
+  void FreeReplicaObjectPool(bool onlyTagged);
   KX_GameObject *GetGameObjectFromObject(Object *ob);
   void BackupObjectsMatToWorld(BackupObj *back);
   void RestoreObjectsMatToWorld();
@@ -372,6 +511,10 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void AppendToIdsToUpdateInOverlayPass(ID *id, IDRecalcFlag flag);
   void TagForExtraIdsUpdate(Main *bmain, KX_Camera *cam);
   void TagBlenderPhysicsObject(Scene *scene, Object *ob);
+  /// Schedule an object transform synchronization with the depsgraph at next render, thread safe.
+  void AddDepsgraphSyncObject(KX_GameObject *gameobj);
+  void TagDepsgraphSyncObjects(Scene *scene, bool is_overlay_pass, bool is_last_render_pass);
+  void UpdateDepsgraphSyncObjectsEvaluated(bool is_last_render_pass);
   KX_GameObject *AddDuplicaObject(KX_GameObject *gameobj,
                                   KX_GameObject *reference,
                                   float lifespan);
@@ -389,6 +532,9 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   static bool KX_ScenegraphUpdateFunc(SG_Node *node, void *gameobj, void *scene);
   static bool KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *scene);
   void UpdateParents(double curtime);
+  void CollectSceneGraphUpdateRoots();
+  void UpdateParentsParallel(double curtime);
+  void UpdateParentsBatch(double curtime);
   void DupliGroupRecurse(KX_GameObject *groupobj, int level);
   bool IsObjectInGroup(KX_GameObject *gameobj)
   {
@@ -405,6 +551,17 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void RemoveDupliGroup(KX_GameObject *gameobj);
   void DelayedRemoveObject(KX_GameObject *gameobj);
 
+  /**
+   * Register a temporary object removed once its life is over.
+   * \param life The remaining life in seconds of logic time.
+   */
+  void AddTempObject(KX_GameObject *gameobj, float life);
+  /**
+   * Get the remaining life of a temporary object.
+   * \return False if the object is not a temporary object.
+   */
+  bool GetTempObjectLife(KX_GameObject *gameobj, float &life) const;
+
   bool NewRemoveObject(KX_GameObject *gameobj);
   void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys);
 
@@ -493,6 +650,26 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   /// Update the mesh for objects based on level of detail settings
   void UpdateObjectLods(KX_Camera *cam);
 
+  /**
+   * Register a render pass of the frame, the visibility of all the passes is computed in
+   * parallel when the first one is rendered.
+   * \param cullingCamera The camera used for the frustum and occlusion culling.
+   * \param width The width of the rendered viewport.
+   * \param height The height of the rendered viewport.
+   * \param isOverlayPass Cull the objects of the overlay collection instead of the others.
+   * \param useLod Select the lod levels for the render camera.
+   */
+  void AddCameraVisibility(KX_Camera *renderCamera,
+                           KX_Camera *cullingCamera,
+                           int width,
+                           int height,
+                           bool isOverlayPass,
+                           bool useLod);
+  /// Compute the culled objects and the lod levels of a pass, called from the task pool.
+  void ComputeCameraVisibility(CameraVisibility &visibility) const;
+  /// Forget the visibility of the passes once the frame is rendered.
+  void ClearCameraVisibilities();
+
   // LoD Hysteresis functions
   void SetLodHysteresis(bool active);
   bool IsActivedLodHysteresis();
@@ -552,6 +729,11 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     return m_obstacleSimulation;
   }
 
+  KX_PathQueryManager *GetPathQueryManager()
+  {
+    return m_pathQueryManager;
+  }
+
   /**  Inherited from EXP_Value -- returns the name of this object. */
   virtual std::string GetName();
 
@@ -566,6 +748,7 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   /* --------------------------------------------------------------------- */
 
   EXP_PYMETHOD_DOC(KX_Scene, addObject);
+  EXP_PYMETHOD_DOC(KX_Scene, preallocateObject);
   EXP_PYMETHOD_DOC(KX_Scene, end);
   EXP_PYMETHOD_DOC(KX_Scene, restart);
   EXP_PYMETHOD_DOC(KX_Scene, replace);
@@ -579,6 +762,7 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_PYMETHOD_DOC(KX_Scene, addOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, removeOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, getGameObjectFromObject);
+  EXP_PYMETHOD_DOC(KX_Scene, rayCastBatch);
 
   /* attributes */
   static PyObject *pyattr_get_name(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
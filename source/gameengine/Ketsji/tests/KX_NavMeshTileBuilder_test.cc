@@ -0,0 +1,187 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/tests/KX_NavMeshTileBuilder_test.cc
+ *  \ingroup ketsji
+ */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "DetourTileNavMesh.h"
+#include "KX_NavMeshTileBuilder.h"
+
+/// Square from 0.5 to 5.5 on X and Z, its height is 0.1 * X.
+static void build_square_source(KX_NavMeshTileBuilder::Source &source)
+{
+  const float corners[4][2] = {{0.5f, 0.5f}, {0.5f, 5.5f}, {5.5f, 5.5f}, {5.5f, 0.5f}};
+  for (const float *corner : corners) {
+    source.verts.push_back(corner[0]);
+    source.verts.push_back(0.1f * corner[0]);
+    source.verts.push_back(corner[1]);
+  }
+
+  source.vertsPerPoly = 6;
+  source.polys = {0, 1, 2, 3, 0xffff, 0xffff};
+
+  const int tris[2][3] = {{0, 1, 2}, {0, 2, 3}};
+  for (const int *tri : tris) {
+    for (int i = 0; i < 3; ++i) {
+      const float *v = &source.verts[tri[i] * 3];
+      source.tris.insert(source.tris.end(), v, v + 3);
+    }
+  }
+  source.polyTris = {0, 2};
+
+  const float bmin[3] = {0.5f, 0.05f, 0.5f};
+  const float bmax[3] = {5.5f, 0.55f, 5.5f};
+  std::copy_n(bmin, 3, source.bmin);
+  std::copy_n(bmax, 3, source.bmax);
+}
+
+static bool on_square_border(const float *a, const float *b)
+{
+  const float eps = 1e-3f;
+  for (int k = 0; k < 3; k += 2) {
+    for (const float side : {0.5f, 5.5f}) {
+      if (fabsf(a[k] - side) < eps && fabsf(b[k] - side) < eps) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+TEST(navmesh_tile_builder, clip_polygons)
+{
+  KX_NavMeshTileBuilder::Source source;
+  build_square_source(source);
+
+  const float orig[3] = {0.0f, 0.0f, 0.0f};
+  const float cellSize = 0.1f;
+  KX_NavMeshTileBuilder builder(orig, 2.0f, cellSize);
+  const float tileSize = builder.GetTileSize();
+  EXPECT_FLOAT_EQ(tileSize, 2.0f);
+
+  int minx, miny, maxx, maxy;
+  builder.GetTileRange(source.bmin, source.bmax, minx, miny, maxx, maxy);
+  EXPECT_EQ(minx, 0);
+  EXPECT_EQ(miny, 0);
+  EXPECT_EQ(maxx, 2);
+  EXPECT_EQ(maxy, 2);
+
+  // One more column of tiles without polygons.
+  std::vector<KX_NavMeshTileBuilder::Tile> tiles;
+  builder.BuildTiles(source, 0, 0, 3, 2, tiles);
+  ASSERT_EQ(tiles.size(), 12u);
+
+  dtTiledNavMesh navmesh;
+  navmesh.init(builder.GetOrigin(), tileSize, cellSize);
+  for (const KX_NavMeshTileBuilder::Tile &tile : tiles) {
+    if (tile.x == 3) {
+      EXPECT_EQ(tile.data, nullptr);
+      continue;
+    }
+    ASSERT_NE(tile.data, nullptr);
+    ASSERT_TRUE(navmesh.addTileAt(tile.x, tile.y, tile.data, tile.dataSize, true));
+  }
+
+  float area = 0.0f;
+  for (int y = 0; y <= 2; ++y) {
+    for (int x = 0; x <= 2; ++x) {
+      const dtTileHeader *header = navmesh.getTileAt(x, y)->header;
+      const float tmin[2] = {x * tileSize, y * tileSize};
+
+      // The vertices are clipped to the tile and keep the height of the source polygon.
+      for (int i = 0; i < header->nverts; ++i) {
+        const float *v = &header->verts[i * 3];
+        EXPECT_GE(v[0], tmin[0] - 1e-4f);
+        EXPECT_LE(v[0], tmin[0] + tileSize + 1e-4f);
+        EXPECT_GE(v[2], tmin[1] - 1e-4f);
+        EXPECT_LE(v[2], tmin[1] + tileSize + 1e-4f);
+        EXPECT_NEAR(v[1], 0.1f * v[0], cellSize);
+      }
+
+      for (int p = 0; p < header->npolys; ++p) {
+        const dtTilePoly &poly = header->polys[p];
+        for (int j = poly.nv - 1, i = 0; i < poly.nv; j = i++) {
+          const float *a = &header->verts[poly.v[j] * 3];
+          const float *b = &header->verts[poly.v[i] * 3];
+          area += a[0] * b[2] - b[0] * a[2];
+
+          // The clipped edges are portals to the neighbor tiles, only the square border is a wall.
+          EXPECT_EQ(KX_NavMeshTileBuilder::IsWall(header, p, j), on_square_border(a, b));
+        }
+      }
+    }
+  }
+  EXPECT_NEAR(fabsf(area) * 0.5f, 25.0f, 1e-3f);
+
+  // A path crosses the tile borders in a straight line.
+  const float start[3] = {1.0f, 0.1f, 1.0f};
+  const float end[3] = {5.0f, 0.5f, 3.0f};
+  const float extents[3] = {0.5f, 1.0f, 0.5f};
+  const dtTilePolyRef startRef = navmesh.findNearestPoly(start, extents);
+  const dtTilePolyRef endRef = navmesh.findNearestPoly(end, extents);
+  ASSERT_NE(startRef, 0u);
+  ASSERT_NE(endRef, 0u);
+
+  dtTilePolyRef polys[64];
+  const int npolys = navmesh.findPath(startRef, endRef, start, end, polys, 64);
+  ASSERT_GT(npolys, 0);
+  EXPECT_EQ(polys[npolys - 1], endRef);
+
+  float path[64 * 3];
+  const int npoints = navmesh.findStraightPath(start, end, polys, npolys, path, 64);
+  ASSERT_GE(npoints, 2);
+  EXPECT_NEAR(path[(npoints - 1) * 3], end[0], 1e-3f);
+  EXPECT_NEAR(path[(npoints - 1) * 3 + 2], end[2], 1e-3f);
+  // The portals are stored with a limited precision, the path stays close to the line.
+  for (int i = 0; i < npoints; ++i) {
+    const float *p = &path[i * 3];
+    const float dist = ((end[0] - start[0]) * (p[2] - start[2]) -
+                        (end[2] - start[2]) * (p[0] - start[0])) /
+                       hypotf(end[0] - start[0], end[2] - start[2]);
+    EXPECT_LT(fabsf(dist), 0.05f);
+  }
+}
+
+TEST(navmesh_tile_builder, empty_range)
+{
+  KX_NavMeshTileBuilder::Source source;
+  build_square_source(source);
+
+  const float orig[3] = {0.0f, 0.0f, 0.0f};
+  KX_NavMeshTileBuilder builder(orig, 2.0f, 0.1f);
+
+  std::vector<KX_NavMeshTileBuilder::Tile> tiles;
+  builder.BuildTiles(source, 5, 5, 6, 6, tiles);
+  ASSERT_EQ(tiles.size(), 4u);
+  for (const KX_NavMeshTileBuilder::Tile &tile : tiles) {
+    EXPECT_EQ(tile.data, nullptr);
+  }
+
+  tiles.clear();
+  builder.BuildTiles(source, 2, 2, 1, 1, tiles);
+  EXPECT_TRUE(tiles.empty());
+}
@@ -0,0 +1,180 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/tests/KX_PathQueryManager_test.cc
+ *  \ingroup ketsji
+ */
+
+#include "testing/testing.h"
+
+#include "KX_NavMeshObject.h"
+#include "KX_NavMeshTileBuilder.h"
+#include "KX_PathQueryManager.h"
+
+/// Navigation mesh object without scene, using a tiled navigation mesh of a 6 x 6 square.
+class TestNavMesh : public KX_NavMeshObject {
+ public:
+  TestNavMesh()
+  {
+    KX_NavMeshTileBuilder::Source source;
+    source.vertsPerPoly = 6;
+    source.verts = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 6.0f, 6.0f, 0.0f, 6.0f, 6.0f, 0.0f, 0.0f};
+    source.polys = {0, 1, 2, 3, 0xffff, 0xffff};
+    source.tris = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 6.0f, 6.0f, 0.0f, 6.0f,
+                   0.0f, 0.0f, 0.0f, 6.0f, 0.0f, 6.0f, 6.0f, 0.0f, 0.0f};
+    source.polyTris = {0, 2};
+
+    const float orig[3] = {0.0f, 0.0f, 0.0f};
+    KX_NavMeshTileBuilder builder(orig, 2.0f, 0.1f);
+    std::vector<KX_NavMeshTileBuilder::Tile> tiles;
+    builder.BuildTiles(source, 0, 0, 2, 2, tiles);
+
+    m_tiledNavMesh = new dtTiledNavMesh;
+    m_tiledNavMesh->init(orig, builder.GetTileSize(), 0.1f);
+    for (const KX_NavMeshTileBuilder::Tile &tile : tiles) {
+      m_tiledNavMesh->addTileAt(tile.x, tile.y, tile.data, tile.dataSize, true);
+    }
+  }
+};
+
+static const MT_Transform &identity_transform = MT_Transform::Identity();
+
+/// Check that the world space path goes from the Detour start to the Detour goal.
+static void expect_path(const KX_PathQuery &query,
+                        const float spos[3],
+                        const float epos[3],
+                        const MT_Vector3 &offset)
+{
+  ASSERT_TRUE(query.IsDone());
+  const int pathLen = query.GetPathLen();
+  ASSERT_GE(pathLen, 2);
+
+  // The Detour Y and Z axes are swapped in world space.
+  const float *first = &query.GetPath()[0];
+  const float *last = &query.GetPath()[(pathLen - 1) * 3];
+  EXPECT_NEAR(first[0], spos[0] + offset.x(), 1e-3f);
+  EXPECT_NEAR(first[1], spos[2] + offset.y(), 1e-3f);
+  EXPECT_NEAR(last[0], epos[0] + offset.x(), 1e-3f);
+  EXPECT_NEAR(last[1], epos[2] + offset.y(), 1e-3f);
+  EXPECT_NEAR(last[2], offset.z(), 1e-3f);
+}
+
+TEST(path_query_manager, batched_queries)
+{
+  TestNavMesh *navmesh = new TestNavMesh();
+  KX_PathQueryManager manager;
+
+  // Both starts and both goals are in the same polygons, the queries share a single search.
+  const float spos1[3] = {0.5f, 0.0f, 0.5f};
+  const float spos2[3] = {1.5f, 0.0f, 1.0f};
+  const float epos1[3] = {5.5f, 0.0f, 5.0f};
+  const float epos2[3] = {5.0f, 0.0f, 5.5f};
+  std::shared_ptr<KX_PathQuery> query1 = manager.RequestPath(
+      navmesh, identity_transform, spos1, epos1, 32);
+  std::shared_ptr<KX_PathQuery> query2 = manager.RequestPath(
+      navmesh, identity_transform, spos2, epos2, 32);
+  EXPECT_FALSE(query1->IsDone());
+  EXPECT_FALSE(query2->IsDone());
+
+  manager.DispatchJobs();
+  manager.WaitNavMesh(navmesh);
+
+  // Each query of a batch gets the path between its own positions.
+  expect_path(*query1, spos1, epos1, MT_Vector3(0.0f, 0.0f, 0.0f));
+  expect_path(*query2, spos2, epos2, MT_Vector3(0.0f, 0.0f, 0.0f));
+
+  // The corridor found is cached, a query between the same polygons is answered immediately.
+  std::shared_ptr<KX_PathQuery> query3 = manager.RequestPath(
+      navmesh, identity_transform, spos2, epos1, 32);
+  expect_path(*query3, spos2, epos1, MT_Vector3(0.0f, 0.0f, 0.0f));
+
+  float path[32 * 3];
+  EXPECT_GE(manager.FindPath(navmesh, spos1, epos2, path, 32), 2);
+
+  manager.RemoveNavMesh(navmesh);
+  navmesh->Release();
+}
+
+TEST(path_query_manager, request_transform)
+{
+  TestNavMesh *navmesh = new TestNavMesh();
+  KX_PathQueryManager manager;
+
+  const float spos[3] = {0.5f, 0.0f, 0.5f};
+  const float epos[3] = {5.5f, 0.0f, 5.5f};
+  const MT_Vector3 offset(10.0f, 20.0f, 30.0f);
+  const MT_Transform transform(offset, identity_transform.getBasis());
+  std::shared_ptr<KX_PathQuery> query = manager.RequestPath(navmesh, transform, spos, epos, 32);
+
+  // The path uses the transform of the request, not the one of the collection.
+  manager.DispatchJobs();
+  manager.WaitNavMesh(navmesh);
+  manager.CollectJobs();
+  expect_path(*query, spos, epos, offset);
+
+  // A query answered from the cache uses its own transform.
+  query = manager.RequestPath(navmesh, identity_transform, spos, epos, 32);
+  expect_path(*query, spos, epos, MT_Vector3(0.0f, 0.0f, 0.0f));
+
+  manager.RemoveNavMesh(navmesh);
+  navmesh->Release();
+}
+
+TEST(path_query_manager, reset_and_remove)
+{
+  TestNavMesh *navmesh = new TestNavMesh();
+  KX_PathQueryManager manager;
+
+  const float spos[3] = {0.5f, 0.0f, 0.5f};
+  const float epos[3] = {5.5f, 0.0f, 5.5f};
+  const float outside[3] = {50.0f, 0.0f, 50.0f};
+
+  // A position outside of the navigation mesh has no path.
+  std::shared_ptr<KX_PathQuery> query = manager.RequestPath(
+      navmesh, identity_transform, spos, outside, 32);
+  ASSERT_TRUE(query->IsDone());
+  EXPECT_EQ(query->GetPathLen(), 0);
+
+  query = manager.RequestPath(navmesh, identity_transform, spos, epos, 32);
+  manager.DispatchJobs();
+  manager.WaitNavMesh(navmesh);
+  ASSERT_TRUE(query->IsDone());
+
+  // The cache of a modified navigation mesh is dropped, the pending queries are searched again.
+  manager.ResetNavMesh(navmesh);
+  query = manager.RequestPath(navmesh, identity_transform, spos, epos, 32);
+  EXPECT_FALSE(query->IsDone());
+  manager.ResetNavMesh(navmesh);
+  EXPECT_FALSE(query->IsDone());
+  manager.DispatchJobs();
+  manager.WaitNavMesh(navmesh);
+  expect_path(*query, spos, epos, MT_Vector3(0.0f, 0.0f, 0.0f));
+
+  // The pending queries of a removed navigation mesh are done without path.
+  manager.ResetNavMesh(navmesh);
+  query = manager.RequestPath(navmesh, identity_transform, spos, epos, 32);
+  manager.RemoveNavMesh(navmesh);
+  ASSERT_TRUE(query->IsDone());
+  EXPECT_EQ(query->GetPathLen(), 0);
+
+  navmesh->Release();
+}
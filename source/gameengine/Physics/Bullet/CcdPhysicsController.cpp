@@ -193,6 +193,9 @@ CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cc
   m_softbodyMappingDone = false;
   m_newClientInfo = 0;
   m_registerCount = 0;
+  m_controllerKind = -1;
+  m_controllerIndex = -1;
+  m_fhControllerIndex = -1;
   m_softBodyTransformInitialized = false;
   m_parentRoot = nullptr;
   // copy pointers locally to allow smart release
@@ -939,6 +942,9 @@ void CcdPhysicsController::PostProcessReplica(class PHY_IMotionState *motionstat
   m_softBodyTransformInitialized = false;
   m_MotionState = motionstate;
   m_registerCount = 0;
+  m_controllerKind = -1;
+  m_controllerIndex = -1;
+  m_fhControllerIndex = -1;
   m_collisionShape = nullptr;
 
   // Clear all old constraints.
@@ -1256,6 +1262,14 @@ void CcdPhysicsController::SetTransform()
   const MT_Matrix3x3 rot = m_MotionState->GetWorldOrientation();
   ForceWorldTransform(ToBullet(rot), ToBullet(pos));
 
+  /* The environment only synchronizes the active dynamic objects, apply here the world
+   * scaling of the other objects, it can be changed by a parent. */
+  btCollisionShape *shape = GetCollisionShape();
+  const btVector3 scale = ToBullet(m_MotionState->GetWorldScaling());
+  if (shape && !(shape->getLocalScaling() == scale)) {
+    shape->setLocalScaling(scale);
+  }
+
   if (!IsDynamic() && !GetConstructionInfo().m_bSensor && !GetCharacterController()) {
     btCollisionObject *object = GetRigidBody();
     object->setActivationState(ACTIVE_TAG);
@@ -581,6 +581,12 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   void *m_newClientInfo;
   int m_registerCount;        // needed when multiple sensors use the same controller
+
+  /// Kind and index of the controller in the environment controller lists, -1 when not added.
+  short m_controllerKind;
+  int m_controllerIndex;
+  /// Index of the controller in the environment Fh spring list, -1 when not added.
+  int m_fhControllerIndex;
   CcdConstructionInfo m_cci;  // needed for replication
 
   CcdPhysicsController *m_parentRoot;
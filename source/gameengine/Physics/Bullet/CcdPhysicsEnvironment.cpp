@@ -21,17 +21,26 @@
 
 #include "CcdPhysicsEnvironment.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "BKE_object.hh"
 #include "BLI_bounds_types.hh"
+#include "BLI_task.h"
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/ConstraintSolver/btNNCGConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+#include "LinearMath/btPoolAllocator.h"
+#include "LinearMath/btThreads.h"
 
 #include "BL_SceneConverter.h"
 #include "CM_List.h"
@@ -359,6 +368,238 @@ class CcdOverlapFilterCallBack : public btOverlapFilterCallback {
   virtual bool needBroadphaseCollision(btBroadphaseProxy *proxy0, btBroadphaseProxy *proxy1) const;
 };
 
+/** Bullet task scheduler running the parallel loops in the blender task scheduler,
+ * the physics step then shares the same worker threads than the rest of the engine.
+ *
+ * Bullet thread indices are assigned once per thread and wrap when more threads than
+ * BT_MAX_THREAD_COUNT ran bullet code, so two workers can share an index. A loop is instead
+ * run by at most getMaxNumThreads() tasks taking the chunks in turn, and each task exposes
+ * its own slot to index the per thread data, see GetThreadSlot.
+ */
+class CcdTaskScheduler : public btITaskScheduler {
+ private:
+  struct ForData {
+    const btIParallelForBody *body;
+    int begin;
+    int end;
+    int grainSize;
+    int numChunks;
+    std::atomic<int> nextChunk;
+  };
+
+  struct SumData {
+    const btIParallelSumBody *body;
+    int begin;
+    int end;
+    int grainSize;
+    int numChunks;
+    std::atomic<int> nextChunk;
+    btScalar *sums;
+  };
+
+  /// Slot of the task run by the current thread.
+  static thread_local int m_threadSlot;
+
+  static void for_task_func(void *__restrict userdata,
+                            const int slot,
+                            const TaskParallelTLS *__restrict /*tls*/)
+  {
+    ForData *data = static_cast<ForData *>(userdata);
+    const int prevSlot = m_threadSlot;
+    m_threadSlot = slot;
+    for (int chunk = data->nextChunk++; chunk < data->numChunks; chunk = data->nextChunk++) {
+      const int begin = data->begin + chunk * data->grainSize;
+      data->body->forLoop(begin, std::min(begin + data->grainSize, data->end));
+    }
+    m_threadSlot = prevSlot;
+  }
+
+  static void sum_task_func(void *__restrict userdata,
+                            const int slot,
+                            const TaskParallelTLS *__restrict /*tls*/)
+  {
+    SumData *data = static_cast<SumData *>(userdata);
+    const int prevSlot = m_threadSlot;
+    m_threadSlot = slot;
+    for (int chunk = data->nextChunk++; chunk < data->numChunks; chunk = data->nextChunk++) {
+      const int begin = data->begin + chunk * data->grainSize;
+      data->sums[chunk] = data->body->sumLoop(begin,
+                                              std::min(begin + data->grainSize, data->end));
+    }
+    m_threadSlot = prevSlot;
+  }
+
+  static int NumChunks(int begin, int end, int grainSize)
+  {
+    return (end - begin + grainSize - 1) / grainSize;
+  }
+
+  /// Run the chunks in at most getMaxNumThreads() tasks of func, one slot per task.
+  void RunTasks(int numChunks, void *userdata, TaskParallelRangeFunc func) const
+  {
+    const int numTasks = std::min(numChunks, getMaxNumThreads());
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (numTasks > 1);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, numTasks, userdata, func, &settings);
+  }
+
+ public:
+  CcdTaskScheduler() : btITaskScheduler("Blender")
+  {
+  }
+
+  /** Return the slot of the task running on the current thread, in [0, getMaxNumThreads()[.
+   * The slots are unique among the tasks of a loop, the thread running no task uses 0.
+   */
+  static int GetThreadSlot()
+  {
+    return m_threadSlot;
+  }
+
+  virtual int getMaxNumThreads() const
+  {
+    return std::min(BLI_task_scheduler_num_threads(), int(BT_MAX_THREAD_COUNT));
+  }
+
+  virtual int getNumThreads() const
+  {
+    return getMaxNumThreads();
+  }
+
+  virtual void setNumThreads(int /*numThreads*/)
+  {
+    // The thread count is owned by the blender task scheduler.
+  }
+
+  virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body)
+  {
+    grainSize = std::max(grainSize, 1);
+    ForData data;
+    data.body = &body;
+    data.begin = iBegin;
+    data.end = iEnd;
+    data.grainSize = grainSize;
+    data.numChunks = NumChunks(iBegin, iEnd, grainSize);
+    data.nextChunk = 0;
+
+    RunTasks(data.numChunks, &data, for_task_func);
+  }
+
+  virtual btScalar parallelSum(int iBegin,
+                               int iEnd,
+                               int grainSize,
+                               const btIParallelSumBody &body)
+  {
+    grainSize = std::max(grainSize, 1);
+    const int numChunks = NumChunks(iBegin, iEnd, grainSize);
+    // Sum the chunks in order to keep the result deterministic.
+    std::vector<btScalar> sums(numChunks, 0.0f);
+    SumData data;
+    data.body = &body;
+    data.begin = iBegin;
+    data.end = iEnd;
+    data.grainSize = grainSize;
+    data.numChunks = numChunks;
+    data.nextChunk = 0;
+    data.sums = sums.data();
+
+    RunTasks(numChunks, &data, sum_task_func);
+
+    btScalar sum = 0.0f;
+    for (btScalar chunkSum : sums) {
+      sum += chunkSum;
+    }
+    return sum;
+  }
+};
+
+thread_local int CcdTaskScheduler::m_threadSlot = 0;
+
+static CcdTaskScheduler ccd_task_scheduler;
+
+/** Install the blender task scheduler as bullet global task scheduler.
+ * \return False if the scheduler couldn't be installed and the world must be stepped serially.
+ */
+static bool ccd_task_scheduler_init()
+{
+  if (btGetTaskScheduler() != &ccd_task_scheduler) {
+    // Only possible from the thread owning the bullet thread index 0.
+    btSetTaskScheduler(&ccd_task_scheduler);
+  }
+  return (btGetTaskScheduler() == &ccd_task_scheduler);
+}
+
+/** Multithreaded collision dispatcher falling back to the serial dispatch while the world
+ * contains soft bodies, the soft body collision algorithms append contacts to the soft body
+ * without any locking.
+ */
+class CcdCollisionDispatcherMt : public btCollisionDispatcherMt {
+ private:
+  btSoftRigidDynamicsWorld *m_world;
+
+ public:
+  CcdCollisionDispatcherMt(btCollisionConfiguration *config)
+      : btCollisionDispatcherMt(config), m_world(nullptr)
+  {
+    // Manifolds are batched per scheduler slot.
+    m_batchManifoldsPtr.resize(BT_MAX_THREAD_COUNT);
+  }
+
+  /** Same as btCollisionDispatcherMt::getNewManifold but batching the manifolds created in
+   * parallel per scheduler slot instead of per bullet thread index, which can be shared.
+   */
+  virtual btPersistentManifold *getNewManifold(const btCollisionObject *body0,
+                                               const btCollisionObject *body1)
+  {
+    if (!m_batchUpdating) {
+      return btCollisionDispatcherMt::getNewManifold(body0, body1);
+    }
+
+    const btScalar contactBreakingThreshold =
+        (m_dispatcherFlags & CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD) ?
+            btMin(body0->getCollisionShape()->getContactBreakingThreshold(
+                      gContactBreakingThreshold),
+                  body1->getCollisionShape()->getContactBreakingThreshold(
+                      gContactBreakingThreshold)) :
+            gContactBreakingThreshold;
+    const btScalar contactProcessingThreshold = btMin(body0->getContactProcessingThreshold(),
+                                                      body1->getContactProcessingThreshold());
+
+    void *mem = m_persistentManifoldPoolAllocator->allocate(sizeof(btPersistentManifold));
+    if (!mem) {
+      if (m_dispatcherFlags & CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION) {
+        return nullptr;
+      }
+      mem = btAlignedAlloc(sizeof(btPersistentManifold), 16);
+    }
+    btPersistentManifold *manifold = new (mem) btPersistentManifold(
+        body0, body1, 0, contactBreakingThreshold, contactProcessingThreshold);
+    m_batchManifoldsPtr[CcdTaskScheduler::GetThreadSlot()].push_back(manifold);
+
+    return manifold;
+  }
+
+  void SetWorld(btSoftRigidDynamicsWorld *world)
+  {
+    m_world = world;
+  }
+
+  virtual void dispatchAllCollisionPairs(btOverlappingPairCache *pairCache,
+                                         const btDispatcherInfo &info,
+                                         btDispatcher *dispatcher)
+  {
+    if (m_world && m_world->getSoftBodyArray().size() > 0) {
+      btCollisionDispatcher::dispatchAllCollisionPairs(pairCache, info, dispatcher);
+    }
+    else {
+      btCollisionDispatcherMt::dispatchAllCollisionPairs(pairCache, info, dispatcher);
+    }
+  }
+};
+
 void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
 {
   if (debugDrawer && m_dynamicsWorld)
@@ -366,12 +607,15 @@ void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
   m_debugDrawer = debugDrawer;
 }
 
-CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling)
+CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType,
+                                             bool useDbvtCulling,
+                                             bool useThreads)
     : m_cullingCache(nullptr),
       m_cullingTree(nullptr),
       m_numIterations(10),
       m_numTimeSubSteps(1),
       m_solverType(PHY_SOLVER_NONE),
+      m_useThreads(useThreads && ccd_task_scheduler_init()),
       m_deactivationTime(2.0f),
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
@@ -387,7 +631,13 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
 
   m_collisionConfiguration = new btSoftBodyRigidBodyCollisionConfiguration();
 
-  btCollisionDispatcher *dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+  btCollisionDispatcher *dispatcher;
+  if (m_useThreads) {
+    dispatcher = new CcdCollisionDispatcherMt(m_collisionConfiguration);
+  }
+  else {
+    dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+  }
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
   m_ownDispatcher = dispatcher;
 
@@ -410,6 +660,12 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
       dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
+  if (m_useThreads) {
+    static_cast<CcdCollisionDispatcherMt *>(dispatcher)->SetWorld(m_dynamicsWorld);
+    /* Solve all the islands in a single call, the multithreaded solver then splits
+     * the constraints in batches of independent bodies solved in parallel. */
+    m_dynamicsWorld->getSimulationIslandManager()->setSplitIslands(false);
+  }
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
   // m_dynamicsWorld->getSolverInfo().m_solverMode=	SOLVER_USE_WARMSTARTING +
   // SOLVER_USE_2_FRICTION_DIRECTIONS +	SOLVER_RANDMIZE_ORDER +	SOLVER_USE_FRICTION_WARMSTARTING;
@@ -418,13 +674,65 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   SetGravity(0.0f, 0.0f, -9.81f);
 }
 
+CcdPhysicsEnvironment::ControllerKind CcdPhysicsEnvironment::GetControllerKind(
+    CcdPhysicsController *ctrl)
+{
+  if (ctrl->GetSoftBody()) {
+    return CONTROLLER_SOFT_BODY;
+  }
+
+  btRigidBody *body = ctrl->GetRigidBody();
+  if (body && !body->isStaticObject()) {
+    return CONTROLLER_DYNAMIC;
+  }
+  return CONTROLLER_STATIC;
+}
+
+void CcdPhysicsEnvironment::InsertController(CcdPhysicsController *ctrl)
+{
+  const ControllerKind kind = GetControllerKind(ctrl);
+  std::vector<CcdPhysicsController *> &controllers = m_controllers[kind];
+  ctrl->m_controllerKind = kind;
+  ctrl->m_controllerIndex = controllers.size();
+  controllers.push_back(ctrl);
+
+  const CcdConstructionInfo &info = ctrl->GetConstructionInfo();
+  if (ctrl->GetRigidBody() && (info.m_do_fh || info.m_do_rot_fh)) {
+    ctrl->m_fhControllerIndex = m_fhControllers.size();
+    m_fhControllers.push_back(ctrl);
+  }
+}
+
+void CcdPhysicsEnvironment::EraseController(CcdPhysicsController *ctrl)
+{
+  std::vector<CcdPhysicsController *> &controllers = m_controllers[ctrl->m_controllerKind];
+  CcdPhysicsController *last = controllers.back();
+  last->m_controllerIndex = ctrl->m_controllerIndex;
+  controllers[ctrl->m_controllerIndex] = last;
+  controllers.pop_back();
+
+  ctrl->m_controllerKind = -1;
+  ctrl->m_controllerIndex = -1;
+
+  if (ctrl->m_fhControllerIndex != -1) {
+    CcdPhysicsController *lastFh = m_fhControllers.back();
+    lastFh->m_fhControllerIndex = ctrl->m_fhControllerIndex;
+    m_fhControllers[ctrl->m_fhControllerIndex] = lastFh;
+    m_fhControllers.pop_back();
+
+    ctrl->m_fhControllerIndex = -1;
+  }
+}
+
 void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
 {
   // the controller is already added we do nothing
-  if (!m_controllers.insert(ctrl).second) {
+  if (IsActiveCcdPhysicsController(ctrl)) {
     return;
   }
 
+  InsertController(ctrl);
+
   btRigidBody *body = ctrl->GetRigidBody();
   btCollisionObject *obj = ctrl->GetCollisionObject();
 
@@ -561,10 +869,12 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
                                                        bool freeConstraints)
 {
   // if the physics controller is already removed we do nothing
-  if (!m_controllers.erase(ctrl)) {
+  if (!IsActiveCcdPhysicsController(ctrl)) {
     return false;
   }
 
+  EraseController(ctrl);
+
   // also remove constraint
   btRigidBody *body = ctrl->GetRigidBody();
   if (body) {
@@ -637,6 +947,12 @@ void CcdPhysicsEnvironment::UpdateCcdPhysicsController(CcdPhysicsController *ctr
   ctrl->m_cci.m_collisionFilterGroup = newCollisionGroup;
   ctrl->m_cci.m_collisionFilterMask = newCollisionMask;
   ctrl->m_cci.m_collisionFlags = newCollisionFlags;
+
+  // A mass change can turn a dynamic body into a static one and back.
+  if (IsActiveCcdPhysicsController(ctrl) && GetControllerKind(ctrl) != ctrl->m_controllerKind) {
+    EraseController(ctrl);
+    InsertController(ctrl);
+  }
 }
 
 void CcdPhysicsEnvironment::RefreshCcdPhysicsController(CcdPhysicsController *ctrl)
@@ -653,7 +969,13 @@ void CcdPhysicsEnvironment::RefreshCcdPhysicsController(CcdPhysicsController *ct
 
 bool CcdPhysicsEnvironment::IsActiveCcdPhysicsController(CcdPhysicsController *ctrl)
 {
-  return (m_controllers.find(ctrl) != m_controllers.end());
+  // The indices could come from an other environment or a replicated controller.
+  if (ctrl->m_controllerKind == -1) {
+    return false;
+  }
+  const std::vector<CcdPhysicsController *> &controllers = m_controllers[ctrl->m_controllerKind];
+  return (ctrl->m_controllerIndex < int(controllers.size()) &&
+          controllers[ctrl->m_controllerIndex] == ctrl);
 }
 
 void CcdPhysicsEnvironment::AddCcdGraphicController(CcdGraphicController *ctrl)
@@ -690,12 +1012,14 @@ void CcdPhysicsEnvironment::RemoveCcdGraphicController(CcdGraphicController *ctr
 
 void CcdPhysicsEnvironment::UpdateCcdPhysicsControllerShape(CcdShapeConstructionInfo *shapeInfo)
 {
-  for (CcdPhysicsController *ctrl : m_controllers) {
-    if (ctrl->GetShapeInfo() != shapeInfo)
-      continue;
+  for (const std::vector<CcdPhysicsController *> &controllers : m_controllers) {
+    for (CcdPhysicsController *ctrl : controllers) {
+      if (ctrl->GetShapeInfo() != shapeInfo)
+        continue;
 
-    ctrl->ReplaceControllerShape(nullptr);
-    RefreshCcdPhysicsController(ctrl);
+      ctrl->ReplaceControllerShape(nullptr);
+      RefreshCcdPhysicsController(ctrl);
+    }
   }
 }
 
@@ -714,24 +1038,32 @@ void CcdPhysicsEnvironment::StaticSimulationSubtickCallback(btDynamicsWorld *wor
 
 void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SimulationTick(timeStep);
+  // Only the dynamic bodies have their velocities clamped.
+  for (CcdPhysicsController *ctrl : m_controllers[CONTROLLER_DYNAMIC]) {
+    ctrl->SimulationTick(timeStep);
   }
 }
 
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
   int i;
 
   // Update Bullet global variables.
   gDeactivationTime = m_deactivationTime;
   gContactBreakingThreshold = m_contactBreakingThreshold;
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
+  /* Rigid bodies are moved directly by the logic, only the soft bodies need to update their
+   * pose before the simulation. */
+  for (CcdPhysicsController *ctrl : m_controllers[CONTROLLER_SOFT_BODY]) {
+    ctrl->SynchronizeMotionStates(timeStep);
+  }
+
+  /* A body can move in a substep and fall asleep in a later one, the bodies active at the start
+   * of the step are synchronized too. */
+  const std::vector<CcdPhysicsController *> &dynamics = m_controllers[CONTROLLER_DYNAMIC];
+  m_dynamicActiveAtStep.resize(dynamics.size());
+  for (unsigned int n = 0, size = dynamics.size(); n < size; ++n) {
+    m_dynamicActiveAtStep[n] = dynamics[n]->GetRigidBody()->isActive();
   }
 
   float subStep = timeStep / float(m_numTimeSubSteps);
@@ -742,8 +1074,15 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
 
   ProcessFhSprings(curTime, i * subStep);
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
+  for (unsigned int n = 0, size = dynamics.size(); n < size; ++n) {
+    // Bodies sleeping during the whole step didn't move since their last synchronization.
+    CcdPhysicsController *ctrl = dynamics[n];
+    if (m_dynamicActiveAtStep[n] || ctrl->GetRigidBody()->isActive()) {
+      ctrl->SynchronizeMotionStates(timeStep);
+    }
+  }
+  for (CcdPhysicsController *ctrl : m_controllers[CONTROLLER_SOFT_BODY]) {
+    ctrl->SynchronizeMotionStates(timeStep);
   }
 
   for (i = 0; i < m_wrapperVehicles.size(); i++) {
@@ -758,25 +1097,27 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
 
 void CcdPhysicsEnvironment::UpdateSoftBodies()
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->UpdateSoftBody();
+  for (CcdPhysicsController *ctrl : m_controllers[CONTROLLER_SOFT_BODY]) {
+    ctrl->UpdateSoftBody();
   }
 }
 
-class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultCallback {
-  btCollisionObject *m_owner;
-  btCollisionObject *m_parent;
+/// Closest ray callback of a batch ray, ignoring its owner objects and filtered by the user.
+class BatchRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
+  const btCollisionObject *m_owner;
+  const btCollisionObject *m_parent;
+  PHY_IRayCastFilterCallback *m_filterCallback;
 
  public:
-  ClosestRayResultCallbackNotMe(const btVector3 &rayFromWorld,
-                                const btVector3 &rayToWorld,
-                                btCollisionObject *owner,
-                                btCollisionObject *parent)
+  BatchRayResultCallback(const btVector3 &rayFromWorld,
+                         const btVector3 &rayToWorld,
+                         const btCollisionObject *owner,
+                         const btCollisionObject *parent,
+                         PHY_IRayCastFilterCallback *filterCallback)
       : btCollisionWorld::ClosestRayResultCallback(rayFromWorld, rayToWorld),
         m_owner(owner),
-        m_parent(parent)
+        m_parent(parent),
+        m_filterCallback(filterCallback)
   {
   }
 
@@ -789,132 +1130,201 @@ class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultC
     if (proxy0->m_clientObject == m_parent)
       return false;
 
-    return btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0);
+    if (!btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0))
+      return false;
+
+    if (m_filterCallback) {
+      btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
+      CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(
+          object->getUserPointer());
+      if (!phyCtrl || phyCtrl == m_filterCallback->m_ignoreController)
+        return false;
+      return m_filterCallback->needBroadphaseRayCast(phyCtrl);
+    }
+    return true;
   }
 };
 
-void CcdPhysicsEnvironment::ProcessFhSprings(double curTime, float interval)
+void CcdPhysicsEnvironment::CastRays(short filterGroup,
+                                     short filterMask,
+                                     unsigned int flags,
+                                     PHY_IRayCastFilterCallback *filterCallback)
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
-  const float step = interval * KX_GetActiveEngine()->GetTicRate();
-
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    CcdPhysicsController *ctrl = (*it);
-    btRigidBody *body = ctrl->GetRigidBody();
-
-    if (body && (ctrl->GetConstructionInfo().m_do_fh || ctrl->GetConstructionInfo().m_do_rot_fh)) {
-      // re-implement SM_FhObject.cpp using btCollisionWorld::rayTest and info from
-      // ctrl->getConstructionInfo() send a ray from {0.0, 0.0, 0.0} towards {0.0, 0.0, -10.0}, in
-      // local coordinates
-      CcdPhysicsController *parentCtrl = ctrl->GetParentRoot();
-      btRigidBody *parentBody = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
-      btRigidBody *cl_object = parentBody ? parentBody : body;
-
-      if (body->isStaticOrKinematicObject())
-        continue;
+  struct CastRaysBody : public btIParallelForBody {
+    btCollisionWorld *world;
+    BatchRay *rays;
+    short filterGroup;
+    short filterMask;
+    unsigned int flags;
+    PHY_IRayCastFilterCallback *filterCallback;
 
-      btVector3 rayDirLocal(0.0f, 0.0f, -10.0f);
+    void forLoop(int iBegin, int iEnd) const
+    {
+      for (int i = iBegin; i < iEnd; ++i) {
+        BatchRay &ray = rays[i];
 
-      // m_dynamicsWorld
-      // ctrl->GetRigidBody();
-      btVector3 rayFromWorld = body->getCenterOfMassPosition();
-      // btVector3	rayToWorld = rayFromWorld + body->getCenterOfMassTransform().getBasis() *
-      // rayDirLocal; ray always points down the z axis in world space...
-      btVector3 rayToWorld = rayFromWorld + rayDirLocal;
+        BatchRayResultCallback callback(
+            ray.m_from, ray.m_to, ray.m_ignore[0], ray.m_ignore[1], filterCallback);
+        callback.m_collisionFilterGroup = filterGroup;
+        callback.m_collisionFilterMask = filterMask;
+        callback.m_flags = flags;
 
-      ClosestRayResultCallbackNotMe resultCallback(rayFromWorld, rayToWorld, body, parentBody);
+        world->rayTest(ray.m_from, ray.m_to, callback);
 
-      m_dynamicsWorld->rayTest(rayFromWorld, rayToWorld, resultCallback);
-      if (resultCallback.hasHit()) {
-        // we hit this one: resultCallback.m_collisionObject;
-        CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
-            resultCallback.m_collisionObject->getUserPointer());
+        ray.m_hitObject = callback.m_collisionObject;
+        ray.m_hitFraction = callback.m_closestHitFraction;
+        ray.m_hitPoint = callback.m_hitPointWorld;
+        ray.m_hitNormal = callback.m_hitNormalWorld;
+      }
+    }
+  };
 
-        if (controller) {
-          if (controller->GetConstructionInfo().m_fh_distance < SIMD_EPSILON)
-            continue;
+  CastRaysBody body;
+  body.world = m_dynamicsWorld;
+  body.rays = m_batchRays.data();
+  body.filterGroup = filterGroup;
+  body.filterMask = filterMask;
+  body.flags = flags;
+  body.filterCallback = filterCallback;
 
-          btRigidBody *hit_object = controller->GetRigidBody();
-          if (!hit_object)
-            continue;
+  /* The rays are cast by chunks of 16 in the scheduler tasks, whatever the physics threading
+   * option. The broadphase traverses its tree with a stack local to each ray test, so no task
+   * reads per thread data indexed by the bullet thread index. */
+  ccd_task_scheduler.parallelFor(0, m_batchRays.size(), 16, body);
+}
 
-          CcdConstructionInfo &hitObjShapeProps = controller->GetConstructionInfo();
+void CcdPhysicsEnvironment::ProcessFhSprings(double curTime, float interval)
+{
+  const float step = interval * KX_GetActiveEngine()->GetTicRate();
+  // ray always points down the z axis in world space...
+  const btVector3 rayDirLocal(0.0f, 0.0f, -10.0f);
 
-          float distance = resultCallback.m_closestHitFraction * rayDirLocal.length() -
-                           ctrl->GetConstructionInfo().m_radius;
-          if (distance >= hitObjShapeProps.m_fh_distance)
-            continue;
+  // Gather the rays of all the Fh springs to cast them in a single batch.
+  m_batchRays.clear();
+  for (CcdPhysicsController *ctrl : m_fhControllers) {
+    btRigidBody *body = ctrl->GetRigidBody();
+    if (body->isStaticOrKinematicObject())
+      continue;
 
-          // btVector3 ray_dir = cl_object->getCenterOfMassTransform().getBasis()*
-          // rayDirLocal.normalized();
-          btVector3 ray_dir = rayDirLocal.normalized();
-          btVector3 normal = resultCallback.m_hitNormalWorld;
-          normal.normalize();
+    CcdPhysicsController *parentCtrl = ctrl->GetParentRoot();
+    BatchRay ray;
+    ray.m_from = body->getCenterOfMassPosition();
+    ray.m_to = ray.m_from + rayDirLocal;
+    ray.m_ignore[0] = body;
+    ray.m_ignore[1] = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
+    m_batchRays.push_back(ray);
+  }
 
-          if (ctrl->GetConstructionInfo().m_do_fh) {
-            btVector3 lspot = cl_object->getCenterOfMassPosition() +
-                              rayDirLocal * resultCallback.m_closestHitFraction;
+  if (m_batchRays.empty()) {
+    return;
+  }
 
-            lspot -= hit_object->getCenterOfMassPosition();
-            btVector3 rel_vel = cl_object->getLinearVelocity() -
-                                hit_object->getVelocityInLocalPoint(lspot);
-            btScalar rel_vel_ray = ray_dir.dot(rel_vel);
-            btScalar spring_extent = 1.0f - distance / hitObjShapeProps.m_fh_distance;
+  CastRays(btBroadphaseProxy::DefaultFilter, btBroadphaseProxy::AllFilter, 0, nullptr);
 
-            btScalar i_spring = spring_extent * hitObjShapeProps.m_fh_spring;
-            btScalar i_damp = rel_vel_ray * hitObjShapeProps.m_fh_damping;
+  // The rays are in the same order as the non static controllers.
+  unsigned int rayIndex = 0;
+  for (CcdPhysicsController *ctrl : m_fhControllers) {
+    btRigidBody *body = ctrl->GetRigidBody();
+    if (body->isStaticOrKinematicObject())
+      continue;
 
+    const BatchRay &ray = m_batchRays[rayIndex++];
+
+    // re-implement SM_FhObject.cpp using btCollisionWorld::rayTest and info from
+    // ctrl->getConstructionInfo() send a ray from {0.0, 0.0, 0.0} towards {0.0, 0.0, -10.0}, in
+    // local coordinates
+    CcdPhysicsController *parentCtrl = ctrl->GetParentRoot();
+    btRigidBody *parentBody = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
+    btRigidBody *cl_object = parentBody ? parentBody : body;
+
+    if (ray.m_hitObject) {
+      // we hit this one: ray.m_hitObject;
+      CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
+          ray.m_hitObject->getUserPointer());
+
+      if (controller) {
+        if (controller->GetConstructionInfo().m_fh_distance < SIMD_EPSILON)
+          continue;
+
+        btRigidBody *hit_object = controller->GetRigidBody();
+        if (!hit_object)
+          continue;
+
+        CcdConstructionInfo &hitObjShapeProps = controller->GetConstructionInfo();
+
+        float distance = ray.m_hitFraction * rayDirLocal.length() -
+                         ctrl->GetConstructionInfo().m_radius;
+        if (distance >= hitObjShapeProps.m_fh_distance)
+          continue;
+
+        // btVector3 ray_dir = cl_object->getCenterOfMassTransform().getBasis()*
+        // rayDirLocal.normalized();
+        btVector3 ray_dir = rayDirLocal.normalized();
+        btVector3 normal = ray.m_hitNormal;
+        normal.normalize();
+
+        if (ctrl->GetConstructionInfo().m_do_fh) {
+          btVector3 lspot = cl_object->getCenterOfMassPosition() +
+                            rayDirLocal * ray.m_hitFraction;
+
+          lspot -= hit_object->getCenterOfMassPosition();
+          btVector3 rel_vel = cl_object->getLinearVelocity() -
+                              hit_object->getVelocityInLocalPoint(lspot);
+          btScalar rel_vel_ray = ray_dir.dot(rel_vel);
+          btScalar spring_extent = 1.0f - distance / hitObjShapeProps.m_fh_distance;
+
+          btScalar i_spring = spring_extent * hitObjShapeProps.m_fh_spring;
+          btScalar i_damp = rel_vel_ray * hitObjShapeProps.m_fh_damping;
+
+          cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
+                                       (-(i_spring + i_damp) * ray_dir) * step);
+          if (hitObjShapeProps.m_fh_normal) {
             cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
-                                         (-(i_spring + i_damp) * ray_dir) * step);
-            if (hitObjShapeProps.m_fh_normal) {
-              cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
-                                           (i_spring + i_damp) *
-                                               (normal - normal.dot(ray_dir) * ray_dir) * step);
-            }
+                                         (i_spring + i_damp) *
+                                             (normal - normal.dot(ray_dir) * ray_dir) * step);
+          }
 
-            btVector3 lateral = rel_vel - rel_vel_ray * ray_dir;
+          btVector3 lateral = rel_vel - rel_vel_ray * ray_dir;
 
-            if (ctrl->GetConstructionInfo().m_do_anisotropic) {
-              // Bullet basis contains no scaling/shear etc.
-              const btMatrix3x3 &lcs = cl_object->getCenterOfMassTransform().getBasis();
-              btVector3 loc_lateral = lateral * lcs;
-              const btVector3 &friction_scaling = cl_object->getAnisotropicFriction();
-              loc_lateral *= friction_scaling;
-              lateral = lcs * loc_lateral;
-            }
+          if (ctrl->GetConstructionInfo().m_do_anisotropic) {
+            // Bullet basis contains no scaling/shear etc.
+            const btMatrix3x3 &lcs = cl_object->getCenterOfMassTransform().getBasis();
+            btVector3 loc_lateral = lateral * lcs;
+            const btVector3 &friction_scaling = cl_object->getAnisotropicFriction();
+            loc_lateral *= friction_scaling;
+            lateral = lcs * loc_lateral;
+          }
 
-            btScalar rel_vel_lateral = lateral.length();
+          btScalar rel_vel_lateral = lateral.length();
 
-            if (rel_vel_lateral > SIMD_EPSILON) {
-              btScalar friction_factor = hit_object->getFriction();  // cl_object->getFriction();
+          if (rel_vel_lateral > SIMD_EPSILON) {
+            btScalar friction_factor = hit_object->getFriction();  // cl_object->getFriction();
 
-              btScalar max_friction = friction_factor * btMax(btScalar(0.0), i_spring);
+            btScalar max_friction = friction_factor * btMax(btScalar(0.0), i_spring);
 
-              btScalar rel_mom_lateral = rel_vel_lateral / cl_object->getInvMass();
+            btScalar rel_mom_lateral = rel_vel_lateral / cl_object->getInvMass();
 
-              btVector3 friction = (rel_mom_lateral > max_friction) ?
-                                       -lateral * (max_friction / rel_vel_lateral) :
-                                       -lateral;
+            btVector3 friction = (rel_mom_lateral > max_friction) ?
+                                     -lateral * (max_friction / rel_vel_lateral) :
+                                     -lateral;
 
-              cl_object->applyCentralImpulse(friction * step);
-            }
+            cl_object->applyCentralImpulse(friction * step);
           }
+        }
 
-          if (ctrl->GetConstructionInfo().m_do_rot_fh) {
-            btVector3 up2 = cl_object->getWorldTransform().getBasis().getColumn(2);
+        if (ctrl->GetConstructionInfo().m_do_rot_fh) {
+          btVector3 up2 = cl_object->getWorldTransform().getBasis().getColumn(2);
 
-            btVector3 t_spring = up2.cross(normal) * hitObjShapeProps.m_fh_spring;
-            btVector3 ang_vel = cl_object->getAngularVelocity();
+          btVector3 t_spring = up2.cross(normal) * hitObjShapeProps.m_fh_spring;
+          btVector3 ang_vel = cl_object->getAngularVelocity();
 
-            // only rotations that tilt relative to the normal are damped
-            ang_vel -= ang_vel.dot(normal) * normal;
+          // only rotations that tilt relative to the normal are damped
+          ang_vel -= ang_vel.dot(normal) * normal;
 
-            btVector3 t_damp = ang_vel * hitObjShapeProps.m_fh_damping;
+          btVector3 t_damp = ang_vel * hitObjShapeProps.m_fh_damping;
 
-            cl_object->setAngularVelocity(cl_object->getAngularVelocity() +
-                                          (t_spring - t_damp) * step);
-          }
+          cl_object->setAngularVelocity(cl_object->getAngularVelocity() +
+                                        (t_spring - t_damp) * step);
         }
       }
     }
@@ -949,10 +1359,12 @@ void CcdPhysicsEnvironment::SetDeactivationLinearTreshold(float linTresh)
   m_linearDeactivationThreshold = linTresh;
 
   // Update from all controllers.
-  for (CcdPhysicsController *ctrl : m_controllers) {
-    if (ctrl->GetRigidBody()) {
-      ctrl->GetRigidBody()->setSleepingThresholds(m_linearDeactivationThreshold,
-                                                  m_angularDeactivationThreshold);
+  for (const std::vector<CcdPhysicsController *> &controllers : m_controllers) {
+    for (CcdPhysicsController *ctrl : controllers) {
+      if (ctrl->GetRigidBody()) {
+        ctrl->GetRigidBody()->setSleepingThresholds(m_linearDeactivationThreshold,
+                                                    m_angularDeactivationThreshold);
+      }
     }
   }
 }
@@ -961,12 +1373,13 @@ void CcdPhysicsEnvironment::SetDeactivationAngularTreshold(float angTresh)
   m_angularDeactivationThreshold = angTresh;
 
   // Update from all controllers.
-  for (std::set<CcdPhysicsController *>::iterator it = m_controllers.begin();
-       it != m_controllers.end();
-       it++) {
-    if ((*it)->GetRigidBody())
-      (*it)->GetRigidBody()->setSleepingThresholds(m_linearDeactivationThreshold,
-                                                   m_angularDeactivationThreshold);
+  for (const std::vector<CcdPhysicsController *> &controllers : m_controllers) {
+    for (CcdPhysicsController *ctrl : controllers) {
+      if (ctrl->GetRigidBody()) {
+        ctrl->GetRigidBody()->setSleepingThresholds(m_linearDeactivationThreshold,
+                                                    m_angularDeactivationThreshold);
+      }
+    }
   }
 }
 
@@ -1012,7 +1425,12 @@ void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
 
   switch (solverType) {
     case PHY_SOLVER_SEQUENTIAL: {
-      m_solver = new btSequentialImpulseConstraintSolver();
+      if (m_useThreads) {
+        m_solver = new btSequentialImpulseConstraintSolverMt();
+      }
+      else {
+        m_solver = new btSequentialImpulseConstraintSolver();
+      }
       break;
     }
 
@@ -1318,6 +1736,48 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
   return result.m_controller;
 }
 
+void CcdPhysicsEnvironment::RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                                         const MT_Vector3 *from,
+                                         const MT_Vector3 *to,
+                                         unsigned int count,
+                                         PHY_RayCastBatchResult *results)
+{
+  m_batchRays.resize(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    BatchRay &ray = m_batchRays[i];
+    ray.m_from = ToBullet(from[i]);
+    ray.m_to = ToBullet(to[i]);
+    ray.m_ignore[0] = nullptr;
+    ray.m_ignore[1] = nullptr;
+  }
+
+  // Same filtering as RayTest: don't collision with sensor object.
+  CastRays(btBroadphaseProxy::DefaultFilter,
+           CcdConstructionInfo::AllFilter ^ CcdConstructionInfo::SensorFilter,
+           btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest,
+           &filterCallback);
+
+  for (unsigned int i = 0; i < count; ++i) {
+    const BatchRay &ray = m_batchRays[i];
+    PHY_RayCastBatchResult &result = results[i];
+    if (ray.m_hitObject) {
+      btVector3 normal = ray.m_hitNormal;
+      if (normal.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
+        normal.normalize();
+      }
+      else {
+        normal.setValue(1.0f, 0.0f, 0.0f);
+      }
+      result.m_controller = static_cast<CcdPhysicsController *>(ray.m_hitObject->getUserPointer());
+      result.m_hitPoint = ToMoto(ray.m_hitPoint);
+      result.m_hitNormal = ToMoto(normal);
+    }
+    else {
+      result.m_controller = nullptr;
+    }
+  }
+}
+
 // Handles occlusion culling.
 // The implementation is based on the CDTestFramework
 struct OcclusionBuffer {
@@ -1363,6 +1823,10 @@ struct OcclusionBuffer {
     m_buffer = nullptr;
     m_bufferSize = 0;
   }
+  ~OcclusionBuffer()
+  {
+    free(m_buffer);
+  }
   // multiplication of column major matrices: m = m1 * m2
   template<typename T1, typename T2> void CMmat4mul(btScalar *m, const T1 *m1, const T2 *m2)
   {
@@ -1907,7 +2371,6 @@ struct DbvtCullingCallback : btDbvt::ICollide {
   }
 };
 
-static OcclusionBuffer gOcb;
 bool CcdPhysicsEnvironment::CullingTest(PHY_CullingCallback callback,
                                         void *userData,
                                         const std::array<MT_Vector4, 6> &planes,
@@ -1928,8 +2391,10 @@ bool CcdPhysicsEnvironment::CullingTest(PHY_CullingCallback callback,
   if (occlusionRes) {
     float mat[16];
     matrix.getValue(mat);
-    gOcb.setup(occlusionRes, viewport, mat);
-    dispatcher.m_ocb = &gOcb;
+    // One buffer per query, culling tests can run for several cameras at once.
+    OcclusionBuffer ocb;
+    ocb.setup(occlusionRes, viewport, mat);
+    dispatcher.m_ocb = &ocb;
     // occlusion culling, the direction of the view is taken from the first plan which MUST be the
     // near plane
     btDbvt::collideOCL(
@@ -1972,14 +2437,13 @@ void CcdPhysicsEnvironment::MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
     return;
   }
 
-  std::set<CcdPhysicsController *>::iterator it;
+  for (std::vector<CcdPhysicsController *> &controllers : other->m_controllers) {
+    while (!controllers.empty()) {
+      CcdPhysicsController *ctrl = controllers.back();
 
-  while (other->m_controllers.begin() != other->m_controllers.end()) {
-    it = other->m_controllers.begin();
-    CcdPhysicsController *ctrl = (*it);
-
-    other->RemoveCcdPhysicsController(ctrl, true);
-    this->AddCcdPhysicsController(ctrl);
+      other->RemoveCcdPhysicsController(ctrl, true);
+      this->AddCcdPhysicsController(ctrl);
+    }
   }
 }
 
@@ -2075,6 +2539,8 @@ void CcdPhysicsEnvironment::CallbackTriggers()
     return;
   }
 
+  m_collisionEvents.clear();
+
   // Walk over all overlapping pairs, and if one of the involved bodies is registered for trigger
   // callback, perform callback
   btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
@@ -2112,8 +2578,17 @@ void CcdPhysicsEnvironment::CallbackTriggers()
       manifold->clearManifold();  // refreshContactPoints(rb0->getCenterOfMassTransform(),rb1->getCenterOfMassTransform());
     }
 
-    const CcdCollData *coll_data = new CcdCollData(manifold);
-    m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE], ctrl0, ctrl1, coll_data, first);
+    m_collisionEvents.push_back({ctrl0, ctrl1, CcdCollData(manifold), first});
+  }
+
+  /* The callbacks are called once the list is complete, the collision data must not move while
+   * the receivers hold it. */
+  for (const CollisionEvent &event : m_collisionEvents) {
+    m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE],
+                                            event.m_ctrl0,
+                                            event.m_ctrl1,
+                                            &event.m_collData,
+                                            event.m_first);
   }
 }
 
@@ -2750,7 +3225,9 @@ CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool v
       PHY_SOLVER_NNCG,        // GAME_SOLVER_NNGC
   };
   CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
-      solverTypeTable[blenderscene->gm.solverType], false);
+      solverTypeTable[blenderscene->gm.solverType],
+      false,
+      (blenderscene->gm.flag & GAME_USE_THREADED_PHYSICS) != 0);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
@@ -50,6 +50,24 @@ class CcdGraphicController;
 class CcdOverlapFilterCallBack;
 class CcdShapeConstructionInfo;
 
+class CcdCollData : public PHY_ICollData {
+  const btPersistentManifold *m_manifoldPoint;
+
+ public:
+  CcdCollData(const btPersistentManifold *manifoldPoint);
+  virtual ~CcdCollData();
+
+  virtual unsigned int GetNumContacts() const;
+  virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
+  virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
+  virtual MT_Vector3 GetWorldPoint(unsigned int index, bool first) const;
+  virtual MT_Vector3 GetNormal(unsigned int index, bool first) const;
+  virtual float GetCombinedFriction(unsigned int index, bool first) const;
+  virtual float GetCombinedRollingFriction(unsigned int index, bool first) const;
+  virtual float GetCombinedRestitution(unsigned int index, bool first) const;
+  virtual float GetAppliedImpulse(unsigned int index, bool first) const;
+};
+
 /** CcdPhysicsEnvironment is an experimental mainloop for physics simulation using optional
  * continuous collision detection. Physics Environment takes care of stepping the simulation and is
  * a container for physics entities. It stores rigidbodies,constraints, materials etc. A derived
@@ -87,6 +105,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   PHY_SolverType m_solverType;
 
+  /// Use the multithreaded collision dispatcher and constraint solver.
+  bool m_useThreads;
+
   float m_deactivationTime;
   float m_linearDeactivationThreshold;
   float m_angularDeactivationThreshold;
@@ -94,8 +115,49 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void ProcessFhSprings(double curTime, float timeStep);
 
+  /// A ray of a batch, see CastRays.
+  struct BatchRay {
+    btVector3 m_from;
+    btVector3 m_to;
+    /// Collision objects ignored by the ray, can be nullptr.
+    const btCollisionObject *m_ignore[2];
+
+    /// Closest object hit by the ray or nullptr.
+    const btCollisionObject *m_hitObject;
+    btScalar m_hitFraction;
+    btVector3 m_hitPoint;
+    btVector3 m_hitNormal;
+  };
+
+  /// Rays of the current batch, kept to not reallocate them at each batch.
+  std::vector<BatchRay> m_batchRays;
+
+  /** Cast all the rays of m_batchRays in parallel and write their closest hit.
+   * \param filterCallback Optional filter called from the worker threads.
+   */
+  void CastRays(short filterGroup,
+                short filterMask,
+                unsigned int flags,
+                PHY_IRayCastFilterCallback *filterCallback);
+
+  /// Kinds of controllers, each kind is stored in its own list.
+  enum ControllerKind {
+    /// Non static rigid bodies.
+    CONTROLLER_DYNAMIC = 0,
+    /// Static rigid bodies, sensors, characters and other collision objects.
+    CONTROLLER_STATIC,
+    CONTROLLER_SOFT_BODY,
+    CONTROLLER_KIND_MAX
+  };
+
+  static ControllerKind GetControllerKind(CcdPhysicsController *ctrl);
+  /// Add the controller to the list of its kind and to the Fh spring list if needed.
+  void InsertController(CcdPhysicsController *ctrl);
+  /// Remove the controller from its lists by swapping it with the last controller.
+  void EraseController(CcdPhysicsController *ctrl);
+
  public:
-  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling);
+  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling, bool useThreads);
 
   virtual ~CcdPhysicsEnvironment();
 
@@ -200,6 +262,11 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                            const MT_Vector3 *from,
+                            const MT_Vector3 *to,
+                            unsigned int count,
+                            PHY_RayCastBatchResult *results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -300,11 +367,27 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                       bool replicate_dupli);
 
  protected:
-  std::set<CcdPhysicsController *> m_controllers;
+  /// Controllers partitioned by kind, each controller stores its kind and index.
+  std::vector<CcdPhysicsController *> m_controllers[CONTROLLER_KIND_MAX];
+  /// Dynamic controllers using a Fh spring.
+  std::vector<CcdPhysicsController *> m_fhControllers;
+  /// Activation state of the dynamic controllers at the start of the step.
+  std::vector<char> m_dynamicActiveAtStep;
 
   PHY_ResponseCallback m_triggerCallbacks[PHY_NUM_RESPONSE];
   void *m_triggerCallbacksUserPtrs[PHY_NUM_RESPONSE];
 
+  /// Collision reported to the object response callback.
+  struct CollisionEvent {
+    CcdPhysicsController *m_ctrl0;
+    CcdPhysicsController *m_ctrl1;
+    CcdCollData m_collData;
+    bool m_first;
+  };
+  /** Collisions of the last step, the collision data passed to the callback points into this
+   * list and stays valid until the next step. */
+  std::vector<CollisionEvent> m_collisionEvents;
+
   std::vector<WrapperVehicle *> m_wrapperVehicles;
 
   /** use explicit btSoftRigidDynamicsWorld/btDiscreteDynamicsWorld* so that we have access to
@@ -326,21 +409,3 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename);
 };
-
-class CcdCollData : public PHY_ICollData {
-  const btPersistentManifold *m_manifoldPoint;
-
- public:
-  CcdCollData(const btPersistentManifold *manifoldPoint);
-  virtual ~CcdCollData();
-
-  virtual unsigned int GetNumContacts() const;
-  virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
-  virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
-  virtual MT_Vector3 GetWorldPoint(unsigned int index, bool first) const;
-  virtual MT_Vector3 GetNormal(unsigned int index, bool first) const;
-  virtual float GetCombinedFriction(unsigned int index, bool first) const;
-  virtual float GetCombinedRollingFriction(unsigned int index, bool first) const;
-  virtual float GetCombinedRestitution(unsigned int index, bool first) const;
-  virtual float GetAppliedImpulse(unsigned int index, bool first) const;
-};
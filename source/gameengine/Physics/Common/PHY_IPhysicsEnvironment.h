@@ -77,6 +77,14 @@ struct PHY_RayCastResult {
   }
 };
 
+/**
+ * Result of a ray of a batch, see PHY_IPhysicsEnvironment::RayTestBatch.
+ */
+struct PHY_RayCastBatchResult {
+  PHY_IPhysicsController *m_controller;  // nullptr if the ray hit nothing
+  MT_Vector3 m_hitPoint;
+  MT_Vector3 m_hitNormal;
+};
 
 /**
  * This class replaces the ignoreController parameter of rayTest function.
@@ -241,6 +249,21 @@ class PHY_IPhysicsEnvironment {
                                           float toY,
                                           float toZ) = 0;
 
+  /**
+   * Cast a batch of rays, the rays are tested in parallel and the closest hit of each ray
+   * is written in the results.
+   * \param filterCallback Only m_ignoreController and needBroadphaseRayCast are used, the
+   * latter is called from worker threads and must be thread safe.
+   * \param from The start points of the rays.
+   * \param to The end points of the rays.
+   * \param count The number of rays, the size of from, to and results arrays.
+   */
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                            const MT_Vector3 *from,
+                            const MT_Vector3 *to,
+                            unsigned int count,
+                            PHY_RayCastBatchResult *results) = 0;
+
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
   // the near plane must be the first one and must always be present, it is used to get the
@@ -122,3 +122,14 @@ PHY_IPhysicsController *DummyPhysicsEnvironment::RayTest(
   // collision detection / raytesting
   return nullptr;
 }
+
+void DummyPhysicsEnvironment::RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                                           const MT_Vector3 *from,
+                                           const MT_Vector3 *to,
+                                           unsigned int count,
+                                           PHY_RayCastBatchResult *results)
+{
+  for (unsigned int i = 0; i < count; ++i) {
+    results[i].m_controller = nullptr;
+  }
+}
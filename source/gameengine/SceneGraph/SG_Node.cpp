@@ -372,7 +372,12 @@ void SG_Node::SetControllerTime(double time)
 void SG_Node::ClearModified()
 {
   m_modified = false;
+  // Notify only once until the render dirty flag is cleared.
+  const bool renderDirty = (m_dirty & DIRTY_RENDER);
   m_dirty = DIRTY_ALL;
+  if (!renderDirty) {
+    ActivateRenderDirtyCallback();
+  }
 }
 
 void SG_Node::SetModified()
@@ -401,7 +406,7 @@ SG_ParentRelation *SG_Node::GetParentRelation()
  * Update Spatial Data.
  * Calculates WorldTransform., (either doing its self or using the linked SGControllers)
  */
-bool SG_Node::UpdateSpatialData(const SG_Node *parent, double time, bool &parentUpdated)
+bool SG_Node::UpdateControllers(double time)
 {
   bool bComputesWorldTransform = false;
 
@@ -412,6 +417,13 @@ bool SG_Node::UpdateSpatialData(const SG_Node *parent, double time, bool &parent
     }
   }
 
+  return bComputesWorldTransform;
+}
+
+bool SG_Node::UpdateSpatialData(const SG_Node *parent, double time, bool &parentUpdated)
+{
+  bool bComputesWorldTransform = UpdateControllers(time);
+
   // If none of the objects updated our values then we ask the
   // parent_relation object owned by this class to update
   // our world coordinates.
@@ -641,3 +653,12 @@ void SG_Node::ActivateRecheduleUpdateCallback()
     m_callbacks.m_reschedulefunc(this, m_SGclientObject, m_SGclientInfo);
   }
 }
+
+void SG_Node::ActivateRenderDirtyCallback()
+{
+  if (m_callbacks.m_renderdirtyfunc) {
+    /* Call client provided render dirty func, it must be thread safe
+     * as nodes can be updated from several threads. */
+    m_callbacks.m_renderdirtyfunc(this, m_SGclientObject, m_SGclientInfo);
+  }
+}
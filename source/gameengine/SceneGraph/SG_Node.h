@@ -26,6 +26,7 @@ typedef void *(*SG_DestructionNewCallback)(SG_Node *sgnode, void *clientobj, voi
 typedef void (*SG_UpdateTransformCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 typedef bool (*SG_ScheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 typedef bool (*SG_RescheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
+typedef void (*SG_RenderDirtyCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 
 /**
  * SG_Callbacks hold 2 call backs to the outside world.
@@ -41,6 +42,8 @@ typedef bool (*SG_RescheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, vo
  * To define a class interface rather than a simple function
  * call back so that replication information can be transmitted from
  * parent->child.
+ * The render dirty callback is called when a node becomes dirty for render,
+ * it lets the outside world track the moved nodes without iterating over all of them.
  */
 struct SG_Callbacks {
   SG_Callbacks()
@@ -48,7 +51,8 @@ struct SG_Callbacks {
         m_destructionfunc(nullptr),
         m_updatefunc(nullptr),
         m_schedulefunc(nullptr),
-        m_reschedulefunc(nullptr)
+        m_reschedulefunc(nullptr),
+        m_renderdirtyfunc(nullptr)
   {
   }
 
@@ -56,12 +60,14 @@ struct SG_Callbacks {
                SG_DestructionNewCallback destructfunc,
                SG_UpdateTransformCallback updatefunc,
                SG_ScheduleUpdateCallback schedulefunc,
-               SG_RescheduleUpdateCallback reschedulefunc)
+               SG_RescheduleUpdateCallback reschedulefunc,
+               SG_RenderDirtyCallback renderdirtyfunc)
       : m_replicafunc(repfunc),
         m_destructionfunc(destructfunc),
         m_updatefunc(updatefunc),
         m_schedulefunc(schedulefunc),
-        m_reschedulefunc(reschedulefunc)
+        m_reschedulefunc(reschedulefunc),
+        m_renderdirtyfunc(renderdirtyfunc)
   {
   }
 
@@ -70,6 +76,7 @@ struct SG_Callbacks {
   SG_UpdateTransformCallback m_updatefunc;
   SG_ScheduleUpdateCallback m_schedulefunc;
   SG_RescheduleUpdateCallback m_reschedulefunc;
+  SG_RenderDirtyCallback m_renderdirtyfunc;
 };
 
 typedef std::vector<SG_Node *> NodeList;
@@ -329,12 +336,20 @@ class SG_Node : public SG_QList {
   friend class KX_VertexParentRelation;
   friend class KX_SlowParentRelation;
   friend class KX_NormalParentRelation;
+  friend class SG_TransformStore;
 
   bool ActivateReplicationCallback(SG_Node *replica);
   void ActivateDestructionCallback();
   void ActivateUpdateTransformCallback();
   bool ActivateScheduleUpdateCallback();
   void ActivateRecheduleUpdateCallback();
+  void ActivateRenderDirtyCallback();
+
+  /**
+   * Update the spatial controllers of this node.
+   * \return True if a controller computed the world coordinates.
+   */
+  bool UpdateControllers(double time);
 
   /**
    * Update the world coordinates of this spatial node. This also informs
@@ -71,6 +71,15 @@ class SG_ParentRelation {
     return false;
   }
 
+  /**
+   * Normal Parent Relation only compose parent and child transforms,
+   * they can be updated by batch, see SG_TransformStore.
+   */
+  virtual bool IsNormalRelation()
+  {
+    return false;
+  }
+
  protected:
   /**
    * Protected constructors
@@ -0,0 +1,188 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file gameengine/SceneGraph/SG_TransformStore.cpp
+ *  \ingroup bgesg
+ */
+
+#include "SG_TransformStore.h"
+
+#include <cmath>
+
+#include "SG_Node.h"
+
+void SG_TransformStore::Clear()
+{
+  m_nodes.clear();
+
+  for (unsigned short i = 0; i < 3; ++i) {
+    m_parentPosition[i].clear();
+    m_parentScaling[i].clear();
+    m_localPosition[i].clear();
+    m_localScaling[i].clear();
+  }
+  for (unsigned short i = 0; i < 9; ++i) {
+    m_parentRotation[i].clear();
+    m_localRotation[i].clear();
+  }
+}
+
+void SG_TransformStore::Add(SG_Node *node, const SG_Node *parent)
+{
+  m_nodes.push_back(node);
+
+  const MT_Vector3 &parentPosition = parent->GetWorldPosition();
+  const MT_Matrix3x3 &parentRotation = parent->GetWorldOrientation();
+  const MT_Vector3 &parentScaling = parent->GetWorldScaling();
+  const MT_Vector3 &localPosition = node->GetLocalPosition();
+  const MT_Matrix3x3 &localRotation = node->GetLocalOrientation();
+  const MT_Vector3 &localScaling = node->GetLocalScale();
+
+  for (unsigned short i = 0; i < 3; ++i) {
+    m_parentPosition[i].push_back(parentPosition[i]);
+    m_parentScaling[i].push_back(parentScaling[i]);
+    m_localPosition[i].push_back(localPosition[i]);
+    m_localScaling[i].push_back(localScaling[i]);
+    for (unsigned short j = 0; j < 3; ++j) {
+      m_parentRotation[i * 3 + j].push_back(parentRotation[i][j]);
+      m_localRotation[i * 3 + j].push_back(localRotation[i][j]);
+    }
+  }
+}
+
+void SG_TransformStore::Compose()
+{
+  const unsigned int size = m_nodes.size();
+
+  for (unsigned short i = 0; i < 3; ++i) {
+    m_worldPosition[i].resize(size);
+    m_worldScaling[i].resize(size);
+  }
+  for (unsigned short i = 0; i < 9; ++i) {
+    m_worldRotation[i].resize(size);
+  }
+
+  const float *__restrict pp[3];
+  const float *__restrict ps[3];
+  const float *__restrict lp[3];
+  const float *__restrict ls[3];
+  const float *__restrict pr[9];
+  const float *__restrict lr[9];
+  float *__restrict wp[3];
+  float *__restrict ws[3];
+  float *__restrict wr[9];
+  for (unsigned short i = 0; i < 3; ++i) {
+    pp[i] = m_parentPosition[i].data();
+    ps[i] = m_parentScaling[i].data();
+    lp[i] = m_localPosition[i].data();
+    ls[i] = m_localScaling[i].data();
+    wp[i] = m_worldPosition[i].data();
+    ws[i] = m_worldScaling[i].data();
+  }
+  for (unsigned short i = 0; i < 9; ++i) {
+    pr[i] = m_parentRotation[i].data();
+    lr[i] = m_localRotation[i].data();
+    wr[i] = m_worldRotation[i].data();
+  }
+
+  /* Same operations as KX_NormalParentRelation: the parent and local bases are scaled,
+   * multiplied, and the world scale is extracted from the length of the result columns. */
+  for (unsigned int n = 0; n < size; ++n) {
+    float pb[9];
+    float lb[9];
+    for (unsigned short i = 0; i < 3; ++i) {
+      for (unsigned short j = 0; j < 3; ++j) {
+        pb[i * 3 + j] = pr[i * 3 + j][n] * ps[j][n];
+        lb[i * 3 + j] = lr[i * 3 + j][n] * ls[j][n];
+      }
+    }
+
+    float basis[9];
+    for (unsigned short i = 0; i < 3; ++i) {
+      for (unsigned short j = 0; j < 3; ++j) {
+        basis[i * 3 + j] = pb[i * 3] * lb[j] + pb[i * 3 + 1] * lb[3 + j] +
+                           pb[i * 3 + 2] * lb[6 + j];
+      }
+      wp[i][n] = pb[i * 3] * lp[0][n] + pb[i * 3 + 1] * lp[1][n] + pb[i * 3 + 2] * lp[2][n] +
+                 pp[i][n];
+    }
+
+    for (unsigned short j = 0; j < 3; ++j) {
+      const float scale = sqrtf(basis[j] * basis[j] + basis[3 + j] * basis[3 + j] +
+                                basis[6 + j] * basis[6 + j]);
+      const float invscale = 1.0f / scale;
+      ws[j][n] = scale;
+      for (unsigned short i = 0; i < 3; ++i) {
+        wr[i * 3 + j][n] = basis[i * 3 + j] * invscale;
+      }
+    }
+  }
+}
+
+void SG_TransformStore::Apply()
+{
+  for (unsigned int n = 0, size = m_nodes.size(); n < size; ++n) {
+    SG_Node *node = m_nodes[n];
+
+    node->SetWorldScale(
+        MT_Vector3(m_worldScaling[0][n], m_worldScaling[1][n], m_worldScaling[2][n]));
+    node->SetWorldPosition(
+        MT_Vector3(m_worldPosition[0][n], m_worldPosition[1][n], m_worldPosition[2][n]));
+    node->SetWorldOrientation(MT_Matrix3x3(m_worldRotation[0][n],
+                                           m_worldRotation[1][n],
+                                           m_worldRotation[2][n],
+                                           m_worldRotation[3][n],
+                                           m_worldRotation[4][n],
+                                           m_worldRotation[5][n],
+                                           m_worldRotation[6][n],
+                                           m_worldRotation[7][n],
+                                           m_worldRotation[8][n]));
+    node->ClearModified();
+    node->ActivateUpdateTransformCallback();
+  }
+}
+
+void SG_TransformStore::UpdateWorldData(const std::vector<SG_Node *> &roots, double time)
+{
+  m_level.clear();
+  for (SG_Node *root : roots) {
+    m_level.emplace_back(root, false);
+  }
+
+  while (!m_level.empty()) {
+    Clear();
+    m_nextLevel.clear();
+
+    for (std::pair<SG_Node *, bool> &item : m_level) {
+      SG_Node *node = item.first;
+      bool &parentUpdated = item.second;
+      const SG_Node *parent = node->GetSGParent();
+
+      // Same logic as SG_Node::UpdateSpatialData but batching the normal parent relations.
+      if (node->UpdateControllers(time)) {
+        node->ActivateUpdateTransformCallback();
+      }
+      else if (parent && node->GetParentRelation()->IsNormalRelation()) {
+        if (parentUpdated || node->IsModified()) {
+          parentUpdated = true;
+          // The callback is called once the world transform is computed.
+          Add(node, parent);
+        }
+      }
+      else if (node->ComputeWorldTransforms(parent, parentUpdated)) {
+        node->ActivateUpdateTransformCallback();
+      }
+
+      // The node is updated, remove it from the update list.
+      node->Delink();
+
+      for (SG_Node *child : node->GetSGChildren()) {
+        m_nextLevel.emplace_back(child, parentUpdated);
+      }
+    }
+
+    Compose();
+    Apply();
+
+    m_level.swap(m_nextLevel);
+  }
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file SG_TransformStore.h
+ *  \ingroup bgesg
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+class SG_Node;
+
+/**
+ * Structure of arrays storage of the transforms of a level of scene graph nodes.
+ * The nodes using a normal parent relation are gathered level by level, their
+ * world transforms are composed from their parent world transform and their local
+ * transform in a single loop over contiguous float arrays the compiler can vectorize,
+ * then the result is written back to the nodes.
+ */
+class SG_TransformStore {
+ private:
+  /// Nodes of the current batch, the index in this list is the index in the arrays.
+  std::vector<SG_Node *> m_nodes;
+
+  /// Inputs: parent world transform.
+  std::vector<float> m_parentPosition[3];
+  std::vector<float> m_parentRotation[9];
+  std::vector<float> m_parentScaling[3];
+  /// Inputs: node local transform.
+  std::vector<float> m_localPosition[3];
+  std::vector<float> m_localRotation[9];
+  std::vector<float> m_localScaling[3];
+  /// Outputs: node world transform.
+  std::vector<float> m_worldPosition[3];
+  std::vector<float> m_worldRotation[9];
+  std::vector<float> m_worldScaling[3];
+
+  /// Nodes to update and their parent updated status, for the current and next level.
+  std::vector<std::pair<SG_Node *, bool>> m_level;
+  std::vector<std::pair<SG_Node *, bool>> m_nextLevel;
+
+  /// Remove all nodes of the batch.
+  void Clear();
+  /// Add a node to the batch, copying its local and parent world transforms.
+  void Add(SG_Node *node, const SG_Node *parent);
+  /// Compute the world transforms of all nodes of the batch.
+  void Compose();
+  /// Write the computed world transforms back to the nodes.
+  void Apply();
+
+ public:
+  SG_TransformStore() = default;
+  ~SG_TransformStore() = default;
+
+  /**
+   * Update the world transforms of the hierarchies starting at the given nodes,
+   * parents are always updated before their children. This is equivalent to call
+   * SG_Node::UpdateWorldData on each root node.
+   * \param roots Nodes without any ancestor to update, they must be removed from
+   * the schedule list.
+   */
+  void UpdateWorldData(const std::vector<SG_Node *> &roots, double time);
+};
@@ -7,6 +7,8 @@
 
 #include "FilterBase.h"
 
+#include <algorithm>
+
 // FilterBase class implementation
 
 // constructor
@@ -54,6 +56,25 @@ FilterBase *FilterBase::findFirst(void)
   return frst;
 }
 
+// get filters of chain
+bool FilterBase::getRowChain(std::vector<FilterBase *> &chain, bool scaled)
+{
+  chain.clear();
+  for (FilterBase *filt = this; filt != nullptr;
+       filt = (filt->m_previous != nullptr) ? filt->m_previous->m_filter : nullptr)
+  {
+    chain.push_back(filt);
+  }
+  std::reverse(chain.begin(), chain.end());
+  // the first filter converts the source pixels, the other ones process its values
+  for (unsigned int i = 1; i < chain.size(); ++i) {
+    const RowMode mode = chain[i]->getRowMode();
+    if (mode == ROW_NONE || (mode == ROW_NEIGHBOURS && scaled))
+      return false;
+  }
+  return true;
+}
+
 // list offilter types
 PyTypeList pyFilterTypes;
 
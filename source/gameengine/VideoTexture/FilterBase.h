@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "Common.h"
 
 #include "EXP_PyObjectPlus.h"
@@ -40,6 +42,16 @@ struct PyFilter {
 /// base class for pixel filters
 class FilterBase {
  public:
+  /// processing of the rows of values converted by the previous filters
+  enum RowMode {
+    /// filter reads the source pixels, it can only be the first filter of a row chain
+    ROW_NONE,
+    /// filter depends only on the converted value of the pixel
+    ROW_POINTWISE,
+    /// filter depends also on the converted values of the left and upper pixels
+    ROW_NEIGHBOURS
+  };
+
   /// constructor
   FilterBase(void);
   /// destructor
@@ -71,6 +83,64 @@ class FilterBase {
     return findFirst()->getPixelSize();
   }
 
+  /** get filters of chain, first filter first, return false if the filters following the first
+   * one can't process rows of values, the neighbours filters need the unscaled source rows */
+  bool getRowChain(std::vector<FilterBase *> &chain, bool scaled);
+
+  /// get row processing mode of filter following the first one
+  virtual RowMode getRowMode(void)
+  {
+    return ROW_NONE;
+  }
+
+  /** convert row of pixels as first filter of chain, src is the beginning of the source row,
+   * columns are the source columns of the converted pixels, nullptr for all the row */
+  virtual void filterRow(unsigned char *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst)
+  {
+    tFilterRow(src, y, size, pixSize, columns, count, dst);
+  }
+  /// convert row of pixels as first filter of chain, source int buffer
+  virtual void filterRow(unsigned int *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst)
+  {
+    tFilterRow(src, y, size, pixSize, columns, count, dst);
+  }
+  /// convert row of pixels as first filter of chain, source float buffer
+  virtual void filterRow(float *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst)
+  {
+    tFilterRow(src, y, size, pixSize, columns, count, dst);
+  }
+
+  /// filter row of converted values in place, ROW_POINTWISE filters
+  virtual void filterValues(unsigned int *vals, short count)
+  {
+  }
+  /** filter row of converted values to dst using the converted values of the previous row,
+   * nullptr for the first row, ROW_NEIGHBOURS filters */
+  virtual void filterValues(const unsigned int *vals,
+                            const unsigned int *prevVals,
+                            unsigned int *dst,
+                            short count)
+  {
+  }
+
  protected:
   /// previous pixel filter
   PyFilter *m_previous;
@@ -104,6 +174,24 @@ class FilterBase {
     return 1;
   }
 
+  /// convert row of pixels one by one
+  template<class SRC>
+  void tFilterRow(SRC src,
+                  short y,
+                  short *size,
+                  unsigned int pixSize,
+                  const short *columns,
+                  short count,
+                  unsigned int *dst)
+  {
+    for (short i = 0; i < count; ++i) {
+      const short x = (columns != nullptr) ? columns[i] : i;
+      SRC pix = src + x * pixSize;
+      // without previous filter the source pixel is the filtered value
+      dst[i] = filter(pix, x, y, size, pixSize, (unsigned int)*pix);
+    }
+  }
+
   /// get converted pixel from previous filters
   template<class SRC>
   unsigned int convertPrevious(SRC src, short x, short y, short *size, unsigned int pixSize)
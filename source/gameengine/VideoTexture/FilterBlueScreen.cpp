@@ -7,6 +7,10 @@
 
 #include "FilterBlueScreen.h"
 
+#include <algorithm>
+
+#include "BLI_simd.h"
+
 // implementation FilterBlueScreen
 
 // constructor
@@ -38,6 +42,54 @@ void FilterBlueScreen::setLimits(unsigned short minLimit, unsigned short maxLimi
   m_limitDist = m_squareLimits[1] - m_squareLimits[0];
 }
 
+// filter row of converted values
+void FilterBlueScreen::filterValues(unsigned int *vals, short count)
+{
+  short i = 0;
+#if BLI_HAVE_SSE2
+  // distances are lower than 3 * 255 * 255, limits are clamped to be compared as signed
+  const __m128i limit0 = _mm_set1_epi32((int)std::min(m_squareLimits[0], 0x7FFFFFFFu));
+  const __m128i limit1 = _mm_set1_epi32((int)std::min(m_squareLimits[1], 0x7FFFFFFFu));
+  // red and green are packed as 16 bits pairs to square and add them with one multiply-add
+  const __m128i colorRG = _mm_set1_epi32(m_color[0] | (m_color[1] << 16));
+  const __m128i colorB = _mm_set1_epi32(m_color[2]);
+  const __m128i maskByte = _mm_set1_epi32(0xFF);
+  const __m128i maskHigh = _mm_set1_epi32(0xFF0000);
+  const __m128i maskAlpha = _mm_set1_epi32((int)0xFF000000);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i val = _mm_loadu_si128((const __m128i *)(vals + i));
+    const __m128i difRG = _mm_sub_epi16(
+        _mm_or_si128(_mm_and_si128(val, maskByte),
+                     _mm_and_si128(_mm_slli_epi32(val, 8), maskHigh)),
+        colorRG);
+    const __m128i difB = _mm_sub_epi16(_mm_and_si128(_mm_srli_epi32(val, 16), maskByte), colorB);
+    const __m128i dist = _mm_add_epi32(_mm_madd_epi16(difRG, difRG), _mm_madd_epi16(difB, difB));
+    // transparent color when dist <= limit0, opaque when dist >= limit1
+    const __m128i notTransparent = _mm_cmpgt_epi32(dist, limit0);
+    const __m128i notOpaque = _mm_cmpgt_epi32(limit1, dist);
+    const __m128i opaque = _mm_andnot_si128(notOpaque, notTransparent);
+    const __m128i result = _mm_or_si128(_mm_andnot_si128(maskAlpha, val),
+                                        _mm_and_si128(opaque, maskAlpha));
+    // alpha between the limits needs a division, it is calculated per pixel
+    const int between = _mm_movemask_ps(
+        _mm_castsi128_ps(_mm_and_si128(notTransparent, notOpaque)));
+    if (between == 0) {
+      _mm_storeu_si128((__m128i *)(vals + i), result);
+      continue;
+    }
+    unsigned int orig[4];
+    _mm_storeu_si128((__m128i *)orig, val);
+    _mm_storeu_si128((__m128i *)(vals + i), result);
+    for (int k = 0; k < 4; ++k) {
+      if (between & (1 << k))
+        vals[i + k] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, orig[k]);
+    }
+  }
+#endif
+  for (; i < count; ++i)
+    vals[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, vals[i]);
+}
+
 // cast Filter pointer to FilterBlueScreen
 inline FilterBlueScreen *getFilter(PyFilter *self)
 {
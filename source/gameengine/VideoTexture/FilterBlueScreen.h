@@ -36,6 +36,14 @@ class FilterBlueScreen : public FilterBase {
   /// set limits for color variation
   void setLimits(unsigned short minLimit, unsigned short maxLimit);
 
+  /// get row processing mode
+  virtual RowMode getRowMode(void)
+  {
+    return ROW_POINTWISE;
+  }
+  /// filter row of converted values
+  virtual void filterValues(unsigned int *vals, short count);
+
  protected:
   ///  blue screen color (red component first)
   unsigned char m_color[3];
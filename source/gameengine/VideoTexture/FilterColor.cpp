@@ -7,8 +7,39 @@
 
 #include "FilterColor.h"
 
+#include "BLI_simd.h"
+
 // implementation FilterGray
 
+// filter row of converted values
+void FilterGray::filterValues(unsigned int *vals, short count)
+{
+  short i = 0;
+#if BLI_HAVE_SSE2
+  const __m128i maskByte = _mm_set1_epi32(0xFF);
+  const __m128i maskAlpha = _mm_set1_epi32((int)0xFF000000);
+  // the products and their sum fit in the low 16 bits of each component
+  const __m128i koefRed = _mm_set1_epi32(77);
+  const __m128i koefGreen = _mm_set1_epi32(151);
+  const __m128i koefBlue = _mm_set1_epi32(28);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i val = _mm_loadu_si128((const __m128i *)(vals + i));
+    const __m128i red = _mm_and_si128(val, maskByte);
+    const __m128i green = _mm_and_si128(_mm_srli_epi32(val, 8), maskByte);
+    const __m128i blue = _mm_and_si128(_mm_srli_epi32(val, 16), maskByte);
+    const __m128i sum = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(blue, koefBlue),
+                                                    _mm_mullo_epi16(green, koefGreen)),
+                                      _mm_mullo_epi16(red, koefRed));
+    const __m128i gray = _mm_srli_epi32(sum, 8);
+    const __m128i color = _mm_or_si128(
+        _mm_or_si128(gray, _mm_slli_epi32(gray, 8)), _mm_slli_epi32(gray, 16));
+    _mm_storeu_si128((__m128i *)(vals + i), _mm_or_si128(color, _mm_and_si128(val, maskAlpha)));
+  }
+#endif
+  for (; i < count; ++i)
+    vals[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, vals[i]);
+}
+
 // attributes structure
 static PyGetSetDef filterGrayGetSets[] = {  // attributes from FilterBase class
     {(char *)"previous",
@@ -79,6 +110,44 @@ void FilterColor::setMatrix(ColorMatrix &mat)
       m_matrix[r][c] = mat[r][c];
 }
 
+// filter row of converted values
+void FilterColor::filterValues(unsigned int *vals, short count)
+{
+  short i = 0;
+#if BLI_HAVE_SSE2
+  /* Red and green then blue and alpha are packed as 16 bits pairs in each component to compute
+   * the matrix rows with one multiply-add per pair. */
+  __m128i koefRG[4], koefBA[4], offset[4];
+  for (int r = 0; r < 4; ++r) {
+    koefRG[r] = _mm_set1_epi32(
+        (int)(((unsigned short)m_matrix[r][1] << 16) | (unsigned short)m_matrix[r][0]));
+    koefBA[r] = _mm_set1_epi32(
+        (int)(((unsigned short)m_matrix[r][3] << 16) | (unsigned short)m_matrix[r][2]));
+    offset[r] = _mm_set1_epi32(m_matrix[r][4]);
+  }
+  const __m128i maskByte = _mm_set1_epi32(0xFF);
+  const __m128i maskHigh = _mm_set1_epi32(0xFF0000);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i val = _mm_loadu_si128((const __m128i *)(vals + i));
+    const __m128i rg = _mm_or_si128(_mm_and_si128(val, maskByte),
+                                    _mm_and_si128(_mm_slli_epi32(val, 8), maskHigh));
+    const __m128i ba = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(val, 16), maskByte),
+                                    _mm_and_si128(_mm_srli_epi32(val, 8), maskHigh));
+    __m128i color = _mm_setzero_si128();
+    for (int r = 0; r < 4; ++r) {
+      const __m128i sum = _mm_add_epi32(
+          _mm_add_epi32(_mm_madd_epi16(rg, koefRG[r]), _mm_madd_epi16(ba, koefBA[r])),
+          offset[r]);
+      const __m128i comp = _mm_and_si128(_mm_srli_epi32(sum, 8), maskByte);
+      color = _mm_or_si128(color, _mm_slli_epi32(comp, 8 * r));
+    }
+    _mm_storeu_si128((__m128i *)(vals + i), color);
+  }
+#endif
+  for (; i < count; ++i)
+    vals[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, vals[i]);
+}
+
 // cast Filter pointer to FilterColor
 inline FilterColor *getFilterColor(PyFilter *self)
 {
@@ -213,6 +282,7 @@ FilterLevel::FilterLevel(void)
     levels[r][1] = 0xFF;
     levels[r][2] = 0xFF;
   }
+  calcTable();
 }
 
 // set color levels
@@ -224,6 +294,33 @@ void FilterLevel::setLevels(ColorLevel &lev)
       levels[r][c] = lev[r][c];
     levels[r][2] = lev[r][0] < lev[r][1] ? lev[r][1] - lev[r][0] : 1;
   }
+  calcTable();
+}
+
+// calculate table of color components
+void FilterLevel::calcTable(void)
+{
+  for (short idx = 0; idx < 4; ++idx) {
+    for (unsigned int col = 0; col < 256; ++col) {
+      unsigned int val = 0;
+      VT_C(val, idx) = col;
+      m_table[idx][col] = calcColor(val, idx);
+    }
+  }
+}
+
+// filter row of converted values
+void FilterLevel::filterValues(unsigned int *vals, short count)
+{
+  // the division of each component is replaced by a table lookup
+  for (short i = 0; i < count; ++i) {
+    unsigned int &val = vals[i];
+    VT_RGBA(val,
+            m_table[0][VT_R(val)],
+            m_table[1][VT_G(val)],
+            m_table[2][VT_B(val)],
+            m_table[3][VT_A(val)]);
+  }
 }
 
 // cast Filter pointer to FilterLevel
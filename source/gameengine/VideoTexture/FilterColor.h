@@ -22,6 +22,14 @@ class FilterGray : public FilterBase {
   {
   }
 
+  /// get row processing mode
+  virtual RowMode getRowMode(void)
+  {
+    return ROW_POINTWISE;
+  }
+  /// filter row of converted values
+  virtual void filterValues(unsigned int *vals, short count);
+
  protected:
   /// filter pixel template, source int buffer
   template<class SRC>
@@ -76,6 +84,14 @@ class FilterColor : public FilterBase {
   /// set color matrix
   void setMatrix(ColorMatrix &mat);
 
+  /// get row processing mode
+  virtual RowMode getRowMode(void)
+  {
+    return ROW_POINTWISE;
+  }
+  /// filter row of converted values
+  virtual void filterValues(unsigned int *vals, short count);
+
  protected:
   ///  color calculation matrix
   ColorMatrix m_matrix;
@@ -140,9 +156,22 @@ class FilterLevel : public FilterBase {
   /// set color matrix
   void setLevels(ColorLevel &lev);
 
+  /// get row processing mode
+  virtual RowMode getRowMode(void)
+  {
+    return ROW_POINTWISE;
+  }
+  /// filter row of converted values
+  virtual void filterValues(unsigned int *vals, short count);
+
  protected:
   ///  color calculation matrix
   ColorLevel levels;
+  /// calculated color components for each color level
+  unsigned char m_table[4][256];
+
+  /// calculate table of color components
+  void calcTable(void);
 
   /// calculate one color component
   unsigned int calcColor(unsigned int val, short idx)
@@ -32,6 +32,30 @@ void FilterNormal::setDepth(float depth)
   m_depthScale = depth / depthScaleKoef;
 }
 
+// filter row of converted values
+void FilterNormal::filterValues(const unsigned int *vals,
+                                const unsigned int *prevVals,
+                                unsigned int *dst,
+                                short count)
+{
+  // the neighbours are taken from the rows converted once by the previous filters
+  for (short x = 0; x < count; ++x) {
+    unsigned int val = vals[x];
+    const int actPix = int(VT_C(val, m_colIdx));
+    int upPix = actPix;
+    int leftPix = actPix;
+    if (prevVals != nullptr) {
+      val = prevVals[x];
+      upPix = VT_C(val, m_colIdx);
+    }
+    if (x > 0) {
+      val = vals[x - 1];
+      leftPix = VT_C(val, m_colIdx);
+    }
+    dst[x] = calcNormal(actPix, upPix, leftPix);
+  }
+}
+
 // cast Filter pointer to FilterNormal
 inline FilterNormal *getFilter(PyFilter *self)
 {
@@ -40,6 +40,17 @@ class FilterNormal : public FilterBase {
   /// set depth
   void setDepth(float depth);
 
+  /// get row processing mode
+  virtual RowMode getRowMode(void)
+  {
+    return ROW_NEIGHBOURS;
+  }
+  /// filter row of converted values using the previous row
+  virtual void filterValues(const unsigned int *vals,
+                            const unsigned int *prevVals,
+                            unsigned int *dst,
+                            short count);
+
  protected:
   /// depth of normal relief
   float m_depth;
@@ -49,6 +60,23 @@ class FilterNormal : public FilterBase {
   /// color index, 0=red, 1=green, 2=blue, 3=alpha
   unsigned short m_colIdx;
 
+  /// calculate normal vector from the heights of actual, upper and left pixels
+  unsigned int calcNormal(int actPix, int upPix, int leftPix)
+  {
+    // height differences (from blue color)
+    float dx = (actPix - leftPix) * m_depthScale;
+    float dy = (actPix - upPix) * m_depthScale;
+    // normalize vector
+    float dz = float(normScaleKoef / sqrt(dx * dx + dy * dy + 1.0));
+    dx = dx * dz + normScaleKoef;
+    dy = dy * dz + normScaleKoef;
+    dz += normScaleKoef;
+    // return normal vector converted to color
+    unsigned int val;
+    VT_RGBA(val, dx, dy, dz, 0xFF);
+    return val;
+  }
+
   /// filter pixel, source int buffer
   template<class SRC>
   unsigned int tFilter(
@@ -67,17 +95,7 @@ class FilterNormal : public FilterBase {
       val = convertPrevious(src - pixSize, x - 1, y, size, pixSize);
       leftPix = VT_C(val, m_colIdx);
     }
-    // height differences (from blue color)
-    float dx = (actPix - leftPix) * m_depthScale;
-    float dy = (actPix - upPix) * m_depthScale;
-    // normalize vector
-    float dz = float(normScaleKoef / sqrt(dx * dx + dy * dy + 1.0));
-    dx = dx * dz + normScaleKoef;
-    dy = dy * dz + normScaleKoef;
-    dz += normScaleKoef;
-    // return normal vector converted to color
-    VT_RGBA(val, dx, dy, dz, 0xFF);
-    return val;
+    return calcNormal(actPix, upPix, leftPix);
   }
 
   /// filter pixel, source byte buffer
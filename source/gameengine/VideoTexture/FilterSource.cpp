@@ -9,6 +9,140 @@
 
 #include "FilterSource.h"
 
+#include <cstring>
+
+#include "BLI_simd.h"
+
+/* The row conversions of the source filters don't call a virtual function for each pixel,
+ * the byte order conversions without shuffle are left to the compiler vectorizer. */
+
+// convert row of RGB24 pixels
+void FilterRGB24::filterRow(unsigned char *src,
+                            short y,
+                            short *size,
+                            unsigned int pixSize,
+                            const short *columns,
+                            short count,
+                            unsigned int *dst)
+{
+  for (short i = 0; i < count; ++i) {
+    const unsigned char *pix = src + ((columns != nullptr) ? columns[i] : i) * pixSize;
+    VT_RGBA(dst[i], pix[0], pix[1], pix[2], 0xFF);
+  }
+}
+
+// convert row of RGBA32 pixels
+void FilterRGBA32::filterRow(unsigned char *src,
+                             short y,
+                             short *size,
+                             unsigned int pixSize,
+                             const short *columns,
+                             short count,
+                             unsigned int *dst)
+{
+  // the bytes are already in the image order
+  if (columns == nullptr && pixSize == 4) {
+    memcpy(dst, src, count * sizeof(unsigned int));
+    return;
+  }
+  for (short i = 0; i < count; ++i)
+    memcpy(dst + i, src + columns[i] * pixSize, sizeof(unsigned int));
+}
+
+// convert row of BGRA32 pixels
+void FilterBGRA32::filterRow(unsigned char *src,
+                             short y,
+                             short *size,
+                             unsigned int pixSize,
+                             const short *columns,
+                             short count,
+                             unsigned int *dst)
+{
+  short i = 0;
+#if BLI_HAVE_SSE2
+  if (columns == nullptr && pixSize == 4) {
+    const __m128i maskByte = _mm_set1_epi32(0xFF);
+    const __m128i maskGA = _mm_set1_epi32((int)0xFF00FF00);
+    // swap red and blue of 4 pixels
+    for (; i + 4 <= count; i += 4) {
+      const __m128i pix = _mm_loadu_si128((const __m128i *)(src + i * 4));
+      const __m128i red = _mm_slli_epi32(_mm_and_si128(pix, maskByte), 16);
+      const __m128i blue = _mm_and_si128(_mm_srli_epi32(pix, 16), maskByte);
+      _mm_storeu_si128((__m128i *)(dst + i),
+                       _mm_or_si128(_mm_or_si128(red, blue), _mm_and_si128(pix, maskGA)));
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    unsigned int pix;
+    memcpy(&pix, src + ((columns != nullptr) ? columns[i] : i) * pixSize, sizeof(unsigned int));
+    dst[i] = VT_SWAPBR(pix);
+  }
+}
+
+// convert row of BGR24 pixels
+void FilterBGR24::filterRow(unsigned char *src,
+                            short y,
+                            short *size,
+                            unsigned int pixSize,
+                            const short *columns,
+                            short count,
+                            unsigned int *dst)
+{
+  for (short i = 0; i < count; ++i) {
+    const unsigned char *pix = src + ((columns != nullptr) ? columns[i] : i) * pixSize;
+    VT_RGBA(dst[i], pix[2], pix[1], pix[0], 0xFF);
+  }
+}
+
+// convert row of depth values to gray
+void FilterZZZA::filterRow(float *src,
+                           short y,
+                           short *size,
+                           unsigned int pixSize,
+                           const short *columns,
+                           short count,
+                           unsigned int *dst)
+{
+  short i = 0;
+#if BLI_HAVE_SSE2
+  if (columns == nullptr && pixSize == 1) {
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128i maskByte = _mm_set1_epi32(0xFF);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    for (; i + 4 <= count; i += 4) {
+      // truncated as the int conversion of the pixel filter
+      const __m128i depth = _mm_and_si128(
+          _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale)), maskByte);
+      const __m128i gray = _mm_or_si128(
+          _mm_or_si128(depth, _mm_slli_epi32(depth, 8)), _mm_slli_epi32(depth, 16));
+      _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(gray, alpha));
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    const unsigned int depth = int(src[((columns != nullptr) ? columns[i] : i) * pixSize] * 255);
+    VT_RGBA(dst[i], depth, depth, depth, 0xFF);
+  }
+}
+
+// copy row of depth values
+void FilterDEPTH::filterRow(float *src,
+                            short y,
+                            short *size,
+                            unsigned int pixSize,
+                            const short *columns,
+                            short count,
+                            unsigned int *dst)
+{
+  if (columns == nullptr && pixSize == 1) {
+    memcpy(dst, src, count * sizeof(unsigned int));
+    return;
+  }
+  for (short i = 0; i < count; ++i)
+    memcpy(dst + i, src + ((columns != nullptr) ? columns[i] : i) * pixSize, sizeof(float));
+}
+
 // FilterRGB24
 
 // define python type
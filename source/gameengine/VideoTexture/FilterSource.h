@@ -28,6 +28,15 @@ class FilterRGB24 : public FilterBase {
     return 3;
   }
 
+  /// convert row of pixels, source byte buffer
+  virtual void filterRow(unsigned char *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst);
+
  protected:
   /// filter pixel, source byte buffer
   virtual unsigned int filter(
@@ -56,6 +65,15 @@ class FilterRGBA32 : public FilterBase {
     return 4;
   }
 
+  /// convert row of pixels, source byte buffer
+  virtual void filterRow(unsigned char *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst);
+
  protected:
   /// filter pixel, source byte buffer
   virtual unsigned int filter(
@@ -88,6 +106,15 @@ class FilterBGRA32 : public FilterBase {
     return 4;
   }
 
+  /// convert row of pixels, source byte buffer
+  virtual void filterRow(unsigned char *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst);
+
  protected:
   /// filter pixel, source byte buffer
   virtual unsigned int filter(
@@ -116,6 +143,15 @@ class FilterBGR24 : public FilterBase {
     return 3;
   }
 
+  /// convert row of pixels, source byte buffer
+  virtual void filterRow(unsigned char *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst);
+
  protected:
   /// filter pixel, source byte buffer
   virtual unsigned int filter(
@@ -144,6 +180,15 @@ class FilterZZZA : public FilterBase {
     return 1;
   }
 
+  /// convert row of pixels, source float buffer
+  virtual void filterRow(float *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst);
+
  protected:
   /// filter pixel, source float buffer
   virtual unsigned int filter(
@@ -180,6 +225,15 @@ class FilterDEPTH : public FilterBase {
     return 1;
   }
 
+  /// convert row of pixels, source float buffer
+  virtual void filterRow(float *src,
+                         short y,
+                         short *size,
+                         unsigned int pixSize,
+                         const short *columns,
+                         short count,
+                         unsigned int *dst);
+
  protected:
   /// filter pixel, source float buffer
   virtual unsigned int filter(
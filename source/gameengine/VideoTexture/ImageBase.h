@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
+#include "BLI_task.h"
+
 #include "Common.h"
 #include "EXP_PyObjectPlus.h"
 #include "FilterBase.h"
@@ -21,6 +25,100 @@ class ImageSource;
 /// type for list of image sources
 typedef std::vector<ImageSource *> ImageSourceList;
 
+/** rows of image converted through a filter chain, the groups of rows are converted by
+ * parallel tasks */
+template<class SRC> struct ImageConvertRows {
+  /// last filter of chain
+  FilterBase *m_filter;
+  /// filters of chain, first filter first, empty to convert pixel by pixel
+  std::vector<FilterBase *> m_chain;
+  /// number of neighbours filters in chain
+  unsigned int m_neighbours;
+  /// source buffer
+  SRC m_srcBuff;
+  /// source size
+  short *m_srcSize;
+  /// source pixel size
+  unsigned int m_pixSize;
+  /// destination buffer
+  unsigned int *m_dstBuff;
+  /// number of converted pixels in each row
+  short m_width;
+  /// source columns of converted pixels, empty without scaling
+  std::vector<short> m_columns;
+  /// source rows of converted rows, increasing without scaling
+  std::vector<short> m_srcRows;
+  /// destination rows of converted rows
+  std::vector<short> m_dstRows;
+  /// number of rows converted by each task
+  int m_taskRows;
+
+  /// convert rows of one task
+  void convert(int task)
+  {
+    const int begin = task * m_taskRows;
+    const int end = std::min(begin + m_taskRows, int(m_srcRows.size()));
+    const short *columns = m_columns.empty() ? nullptr : m_columns.data();
+
+    // filters that can't process rows are applied pixel by pixel
+    if (m_chain.empty()) {
+      for (int i = begin; i < end; ++i) {
+        const short y = m_srcRows[i];
+        SRC src = m_srcBuff + y * m_srcSize[0] * m_pixSize;
+        unsigned int *dst = m_dstBuff + m_dstRows[i] * m_width;
+        for (short j = 0; j < m_width; ++j) {
+          const short x = (columns != nullptr) ? columns[j] : j;
+          dst[j] = m_filter->convert(src + x * m_pixSize, x, y, m_srcSize, m_pixSize);
+        }
+      }
+      return;
+    }
+
+    // the neighbours filters keep the values of their previous row
+    std::vector<unsigned int> row, result;
+    std::vector<std::vector<unsigned int>> prevRows(m_neighbours);
+    if (m_neighbours > 0) {
+      row.resize(m_width);
+      result.resize(m_width);
+      for (std::vector<unsigned int> &prev : prevRows)
+        prev.resize(m_width);
+    }
+    // each neighbours filter needs one more row converted before the first row of the task
+    const int start = std::max(0, begin - int(m_neighbours));
+    for (int i = start; i < end; ++i) {
+      const short y = m_srcRows[i];
+      unsigned int *dst = m_dstBuff + m_dstRows[i] * m_width;
+      // without neighbours filters the row is converted in place in destination buffer
+      unsigned int *vals = (m_neighbours > 0) ? row.data() : dst;
+      SRC src = m_srcBuff + y * m_srcSize[0] * m_pixSize;
+      m_chain[0]->filterRow(src, y, m_srcSize, m_pixSize, columns, m_width, vals);
+      unsigned int neighbour = 0;
+      for (unsigned int f = 1; f < m_chain.size(); ++f) {
+        FilterBase *filt = m_chain[f];
+        if (filt->getRowMode() == FilterBase::ROW_POINTWISE) {
+          filt->filterValues(vals, m_width);
+          continue;
+        }
+        std::vector<unsigned int> &prev = prevRows[neighbour++];
+        const unsigned int *prevVals = (i > start) ? prev.data() : nullptr;
+        filt->filterValues(row.data(), prevVals, result.data(), m_width);
+        // filter input becomes the previous row, filter output the actual row
+        row.swap(prev);
+        row.swap(result);
+        vals = row.data();
+      }
+      if (m_neighbours > 0 && i >= begin)
+        memcpy(dst, vals, m_width * sizeof(unsigned int));
+    }
+  }
+
+  /// task function
+  static void task(void *__restrict userdata, int iter, const TaskParallelTLS *__restrict tls)
+  {
+    static_cast<ImageConvertRows<SRC> *>(userdata)->convert(iter);
+  }
+};
+
 /// base class for image filters
 class ImageBase {
  public:
@@ -183,75 +281,67 @@ class ImageBase {
   /// template for image conversion
   template<class FLT, class SRC> void convImage(FLT &filter, SRC srcBuff, short *srcSize)
   {
-    // destination buffer
-    unsigned int *dstBuff = m_image;
+    ImageConvertRows<SRC> rows;
+    rows.m_filter = &filter;
+    rows.m_srcBuff = srcBuff;
+    rows.m_srcSize = srcSize;
     // pixel size from filter
-    unsigned int pixSize = filter.firstPixelSize();
+    rows.m_pixSize = filter.firstPixelSize();
+    rows.m_dstBuff = m_image;
+    rows.m_width = m_size[0];
     // if no scaling is needed
-    if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1])
-      // if flipping isn't required
-      if (!m_flip)
-        // copy bitmap
-        for (short y = 0; y < m_size[1]; ++y)
-          for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-            // copy pixel
-            *dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-      // otherwise flip image top to bottom
-      else {
-        // go to last row of image
-        srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
-        // copy bitmap
-        for (short y = m_size[1] - 1; y >= 0; --y, srcBuff -= 2 * srcSize[0] * pixSize)
-          for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-            // copy pixel
-            *dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
+    const bool scaled = srcSize[0] != m_size[0] || srcSize[1] != m_size[1];
+    if (!scaled) {
+      // rows are converted from top to bottom of source, flipped in destination if required
+      for (short y = 0; y < m_size[1]; ++y) {
+        rows.m_srcRows.push_back(y);
+        rows.m_dstRows.push_back(m_flip ? m_size[1] - y - 1 : y);
       }
+    }
     // else scale picture (nearest neighbor)
     else {
-      // interpolation accumulator
+      // interpolation accumulators
+      int accWidth = srcSize[0] >> 1;
+      for (short x = 0; x < srcSize[0]; ++x) {
+        accWidth += m_size[0];
+        // if pixel has to be drawn
+        if (accWidth >= srcSize[0]) {
+          accWidth -= srcSize[0];
+          rows.m_columns.push_back(x);
+        }
+      }
       int accHeight = srcSize[1] >> 1;
-      // if flipping is required
-      if (m_flip)
-        // go to last row of image
-        srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
-      // process image rows
-      for (int y = 0; y < srcSize[1]; ++y) {
-        // increase height accum
+      for (short y = 0; y < srcSize[1]; ++y) {
         accHeight += m_size[1];
-        // if pixel row has to be drawn
+        // if pixel row has to be drawn, from bottom of source if flipping is required
         if (accHeight >= srcSize[1]) {
-          // decrease accum
           accHeight -= srcSize[1];
-          // width accum
-          int accWidth = srcSize[0] >> 1;
-          // process row
-          for (int x = 0; x < srcSize[0]; ++x) {
-            // increase width accum
-            accWidth += m_size[0];
-            // if pixel has to be drawn
-            if (accWidth >= srcSize[0]) {
-              // decrease accum
-              accWidth -= srcSize[0];
-              // convert pixel
-              *dstBuff = filter.convert(
-                  srcBuff, x, m_flip ? srcSize[1] - y - 1 : y, srcSize, pixSize);
-              // next pixel
-              ++dstBuff;
-            }
-            // shift source pointer
-            srcBuff += pixSize;
-          }
+          rows.m_dstRows.push_back(rows.m_srcRows.size());
+          rows.m_srcRows.push_back(m_flip ? srcSize[1] - y - 1 : y);
         }
-        // if pixel row will not be drawn
-        else
-          // move source pointer to next row
-          srcBuff += pixSize * srcSize[0];
-        // if y flipping is required
-        if (m_flip)
-          // go to previous row of image
-          srcBuff -= 2 * pixSize * srcSize[0];
       }
+      rows.m_width = rows.m_columns.size();
     }
+    if (rows.m_width == 0 || rows.m_srcRows.empty())
+      return;
+
+    // fuse filter chain to convert rows of pixels, otherwise convert pixel by pixel
+    if (!filter.getRowChain(rows.m_chain, scaled))
+      rows.m_chain.clear();
+    rows.m_neighbours = 0;
+    for (unsigned int f = 1; f < rows.m_chain.size(); ++f) {
+      if (rows.m_chain[f]->getRowMode() == FilterBase::ROW_NEIGHBOURS)
+        ++rows.m_neighbours;
+    }
+
+    // split rows in tasks of about 64K pixels
+    rows.m_taskRows = std::max(1, 0x10000 / rows.m_width);
+    const int numTasks = (int(rows.m_srcRows.size()) + rows.m_taskRows - 1) / rows.m_taskRows;
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (numTasks > 1);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, numTasks, &rows, ImageConvertRows<SRC>::task, &settings);
   }
 
   // template for specific filter preprocessing